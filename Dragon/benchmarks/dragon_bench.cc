@@ -0,0 +1,422 @@
+/*!
+ * The operator-level micro-benchmarks on CPU.
+ *
+ * Usage: dragon_bench [--filter=<substr>] [--json=<file>]
+ *                     [--min_time=<seconds>] [--phase=<TRAIN|TEST>]
+ *                     [--list] [--dispatch]
+ *
+ * Each case instantiates an operator (and its gradient ops) through
+ * the workspace on synthetic tensors, then reports the time, GFLOP/s
+ * and GB/s of the forward and backward pass. The variants of a case,
+ * e.g. data_format NCHW vs. NHWC, are expanded into separate entries
+ * which share the prefix of name. ``--phase=TEST`` runs the forward
+ * pass only as an inference graph does, e.g. with the packed weights.
+ *
+ * ``--dispatch`` reports the latency to dispatch a tiny eager op instead,
+ * through the serialized def, the def reference, and the resolved handles.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+
+#include "core/workspace.h"
+#include "core/operator_gradient.h"
+#include "utils/proto_utils.h"
+
+using namespace dragon;
+
+namespace {
+
+struct BenchInput {
+    string name;
+    vector<int64_t> dims;
+    /*! \brief Fill with uniform floats, or integers in [0, high) */
+    int64_t high;
+};
+
+struct BenchCase {
+    string name, type;
+    vector<BenchInput> inputs;
+    vector<Argument> args;
+    /*! \brief The forward FLOPs, zero for the memory-bound ops */
+    double flops;
+    bool backward;
+};
+
+struct BenchResult {
+    string name, pass;
+    int64_t iters;
+    double ms, gflops, gbytes;
+};
+
+Argument IntArg(const string& name, int64_t value) {
+    Argument arg; arg.set_name(name); arg.set_i(value); return arg;
+}
+
+Argument FloatArg(const string& name, float value) {
+    Argument arg; arg.set_name(name); arg.set_f(value); return arg;
+}
+
+Argument StrArg(const string& name, const string& value) {
+    Argument arg; arg.set_name(name); arg.set_s(value); return arg;
+}
+
+Argument IntsArg(const string& name, const vector<int64_t>& values) {
+    Argument arg; arg.set_name(name);
+    for (auto v : values) arg.add_ints(v);
+    return arg;
+}
+
+/*! \brief Return the NCHW or NHWC dimensions */
+vector<int64_t> Dims4d(
+    const string&                   data_format,
+    int64_t n, int64_t c, int64_t h, int64_t w) {
+    if (data_format == "NHWC") return { n, h, w, c };
+    return { n, c, h, w };
+}
+
+vector<BenchCase> MakeCases() {
+    vector<BenchCase> cases;
+
+    for (string fmt : { "NCHW", "NHWC" }) {
+        // ResNet-like 3x3 and 1x1 convolutions
+        const int64_t N = 8;
+        cases.push_back({ "conv2d/3x3/" + fmt, "Conv2d",
+            { { "X", Dims4d(fmt, N, 64, 56, 56), 0 },
+              { "W", { 64, 64, 3, 3 }, 0 } },
+            { IntArg("num_output", 64), IntsArg("kernel_shape", { 3, 3 }),
+              IntsArg("strides", { 1, 1 }), IntsArg("pads", { 1, 1 }),
+              IntsArg("dilations", { 1, 1 }), StrArg("data_format", fmt) },
+            2. * N * 64 * 56 * 56 * 64 * 9, true });
+        cases.push_back({ "conv2d/1x1/" + fmt, "Conv2d",
+            { { "X", Dims4d(fmt, N, 256, 28, 28), 0 },
+              { "W", { 64, 256, 1, 1 }, 0 } },
+            { IntArg("num_output", 64), IntsArg("kernel_shape", { 1, 1 }),
+              IntsArg("strides", { 1, 1 }), IntsArg("pads", { 0, 0 }),
+              IntsArg("dilations", { 1, 1 }), StrArg("data_format", fmt) },
+            2. * N * 64 * 28 * 28 * 256, true });
+        // MobileNet-like depthwise convolutions with the fused bias and ReLU6
+        for (int64_t stride : { 1, 2 }) {
+            const int64_t out_dim = 56 / stride;
+            cases.push_back({ "depthwise_conv2d/3x3s" +
+                    std::to_string(stride) + "/" + fmt, "DepthwiseConv2d",
+                { { "X", Dims4d(fmt, N, 128, 56, 56), 0 },
+                  { "W", { 128, 1, 3, 3 }, 0 }, { "B", { 128 }, 0 } },
+                { IntArg("num_output", 128), IntsArg("kernel_shape", { 3, 3 }),
+                  IntsArg("strides", { stride, stride }), IntsArg("pads", { 1, 1 }),
+                  IntsArg("dilations", { 1, 1 }), StrArg("data_format", fmt),
+                  StrArg("activation", "Relu6") },
+                2. * N * 128 * out_dim * out_dim * 9, true });
+        }
+        for (string mode : { "MAX", "AVG" }) {
+            cases.push_back({ "pool2d/" + mode + "/3x3s2/" + fmt, "Pool2d",
+                { { "X", Dims4d(fmt, N, 64, 56, 56), 0 } },
+                { IntsArg("kernel_shape", { 3, 3 }),
+                  IntsArg("strides", { 2, 2 }), IntsArg("pads", { 1, 1 }),
+                  StrArg("mode", mode), StrArg("data_format", fmt) },
+                9. * N * 64 * 28 * 28, true });
+            // ResNet-like heads
+            cases.push_back({ "pool2d/" + mode + "/global/" + fmt, "Pool2d",
+                { { "X", Dims4d(fmt, N, 2048, 7, 7), 0 } },
+                { IntArg("global_pooling", 1),
+                  StrArg("mode", mode), StrArg("data_format", fmt) },
+                N * 2048. * 7 * 7, true });
+        }
+        cases.push_back({ "batch_norm/" + fmt, "BatchNorm",
+            { { "X", Dims4d(fmt, N, 64, 56, 56), 0 },
+              { "mean", { 64 }, 0 }, { "var", { 64 }, 0 },
+              { "gamma", { 64 }, 0 }, { "beta", { 64 }, 0 } },
+            { IntArg("axis", fmt == "NCHW" ? 1 : -1) },
+            0., true });
+        cases.push_back({ "group_norm/" + fmt, "GroupNorm",
+            { { "X", Dims4d(fmt, N, 64, 56, 56), 0 },
+              { "gamma", { 64 }, 0 }, { "beta", { 64 }, 0 } },
+            { IntArg("axis", fmt == "NCHW" ? 1 : -1),
+              IntArg("group", 32) },
+            0., true });
+    }
+
+    cases.push_back({ "softmax/256x1000", "Softmax",
+        { { "X", { 256, 1000 }, 0 } }, { IntArg("axis", 1) }, 0., true });
+    cases.push_back({ "softmax/64x21x4096/axis1", "Softmax",
+        { { "X", { 64, 21, 4096 }, 0 } }, { IntArg("axis", 1) }, 0., true });
+
+    cases.push_back({ "transpose/64x128x256/021", "Transpose",
+        { { "X", { 64, 128, 256 }, 0 } },
+        { IntsArg("perm", { 0, 2, 1 }) }, 0., true });
+    cases.push_back({ "transpose/8x64x56x56/0231", "Transpose",
+        { { "X", { 8, 64, 56, 56 }, 0 } },
+        { IntsArg("perm", { 0, 2, 3, 1 }) }, 0., true });
+
+    for (string op : { "SUM", "MEAN", "MAX", "L2", "LOGSUMEXP" }) {
+        cases.push_back({ "reduce/" + op + "/1024x4096/axis0", "Reduce",
+            { { "X", { 1024, 4096 }, 0 } },
+            { IntsArg("axes", { 0 }), StrArg("operation", op) },
+            1024. * 4096, true });
+        cases.push_back({ "reduce/" + op + "/1024x4096/axis1", "Reduce",
+            { { "X", { 1024, 4096 }, 0 } },
+            { IntsArg("axes", { 1 }), StrArg("operation", op) },
+            1024. * 4096, true });
+        cases.push_back({ "reduce/" + op + "/32x64x56x56/axis023", "Reduce",
+            { { "X", { 32, 64, 56, 56 }, 0 } },
+            { IntsArg("axes", { 0, 2, 3 }), StrArg("operation", op) },
+            32. * 64 * 56 * 56, true });
+    }
+
+    cases.push_back({ "gather/50000x256/4096", "Gather",
+        { { "X", { 50000, 256 }, 0 }, { "indices", { 4096 }, 50000 } },
+        { IntArg("axis", 0) }, 0., true });
+
+    cases.push_back({ "fully_connected/256x1024x1024", "FullyConnected",
+        { { "X", { 256, 1024 }, 0 }, { "W", { 1024, 1024 }, 0 },
+          { "b", { 1024 }, 0 } },
+        { IntArg("num_output", 1024) }, 2. * 256 * 1024 * 1024, true });
+
+    cases.push_back({ "update/sgd/4M", "SGDUpdate",
+        { { "dX", { 4 << 20 }, 0 } }, { StrArg("slot", "bench") },
+        3. * (4 << 20), false });
+    cases.push_back({ "update/adam/4M", "AdamUpdate",
+        { { "dX", { 4 << 20 }, 0 } }, { StrArg("slot", "bench") },
+        12. * (4 << 20), false });
+
+    return cases;
+}
+
+void FillTensor(
+    Tensor*                         tensor,
+    const BenchInput&               spec,
+    std::mt19937&                   rng) {
+    tensor->Reshape(spec.dims);
+    if (spec.high > 0) {
+        std::uniform_int_distribution<int64_t> dist(0, spec.high - 1);
+        auto* x = tensor->mutable_data<int64_t, CPUContext>();
+        for (int64_t i = 0; i < tensor->count(); i++) x[i] = dist(rng);
+    } else {
+        std::uniform_real_distribution<float> dist(0.1f, 1.f);
+        auto* x = tensor->mutable_data<float, CPUContext>();
+        for (int64_t i = 0; i < tensor->count(); i++) x[i] = dist(rng);
+    }
+}
+
+/*! \brief Return the bytes of inputs and outputs touched by the ops */
+double TouchedBytes(
+    Workspace*                      ws,
+    const vector<OperatorDef>&      defs) {
+    double nbytes = 0.;
+    for (const auto& def : defs) {
+        for (const auto& name : def.input())
+            if (name != "NULL") nbytes += ws->GetTensor(name)->nbytes();
+        for (const auto& name : def.output())
+            if (name != "NULL") nbytes += ws->GetTensor(name)->nbytes();
+    }
+    return nbytes;
+}
+
+/*! \brief Run the function repeatedly until the minimal time is reached */
+template <class Function>
+BenchResult Measure(
+    Function                        run,
+    double                          min_time) {
+    typedef std::chrono::steady_clock Clock;
+    for (int i = 0; i < 2; i++) run();
+    int64_t iters = 1;
+    double elapsed = 0.;
+    while (true) {
+        auto start = Clock::now();
+        for (int64_t i = 0; i < iters; i++) run();
+        elapsed = std::chrono::duration<double>(
+            Clock::now() - start).count();
+        if (elapsed >= min_time || iters >= (1 << 20)) break;
+        iters = elapsed > 0. ? std::max(iters * 2, (int64_t)(
+            iters * min_time * 1.2 / elapsed)) : iters * 10;
+    }
+    BenchResult result;
+    result.iters = iters;
+    result.ms = elapsed * 1e3 / iters;
+    return result;
+}
+
+vector<BenchResult> RunCase(
+    const BenchCase&                bench,
+    double                          min_time,
+    const string&                   phase) {
+    Workspace ws("bench");
+    std::mt19937 rng(1);
+    vector<string> inputs;
+    for (const auto& spec : bench.inputs) {
+        FillTensor(ws.CreateTensor(spec.name), spec, rng);
+        inputs.push_back(spec.name);
+    }
+    string output = "Y";
+    if (bench.type.find("Update") != string::npos) {
+        // Updates apply to a parameter with the slot hyper-parameters
+        output = "X";
+        FillTensor(ws.CreateTensor(output), bench.inputs[0], rng);
+        for (auto& kv : vector<std::pair<string, float> >({
+            { "base_lr", 0.01f }, { "momentum", 0.9f },
+            { "beta1", 0.9f }, { "beta2", 0.999f }, { "eps", 1e-8f },
+            { "scale_gradient", 1.f }, { "clip_gradient", -1.f },
+            { "l2_decay", -1.f } })) {
+            ws.CreateTensor("bench/" + kv.first)->Reshape({ 1 })
+                ->mutable_data<float, CPUContext>()[0] = kv.second;
+        }
+    }
+
+    auto def = MakeOperatorDef(bench.type, "bench",
+        inputs, vector<string>({ output }), bench.args);
+    def.set_uid(bench.name);
+    auto* op = ws.CreateOperator(def);
+    op->SwitchToPhase(phase);
+
+    vector<BenchResult> results;
+    auto forward = Measure([op]() { op->Run(); }, min_time);
+    forward.gbytes = TouchedBytes(&ws, { def });
+    forward.gflops = bench.flops;
+    forward.pass = "forward";
+    results.push_back(forward);
+
+    if (bench.backward && phase != "TEST") {
+        FillTensor(ws.CreateTensor(output + "_grad"),
+            { "", ws.GetTensor(output)->dims(), 0 }, rng);
+        auto grad = MakeGradientForOp(def, { output + "_grad" });
+        vector<OperatorBase*> grad_ops;
+        for (auto& grad_def : grad.ops) {
+            for (const auto& name : grad_def.output())
+                if (name != "NULL") ws.CreateTensor(name);
+            grad_ops.push_back(ws.CreateOperator(grad_def));
+            grad_ops.back()->SwitchToPhase("TRAIN");
+        }
+        auto backward = Measure([&grad_ops]() {
+            for (auto* grad_op : grad_ops) grad_op->Run();
+        }, min_time);
+        backward.gbytes = TouchedBytes(&ws, grad.ops);
+        // Most gradients cost about twice of the forward
+        backward.gflops = 2. * bench.flops;
+        backward.pass = "backward";
+        results.push_back(backward);
+    }
+
+    for (auto& result : results) {
+        result.name = bench.name;
+        result.gflops = result.gflops / result.ms * 1e-6;
+        result.gbytes = result.gbytes / result.ms * 1e-6;
+    }
+    return results;
+}
+
+/*! \brief Measure the ways to dispatch a tiny op in the eager mode */
+vector<BenchResult> RunDispatch(
+    const string&                   type,
+    int64_t                         num_inputs,
+    double                          min_time) {
+    Workspace ws("bench");
+    std::mt19937 rng(1);
+    vector<string> inputs;
+    for (int64_t i = 0; i < num_inputs; i++) {
+        inputs.push_back("X" + std::to_string(i));
+        FillTensor(ws.CreateTensor(inputs.back()), { "", { 16 }, 0 }, rng);
+    }
+    auto def = MakeOperatorDef(type, "runtime",
+        inputs, vector<string>({ "Y" }), vector<Argument>());
+    def.set_uid("dispatch/" + type);
+    const string serialized = def.SerializeAsString();
+
+    vector<BenchResult> results;
+    // As the frontend, which copies the def and sends the bytes
+    results.push_back(Measure([&]() {
+        OperatorDef op_def;
+        CHECK(op_def.ParseFromString(serialized));
+        ws.RunOperator(op_def);
+    }, min_time));
+    results.back().pass = "serialized";
+    // As the frontend, which sends the def reference
+    results.push_back(Measure([&]() {
+        OperatorDef op_def; op_def.CopyFrom(def);
+        ws.RunOperator(op_def);
+    }, min_time));
+    results.back().pass = "def";
+    // As the frontend, which keeps the resolved handles
+    auto* op = ws.CreateOperator(def);
+    vector<Tensor*> X, Y = { ws.CreateTensor("Y") };
+    for (const auto& name : inputs) X.push_back(ws.GetTensor(name));
+    results.push_back(Measure([&]() {
+        op->UpdateFrom(X, Y, "runtime"); op->Run();
+    }, min_time));
+    results.back().pass = "handle";
+
+    for (auto& result : results) {
+        result.name = "dispatch/" + type;
+        result.gflops = result.gbytes = 0.;
+    }
+    return results;
+}
+
+void WriteJSON(const string& path, const vector<BenchResult>& results) {
+    std::ofstream out(path);
+    CHECK(out.is_open()) << "\nFailed to open " << path << ".";
+    out << "[\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const auto& r = results[i];
+        out << "  {\"name\": \"" << r.name << "\", "
+            << "\"pass\": \"" << r.pass << "\", "
+            << "\"iters\": " << r.iters << ", "
+            << "\"time_ms\": " << r.ms << ", "
+            << "\"gflops\": " << r.gflops << ", "
+            << "\"gbytes_per_sec\": " << r.gbytes << "}"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "]\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    string filter, json_path, phase = "TRAIN";
+    double min_time = 0.2;
+    bool list_only = false, dispatch = false;
+    for (int i = 1; i < argc; i++) {
+        string arg(argv[i]);
+        if (arg.find("--filter=") == 0) filter = arg.substr(9);
+        else if (arg.find("--json=") == 0) json_path = arg.substr(7);
+        else if (arg.find("--min_time=") == 0)
+            min_time = atof(arg.substr(11).c_str());
+        else if (arg.find("--phase=") == 0) phase = arg.substr(8);
+        else if (arg == "--list") list_only = true;
+        else if (arg == "--dispatch") dispatch = true;
+        else LOG(FATAL) << "Unknown argument: " << arg;
+    }
+    SetLogDestination(WARNING);
+
+    vector<BenchResult> results;
+    if (dispatch) {
+        printf("%-36s %-10s %10s\n", "name", "pass", "us");
+        for (auto& kv : vector<std::pair<string, int64_t> >({
+                { "Relu", 1 }, { "Add", 2 }, { "Concat", 4 } })) {
+            for (const auto& r : RunDispatch(kv.first, kv.second, min_time)) {
+                printf("%-36s %-10s %10.3f\n", r.name.c_str(),
+                       r.pass.c_str(), r.ms * 1e3);
+                results.push_back(r);
+            }
+        }
+        if (!json_path.empty()) WriteJSON(json_path, results);
+        return 0;
+    }
+    printf("%-36s %-9s %10s %10s %10s\n",
+           "name", "pass", "ms", "GFLOP/s", "GB/s");
+    for (const auto& bench : MakeCases()) {
+        if (bench.name.find(filter) == string::npos) continue;
+        if (list_only) { printf("%s\n", bench.name.c_str()); continue; }
+        for (const auto& r : RunCase(bench, min_time, phase)) {
+            printf("%-36s %-9s %10.3f %10.2f %10.2f\n", r.name.c_str(),
+                   r.pass.c_str(), r.ms, r.gflops, r.gbytes);
+            fflush(stdout);
+            results.push_back(r);
+        }
+    }
+    if (!json_path.empty()) WriteJSON(json_path, results);
+    return 0;
+}
@@ -0,0 +1,117 @@
+/*!
+ * A local load generator for the serving engine.
+ *
+ * Usage: serving_bench [clients] [requests] [workers] [max_batch] [latency_us]
+ *
+ * Each client sends single-row requests to a MLP synchronously,
+ * and the latency percentiles and throughput are reported
+ * without and with the dynamic batching.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "dragon.h"
+
+using namespace dragon;
+
+const int kInputDim = 256, kHiddenDim = 1024, kOutputDim = 16;
+
+const char* kGraph =
+    "name: \"mlp\"\n"
+    "op { type: \"FullyConnected\" input: \"data\" input: \"fc1/W\" "
+    "input: \"fc1/b\" output: \"fc1\" arg { name: \"num_output\" i: 1024 } }\n"
+    "op { type: \"Relu\" input: \"fc1\" output: \"relu1\" }\n"
+    "op { type: \"FullyConnected\" input: \"relu1\" input: \"fc2/W\" "
+    "input: \"fc2/b\" output: \"fc2\" arg { name: \"num_output\" i: 1024 } }\n"
+    "op { type: \"Relu\" input: \"fc2\" output: \"relu2\" }\n"
+    "op { type: \"FullyConnected\" input: \"relu2\" input: \"fc3/W\" "
+    "input: \"fc3/b\" output: \"prob\" arg { name: \"num_output\" i: 16 } }\n"
+    "output: \"prob\"\n"
+    "arg { name: \"phase\" s: \"TEST\" }\n";
+
+void FeedWeights(Workspace_t ws) {
+    std::mt19937 rng(1);
+    std::normal_distribution<float> normal(0.f, 0.02f);
+    auto Feed = [&](const std::string& name, std::vector<int64_t> shape) {
+        int64_t count = 1;
+        for (auto dim : shape) count *= dim;
+        std::vector<float> values(count);
+        for (auto& v : values) v = normal(rng);
+        FeedTensor<float>(name, shape, values.data(), Device("CPU"), ws);
+    };
+    Feed("fc1/W", { kHiddenDim, kInputDim }); Feed("fc1/b", { kHiddenDim });
+    Feed("fc2/W", { kHiddenDim, kHiddenDim }); Feed("fc2/b", { kHiddenDim });
+    Feed("fc3/W", { kOutputDim, kHiddenDim }); Feed("fc3/b", { kOutputDim });
+}
+
+void Bench(
+    const std::string&              name,
+    Workspace_t                     ws,
+    int                             clients,
+    int                             requests,
+    int                             workers,
+    int                             max_batch,
+    int                             latency_us) {
+    auto server = CreateServer(name, std::string(kGraph), Device("CPU"),
+        ws, { "data" }, { "prob" }, workers, max_batch, latency_us);
+
+    std::vector<std::vector<double>> latencies(clients);
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (int c = 0; c < clients; c++) {
+        threads.emplace_back([&, c]() {
+            std::vector<float> x(kInputDim, 0.1f * (c + 1));
+            std::vector<std::vector<float>> y;
+            std::vector<std::vector<int64_t>> y_shapes;
+            for (int i = 0; i < requests; i++) {
+                auto t0 = std::chrono::steady_clock::now();
+                ServeRequest<float, float>(server, { x.data() },
+                    { { 1, kInputDim } }, y, y_shapes);
+                auto t1 = std::chrono::steady_clock::now();
+                latencies[c].push_back(std::chrono::duration
+                    <double, std::milli>(t1 - t0).count());
+                if (y_shapes[0][0] != 1 || y_shapes[0][1] != kOutputDim) {
+                    fprintf(stderr, "Unexpected output shape.\n");
+                    exit(1);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    DestroyServer(name);
+
+    std::vector<double> all;
+    for (auto& e : latencies) all.insert(all.end(), e.begin(), e.end());
+    std::sort(all.begin(), all.end());
+    auto Percentile = [&all](double p) {
+        return all[std::min(all.size() - 1, (size_t)(p * all.size()))];
+    };
+    printf("%-12s batch<=%-3d p50: %7.3f ms  p99: %7.3f ms  "
+           "throughput: %9.1f req/s\n", name.c_str(), max_batch,
+           Percentile(0.50), Percentile(0.99), all.size() / seconds);
+}
+
+int main(int argc, char** argv) {
+    int clients = argc > 1 ? atoi(argv[1]) : 16;
+    int requests = argc > 2 ? atoi(argv[2]) : 200;
+    int workers = argc > 3 ? atoi(argv[3]) : 2;
+    int max_batch = argc > 4 ? atoi(argv[4]) : 16;
+    int latency_us = argc > 5 ? atoi(argv[5]) : 1000;
+    SetLoggingLevel("WARNING");
+    auto* ws = CreateWorkspace("weights");
+    FeedWeights(ws);
+    printf("clients: %d, requests: %d, workers: %d\n",
+           clients, requests, workers);
+    Bench("unbatched", ws, clients, requests, workers, 1, 0);
+    Bench("batched", ws, clients, requests, workers, max_batch, latency_us);
+    return 0;
+}
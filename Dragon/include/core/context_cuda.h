@@ -343,6 +343,9 @@ class CUDAContext {
     /*! \brief Malloc the memory */
     static void* New(size_t nbytes) { CUDA_NOT_COMPILED; }
 
+    /*! \brief Free the memory */
+    static void Delete(void* data) { CUDA_NOT_COMPILED; }
+
     /*! \brief Zero-Reset the memory */
     static void Memset(
         size_t              nbytes,
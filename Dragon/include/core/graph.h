@@ -15,6 +15,7 @@
 
 #include "core/common.h"
 #include "core/operator.h"
+#include "core/graph_optimizer.h"
 
 namespace dragon {
 
@@ -78,8 +79,42 @@ class Graph : public GraphBase {
     Workspace* ws() const { return ws_; }
 
  protected:
+    /*! \brief Plan the recomputing and offloading for training */
+    GraphDef PlanTraining(
+        const GraphDef&                     input_def,
+        Map< string, vector<int> >&         subgraph_indices);
+
+    /*! \brief Create the operators and bind the recomputing subgraph */
+    void Build(
+        const GraphDef&                     optimized_graph,
+        const Map< string, vector<int> >&   subgraph_indices);
+
+    /*! \brief Record the size of outputs produced by the given op */
+    void RecordActivations(int op_idx);
+
+    /*! \brief Rebuild the graph with the recorded sizes */
+    void Replan();
+
     /*! \brief Store the internal operators */
     vector<OperatorBase*> ops_;
+
+    /*! \brief Store the asynchronous operators */
+    vector<OperatorBase*> async_ops_;
+
+    /*! \brief Store the asynchronous operators to wait before each */
+    Map<OperatorBase*, vector<OperatorBase*> > async_deps_;
+
+    /*! \brief Store the filtered operators, keyed by the include/exclude */
+    Map<string, vector<OperatorBase*> > filtered_ops_;
+
+    /*! \brief Store the update def to build at the first run */
+    GraphDef update_def_;
+
+    /*! \brief Store the def to replan the checkpoints at the first run */
+    GraphDef checkpoint_def_;
+
+    /*! \brief Store the sizes of activations recorded by the first run */
+    Map<string, GraphOptimizer::Activation> activations_;
 };
 
 /*! \brief Create a graph from the raw def */
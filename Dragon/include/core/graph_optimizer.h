@@ -29,6 +29,12 @@ class GraphOptimizer {
         OperatorDef op_def;
     };
 
+    /*! \brief The size of an activation recorded by a run */
+    struct Activation {
+        int64_t count = 0;
+        size_t nbytes = 0;
+    };
+
     /*! \brief Default constructor */
     GraphOptimizer(Workspace* ws) : ws_(ws) {}
 
@@ -38,6 +44,21 @@ class GraphOptimizer {
     /*! \brief Add the inplace for outputs (-O2) */
     GraphDef AddInplace(const GraphDef& input_def);
 
+    /*! \brief Select the activations to recompute (-O3) */
+    GraphDef PlanCheckpoints(
+        const GraphDef&                   input_def,
+        const string&                     mode,
+        int64_t                           budget,
+        const Map<string, Activation>&    activations,
+        string*                           report,
+        bool*                             deferred);
+
+    /*! \brief Move the activations to host between the passes (-O3) */
+    GraphDef PlanOffload(
+        const GraphDef&                   input_def,
+        int64_t                           distance,
+        string*                           report);
+
     /*! \brief Plan the recomputing for inputs (-O3) */
     GraphDef MirrorStage(
         const GraphDef&                   input_def,
@@ -46,6 +67,12 @@ class GraphOptimizer {
     /*! \brief Allocate the buffer for outputs (-O3) */
     GraphDef SimulateGC(const GraphDef& input_def);
 
+    /*! \brief Write the inputs of concat into its output (-O3) */
+    GraphDef ZeroCopyConcat(const GraphDef& input_def);
+
+    /*! \brief Share the memory for the outputs of layout ops (-O3) */
+    GraphDef ZeroCopyView(const GraphDef& input_def);
+
  protected:
     /*! \brief Traverse from input gradients to dying the nodes */
     void ForwardPruneTraversal(
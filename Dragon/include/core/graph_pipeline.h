@@ -0,0 +1,124 @@
+/*!
+ * Copyright (c) 2017-present, SeetaTech, Co.,Ltd.
+ *
+ * Licensed under the BSD 2-Clause License.
+ * You should have received a copy of the BSD 2-Clause License
+ * along with the software. If not, See,
+ *
+ *      <https://opensource.org/licenses/BSD-2-Clause>
+ *
+ * ------------------------------------------------------------
+ */
+
+#ifndef DRAGON_CORE_GRAPH_PIPELINE_H_
+#define DRAGON_CORE_GRAPH_PIPELINE_H_
+
+#include "core/graph.h"
+
+namespace dragon {
+
+/*!
+ * The graph partitioned into the pipeline stages.
+ *
+ * Each operator is placed on the stage of its first ``mpi_ranks``,
+ * or inherits the stage of its consumers or producers if not given.
+ * The tensors crossing the stages are exchanged by MPISend/MPIRecv,
+ * which are appended to the end/start of the forward/backward pass.
+ *
+ * A run splits the batch into micro-batches, and follows the 1F1B
+ * schedule, i.e., stage ``s`` of ``S`` warms up with ``S - s - 1``
+ * forward passes, then alternates between the forward and backward.
+ * The activations of the pending micro-batches are stashed, and the
+ * gradients of parameters and outputs are averaged over micro-batches.
+ */
+class PipelineGraph : public GraphBase {
+ public:
+    /*! \brief Default constructor */
+    PipelineGraph(const GraphDef& meta_graph, Workspace* ws);
+
+    /*! \brief Default deconstructor */
+    virtual ~PipelineGraph() { for (auto* op : ops_) delete op; }
+
+    /*! \brief Create a graph from the partitioned def */
+    bool Create(
+        const GraphDef&         optimized_graph,
+        Workspace*              ws) override;
+
+    /*! \brief Run all the micro-batches once synchronously */
+    bool Run(
+        const string&           include,
+        const string&           exclude,
+        int                     stream_id = 0) override;
+
+    /*! \brief Return the number of stages */
+    int num_stages() const { return (int)stage_ranks_.size(); }
+
+    /*! \brief Return the stage of this rank, -1 if idle */
+    int stage() const { return stage_; }
+
+    /*! \brief Return the number of micro-batches */
+    int num_micro_batches() const { return num_micro_batches_; }
+
+ protected:
+    /*! \brief The role of each operator in a run */
+    enum Role {
+        FORWARD, BACKWARD,
+        OUTPUT_INIT, OUTPUT_ACC, OUTPUT_MEAN,
+        GRAD_INIT, GRAD_ACC, GRAD_MEAN,
+    };
+
+    /*! \brief Return the operators of this stage with the exchanges */
+    GraphDef Partition(const GraphDef& input_def);
+
+    /*! \brief Run the operators of a role */
+    void RunOps(Role role, int stream_id);
+
+    /*! \brief Run the forward pass of a micro-batch */
+    void Forward(int micro_batch, bool stash, int stream_id);
+
+    /*! \brief Run the backward pass of a micro-batch */
+    void Backward(int micro_batch, int stream_id);
+
+    /*! \brief View the inputs as the rows of a micro-batch */
+    void SliceInputs(int micro_batch);
+
+    /*! \brief Move the activations of a micro-batch into the stash */
+    void Stash(int micro_batch);
+
+    /*! \brief Move the activations of a micro-batch back */
+    void Restore(int micro_batch);
+
+    /*! \brief Switch a tensor to a free memory, keep the used one */
+    void Rotate(Tensor* X);
+
+    /*! \brief Store the internal operators and their roles */
+    vector<OperatorBase*> ops_;
+    vector<Role> roles_;
+
+    /*! \brief Store the role of operators in the partitioned def */
+    vector<Role> def_roles_;
+
+    /*! \brief Store the ranks of stages and the stage of this rank */
+    vector<int> stage_ranks_;
+    int stage_ = 0, num_micro_batches_ = 1;
+
+    /*! \brief Whether to run the backward passes */
+    bool has_backward_ = false;
+
+    /*! \brief Store the names of tensors to handle in a run */
+    vector<string> activations_, backward_sends_, forward_sends_;
+    vector<string> micro_batch_inputs_;
+
+    /*! \brief Store the tensors viewed as micro-batches */
+    vector<std::pair<Tensor*, unique_ptr<Tensor> > > sliced_inputs_;
+
+    /*! \brief Store the activations of pending micro-batches */
+    Map<int, vector<unique_ptr<Tensor> > > stash_;
+
+    /*! \brief Store the memories rotated by the tensors */
+    Map<string, vector<unique_ptr<Tensor> > > memory_pool_;
+};
+
+}  // namespace dragon
+
+#endif  // DRAGON_CORE_GRAPH_PIPELINE_H_
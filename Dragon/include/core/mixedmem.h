@@ -84,6 +84,12 @@ class MixedMemory {
     /*! \brief Set the cpu data pointer from external context */
     void set_cpu_data(void* cpu_ptr, size_t nbytes);
 
+    /*! \brief Set the cuda data pointer from external context */
+    void set_cuda_data(void* cuda_ptr, size_t nbytes, int device_id);
+
+    /*! \brief Set the callback to release the external data pointers */
+    void set_deleter(std::function<void()> deleter) { deleter_ = deleter; }
+
     /*! \brief Switch to the specified device */
     void SwitchToDevice(int device_id);
 
@@ -111,6 +117,14 @@ class MixedMemory {
     /*! \brief Return the device id of the memory on device */
     int device_id() const { return ptr_device_; }
 
+#ifdef WITH_MKL
+    /*! \brief Return the epoch of contents, renewed on mutable accesses */
+    int64_t epoch() const { return epoch_; }
+
+    /*! \brief Return a new epoch unique in the process */
+    static int64_t NewEpoch();
+#endif
+
     /*! \brief Return a string to describe the internal structure */
     const Map<string, string> info() const;
 
@@ -139,9 +153,27 @@ class MixedMemory {
     /*! \brief Whether this memory owns the cpu data pointer */
     int own_cpu_ptr_ = 1;
 
+    /*! \brief Whether this memory owns the cuda data pointer */
+    int own_cuda_ptr_ = 1;
+
+    /*! \brief The callback to release the external data pointers */
+    std::function<void()> deleter_;
+
     /*! \brief Store the device id for some data pointers */
     int ptr_device_ = 0;
 
+    /*! \brief Renew the epoch, only the packed Gemm reads it */
+    void RenewEpoch() {
+#ifdef WITH_MKL
+        epoch_ = NewEpoch();
+#endif
+    }
+
+#ifdef WITH_MKL
+    /*! \brief Store the epoch of contents */
+    int64_t epoch_ = NewEpoch();
+#endif
+
     /*! \brief Binding cpu tensor for CAMBRICON's CNML Library */
     cnmlCpuTensor_t cnml_cpu_tensor_ = nullptr;
 
@@ -18,6 +18,7 @@
 #include "core/tensor.h"
 #include "core/operator_gradient.h"
 #include "core/operator_schema.h"
+#include "core/scratch.h"
 #include "utils/cast.h"
 
 #ifdef WITH_MPI
@@ -51,6 +52,12 @@ class OperatorBase {
     /*! \brief Modify this operator according to the given def  */
     void UpdateFrom(const OperatorDef& def);
 
+    /*! \brief Modify this operator with the resolved tensors */
+    void UpdateFrom(
+        const vector<Tensor*>&  inputs,
+        const vector<Tensor*>&  outputs,
+        const string&           anchor);
+
     /*! \brief Switch the internal running phase */
     void SwitchToPhase(const string& phase) { phase_ = phase; }
 
@@ -60,6 +67,12 @@ class OperatorBase {
     /*! \brief Fusion this operator into the specified graph */
     virtual void Fusion(void* graph) { NOT_IMPLEMENTED; }
 
+    /*! \brief Wait for the run returned before finishing */
+    virtual void Wait() {}
+
+    /*! \brief Whether the run could return before finishing */
+    bool is_async() const { return is_async_; }
+
     /*! \brief Return the operator name */
     const string& name() const { return def_.name(); }
 
@@ -121,6 +134,7 @@ class OperatorBase {
         const Set<string>&      dtypes) const;
 
  protected:
+    bool is_async_ = false;
     string phase_, anchor_;
     Map<std::string, const Argument*> args_;
     SubGraph subgraph_;
@@ -150,6 +164,12 @@ class Operator : public OperatorBase {
         if (!allow_run_) return;
         if (allow_recomputing_) PrepareResource();
         ctx()->SwitchToDevice(stream_id);
+        ScratchScope scratch_scope(ScratchArena::Get<Context>(
+            stream_id), stream_id);
+        if (!allow_strided_inputs_) {
+            for (auto* e : inputs_)
+                if (!e->is_contiguous()) Contiguous(e);
+        }
         MemorySwitch();
         RunOnDevice();
         if (do_sync_ || stream_id > 0) {
@@ -165,6 +185,9 @@ class Operator : public OperatorBase {
     /*! \brief Release the ownership of inputs */
     virtual void ReleaseResource();
 
+    /*! \brief Materialize the strided view into a contiguous tensor */
+    void Contiguous(Tensor* X);
+
     /*! \brief Coordinate the context of inputs and outputs */
     virtual void MemorySwitch() {
         for (auto* e : inputs_)
@@ -189,6 +212,12 @@ class Operator : public OperatorBase {
     Context ctx_;
     bool allow_run_, allow_recomputing_, do_sync_;
 
+    /*! \brief Whether the kernels could read the strided views */
+    bool allow_strided_inputs_ = false;
+
+    /*! \brief Store the materialized strided inputs for reusing */
+    Map<Tensor*, unique_ptr<Tensor> > contiguous_buffers_;
+
  private:
     /*! \brief Check the MPI conditions */
     bool MPICheck() {
@@ -0,0 +1,165 @@
+/*!
+ * Copyright (c) 2017-present, SeetaTech, Co.,Ltd.
+ *
+ * Licensed under the BSD 2-Clause License.
+ * You should have received a copy of the BSD 2-Clause License
+ * along with the software. If not, See,
+ *
+ *      <https://opensource.org/licenses/BSD-2-Clause>
+ *
+ * ------------------------------------------------------------
+ */
+
+#ifndef DRAGON_CORE_SCRATCH_H_
+#define DRAGON_CORE_SCRATCH_H_
+
+#include <atomic>
+
+#include "core/context.h"
+#include "core/context_cuda.h"
+#include "core/context_cnml.h"
+#include "core/typeid.h"
+
+namespace dragon {
+
+/*!
+ * The bump allocator of temporary memory.
+ *
+ * Each thread holds an arena for every (context, device, stream),
+ * so that the operators running concurrently never share the scratch.
+ * The arenas of a thread are freed when the thread exits.
+ * Memory is taken from the top and returned by releasing to a mark,
+ * which is done by the ``ScratchScope`` around an operator.
+ *
+ * The arena may hold several chunks while growing, and they are
+ * coalesced into a single chunk of the high-water size once
+ * all the scratch is released.
+ */
+class ScratchArena {
+ public:
+    typedef void* (*NewFunction)(size_t);
+    typedef void (*DeleteFunction)(void*);
+
+    /*! \brief Constructor with the allocator of a context */
+    ScratchArena(NewFunction new_func, DeleteFunction delete_func)
+        : new_func_(new_func), delete_func_(delete_func) {}
+
+    /*! \brief Deconstructor */
+    ~ScratchArena() { Clear(); }
+
+    /*! \brief Allocate the given bytes from the top */
+    void* Alloc(size_t nbytes);
+
+    /*! \brief Allocate the bytes reusing the last shared block */
+    void* AllocShared(size_t nbytes);
+
+    /*! \brief Return the current top as a mark */
+    size_t Mark() const { return used_; }
+
+    /*! \brief Release the scratch allocated after the mark */
+    void Release(size_t mark);
+
+    /*! \brief Free all the chunks */
+    void Clear();
+
+    /*! \brief Return the bytes in use */
+    size_t used() const {
+        return stats_[0].load(std::memory_order_relaxed);
+    }
+
+    /*! \brief Return the high-water bytes */
+    size_t peak() const {
+        return stats_[1].load(std::memory_order_relaxed);
+    }
+
+    /*! \brief Return the bytes of all the chunks */
+    size_t capacity() const {
+        return stats_[2].load(std::memory_order_relaxed);
+    }
+
+    /*! \brief Return the arena of current thread */
+    template <class Context>
+    static ScratchArena* Get(int stream_id = -1);
+
+    /*! \brief Return the statistics of all the arenas */
+    static void Stats(size_t* used, size_t* peak, size_t* capacity);
+
+    /*! \brief Set the max bytes of an arena, 0 for unlimited */
+    static void SetLimit(size_t nbytes);
+
+    /*! \brief Return the max bytes of an arena */
+    static size_t limit();
+
+    /*! \brief Return the stream of the innermost scope */
+    static int current_stream();
+
+ private:
+    friend class ScratchScope;
+
+    /*! \brief Return the arena by the type, device and stream */
+    static ScratchArena* Get(
+        TypeId                  type,
+        int                     device_id,
+        int                     stream_id,
+        NewFunction             new_func,
+        DeleteFunction          delete_func);
+
+    /*! \brief Store the counters for the readers of other threads */
+    void Publish();
+
+    struct Chunk {
+        /*! \brief The memory, the offset and size in the arena */
+        void* data; size_t begin, nbytes;
+    };
+
+    vector<Chunk> chunks_;
+    NewFunction new_func_;
+    DeleteFunction delete_func_;
+    size_t used_ = 0, peak_ = 0, capacity_ = 0;
+    size_t floor_ = 0, shared_begin_ = 0, shared_end_ = 0;
+    std::atomic<size_t> stats_[3] = {};
+};
+
+/*! \brief Return the device of the memory allocated by a context */
+
+template <class Context>
+inline int ScratchDevice() { return 0; }
+
+#ifdef WITH_CUDA
+template <> inline int ScratchDevice<CUDAContext>() {
+    return CUDAContext::active_device_id();
+}
+#endif
+
+template <class Context>
+ScratchArena* ScratchArena::Get(int stream_id) {
+    return Get(TypeMeta::Id<Context>(), ScratchDevice<Context>(),
+        stream_id < 0 ? current_stream() : stream_id,
+            &Context::New, &Context::Delete);
+}
+
+/*!
+ * Release the scratch taken within the scope.
+ *
+ * The shared blocks returned by ``Workspace::caches`` are reused
+ * by the later requests in the same scope, as the only "/share/cache"
+ * did before. The nested scopes always start a new shared block.
+ */
+class ScratchScope {
+ public:
+    /*! \brief Constructor with the arena to release */
+    ScratchScope(ScratchArena* arena, int stream_id = 0);
+
+    /*! \brief Deconstructor */
+    ~ScratchScope();
+
+ private:
+    ScratchArena* arena_;
+    size_t mark_, prev_floor_;
+    size_t prev_shared_begin_, prev_shared_end_;
+    int prev_stream_;
+};
+
+}  // namespace dragon
+
+#endif  // DRAGON_CORE_SCRATCH_H_
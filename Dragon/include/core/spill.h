@@ -0,0 +1,89 @@
+/*!
+ * Copyright (c) 2017-present, SeetaTech, Co.,Ltd.
+ *
+ * Licensed under the BSD 2-Clause License.
+ * You should have received a copy of the BSD 2-Clause License
+ * along with the software. If not, See,
+ *
+ *      <https://opensource.org/licenses/BSD-2-Clause>
+ *
+ * ------------------------------------------------------------
+ */
+
+#ifndef DRAGON_CORE_SPILL_H_
+#define DRAGON_CORE_SPILL_H_
+
+#include <deque>
+#include <future>
+#include <condition_variable>
+
+#include "core/common.h"
+#include "core/typeid.h"
+
+namespace dragon {
+
+/*!
+ * The host memory holding the offloaded tensors.
+ *
+ * The blocks of CPU tensors are mapped from an unlinked file
+ * under ``DRAGON_SPILL_DIR`` (defaults to ``/tmp``), so that
+ * the kernel could write them back instead of keeping in RAM.
+ * The blocks of CUDA tensors are pinned for the async copies.
+ *
+ * Blocks are never returned to the system, a freed block is
+ * reused by the later requests of the same size in next runs.
+ * The copies are run by a single thread in the order of submitting.
+ */
+class SpillArea {
+ public:
+    /*! \brief The spilled content of a tensor */
+    struct Entry {
+        void* data = nullptr;
+        size_t nbytes = 0;
+        vector<int64_t> dims;
+        TypeMeta meta;
+    };
+
+    /*! \brief Return the global spill area */
+    static SpillArea* Get();
+
+    /*! \brief Allocate a block of the given bytes */
+    void* Alloc(size_t nbytes, bool pinned);
+
+    /*! \brief Return the block for reusing */
+    void Free(void* data);
+
+    /*! \brief Store the entry of a tensor, free the replaced one */
+    void Put(const void* key, const Entry& entry);
+
+    /*! \brief Remove the entry of a tensor, return false if missing */
+    bool Take(const void* key, Entry* entry);
+
+    /*! \brief Queue a copy and return the future of it */
+    std::future<void> Submit(std::function<void()> job);
+
+    /*! \brief Return the bytes in use, the high-water and all blocks */
+    void Stats(size_t* used, size_t* peak, size_t* capacity);
+
+ protected:
+    SpillArea();
+    void ThreadRun();
+
+    /*! \brief Map a block from the spill file, nullptr if failed */
+    void* NewMapped(size_t nbytes);
+
+    struct Block { size_t nbytes; bool pinned; };
+
+    std::mutex mutex_, job_mutex_;
+    std::condition_variable cond_;
+    std::deque<std::packaged_task<void()> > jobs_;
+    Map<void*, Block> blocks_;
+    std::multimap<size_t, void*> free_blocks_[2];
+    Map<const void*, Entry> entries_;
+    size_t used_ = 0, peak_ = 0, capacity_ = 0;
+    int fd_ = -1; size_t file_size_ = 0;
+};
+
+}  // namespace dragon
+
+#endif  // DRAGON_CORE_SPILL_H_
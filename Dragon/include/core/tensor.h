@@ -43,10 +43,11 @@ class Tensor {
             CHECK_GE(d, 0);
             if (d > 0) new_size *= d;
         } if (own_mem_) {
-            if (size_ != new_size &&
-                capacity_ < new_size * meta_.itemsize()) {
+            // A strided view could not be reinterpreted
+            if (!contiguous_ || (size_ != new_size &&
+                capacity_ < new_size * meta_.itemsize())) {
                 memory_.reset();
-                capacity_ = 0;
+                capacity_ = offset_ = 0;
             }
         } else {
             if (ex_memory_ && !is_shared_ &&
@@ -56,7 +57,7 @@ class Tensor {
                 capacity_ = 0;
             }
         }
-        size_ = new_size;
+        size_ = new_size; contiguous_ = true;
         return this;
     }
 
@@ -107,6 +108,9 @@ class Tensor {
     /*! \brief Return the number of elements from the start axis */
     int64_t count(int64_t start) const { return count(start, ndim()); }
 
+    /*! \brief Return the byte offset into the internal memory */
+    size_t offset() const { return offset_; }
+
     /*! \brief Return the stride of given axis */
     int64_t stride(int64_t i) const { return strides_[axis(i)]; }
 
@@ -134,6 +138,14 @@ class Tensor {
     /*! \brief Set the version of this tensor */
     void set_version(int version) { version_ = version; }
 
+#ifdef WITH_MKL
+    /*! \brief Return the epoch of contents, or -1 without a memory */
+    int64_t epoch() const {
+        MixedMemory* mem = memory();
+        return mem ? mem->epoch() : -1;
+    }
+#endif
+
     /*! \brief Whether this tensor holds a valid memory */
     bool has_memory() const { return memory_ || ex_memory_ != nullptr; }
 
@@ -142,9 +154,89 @@ class Tensor {
 
     /*! \brief Set the memory from a external pointer */
     void set_memory(MixedMemory* mem) {
-        memory_.reset(mem); capacity_ = mem->nbytes();
+        memory_.reset(mem); capacity_ = mem->nbytes(); offset_ = 0;
+        copy_on_write_ = false;
+    }
+
+    /*! \brief Whether the owned memory is shared by copy-on-write */
+    bool is_copy_on_write() const {
+        return copy_on_write_ && memory_ && memory_.use_count() > 1;
     }
 
+    /*! \brief Share the owned memory of other until either is mutated */
+    void ShareCopyOnWrite(Tensor& other) {
+        CHECK(other.own_mem_ && other.memory_)
+            << "\nTensor(" << other.name() << ") does not own a memory.";
+        if (&other == this) return;
+        if (!own_mem_ && ex_memory_ && !is_shared_) delete ex_memory_;
+        ex_memory_ = nullptr; is_shared_ = false; own_mem_ = true;
+        memory_ = other.memory_; meta_ = other.meta_;
+        offset_ = other.offset_; size_ = other.size_;
+        capacity_ = other.capacity_; contiguous_ = other.contiguous_;
+        dims_ = other.dims_; strides_ = other.strides_;
+        version_ = other.version_;
+        copy_on_write_ = other.copy_on_write_ = true;
+    }
+
+    /*! \brief Whether this tensor owns a memory that could be viewed */
+    bool is_viewable() const { return own_mem_ && memory_; }
+
+    /*! \brief Whether the owned memory is held by other tensors */
+    bool is_memory_shared() const {
+        return own_mem_ && memory_ && memory_.use_count() > 1;
+    }
+
+    /*! \brief Whether this tensor shares the owned memory of other */
+    bool IsViewOf(const Tensor& other) const {
+        return own_mem_ && memory_ &&
+            memory_ == other.memory_ && &other != this;
+    }
+
+    /*! \brief Share the memory of other with the given layout */
+    void ShareView(
+        const Tensor&               other,
+        size_t                      offset,
+        const vector<int64_t>&      dims,
+        const vector<int64_t>&      strides) {
+        CHECK(other.own_mem_ && other.memory_)
+            << "\nTensor(" << other.name() << ") does not own a memory.";
+        CHECK_EQ(dims.size(), strides.size());
+        size_t new_size = 1, span = 1; int64_t expected = 1;
+        bool contiguous = true;
+        for (int i = (int)dims.size() - 1; i >= 0; i--) {
+            CHECK_GE(dims[i], 0); CHECK_GE(strides[i], 0);
+            if (dims[i] > 1 && strides[i] != expected)
+                contiguous = false;
+            if (dims[i] > 0) {
+                new_size *= dims[i]; expected *= dims[i];
+                span += (dims[i] - 1) * strides[i];
+            }
+        }
+        if (new_size == 0) span = 0;
+        CHECK_LE(offset + span * other.meta_.itemsize(),
+            other.memory_->nbytes())
+            << "\nThe view of Tensor(" << name_ << ") is out of the "
+            << "memory of Tensor(" << other.name() << ").";
+        if (!own_mem_ && ex_memory_ && !is_shared_) delete ex_memory_;
+        ex_memory_ = nullptr; is_shared_ = false; own_mem_ = true;
+        memory_ = other.memory_; meta_ = other.meta_; offset_ = offset;
+        dims_ = dims; strides_ = strides; size_ = new_size;
+        copy_on_write_ = other.copy_on_write_;
+        capacity_ = contiguous ? nbytes() : 0; contiguous_ = contiguous;
+    }
+
+    /*! \brief Share the memory of other starting from the byte offset */
+    void ShareView(const Tensor& other, size_t offset) {
+        Reshape(dims_);
+        ShareView(other, offset, dims_, strides_);
+    }
+
+    /*! \brief Whether the elements are laid out in the row-major order */
+    bool is_contiguous() const { return contiguous_; }
+
+    /*! \brief Return the bytes to synchronize, zero for the whole memory */
+    size_t extent() const { return contiguous_ ? offset_ + nbytes() : 0; }
+
     /*! \brief Return the state of the internal memory */
     MixedMemory::State memory_state() const {
         MixedMemory* mem = memory();
@@ -171,16 +263,19 @@ class Tensor {
     /*! \brief Try to get the raw mutable data pointer */
     template <class Context>
     void mutable_data_ptr(void** data_ptr) {
+        if (copy_on_write_) DetachMemory<Context>();
         MixedMemory* mem = memory();
         if (!mem) {
             *data_ptr = nullptr;
         } else {
             if (TypeMeta::Id<Context>() ==
                 TypeMeta::Id<CPUContext>()) {
-                *data_ptr = mem->mutable_cpu_data(nbytes());
+                *data_ptr = (uint8_t*)mem->mutable_cpu_data(
+                    extent()) + offset_;
             } else if (TypeMeta::Id<Context>() ==
                 TypeMeta::Id<CUDAContext>()) {
-                *data_ptr = mem->mutable_cuda_data(nbytes());
+                *data_ptr = (uint8_t*)mem->mutable_cuda_data(
+                    extent()) + offset_;
             } else if (TypeMeta::Id<Context>() ==
                 TypeMeta::Id<CNMLContext>()) {
                 *data_ptr = mem->mutable_cnml_data();
@@ -191,6 +286,30 @@ class Tensor {
         }
     }
 
+    /*! \brief Copy the memory shared by copy-on-write before mutating */
+    template <class Context>
+    void DetachMemory() {
+        copy_on_write_ = false;
+        if (!own_mem_ || !memory_ || memory_.use_count() == 1) return;
+        shared_ptr<MixedMemory> src = memory_;
+        const size_t nbytes = src->nbytes();
+        memory_.reset(new MixedMemory(meta_, nbytes));
+        if (src->state() == MixedMemory::UNINITIALIZED) return;
+        if (TypeMeta::Id<Context>() ==
+            TypeMeta::Id<CUDAContext>()) {
+            CUDAContext::Memcpy<CUDAContext, CUDAContext>(nbytes,
+                memory_->mutable_cuda_data(), src->cuda_data());
+        } else if (meta_.copy()) {
+            auto* dst = memory_->mutable_cpu_data();
+            meta_.ctor()(dst, nbytes / meta_.itemsize());
+            meta_.copy()(src->cpu_data(), dst,
+                nbytes / meta_.itemsize());
+        } else {
+            CPUContext::Memcpy<CPUContext, CPUContext>(nbytes,
+                memory_->mutable_cpu_data(), src->cpu_data());
+        }
+    }
+
     /*! \brief Try to get the raw const data pointer */
     template <class Context>
     const void* const_data_ptr() const {
@@ -198,10 +317,12 @@ class Tensor {
         CHECK(mem) << "\nMemory access before allowcating.";
         if (TypeMeta::Id<Context>() ==
             TypeMeta::Id<CPUContext>()) {
-            return mem->cpu_data(nbytes());
+            return (const uint8_t*)mem->cpu_data(
+                extent()) + offset_;
         } else if (TypeMeta::Id<Context>() ==
             TypeMeta::Id<CUDAContext>()) {
-            return mem->cuda_data(nbytes());
+            return (const uint8_t*)mem->cuda_data(
+                extent()) + offset_;
         } else if (TypeMeta::Id<Context>() ==
             TypeMeta::Id<CNMLContext>()) {
             return mem->cnml_data();
@@ -220,7 +341,7 @@ class Tensor {
         // Return the memory directly
         if (meta_ == meta && data_ptr) return data_ptr;
         // Return the new memory
-        meta_ = meta;
+        meta_ = meta; offset_ = 0;
         CHECK_GT(size_, 0);
         if (own_mem_) {
             memory_.reset(new MixedMemory(
@@ -250,6 +371,9 @@ class Tensor {
     /*! \brief Get the raw const data pointer */
     template <class Context>
     const void* raw_data() const {
+        CHECK(contiguous_)
+            << "\nTensor(" << name_ << ") is a strided view, "
+            << "which should be materialized before accessing.";
         return const_data_ptr<Context>();
     }
 
@@ -301,7 +425,7 @@ class Tensor {
             ex_memory_ = new MixedMemory(
                 TypeMeta::Make<float>(), 4);
         }
-        own_mem_ = false;
+        own_mem_ = false; offset_ = 0;
         capacity_ = ex_memory_->nbytes();
     }
 
@@ -312,7 +436,8 @@ class Tensor {
 
     /*! \brief Reset the memory */
     void Reset() {
-        size_ = capacity_ = 0; meta_ = TypeMeta();
+        size_ = capacity_ = offset_ = 0; meta_ = TypeMeta();
+        contiguous_ = true; copy_on_write_ = false;
         dims_.clear(); strides_.clear(); memory_.reset();
         if (DECREFPyArray) DECREFPyArray();
     }
@@ -330,8 +455,8 @@ class Tensor {
     /*! \brief The type meta of this tensor */
     TypeMeta meta_;
 
-    /*! \brief Store the size and capacity */
-    size_t size_ = 0, capacity_ = 0;
+    /*! \brief Store the size, capacity and byte offset */
+    size_t size_ = 0, capacity_ = 0, offset_ = 0;
 
     /*! \brief Store the version for shared tensor */
     int version_ = -1;
@@ -347,6 +472,12 @@ class Tensor {
 
     /*! \brief External memory indicators */
     bool is_shared_ = false, own_mem_ = true;
+
+    /*! \brief Whether the strides describe a row-major layout */
+    bool contiguous_ = true;
+
+    /*! \brief Whether to copy the shared memory before mutating */
+    bool copy_on_write_ = false;
 };
 
 }  // namespace dragon
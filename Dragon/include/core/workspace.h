@@ -15,6 +15,7 @@
 
 #include "core/common.h"
 #include "core/graph.h"
+#include "core/scratch.h"
 #include "utils/string.h"
 
 namespace dragon {
@@ -43,6 +44,9 @@ class Workspace {
     /*! \brief Move a external workspace into this workspace */
     Workspace* Move(Workspace* ws);
 
+    /*! \brief Share the tensors of a external workspace by copy-on-write */
+    void Share(Workspace* ws);
+
     /*! \brief Destory all the tensors */
     void Clear();
 
@@ -78,15 +82,18 @@ class Workspace {
     /*! \brief Return the specified filler */
     const TensorFillerProto* GetFiller(const string& name) const;
 
-    /*! \brief Create temporal cache segments */
+    /*!
+     * \brief Create temporal cache segments
+     *
+     * The segments are taken from the scratch arena of current thread,
+     * and reused by the later requests within the same scope.
+     */
     template <class Context>
     vector<void*> caches(const vector<size_t>& segments) {
-        int64_t nbytes = 0;
-        for (auto& segment : segments) nbytes += (int64_t)segment;
-        Tensor* cache_t = CreateTensor("/share/cache");
-        cache_t->Reshape({ nbytes });
+        size_t nbytes = 0;
+        for (auto& segment : segments) nbytes += segment;
         vector<void*> Bcaches(segments.size());
-        Bcaches[0] = cache_t->template mutable_data<uint8_t, Context>();
+        Bcaches[0] = ScratchArena::Get<Context>()->AllocShared(nbytes);
         for (int i = 1; i < segments.size(); i++)
             Bcaches[i] = (uint8_t*)Bcaches[i - 1] + segments[i - 1];
         return Bcaches;
@@ -138,6 +145,9 @@ class Workspace {
         const bool                  zero_based = true);
 
  private:
+    /*! \brief Return the external workspaces */
+    vector<Workspace*> remotes() const;
+
     /*! \brief The unique workspace name */
     string name_;
 
@@ -147,6 +157,9 @@ class Workspace {
     /*! \brief Store the created tensors */
     TensorMap tensor_map_;
 
+    /*! \brief Guard the maps accessed by the asynchronous operators */
+    mutable std::mutex tensor_mutex_;
+
     /*! \brief Store the registered tensor fillers */
     TensorFillerMap tensor_filler_map_;
 
@@ -14,6 +14,7 @@
 #define DRAGON_OPERATORS_ARITHMETIC_FULLY_CONNECTED_OP_H_
 
 #include "core/operator.h"
+#include "utils/gemm_pack.h"
 
 namespace dragon {
 
@@ -31,8 +32,15 @@ class FullyConnectedOp final : public Operator<Context> {
     template <typename T> void TransRunWithType();
     template <typename T> void NoTransRunWithType();
 
+    /*! \brief Whether to run with the cached packed weights */
+    template <typename T> bool PackWeights() {
+        return phase() == "TEST" &&
+            math::GemmPackable<T, Context>(ctx());
+    }
+
  protected:
     int64_t axis, transW, M, K, N;
+    GemmPackCache W_cache;
 };
 
 template <class Context>
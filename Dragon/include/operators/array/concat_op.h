@@ -22,13 +22,15 @@ class ConcatOp : public Operator<Context> {
  public:
     ConcatOp(const OperatorDef& def, Workspace* ws)
         : Operator<Context>(def, ws),
-          axis(OperatorBase::Arg<int64_t>("axis", 0)) {}
+          axis(OperatorBase::Arg<int64_t>("axis", 0)),
+          zero_copy(OperatorBase::Arg<bool>("zero_copy", false)) {}
     USE_OPERATOR_FUNCTIONS;
 
     void RunOnDevice() override;
     template <typename T> void RunWithType();
 
  protected:
+    bool zero_copy;
     int64_t axis, outer_dim, inner_dim;
     int64_t x_concat_dim, y_concat_dim;
     int64_t x_offset, y_offset, concat_offset;
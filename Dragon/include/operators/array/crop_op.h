@@ -24,9 +24,11 @@ class CropOp final : public Operator<Context> {
         : Operator<Context>(def, ws),
           start_axis(OperatorBase::Arg<int64_t>("start_axis", -1)),
           offsets(OperatorBase::Args<int64_t>("offsets")),
-          shape_like(OperatorBase::Arg<string>("shape_like", "")) {
+          shape_like(OperatorBase::Arg<string>("shape_like", "")),
+          zero_copy(OperatorBase::Arg<bool>("zero_copy", false)) {
         GET_ARGUMENTS_WITH_DESC(int64_t, starts);
         GET_ARGUMENTS_WITH_DESC(int64_t, sizes);
+        this->allow_strided_inputs_ = zero_copy;
     }
     USE_OPERATOR_FUNCTIONS;
 
@@ -35,6 +37,7 @@ class CropOp final : public Operator<Context> {
     template <typename T> void RunWithType();
 
  protected:
+    bool zero_copy;
     int64_t start_axis;
     string shape_like;
     vector<int64_t> offsets;
@@ -31,6 +31,21 @@ class DimOpBase : public Operator<Context> {
     void MemorySwitch() override {
         /* Disable the Memory Activation */
     }
+
+ protected:
+    /*! \brief Alias the memory of input with the given dimensions */
+    void ShareInput(const vector<int64_t>& dims) {
+        Tensor& X = OperatorBase::Input(0);
+        Tensor* Y = OperatorBase::Output(0);
+        Y->Reshape(dims);
+        if (X.offset() > 0) {
+            // Keep the offset of a contiguous view
+            Y->ShareView(X, X.offset());
+        } else {
+            Y->SetMeta(X.meta());
+            Y->Share(X.memory());
+        }
+    }
 };
 
 template <class Context>
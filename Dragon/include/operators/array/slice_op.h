@@ -23,13 +23,17 @@ class SliceOp final : public Operator<Context> {
      SliceOp(const OperatorDef& def, Workspace* ws)
          : Operator<Context>(def, ws),
            axis(OperatorBase::Arg<int64_t>("axis", 0)),
-           slice_points(OperatorBase::Args<int64_t>("slice_points")) {}
+           slice_points(OperatorBase::Args<int64_t>("slice_points")),
+           zero_copy(OperatorBase::Arg<bool>("zero_copy", false)) {
+        this->allow_strided_inputs_ = zero_copy;
+    }
     USE_OPERATOR_FUNCTIONS;
 
     void RunOnDevice() override;
     template <typename T> void RunWithType();
 
  protected:
+    bool zero_copy;
     int64_t axis, N, steps, slice_offset;
     int64_t outer_dim, inner_dim, x_slice_dim, y_slice_dim;
     vector<int64_t> slice_dims, slice_points;
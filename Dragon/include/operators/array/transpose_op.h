@@ -21,8 +21,10 @@ template <class Context>
 class TransposeOp final: public Operator<Context> {
  public:
     TransposeOp(const OperatorDef& def, Workspace* ws)
-        : Operator<Context>(def, ws) {
+        : Operator<Context>(def, ws),
+          zero_copy(OperatorBase::Arg<bool>("zero_copy", false)) {
         GET_ARGUMENTS_WITH_DESC(int64_t, perm);
+        this->allow_strided_inputs_ = zero_copy;
     }
     USE_OPERATOR_FUNCTIONS;
 
@@ -30,6 +32,7 @@ class TransposeOp final: public Operator<Context> {
     template <typename T> void RunWithType();
 
  protected:
+    bool zero_copy;
     Tensor x_strides, y_dims;
     DECLARE_ARGUMENTS_WITH_DESC(int64_t, perm);
 };
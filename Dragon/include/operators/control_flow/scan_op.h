@@ -36,14 +36,19 @@ class ScanOp final: public Operator<Context> {
 
     void RunOnDevice() override;
     void InitTemplate();
+    void InitStepTemplate();
+    void DetermineSteps();
     void UnrollTemplate();
     void UpdateTerms(int cur_step);
+    void RunSteps();
 
  protected:
-    GraphDef func_def, template_def, new_def;
+    GraphDef func_def, template_def, step_def, new_def;
     Map<int, unique_ptr<Graph>> graphs;
+    Map<int, string> unrolled_defs;
+    unique_ptr<Graph> step_graph;
     Graph* cur_graph;
-    Map<string, string> terms;
+    Map<string, string> terms, template_terms;
     vector<string> default_outputs;
     int64_t axis, nseqs, nsteps, nrepeats, nout;
     string step_type, step_tensor;
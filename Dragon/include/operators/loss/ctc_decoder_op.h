@@ -0,0 +1,62 @@
+/*!
+ * Copyright (c) 2017-present, SeetaTech, Co.,Ltd.
+ *
+ * Licensed under the BSD 2-Clause License.
+ * You should have received a copy of the BSD 2-Clause License
+ * along with the software. If not, See,
+ *
+ *      <https://opensource.org/licenses/BSD-2-Clause>
+ *
+ * ------------------------------------------------------------
+ */
+
+#ifndef DRAGON_OPERATORS_LOSS_CTC_DECODER_OP_H_
+#define DRAGON_OPERATORS_LOSS_CTC_DECODER_OP_H_
+
+#include "core/operator.h"
+
+namespace dragon {
+
+template <class Context>
+class CTCGreedyDecoderOp final : public Operator<Context> {
+ public:
+    CTCGreedyDecoderOp(const OperatorDef& def, Workspace* ws)
+        : Operator<Context>(def, ws),
+          blank_first(OperatorBase::Arg<bool>("blank_first", true)),
+          merge_repeated(OperatorBase::Arg<bool>("merge_repeated", true)),
+          padding_mask(OperatorBase::Arg<int64_t>("padding_mask", -1)) {}
+    USE_OPERATOR_FUNCTIONS;
+
+    void RunOnDevice() override;
+    template <typename T> void RunWithType();
+
+ protected:
+    bool blank_first, merge_repeated;
+    int64_t padding_mask, blank;
+    int64_t max_seq_len, batch_size, num_classes;
+};
+
+template <class Context>
+class CTCBeamSearchDecoderOp final : public Operator<Context> {
+ public:
+    CTCBeamSearchDecoderOp(const OperatorDef& def, Workspace* ws)
+        : Operator<Context>(def, ws),
+          blank_first(OperatorBase::Arg<bool>("blank_first", true)),
+          beam_width(OperatorBase::Arg<int64_t>("beam_width", 10)),
+          padding_mask(OperatorBase::Arg<int64_t>("padding_mask", -1)) {
+        CHECK_GT(beam_width, 0);
+    }
+    USE_OPERATOR_FUNCTIONS;
+
+    void RunOnDevice() override;
+    template <typename T> void RunWithType();
+
+ protected:
+    bool blank_first;
+    int64_t beam_width, padding_mask, blank;
+    int64_t max_seq_len, batch_size, num_classes;
+};
+
+}  // namespace dragon
+
+#endif  // DRAGON_OPERATORS_LOSS_CTC_DECODER_OP_H_
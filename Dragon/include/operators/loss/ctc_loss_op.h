@@ -20,13 +20,19 @@ namespace dragon {
 template <class Context>
 class CTCLossOp final : public Operator<Context> {
  public:
-     CTCLossOp(const OperatorDef& def, Workspace* ws)
-        : Operator<Context>(def, ws) {
-        LOG(FATAL) << "CTCLoss requires CuDNN support.";
-     }
-     USE_OPERATOR_FUNCTIONS;
+    CTCLossOp(const OperatorDef& def, Workspace* ws)
+        : Operator<Context>(def, ws),
+          blank_first(OperatorBase::Arg<bool>("blank_first", true)),
+          padding_mask(OperatorBase::Arg<int64_t>("padding_mask", -1)) {}
+    USE_OPERATOR_FUNCTIONS;
 
-     void RunOnDevice() override {}
+    void RunOnDevice() override;
+    template <typename Ty> void RunWithType();
+
+ protected:
+    bool blank_first;
+    int64_t padding_mask;
+    vector<int> packed_labels, label_lengths;
 };
 
 template <class Context>
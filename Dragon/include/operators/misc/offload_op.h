@@ -0,0 +1,76 @@
+/*!
+ * Copyright (c) 2017-present, SeetaTech, Co.,Ltd.
+ *
+ * Licensed under the BSD 2-Clause License.
+ * You should have received a copy of the BSD 2-Clause License
+ * along with the software. If not, See,
+ *
+ *      <https://opensource.org/licenses/BSD-2-Clause>
+ *
+ * ------------------------------------------------------------
+ */
+
+#ifndef DRAGON_OPERATORS_MISC_OFFLOAD_OP_H_
+#define DRAGON_OPERATORS_MISC_OFFLOAD_OP_H_
+
+#include "core/operator.h"
+#include "core/spill.h"
+
+namespace dragon {
+
+/*!
+ * Copy the input into the spill area, then free it.
+ *
+ * The memory is held by the copy until it is finished,
+ * which runs after the kernels queued on the stream.
+ * If ``spill`` is false, the input is freed without copying.
+ * The input sharing its memory with other tensors is kept.
+ */
+template <class Context>
+class OffloadOp final : public Operator<Context> {
+ public:
+    OffloadOp(const OperatorDef& def, Workspace* ws)
+        : Operator<Context>(def, ws),
+          spill(OperatorBase::Arg<bool>("spill", true)) {
+        this->allow_strided_inputs_ = true;
+        this->is_async_ = spill &&
+            OperatorBase::Arg<bool>("allow_async", false);
+    }
+    USE_OPERATOR_FUNCTIONS;
+
+    ~OffloadOp() { Wait(); }
+
+    void RunOnDevice() override;
+
+    /*! \brief Wait for the pending copy */
+    void Wait() override;
+
+ protected:
+    bool spill;
+    std::future<void> pending;
+};
+
+/*! Copy the output back from the spill area */
+template <class Context>
+class PrefetchOp final : public Operator<Context> {
+ public:
+    PrefetchOp(const OperatorDef& def, Workspace* ws)
+        : Operator<Context>(def, ws) {
+        this->is_async_ = OperatorBase::Arg<bool>("allow_async", false);
+    }
+    USE_OPERATOR_FUNCTIONS;
+
+    ~PrefetchOp() { Wait(); }
+
+    void RunOnDevice() override;
+
+    /*! \brief Wait for the pending copy */
+    void Wait() override;
+
+ protected:
+    std::future<void> pending;
+};
+
+}  // namespace dragon
+
+#endif  // DRAGON_OPERATORS_MISC_OFFLOAD_OP_H_
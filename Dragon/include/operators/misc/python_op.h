@@ -17,22 +17,86 @@
 
 #include <Python.h>
 
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <thread>
+
 #include "core/operator.h"
 
 namespace dragon {
 
+/*! The time spent by a python operator in seconds */
+struct PythonOpStats {
+    int64_t num_runs = 0;
+    double gil_wait = 0, run = 0, blocked = 0;
+};
+
+/*!
+ * The dedicated thread running the python operators.
+ *
+ * The python operators of a static graph are handed off to
+ * this thread, so that the executor is not stalled by the GIL,
+ * and could run the independent operators concurrently.
+ * The thread is joined by ``Shutdown()`` at the module exit.
+ */
+class PythonWorker {
+ public:
+    /*! \brief Return the global worker */
+    static PythonWorker* Get();
+
+    /*! \brief Stop the global worker after the queued jobs */
+    static void Shutdown();
+
+    /*! \brief Queue a job and return the future of it */
+    std::future<void> Submit(std::function<void()> job);
+
+    /*! \brief Add the time of an operator */
+    void Record(
+        const string&           name,
+        double                  gil_wait,
+        double                  run,
+        double                  blocked);
+
+    /*! \brief Return the time of all operators */
+    Map<string, PythonOpStats> Stats();
+
+ protected:
+    PythonWorker();
+    void ThreadRun();
+
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::deque<std::packaged_task<void()> > jobs_;
+    Map<string, PythonOpStats> stats_;
+    bool stopped_;
+    std::thread thread_;
+};
+
 template <class Context>
 class RunOp : public Operator<Context> {
  public:
     RunOp(const OperatorDef& def, Workspace* ws);
     USE_OPERATOR_FUNCTIONS;
 
+    ~RunOp() { Wait(); }
+
     void RunOnDevice() override;
 
+    /*! \brief Wait for the pending run in the worker */
+    void Wait() override;
+
  protected:
     string CallMethodHelper(const string& method);
+    void Launch(const string& method, const string& fallback);
+    void Call(
+        const string&           phase,
+        const string&           method,
+        const string&           fallback);
     PyObject* self, *inputs, *outputs;
     string module, op, param_str;
+    std::future<void> pending;
 };
 
 template <class Context>
@@ -0,0 +1,76 @@
+/*!
+ * Copyright (c) 2017-present, SeetaTech, Co.,Ltd.
+ *
+ * Licensed under the BSD 2-Clause License.
+ * You should have received a copy of the BSD 2-Clause License
+ * along with the software. If not, See,
+ *
+ *      <https://opensource.org/licenses/BSD-2-Clause>
+ *
+ * ------------------------------------------------------------
+ */
+
+#ifndef DRAGON_OPERATORS_MPI_MPI_SEND_RECV_OP_H_
+#define DRAGON_OPERATORS_MPI_MPI_SEND_RECV_OP_H_
+
+#ifdef WITH_MPI
+
+#include "operators/mpi/base_mpi_op.h"
+
+namespace dragon {
+
+/*!
+ * Send the inputs to the peer without blocking.
+ *
+ * The sent memory is held until the next run waits for
+ * the requests, so that the producers could write the
+ * inputs again after resetting them.
+ */
+template <class Context>
+class MPISendOp final : public ModelMPIBase<Context> {
+ public:
+    MPISendOp(const OperatorDef& def, Workspace* ws)
+        : ModelMPIBase<Context>(def, ws),
+          peer((int)OperatorBase::Arg<int64_t>("peer", 0)),
+          tags(OperatorBase::Args<int64_t>("tags")) {}
+    USE_OPERATOR_FUNCTIONS;
+    USE_MODEL_MPI_FUNCTIONS;
+
+    ~MPISendOp() { Wait(); }
+
+    void RunOnDevice() override;
+
+    /*! \brief Wait for the pending requests */
+    void Wait();
+
+ protected:
+    int peer;
+    vector<int64_t> tags;
+    vector<MPI_Request> requests;
+    vector<vector<int64_t> > headers;
+    vector<unique_ptr<Tensor> > buffers;
+};
+
+/*! Receive the outputs from the peer */
+template <class Context>
+class MPIRecvOp final : public ModelMPIBase<Context> {
+ public:
+    MPIRecvOp(const OperatorDef& def, Workspace* ws)
+        : ModelMPIBase<Context>(def, ws),
+          peer((int)OperatorBase::Arg<int64_t>("peer", 0)),
+          tags(OperatorBase::Args<int64_t>("tags")) {}
+    USE_OPERATOR_FUNCTIONS;
+    USE_MODEL_MPI_FUNCTIONS;
+
+    void RunOnDevice() override;
+
+ protected:
+    int peer;
+    vector<int64_t> tags;
+};
+
+}  // namespace dragon
+
+#endif  // WITH_MPI
+
+#endif  // DRAGON_OPERATORS_MPI_MPI_SEND_RECV_OP_H_
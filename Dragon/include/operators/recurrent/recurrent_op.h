@@ -10,35 +10,103 @@
  * ------------------------------------------------------------
  */
 
-#ifndef DRAGON_OPERATORS_RECURRENT_CUDNN_RECURRENT_OP_H_
-#define DRAGON_OPERATORS_RECURRENT_CUDNN_RECURRENT_OP_H_
+#ifndef DRAGON_OPERATORS_RECURRENT_RECURRENT_OP_H_
+#define DRAGON_OPERATORS_RECURRENT_RECURRENT_OP_H_
 
 #include "core/operator.h"
 
 namespace dragon {
 
 template <class Context>
-class RecurrentOp : public Operator<Context> {
+class RecurrentOpBase : public Operator<Context> {
  public:
-    RecurrentOp(const OperatorDef& def, Workspace* ws)
-        : Operator<Context>(def, ws) {
-        LOG(FATAL) << "RNN Operators require CuDNN support.";
+    RecurrentOpBase(const OperatorDef& def, Workspace* ws)
+        : Operator<Context>(def, ws),
+          hidden_size(OperatorBase::Arg<int64_t>("hidden_size", 0)),
+          num_layers(OperatorBase::Arg<int64_t>("num_layers", 1)),
+          bidirectional(OperatorBase::Arg<bool>("bidirectional", false)),
+          dropout_ratio(OperatorBase::Arg<float>("dropout_ratio", 1.f)),
+          rnn_mode(OperatorBase::Arg<string>("rnn_mode", "")) {
+        num_directions = bidirectional ? 2 : 1;
+        //  determine the number of gates
+        if (rnn_mode == "rnn_tanh" || rnn_mode == "rnn_relu") num_gates = 1;
+        else if (rnn_mode == "lstm") num_gates = 4;
+        else if (rnn_mode == "gru") num_gates = 3;
+        else LOG(FATAL) << "Unsupported rnn mode: " << rnn_mode;
+        const string input_mode = OperatorBase::Arg<string>(
+            "rnn_input_mode", "linear");
+        CHECK_EQ(input_mode, "linear")
+            << "\nUnsupported rnn input mode: " << input_mode;
+        //  override the running phase
+        SwitchToPhase(OperatorBase::Arg<string>("phase", ""));
     }
     USE_OPERATOR_FUNCTIONS;
 
-    void RunOnDevice() override {}
+    /*! \brief Compute the packed weights offsets and reserve layout */
+    void ResetDims();
+
+    /*! \brief Return whether the dropout between layers is enabled */
+    bool use_dropout() const {
+        return phase() == "TRAIN" && num_layers > 1 &&
+            dropout_ratio > 0.f && dropout_ratio < 1.f;
+    }
+
+ public:
+    int64_t hidden_size, num_layers, num_directions, num_gates;
+    int64_t seq_length, batch_size, input_dim, reserve_count;
+    bool bidirectional;
+    float dropout_ratio;
+    string rnn_mode;
+    vector<int64_t> input_dims, output_dims, hidden_dims;
+    vector<int64_t> w_offsets, b_offsets;
+    vector<int64_t> h_offsets, act_offsets, c_offsets, hn_offsets;
+    vector<int64_t> y_offsets, x_offsets;
 };
 
+#define USE_RECURRENT_FUNCTIONS \
+    USE_OPERATOR_FUNCTIONS; \
+    using RecurrentOpBase<Context>::hidden_size; \
+    using RecurrentOpBase<Context>::num_layers; \
+    using RecurrentOpBase<Context>::num_directions; \
+    using RecurrentOpBase<Context>::num_gates; \
+    using RecurrentOpBase<Context>::seq_length; \
+    using RecurrentOpBase<Context>::batch_size; \
+    using RecurrentOpBase<Context>::input_dim; \
+    using RecurrentOpBase<Context>::reserve_count; \
+    using RecurrentOpBase<Context>::dropout_ratio; \
+    using RecurrentOpBase<Context>::rnn_mode; \
+    using RecurrentOpBase<Context>::input_dims; \
+    using RecurrentOpBase<Context>::output_dims; \
+    using RecurrentOpBase<Context>::hidden_dims; \
+    using RecurrentOpBase<Context>::w_offsets; \
+    using RecurrentOpBase<Context>::b_offsets; \
+    using RecurrentOpBase<Context>::h_offsets; \
+    using RecurrentOpBase<Context>::act_offsets; \
+    using RecurrentOpBase<Context>::c_offsets; \
+    using RecurrentOpBase<Context>::hn_offsets; \
+    using RecurrentOpBase<Context>::y_offsets; \
+    using RecurrentOpBase<Context>::x_offsets
+
 template <class Context>
-class RecurrentGradientOp : public Operator<Context> {
-public:
+class RecurrentOp final : public RecurrentOpBase<Context> {
+ public:
+    RecurrentOp(const OperatorDef& def, Workspace* ws)
+        : RecurrentOpBase<Context>(def, ws) {}
+    USE_RECURRENT_FUNCTIONS;
+
+    void RunOnDevice() override;
+    template <typename T> void RunWithType();
+};
+
+template <class Context>
+class RecurrentGradientOp final : public RecurrentOpBase<Context> {
+ public:
     RecurrentGradientOp(const OperatorDef& def, Workspace* ws)
-        : Operator<Context>(def, ws) {
-        LOG(FATAL) << "RNN Operators require CuDNN support.";
-    }
-    USE_OPERATOR_FUNCTIONS;
+        : RecurrentOpBase<Context>(def, ws) {}
+    USE_RECURRENT_FUNCTIONS;
 
-    void RunOnDevice() override {}
+    void RunOnDevice() override;
+    template <typename T> void RunWithType();
 };
 
 }  // namespace dragon
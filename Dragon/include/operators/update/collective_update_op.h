@@ -14,19 +14,23 @@
 #define DRAGON_OPERATORS_UPDATE_COLLECTIVE_UPDATE_OP_H_
 
 #include "core/operator.h"
+#include "utils/shm_comm.h"
 
 namespace dragon {
 
-#ifdef WITH_MPI
-
 template <class Context>
 class CollectiveUpdateOp final : public Operator<Context> {
  public:
     CollectiveUpdateOp(const OperatorDef& def, Workspace* ws)
         : Operator<Context>(def, ws),
-          mode(OperatorBase::Arg<string>("mode", "UNKNOWN")) {
-         InitMPI();
-         if (mode.find("NCCL") != string::npos) InitNCCL();
+          mode(OperatorBase::Arg<string>("mode", "UNKNOWN")),
+          shard_ranks(OperatorBase::Args<int64_t>("shard_ranks")) {
+         if (mode.find("SHM") != string::npos) {
+             InitSHM();
+         } else {
+             InitMPI();
+             if (mode.find("NCCL") != string::npos) InitNCCL();
+         }
     }
     USE_OPERATOR_FUNCTIONS;
 
@@ -42,16 +46,29 @@ class CollectiveUpdateOp final : public Operator<Context> {
 
     void InitMPI();
     void InitNCCL();
+    void InitSHM();
 
     void RunOnDevice() override;
 
+    template <typename T> void SHMAllReduce(Tensor* tensor);
+    template <typename T> void SHMReduce(Tensor* tensor, int root);
+    template <typename T> void SHMBcast(Tensor* tensor, int root);
+
+#ifdef WITH_MPI
     template <typename T> void MPIAllReduce(
         Tensor*                 tensor,
         MPI_Datatype            dtype);
 
+    template <typename T> void MPIReduce(
+        Tensor*                 tensor,
+        MPI_Datatype            dtype,
+        int                     root);
+
     template <typename T> void MPIBcast(
         Tensor*                 tensor,
-        MPI_Datatype            dtype);
+        MPI_Datatype            dtype,
+        int                     root);
+#endif
 
 #ifdef WITH_NCCL
     template <typename T> void NCCLAllReduce(
@@ -59,27 +76,37 @@ class CollectiveUpdateOp final : public Operator<Context> {
         ncclDataType_t          dtype,
         cudaStream_t&           stream);
 
+    template <typename T> void NCCLReduce(
+        Tensor*                 tensor,
+        ncclDataType_t          dtype,
+        cudaStream_t&           stream,
+        int                     root);
+
     template <typename T> void NCCLBcast(
         Tensor*                 tensor,
         ncclDataType_t          dtype,
-        cudaStream_t&           stream);
+        cudaStream_t&           stream,
+        int                     root);
 #endif
 
  protected:
     int comm_size, comm_rank, comm_root;
     int world_size, world_rank;
     string mode;
+    vector<int64_t> shard_ranks;
 
+    SharedMemoryComm* shm_comm = nullptr;
+
+#ifdef WITH_MPI
     MPI_Comm comm;
     MPI_Group group;
+#endif
 
 #ifdef WITH_NCCL
     ncclComm_t nccl_comm;
 #endif
 };
 
-#endif  // WITH_MPI
-
 }  // namespace dragon
 
 #endif  // DRAGON_OPERATORS_UPDATE_COLLECTIVE_UPDATE_OP_H_
\ No newline at end of file
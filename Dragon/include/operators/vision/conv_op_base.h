@@ -14,6 +14,7 @@
 #define DRAGON_OPERATORS_VISION_CONV_OP_BASE_H_
 
 #include "core/operator.h"
+#include "utils/gemm_pack.h"
 #include "utils/math_functions.h"
 #include "utils/op_kernel.h"
 
@@ -50,6 +51,7 @@ class ConvOpBase : public Operator<Context> {
     int64_t conv_out_spatial_dim, kernel_dim, col_dim;
     int64_t col_offset, output_offset, weight_offset, x_offset, y_offset;
     bool is_1x1;
+    GemmPackCache W_cache;
     DECLARE_ARGUMENTS_WITH_DESC(int64_t, output_padding);  // Adjs
     DECLARE_ARGUMENTS_WITH_DESC(int64_t, output_shape_spec);
 
@@ -61,7 +63,10 @@ class ConvOpBase : public Operator<Context> {
     virtual bool HasBias() { NOT_IMPLEMENTED; return true; }
 
     template <typename T> void Wx(const T* x,
-        const T* weights, T* y, bool skip_im2col = false);
+        const T* weights, T* y, bool skip_im2col = false,
+        const T* packed_weights = nullptr);
+
+    template <typename T> const T* PackWeights(const Tensor& W);
 
     template <typename T> void Pb(const T* bias, T* y);
 
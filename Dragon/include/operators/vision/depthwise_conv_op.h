@@ -21,11 +21,12 @@ template <class Context>
 class DepthwiseConv2dOp : public ConvOpBase<Context> {
  public:
     DepthwiseConv2dOp(const OperatorDef& def, Workspace* ws)
-        : ConvOpBase<Context>(def, ws) {
+        : ConvOpBase<Context>(def, ws),
+          activation(OperatorBase::Arg<string>("activation", "")) {
         this->num_spatial_axes = 2;
         Setup();
-        CHECK_EQ(stride[0], stride[1])
-            << "Excepted stride_h == stride_w";
+        CHECK(activation.empty() || activation == "Relu6")
+            << "\nUnsupported fused activation: " << activation;
     }
     USE_OPERATOR_FUNCTIONS;
     USE_CONVOLUTION_FUNCTIONS;
@@ -37,6 +38,7 @@ class DepthwiseConv2dOp : public ConvOpBase<Context> {
     template <typename T> void RunWithType();
 
  protected:
+    string activation;
 };
 
 template <class Context>
@@ -54,6 +56,9 @@ class DepthwiseConv2dGradientOp
 
     void RunOnDevice() override;
     template <typename T> void RunWithType();
+
+ protected:
+    using DepthwiseConv2dOp<Context>::activation;
 };
 
 #ifdef WITH_CUDNN
@@ -65,23 +70,15 @@ class CuDNNDepthwiseConv2dOp final
      CuDNNDepthwiseConv2dOp(
          const OperatorDef&         def,
          Workspace*                 ws)
-        : DepthwiseConv2dOp<Context>(def, ws) {
-        CUDNN_CHECK(cudnnCreateTensorDescriptor(&bias_desc));
-        CUDNN_CHECK(cudnnCreateTensorDescriptor(&output_desc));
-    }
+        : DepthwiseConv2dOp<Context>(def, ws) {}
     USE_OPERATOR_FUNCTIONS;
     USE_CONVOLUTION_FUNCTIONS;
 
-    ~CuDNNDepthwiseConv2dOp() {
-        CUDNN_CHECK(cudnnDestroyTensorDescriptor(bias_desc));
-        CUDNN_CHECK(cudnnDestroyTensorDescriptor(output_desc));
-    }
-
     void RunOnDevice() override;
     template <typename T> void RunWithType();
 
  protected:
-    cudnnTensorDescriptor_t bias_desc, output_desc;
+    using DepthwiseConv2dOp<Context>::activation;
 };
 
 template <class Context>
@@ -107,6 +104,7 @@ class CuDNNDepthwiseConv2dGradientOp final
     template <typename T> void RunWithType();
 
  protected:
+    using DepthwiseConv2dOp<Context>::activation;
     cudnnTensorDescriptor_t bias_desc, input_desc;
 };
 
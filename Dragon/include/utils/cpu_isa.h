@@ -0,0 +1,179 @@
+/*!
+ * Copyright (c) 2017-present, SeetaTech, Co.,Ltd.
+ *
+ * Licensed under the BSD 2-Clause License.
+ * You should have received a copy of the BSD 2-Clause License
+ * along with the software. If not, See,
+ *
+ *      <https://opensource.org/licenses/BSD-2-Clause>
+ *
+ * ------------------------------------------------------------
+ */
+
+#ifndef DRAGON_UTILS_CPU_ISA_H_
+#define DRAGON_UTILS_CPU_ISA_H_
+
+#include <string>
+
+#include "utils/omp_alternative.h"
+
+namespace dragon {
+
+/*!
+ * \brief The instruction sets that the hot CPU kernels are compiled for.
+ *
+ * ``DEFAULT`` is the baseline of the compiler flags (SSE2 for x86-64),
+ * the others are selected at runtime if the processor supports them.
+ */
+enum class CPUISA { DEFAULT = 0, SSE42 = 1, AVX2 = 2, AVX512 = 3 };
+
+/*! \brief Return the best ISA supported by the processor */
+CPUISA GetSupportedCPUISA();
+
+/*!
+ * \brief Return the ISA used by the dispatched kernels.
+ *
+ * It is detected once, and could be lowered by setting
+ * the environment variable ``DRAGON_CPU_ISA`` to one of
+ * ``default``, ``sse4.2``, ``avx2`` and ``avx512``.
+ */
+CPUISA GetCPUISA();
+
+/*! \brief Return the name of a ISA */
+std::string CPUISAToString(CPUISA isa);
+
+/*! \brief Select the variant of a kernel for the current ISA */
+template <typename Func>
+inline Func SelectCPUISA(Func fn, Func sse42, Func avx2, Func avx512) {
+    switch (GetCPUISA()) {
+        case CPUISA::AVX512: return avx512;
+        case CPUISA::AVX2: return avx2;
+        case CPUISA::SSE42: return sse42;
+        default: return fn;
+    }
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define WITH_CPU_ISA_DISPATCH
+#define CPU_ISA_INLINE inline __attribute__((always_inline))
+#define CPU_ISA_TARGET_SSE42 __attribute__((target("sse4.2,popcnt")))
+#define CPU_ISA_TARGET_AVX2 __attribute__((target("avx2,fma,f16c")))
+#define CPU_ISA_TARGET_AVX512 __attribute__(( \
+    target("avx512f,avx512dq,avx512bw,avx512vl,avx2,fma,f16c")))
+#else
+#define CPU_ISA_INLINE inline
+#endif
+
+#define CPU_ISA_TARGET_DEFAULT
+#define _CPU_ISA_UNPACK(...) __VA_ARGS__
+
+#define _CPU_ISA_PRAGMA_SERIAL _Pragma("omp simd")
+#ifdef WITH_OMP
+#define _CPU_ISA_PRAGMA_PARALLEL \
+    _Pragma("omp parallel for simd num_threads(GET_OMP_THREADS(n))")
+#else
+#define _CPU_ISA_PRAGMA_PARALLEL _Pragma("omp simd")
+#endif
+
+#ifdef WITH_OMP
+#define _CPU_ISA_PRAGMA_THREADED \
+    _Pragma("omp parallel for num_threads(GET_OMP_THREADS(work))")
+#else
+#define _CPU_ISA_PRAGMA_THREADED
+#endif
+
+/*!
+ * The dispatched kernels are written as a always-inline element
+ * function, e.g. ``_AxpyElem(i, alpha, x, y)``, and expanded into
+ * a loop over ``[0, n)`` for each target:
+ *
+ *     DEFINE_CPU_ISA_LOOP(_AxpyElem,
+ *         (const float alpha, const float* x, float* y),
+ *         (alpha, x, y));
+ *     DISPATCH_CPU_ISA(_AxpyElem, n, alpha, x, y);
+ *
+ * The loop is generated inside the target function, as the OpenMP
+ * outlined regions inherit the instruction set of their parents.
+ */
+
+#define _DEFINE_CPU_ISA_LOOP(elem, suffix, kind, params, args) \
+    CPU_ISA_TARGET_##suffix void elem##_##suffix( \
+        const int n, _CPU_ISA_UNPACK params) { \
+        _CPU_ISA_PRAGMA_##kind \
+        for (int i = 0; i < n; ++i) elem(i, _CPU_ISA_UNPACK args); \
+    }
+
+#define _DEFINE_CPU_ISA_REDUCE(T, elem, suffix, params, args) \
+    CPU_ISA_TARGET_##suffix T elem##_##suffix( \
+        const int n, _CPU_ISA_UNPACK params) { \
+        T val = T(0); \
+        _Pragma("omp simd reduction(+:val)") \
+        for (int i = 0; i < n; ++i) val += elem(i, _CPU_ISA_UNPACK args); \
+        return val; \
+    }
+
+/*!
+ * The threaded loops run a coarse element, e.g. a image plane,
+ * which vectorizes its inner loops itself. ``work`` is the
+ * total number of elements to estimate the threads.
+ */
+
+#define _DEFINE_CPU_ISA_THREADED_LOOP(elem, suffix, params, args) \
+    CPU_ISA_TARGET_##suffix void elem##_##suffix( \
+        const int n, const int work, _CPU_ISA_UNPACK params) { \
+        _CPU_ISA_PRAGMA_THREADED \
+        for (int i = 0; i < n; ++i) elem(i, _CPU_ISA_UNPACK args); \
+    }
+
+#ifdef WITH_CPU_ISA_DISPATCH
+
+#define _DEFINE_CPU_ISA_VARIANTS(DEFINE, ...) \
+    DEFINE(__VA_ARGS__, DEFAULT) \
+    DEFINE(__VA_ARGS__, SSE42) \
+    DEFINE(__VA_ARGS__, AVX2) \
+    DEFINE(__VA_ARGS__, AVX512)
+
+#define DISPATCH_CPU_ISA(elem, ...) \
+    SelectCPUISA(elem##_DEFAULT, elem##_SSE42, \
+        elem##_AVX2, elem##_AVX512)(__VA_ARGS__)
+
+#else
+
+#define _DEFINE_CPU_ISA_VARIANTS(DEFINE, ...) \
+    DEFINE(__VA_ARGS__, DEFAULT)
+
+#define DISPATCH_CPU_ISA(elem, ...) elem##_DEFAULT(__VA_ARGS__)
+
+#endif  // WITH_CPU_ISA_DISPATCH
+
+#define _CPU_ISA_SERIAL_LOOP(elem, params, args, suffix) \
+    _DEFINE_CPU_ISA_LOOP(elem, suffix, SERIAL, params, args)
+
+#define _CPU_ISA_PARALLEL_LOOP(elem, params, args, suffix) \
+    _DEFINE_CPU_ISA_LOOP(elem, suffix, PARALLEL, params, args)
+
+#define _CPU_ISA_REDUCE(T, elem, params, args, suffix) \
+    _DEFINE_CPU_ISA_REDUCE(T, elem, suffix, params, args)
+
+#define _CPU_ISA_THREADED_LOOP(elem, params, args, suffix) \
+    _DEFINE_CPU_ISA_THREADED_LOOP(elem, suffix, params, args)
+
+/*! \brief Define the variants of a vectorized loop */
+#define DEFINE_CPU_ISA_LOOP(elem, params, args) \
+    _DEFINE_CPU_ISA_VARIANTS(_CPU_ISA_SERIAL_LOOP, elem, params, args)
+
+/*! \brief Define the variants of a vectorized and threaded loop */
+#define DEFINE_CPU_ISA_PARALLEL_LOOP(elem, params, args) \
+    _DEFINE_CPU_ISA_VARIANTS(_CPU_ISA_PARALLEL_LOOP, elem, params, args)
+
+/*! \brief Define the variants of a vectorized sum over the elements */
+#define DEFINE_CPU_ISA_REDUCE(T, elem, params, args) \
+    _DEFINE_CPU_ISA_VARIANTS(_CPU_ISA_REDUCE, T, elem, params, args)
+
+/*! \brief Define the variants of a threaded loop over coarse elements */
+#define DEFINE_CPU_ISA_THREADED_LOOP(elem, params, args) \
+    _DEFINE_CPU_ISA_VARIANTS(_CPU_ISA_THREADED_LOOP, elem, params, args)
+
+}  // namespace dragon
+
+#endif  // DRAGON_UTILS_CPU_ISA_H_
@@ -0,0 +1,107 @@
+/*!
+ * Copyright (c) 2017-present, SeetaTech, Co.,Ltd.
+ *
+ * Licensed under the BSD 2-Clause License.
+ * You should have received a copy of the BSD 2-Clause License
+ * along with the software. If not, See,
+ *
+ *      <https://opensource.org/licenses/BSD-2-Clause>
+ *
+ * ------------------------------------------------------------
+ */
+
+#ifndef DRAGON_UTILS_DLPACK_H_
+#define DRAGON_UTILS_DLPACK_H_
+
+#include "core/tensor.h"
+
+/*!
+ * The ABI of DLPack (https://github.com/dmlc/dlpack).
+ *
+ * Skipped if the official header has been included,
+ * as the layouts are identical.
+ */
+
+#ifndef DLPACK_DLPACK_H_
+#define DLPACK_DLPACK_H_
+
+#define DLPACK_VERSION 60
+
+#include <stdint.h>
+#include <stddef.h>
+
+extern "C" {
+
+typedef enum {
+    kDLCPU = 1,
+    kDLCUDA = 2,
+    kDLCUDAHost = 3,
+} DLDeviceType;
+
+typedef struct {
+    DLDeviceType device_type;
+    int device_id;
+} DLDevice;
+
+typedef enum {
+    kDLInt = 0U,
+    kDLUInt = 1U,
+    kDLFloat = 2U,
+    kDLBfloat = 4U,
+    kDLComplex = 5U,
+    kDLBool = 6U,
+} DLDataTypeCode;
+
+typedef struct {
+    uint8_t code;
+    uint8_t bits;
+    uint16_t lanes;
+} DLDataType;
+
+typedef struct {
+    void* data;
+    DLDevice device;
+    int ndim;
+    DLDataType dtype;
+    int64_t* shape;
+    int64_t* strides;
+    uint64_t byte_offset;
+} DLTensor;
+
+typedef struct DLManagedTensor {
+    DLTensor dl_tensor;
+    void* manager_ctx;
+    void (*deleter)(struct DLManagedTensor* self);
+} DLManagedTensor;
+
+}  // extern "C"
+
+#endif  // DLPACK_DLPACK_H_
+
+namespace dragon {
+
+/*! \brief Convert the type meta to dlpack, false if not supported */
+bool TypeMetaToDLPack(const TypeMeta& meta, DLDataType* dtype);
+
+/*! \brief Convert the dlpack type to meta, unknown if not supported */
+const TypeMeta& TypeDLPackToMeta(const DLDataType& dtype);
+
+/*!
+ * Export the tensor as a managed dlpack tensor.
+ *
+ * The memory is shared on its current device,
+ * and kept alive until the consumer calls the deleter.
+ */
+DLManagedTensor* TensorToDLPack(Tensor* tensor);
+
+/*!
+ * Import the managed dlpack tensor into a tensor.
+ *
+ * The memory is borrowed with the strides,
+ * and the deleter is called when it is released.
+ */
+void TensorFromDLPack(DLManagedTensor* managed, Tensor* tensor);
+
+}  // namespace dragon
+
+#endif  // DRAGON_UTILS_DLPACK_H_
@@ -0,0 +1,92 @@
+/*!
+ * Copyright (c) 2017-present, SeetaTech, Co.,Ltd.
+ *
+ * Licensed under the BSD 2-Clause License.
+ * You should have received a copy of the BSD 2-Clause License
+ * along with the software. If not, See,
+ *
+ *      <https://opensource.org/licenses/BSD-2-Clause>
+ *
+ * ------------------------------------------------------------
+ */
+
+#ifndef DRAGON_UTILS_GEMM_PACK_H_
+#define DRAGON_UTILS_GEMM_PACK_H_
+
+#include "core/tensor.h"
+#include "utils/math_functions.h"
+
+namespace dragon {
+
+#ifdef WITH_MKL
+
+/*!
+ * \brief Cache the packed constant operand of a Gemm.
+ *
+ * The operand is repacked only if its contents are mutated,
+ * i.e. fed, restored or updated, or its own dimensions are changed.
+ * The other dimension of problem, e.g. the spatial size of a conv,
+ * never affects the packed layout and is not a part of the key.
+ */
+class GemmPackCache {
+ public:
+    /*! \brief Return the packed operand, pack it if necessary */
+    template <typename T, class Context>
+    const T* Get(
+        const Tensor&               X,
+        const CBLAS_IDENTIFIER      which,
+        const CBLAS_TRANSPOSE       Trans,
+        const int                   M,
+        const int                   N,
+        const int                   K,
+        Tensor*                     packed,
+        Context*                    ctx) {
+        vector<int64_t> key({ X.epoch(), packed->epoch(),
+            (int64_t)which, (int64_t)Trans,
+                which == CblasAMatrix ? M : N, K });
+        if (key != key_ || !packed->IsType<T>()) {
+            packed->Reshape({ math::GemmPackedSize<T>(
+                which, Trans, M, N, K, ctx) });
+            math::GemmPack(which, Trans, M, N, K,
+                X.template data<T, Context>(),
+                    packed->template mutable_data<T, Context>(), ctx);
+            key[1] = packed->epoch(); key_ = key;
+        }
+        return packed->template data<T, Context>();
+    }
+
+ private:
+    /*! \brief The epochs and operand dimensions of last packing */
+    vector<int64_t> key_;
+};
+
+#else
+
+/*!
+ * \brief Nothing to cache without a packing backend.
+ *
+ * The backend packs the operands inside each Gemm,
+ * so math::GemmPackable is false and this is never called.
+ */
+class GemmPackCache {
+ public:
+    template <typename T, class Context>
+    const T* Get(
+        const Tensor&               X,
+        const CBLAS_IDENTIFIER      which,
+        const CBLAS_TRANSPOSE       Trans,
+        const int                   M,
+        const int                   N,
+        const int                   K,
+        Tensor*                     packed,
+        Context*                    ctx) {
+        LOG(FATAL) << "The Gemm packing requires MKL.";
+        return nullptr;
+    }
+};
+
+#endif  // WITH_MKL
+
+}  // namespace dragon
+
+#endif  // DRAGON_UTILS_GEMM_PACK_H_
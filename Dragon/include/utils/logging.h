@@ -26,6 +26,8 @@ std::string SeverityToStr(LogSeverity severity);
 
 void SetLogDestination(LogSeverity type);
 
+LogSeverity GetLogDestination();
+
 int EveryNRegister(const char* file, int line, int severity, int n);
 
 class MessageLogger {
@@ -41,7 +43,14 @@ class MessageLogger {
     void StripBasename(const std::string &full_path, std::string* filename);
 };
 
-#define FATAL_IF(condition) condition ? MessageLogger("-1", -1, -1).stream() : MessageLogger(__FILE__, __LINE__, FATAL).stream()
+/*! \brief Drop the stream, the messages are built only if it is logged */
+class MessageVoidify {
+ public:
+    void operator&(std::ostream&) {}
+};
+
+#define LOG_STREAM_IF(severity, condition) !(condition) ? (void)0 : MessageVoidify() & MessageLogger(__FILE__, __LINE__, severity).stream()
+#define FATAL_IF(condition) LOG_STREAM_IF(FATAL, !(condition))
 #define CHECK(condition) FATAL_IF(condition) << "Check failed: "#condition" "
 #define CHECK_OP(val1,val2,op) \
     FATAL_IF(val1 op val2) << "Check failed: " #val1 " " #op " " #val2 " " << "(" << val1 <<" vs "<<val2 <<")"
@@ -51,8 +60,8 @@ class MessageLogger {
 #define CHECK_GE(val1, val2) CHECK_OP(val1, val2, >=)
 #define CHECK_LT(val1, val2) CHECK_OP(val1, val2, <)
 #define CHECK_LE(val1, val2) CHECK_OP(val1, val2, <=)
-#define LOG(severity) MessageLogger(__FILE__, __LINE__, severity).stream()
-#define LOG_IF(severity, condition) if(condition) MessageLogger(__FILE__, __LINE__, severity).stream()
+#define LOG(severity) LOG_STREAM_IF(severity, severity >= GetLogDestination())
+#define LOG_IF(severity, condition) LOG_STREAM_IF(severity, (condition) && severity >= GetLogDestination())
 #define LOG_EVERY_N(severity, n) MessageLogger(__FILE__, __LINE__, EveryNRegister(__FILE__, __LINE__, severity, n)).stream()
 
 }  // namespace dragon
@@ -26,6 +26,12 @@ typedef enum CBLAS_TRANSPOSE {
     CblasTrans,
 } CBLAS_TRANSPOSE;
 
+// The operand to pack, following the MKL custom
+typedef enum CBLAS_IDENTIFIER {
+    CblasAMatrix,
+    CblasBMatrix,
+} CBLAS_IDENTIFIER;
+
 namespace math {
 
 /*!
@@ -323,6 +329,71 @@ void Gemv(
     Context*                ctx,
     TensorProto_DataType    math_type = TensorProto_DataType_FLOAT);
 
+/*! \brief Compute ``C[i] = alpha * A[i] * B[i] + beta * C[i]`` for each batch */
+template <typename T, class Context>
+void GemmStridedBatched(
+    const CBLAS_TRANSPOSE   TransA,
+    const CBLAS_TRANSPOSE   TransB,
+    const int               batch_size,
+    const int               M,
+    const int               N,
+    const int               K,
+    const float             alpha,
+    const T*                A,
+    const int64_t           A_stride,
+    const T*                B,
+    const int64_t           B_stride,
+    const float             beta,
+    T*                      C,
+    const int64_t           C_stride,
+    Context*                ctx,
+    TensorProto_DataType    math_type = TensorProto_DataType_FLOAT);
+
+/*! \brief Whether the backend runs Gemm with the packed operand */
+template <typename T, class Context>
+bool GemmPackable(Context* ctx);
+
+/*! \brief Return the number of elements to store the packed operand */
+template <typename T, class Context>
+int64_t GemmPackedSize(
+    const CBLAS_IDENTIFIER  which,
+    const CBLAS_TRANSPOSE   Trans,
+    const int               M,
+    const int               N,
+    const int               K,
+    Context*                ctx);
+
+/*! \brief Pack the A or B of a Gemm into the layout of the backend */
+template <typename T, class Context>
+void GemmPack(
+    const CBLAS_IDENTIFIER  which,
+    const CBLAS_TRANSPOSE   Trans,
+    const int               M,
+    const int               N,
+    const int               K,
+    const T*                X,
+    T*                      packed_X,
+    Context*                ctx);
+
+/*!
+ * \brief Compute ``C = A * B + beta * C`` with a packed A or B.
+ *
+ * The transpose and ``M``, ``N``, ``K`` should be the same as packing.
+ */
+template <typename T, class Context>
+void GemmPacked(
+    const CBLAS_IDENTIFIER  which,
+    const CBLAS_TRANSPOSE   TransA,
+    const CBLAS_TRANSPOSE   TransB,
+    const int               M,
+    const int               N,
+    const int               K,
+    const T*                A,
+    const T*                B,
+    const float             beta,
+    T*                      C,
+    Context*                ctx);
+
 /*!
  * ----------------------------------------------
  *
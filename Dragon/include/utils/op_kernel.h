@@ -490,6 +490,18 @@ void ReduceSum(
     T*                      y,
     Context*                ctx);
 
+template <typename T, class Context>
+void Reduce(
+    const string&           operation,
+    const int               ndims,
+    const int*              dims,
+    const int               naxes,
+    const int*              axes,
+    const float             scale,
+    const T*                x,
+    T*                      y,
+    Context*                ctx);
+
 template <typename T, class Context>
 void ReduceSumGrad(
     const int               count,
@@ -502,6 +514,21 @@ void ReduceSumGrad(
     T*                      dx,
     Context*                ctx);
 
+template <typename T, class Context>
+void ReduceGrad(
+    const string&           operation,
+    const int               count,
+    const int               ndims,
+    const int*              x_dims,
+    const int*              y_dims,
+    const int*              y_strides,
+    const float             scale,
+    const T*                x,
+    const T*                y,
+    const T*                dy,
+    T*                      dx,
+    Context*                ctx);
+
 /*! array.repeat */
 
 template <typename T, class Context>
@@ -647,6 +674,50 @@ void GreaterEqual(
     bool*                   y,
     Context*                ctx);
 
+/*! loss.ctc_decoder */
+
+template <typename T, class Context>
+void CTCGreedyDecode(
+    const int               max_seq_len,
+    const int               batch_size,
+    const int               num_classes,
+    const int               blank,
+    const bool              merge_repeated,
+    const int64_t           padding_mask,
+    const T*                prob,
+    int64_t*                decoded,
+    float*                  log_prob,
+    Context*                ctx);
+
+template <typename T, class Context>
+void CTCBeamSearchDecode(
+    const int               max_seq_len,
+    const int               batch_size,
+    const int               num_classes,
+    const int               blank,
+    const int               beam_width,
+    const int64_t           padding_mask,
+    const T*                prob,
+    int64_t*                decoded,
+    float*                  log_prob,
+    Context*                ctx);
+
+/*! loss.ctc_loss */
+
+template <typename T, class Context>
+void CTCLoss(
+    const int               max_seq_len,
+    const int               batch_size,
+    const int               num_classes,
+    const int               blank,
+    const int*              label_lengths,
+    const int*              packed_labels,
+    const T*                prob,
+    double*                 alpha,
+    T*                      loss,
+    T*                      grad,
+    Context*                ctx);
+
 /*! loss.l1_loss */
 
 template <typename T, class Context>
@@ -964,6 +1035,85 @@ void LSTMCellGrad(
     T*                      dx,
     Context*                ctx);
 
+/*! recurrent.rnn_cell */
+
+template <typename T, class Context>
+void RNNCell(
+    const int               N,
+    const int               C,
+    const bool              use_relu,
+    const T*                xw,
+    const T*                hr,
+    const T*                br,
+    T*                      h,
+    Context*                ctx);
+
+template <typename T, class Context>
+void RNNCellGrad(
+    const int               N,
+    const int               C,
+    const bool              use_relu,
+    const T*                h,
+    const T*                dh,
+    T*                      dx,
+    Context*                ctx);
+
+/*! recurrent.lstm_unit */
+
+template <typename T, class Context>
+void LSTMUnit(
+    const int               N,
+    const int               C,
+    const T*                cx,
+    const T*                xw,
+    const T*                hr,
+    const T*                br,
+    T*                      xact,
+    T*                      c,
+    T*                      h,
+    Context*                ctx);
+
+template <typename T, class Context>
+void LSTMUnitGrad(
+    const int               N,
+    const int               C,
+    const T*                cx,
+    const T*                xact,
+    const T*                c,
+    const T*                dc,
+    const T*                dh,
+    T*                      dcx,
+    T*                      dx,
+    Context*                ctx);
+
+/*! recurrent.gru_unit */
+
+template <typename T, class Context>
+void GRUUnit(
+    const int               N,
+    const int               C,
+    const T*                hx,
+    const T*                xw,
+    const T*                hr,
+    const T*                br,
+    T*                      xact,
+    T*                      hn,
+    T*                      h,
+    Context*                ctx);
+
+template <typename T, class Context>
+void GRUUnitGrad(
+    const int               N,
+    const int               C,
+    const T*                hx,
+    const T*                xact,
+    const T*                hn,
+    const T*                dh,
+    T*                      dhx,
+    T*                      dx,
+    T*                      dhr,
+    Context*                ctx);
+
 /*! update.adam_update */
 
 template <typename T, class Context>
@@ -1125,12 +1275,15 @@ void DepthwiseConv2d(
     const int               out_w,
     const int               kernel_h,
     const int               kernel_w,
-    const int               stride,
+    const int               stride_h,
+    const int               stride_w,
     const int               pad_h,
     const int               pad_w,
     const string&           data_format,
+    const bool              relu6,
     const T*                x,
     const T*                w,
+    const T*                b,
     T*                      y,
     Context*                ctx);
 
@@ -1144,12 +1297,13 @@ void DepthwiseConv2dGrad(
     const int               out_w,
     const int               kernel_h,
     const int               kernel_w,
-    const int               stride,
+    const int               stride_h,
+    const int               stride_w,
     const int               pad_h,
     const int               pad_w,
     const string&           data_format,
     const T*                dy,
-    const T*                d,
+    const T*                w,
     T*                      dx,
     Context*                ctx);
 
@@ -1163,7 +1317,8 @@ void DepthwiseConv2dWGrad(
     const int               out_w,
     const int               kernel_h,
     const int               kernel_w,
-    const int               stride,
+    const int               stride_h,
+    const int               stride_w,
     const int               pad_h,
     const int               pad_w,
     const string&           data_format,
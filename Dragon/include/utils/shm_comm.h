@@ -0,0 +1,98 @@
+/*!
+ * Copyright (c) 2017-present, SeetaTech, Co.,Ltd.
+ *
+ * Licensed under the BSD 2-Clause License.
+ * You should have received a copy of the BSD 2-Clause License
+ * along with the software. If not, See,
+ *
+ *      <https://opensource.org/licenses/BSD-2-Clause>
+ *
+ * ------------------------------------------------------------
+ */
+
+#ifndef DRAGON_UTILS_SHM_COMM_H_
+#define DRAGON_UTILS_SHM_COMM_H_
+
+#include "core/common.h"
+
+namespace dragon {
+
+/*!
+ * The collective communicator of the local processes.
+ *
+ * Ranks attach to a POSIX shared memory segment named by the job,
+ * which holds a barrier and a slot of ``slot_bytes`` for each rank.
+ * Large buffers are exchanged chunk by chunk through the slots.
+ *
+ * The all-reduce is done as reduce-scatter plus all-gather,
+ * i.e., each rank sums a partition of the chunk over all the slots,
+ * so that the reduction runs in parallel across the processes.
+ */
+class SharedMemoryComm {
+ public:
+    /*! \brief Constructor, blocks until all the ranks are attached */
+    SharedMemoryComm(
+        const string&               name,
+        int                         size,
+        int                         rank,
+        size_t                      slot_bytes);
+
+    /*! \brief Deconstructor */
+    ~SharedMemoryComm();
+
+    /*! \brief Return the communicator of the job, create if necessary */
+    static SharedMemoryComm* Get(
+        const string&               name,
+        int                         size,
+        int                         rank);
+
+    /*! \brief Block until all the ranks arrive */
+    void Barrier();
+
+    /*! \brief Sum the data over all the ranks, then scale it */
+    template <typename T>
+    void AllReduce(T* data, int64_t count, float scale = 1.f);
+
+    /*! \brief Sum the data over all the ranks into root, then scale it */
+    template <typename T>
+    void Reduce(T* data, int64_t count, int root, float scale = 1.f);
+
+    /*! \brief Copy the bytes of root to all the ranks */
+    void Broadcast(void* data, size_t nbytes, int root);
+
+    /*! \brief Concat the bytes of all the ranks at root */
+    void Gather(
+        const void*                 x,
+        size_t                      nbytes,
+        void*                       y,
+        int                         root);
+
+    /*! \brief Return the number of ranks */
+    int size() const { return size_; }
+
+    /*! \brief Return the rank of this process */
+    int rank() const { return rank_; }
+
+    /*! \brief Return the bytes of a slot */
+    size_t slot_bytes() const { return slot_bytes_; }
+
+ private:
+    /*! \brief Return the slot of the given rank */
+    uint8_t* slot(int rank) { return slots_ + rank * slot_bytes_; }
+
+    /*! \brief Reduce into all the ranks if root is negative */
+    template <typename T>
+    void ReduceImpl(T* data, int64_t count, int root, float scale);
+
+    struct Header;
+
+    string name_;
+    int size_, rank_;
+    size_t slot_bytes_, nbytes_;
+    Header* header_;
+    uint8_t* slots_;
+};
+
+}  // namespace dragon
+
+#endif  // DRAGON_UTILS_SHM_COMM_H_
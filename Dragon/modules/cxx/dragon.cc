@@ -61,6 +61,17 @@ void MoveWorkspace(
         << "into the Workspace(" << dst->name() << ").";
 }
 
+void ShareWorkspace(
+    Workspace_t                     dst,
+    Workspace_t                     src) {
+    std::unique_lock<std::mutex> lock(g_mutex);
+    CHECK(src) << "\nGiven source workspace is invalid.";
+    CHECK(dst) << "\nGiven destination workspace is invalid.";
+    dst->Share(src);
+    LOG(INFO) << "Share the Workspace(" << src->name() << ") "
+        << "into the Workspace(" << dst->name() << ").";
+}
+
 void DestroyWorkspace(const std::string& name) {
     std::unique_lock<std::mutex> lock(g_mutex);
     CHECK(g_workspaces.count(name))
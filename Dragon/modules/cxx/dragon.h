@@ -15,6 +15,7 @@
 
 #include <string>
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 #ifdef _MSC_VER
@@ -46,6 +47,10 @@ namespace dragon {
 
 typedef struct GraphDef* GraphDef_t;
 typedef struct Workspace* Workspace_t;
+struct Server;
+
+/*! The server is held by the callers until their requests finish */
+typedef std::shared_ptr<Server> Server_t;
 
 class DRAGON_API Device {
  public:
@@ -74,6 +79,14 @@ DRAGON_API Workspace_t ResetWorkspace(const std::string& name);
 
 DRAGON_API void MoveWorkspace(Workspace_t dst, Workspace_t src);
 
+/*!
+ * Share the tensors of source into destination by copy-on-write.
+ *
+ * The memory is copied only if either side mutates it,
+ * so the source could serve as the frozen weights of replicas.
+ */
+DRAGON_API void ShareWorkspace(Workspace_t dst, Workspace_t src);
+
 DRAGON_API void DestroyWorkspace(Workspace_t ws);
 
 DRAGON_API void DestroyWorkspace(const std::string& name);
@@ -124,6 +137,61 @@ DRAGON_API void FeedTensor(
     const Device&                   device,
     Workspace_t                     ws);
 
+/* * * * * * * * * * * * * * * * * * * * *
+ *                                       *
+ *                Serving                *
+ *                                       *
+ * * * * * * * * * * * * * * * * * * * * */
+
+/*!
+ * Create a server running the graph with the dynamic batching.
+ *
+ * Each worker owns a workspace for the activations,
+ * while the weights are shared from the given workspace,
+ * which should not be modified during serving.
+ *
+ * Concurrent requests are stacked along the first dimension,
+ * up to ``max_batch_size`` rows or ``max_latency_us`` waiting.
+ */
+DRAGON_API Server_t CreateServer(
+    const std::string&              name,
+    const GraphDef_t                graph_def,
+    const Device&                   device,
+    Workspace_t                     ws,
+    const std::vector<std::string>& inputs,
+    const std::vector<std::string>& outputs,
+    const int                       num_workers = 1,
+    const int                       max_batch_size = 8,
+    const int                       max_latency_us = 1000);
+
+DRAGON_API Server_t CreateServer(
+    const std::string&              name,
+    const std::string&              graph_file,
+    const Device&                   device,
+    Workspace_t                     ws,
+    const std::vector<std::string>& inputs,
+    const std::vector<std::string>& outputs,
+    const int                       num_workers = 1,
+    const int                       max_batch_size = 8,
+    const int                       max_latency_us = 1000);
+
+DRAGON_API Server_t GetServer(const std::string& name);
+
+DRAGON_API void DestroyServer(const std::string& name);
+
+/*!
+ * Run a request synchronously, thread-safe.
+ *
+ * The outputs of other numeric types are cast to ``Ty``.
+ */
+template <typename Tx, typename Ty>
+DRAGON_API void ServeRequest(
+    Server_t                                    server,
+    const std::vector<const Tx*>&               inputs,
+    const std::vector<std::vector<int64_t> >&   input_shapes,
+    std::vector<std::vector<Ty> >&              outputs,
+    std::vector<std::vector<int64_t> >&         output_shapes);
+
 /* * * * * * * * * * * * * * * * * * * * *
 *                                        *
 *                 Proto                  *
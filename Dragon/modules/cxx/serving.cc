@@ -0,0 +1,396 @@
+#include <mutex>
+#include <thread>
+#include <future>
+#include <condition_variable>
+#include <chrono>
+#include <deque>
+
+#include "core/common.h"
+#include "core/workspace.h"
+#include "utils/cast.h"
+#include "utils/proto_utils.h"
+
+#include "dragon.h"
+
+namespace dragon {
+
+/* * * * * * * * * * * * * * * * * * * * *
+ *                                       *
+ *                Serving                *
+ *                                       *
+ * * * * * * * * * * * * * * * * * * * * */
+
+typedef std::chrono::steady_clock ServingClock;
+
+struct ServingRequest {
+    /*! \brief The raw inputs, owned by the caller */
+    vector<const void*> inputs;
+    vector<vector<int64_t>> input_shapes;
+    TypeMeta meta;
+
+    /*! \brief The outputs split from the batch */
+    vector<vector<uint8_t>> outputs;
+    vector<vector<int64_t>> output_shapes;
+    vector<TypeMeta> output_metas;
+
+    int64_t rows;
+    ServingClock::time_point arrival;
+    std::promise<void> done;
+};
+
+struct Server {
+ public:
+    Server(
+        const string&               name,
+        const GraphDef&             graph_def,
+        const Device&               device,
+        Workspace*                  ws,
+        const vector<string>&       inputs,
+        const vector<string>&       outputs,
+        const int                   num_workers,
+        const int                   max_batch_size,
+        const int                   max_latency_us)
+        : name_(name), device_(device), inputs_(inputs),
+          outputs_(outputs), max_batch_size_(max_batch_size),
+          max_latency_(max_latency_us), running_(true) {
+        CHECK_GT(num_workers, 0);
+        CHECK_GT(max_batch_size, 0);
+        CHECK(!inputs.empty()) << "\nServer(" << name << ") has no inputs.";
+        for (int i = 0; i < num_workers; i++) {
+            // Each worker owns the activations and internal tensors,
+            // while the weights are shared from the given workspace
+            unique_ptr<Workspace> worker_ws(new Workspace(
+                name + "/worker:" + std::to_string(i)));
+            for (const auto& tensor : ws->GetTensors())
+                if (tensor[0] == '/') worker_ws->CreateTensor(tensor);
+            for (const auto& input : inputs) worker_ws->CreateTensor(input);
+            for (const auto& op : graph_def.op())
+                for (const auto& output : op.output())
+                    worker_ws->CreateTensor(output);
+            worker_ws->Move(ws);
+            GraphDef worker_def(graph_def);
+            auto* option = worker_def.mutable_device_option();
+            option->set_device_type((DeviceTypeProto)device.device_type());
+            option->set_device_id(device.device_id());
+            graph_names_.push_back(worker_ws->CreateGraph(worker_def)->name());
+            workspaces_.push_back(std::move(worker_ws));
+        }
+        for (int i = 0; i < num_workers; i++)
+            workers_.emplace_back(&Server::WorkerLoop, this, i);
+        LOG(INFO) << "Create the Server(" << name << ") with "
+                  << num_workers << " worker(s), "
+                  << "max batch size: " << max_batch_size << ", "
+                  << "max latency: " << max_latency_us << "us.";
+    }
+
+    ~Server() {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            running_ = false;
+        }
+        cond_.notify_all();
+        for (auto& worker : workers_) worker.join();
+    }
+
+    /*! \brief Enqueue a request and wait for the outputs */
+    void Serve(ServingRequest* request) {
+        CHECK_EQ(request->inputs.size(), inputs_.size())
+            << "\nServer(" << name_ << ") excepted "
+            << inputs_.size() << " inputs, got "
+            << request->inputs.size() << ".";
+        request->rows = -1;
+        for (const auto& shape : request->input_shapes) {
+            CHECK(!shape.empty())
+                << "\nThe inputs should have a batch dimension.";
+            if (request->rows < 0) request->rows = shape[0];
+            CHECK_EQ(shape[0], request->rows)
+                << "\nThe inputs should have the same batch size.";
+        }
+        auto future = request->done.get_future();
+        request->arrival = ServingClock::now();
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            queue_.push_back(request);
+        }
+        cond_.notify_all();
+        future.get();
+    }
+
+ protected:
+    /*! \brief Whether the request could be stacked with the given */
+    bool IsCompatible(
+        const ServingRequest*       a,
+        const ServingRequest*       b) {
+        if (!(a->meta == b->meta)) return false;
+        for (int i = 0; i < a->input_shapes.size(); i++) {
+            const auto& x = a->input_shapes[i], &y = b->input_shapes[i];
+            if (x.size() != y.size()) return false;
+            for (int j = 1; j < x.size(); j++)
+                if (x[j] != y[j]) return false;
+        }
+        return true;
+    }
+
+    /*! \brief Coalesce the queued requests into a batch */
+    bool NextBatch(vector<ServingRequest*>& batch) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            // The queue may be drained by another worker while waiting
+            cond_.wait(lock, [this] { return !running_ || !queue_.empty(); });
+            if (!running_ && queue_.empty()) return false;
+            auto deadline = queue_.front()->arrival +
+                std::chrono::microseconds(max_latency_);
+            int64_t rows = 0; size_t n = 0;
+            // Stop at the first request which does not fit
+            for (; n < queue_.size(); n++) {
+                if (n > 0 && (!IsCompatible(queue_[0], queue_[n]) ||
+                    rows + queue_[n]->rows > max_batch_size_)) break;
+                rows += queue_[n]->rows;
+            }
+            bool full = n < queue_.size() || rows >= max_batch_size_;
+            if (full || !running_ || ServingClock::now() >= deadline) {
+                batch.assign(queue_.begin(), queue_.begin() + n);
+                queue_.erase(queue_.begin(), queue_.begin() + n);
+                return true;
+            }
+            cond_.wait_until(lock, deadline);
+        }
+    }
+
+    /*! \brief Run a batch on the given worker */
+    void RunBatch(int worker_id, vector<ServingRequest*>& batch) {
+        auto* ws = workspaces_[worker_id].get();
+        const auto& meta = batch[0]->meta;
+        int64_t rows = 0;
+        for (auto* request : batch) rows += request->rows;
+
+        // Stack the inputs along the batch dimension
+        for (int i = 0; i < inputs_.size(); i++) {
+            auto dims = batch[0]->input_shapes[i]; dims[0] = rows;
+            auto* tensor = ws->GetTensor(inputs_[i])->Reshape(dims);
+            auto* dst = (uint8_t*)(device_.device_type() == 1 ?
+                tensor->raw_mutable_data<CUDAContext>(meta) :
+                    tensor->raw_mutable_data<CPUContext>(meta));
+            const size_t row_bytes = tensor->count(1) * meta.itemsize();
+            for (auto* request : batch) {
+                const size_t nbytes = request->rows * row_bytes;
+                if (device_.device_type() == 1) {
+                    CUDAContext::Memcpy<CUDAContext, CPUContext>(
+                        nbytes, dst, request->inputs[i]);
+                } else {
+                    CPUContext::Memcpy<CPUContext, CPUContext>(
+                        nbytes, dst, request->inputs[i]);
+                }
+                dst += nbytes;
+            }
+        }
+
+        ws->RunGraph(graph_names_[worker_id], "", "");
+
+        // Split the outputs back to the requests
+        for (auto* request : batch) {
+            request->outputs.resize(outputs_.size());
+            request->output_shapes.resize(outputs_.size());
+            request->output_metas.resize(outputs_.size());
+        }
+        for (int i = 0; i < outputs_.size(); i++) {
+            auto* tensor = ws->GetTensor(outputs_[i]);
+            CHECK(batch.size() == 1 || (tensor->ndim() > 0 &&
+                tensor->dim(0) == rows))
+                << "\nOutput(" << outputs_[i] << ") with shape "
+                << tensor->DimString() << " could not be split "
+                << "into the batch of " << rows << ".";
+            const uint8_t* src;
+            if (tensor->memory_state() == MixedMemory::STATE_AT_CUDA) {
+                src = (const uint8_t*)tensor->raw_data<CUDAContext>();
+            } else {
+                src = (const uint8_t*)tensor->raw_data<CPUContext>();
+            }
+            const size_t row_bytes = batch.size() == 1 ?
+                tensor->nbytes() : tensor->nbytes() / rows;
+            for (auto* request : batch) {
+                const size_t nbytes = batch.size() == 1 ?
+                    row_bytes : request->rows * row_bytes;
+                auto dims = tensor->dims();
+                if (batch.size() > 1) dims[0] = request->rows;
+                request->outputs[i].resize(nbytes);
+                request->output_shapes[i] = dims;
+                request->output_metas[i] = tensor->meta();
+                if (tensor->memory_state() == MixedMemory::STATE_AT_CUDA) {
+                    CUDAContext::Memcpy<CPUContext, CUDAContext>(
+                        nbytes, request->outputs[i].data(), src);
+                } else {
+                    CPUContext::Memcpy<CPUContext, CPUContext>(
+                        nbytes, request->outputs[i].data(), src);
+                }
+                src += nbytes;
+            }
+        }
+    }
+
+    void WorkerLoop(int worker_id) {
+        if (device_.device_type() == 1) {
+            CUDAContext context(device_.device_id());
+            context.SwitchToDevice();
+        }
+        vector<ServingRequest*> batch;
+        while (NextBatch(batch)) {
+            RunBatch(worker_id, batch);
+            for (auto* request : batch) request->done.set_value();
+        }
+    }
+
+ protected:
+    string name_;
+    Device device_;
+    vector<string> inputs_, outputs_, graph_names_;
+    int64_t max_batch_size_, max_latency_;
+    bool running_;
+
+    vector<unique_ptr<Workspace>> workspaces_;
+    vector<std::thread> workers_;
+    std::deque<ServingRequest*> queue_;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+};
+
+Map<string, Server_t> g_servers;
+std::mutex g_server_mutex;
+
+Server_t CreateServer(
+    const std::string&              name,
+    const GraphDef_t                graph_def,
+    const Device&                   device,
+    Workspace_t                     ws,
+    const std::vector<std::string>& inputs,
+    const std::vector<std::string>& outputs,
+    const int                       num_workers,
+    const int                       max_batch_size,
+    const int                       max_latency_us) {
+    std::unique_lock<std::mutex> lock(g_server_mutex);
+    CHECK(!g_servers.count(name))
+        << "\nServer(" << name << ") already exists.";
+    g_servers[name].reset(new Server(
+        name, *graph_def, device, ws, inputs, outputs,
+            num_workers, max_batch_size, max_latency_us));
+    return g_servers[name];
+}
+
+Server_t CreateServer(
+    const std::string&              name,
+    const std::string&              graph_file,
+    const Device&                   device,
+    Workspace_t                     ws,
+    const std::vector<std::string>& inputs,
+    const std::vector<std::string>& outputs,
+    const int                       num_workers,
+    const int                       max_batch_size,
+    const int                       max_latency_us) {
+    GraphDef graph_def;
+    ParseProtoFromText(graph_file.c_str(), &graph_def);
+    return CreateServer(name, &graph_def, device, ws, inputs,
+        outputs, num_workers, max_batch_size, max_latency_us);
+}
+
+Server_t GetServer(const std::string& name) {
+    std::unique_lock<std::mutex> lock(g_server_mutex);
+    CHECK(g_servers.count(name))
+        << "\nServer(" << name << ") does not exist.";
+    return g_servers[name];
+}
+
+void DestroyServer(const std::string& name) {
+    // The in-flight requests hold the server until finished
+    Server_t server;
+    {
+        std::unique_lock<std::mutex> lock(g_server_mutex);
+        CHECK(g_servers.count(name))
+            << "\nServer(" << name << ") does not exist."
+            << "\nCan not be released.";
+        server = std::move(g_servers[name]);
+        g_servers.erase(name);
+    }
+    LOG(INFO) << "Destroy the Server(" << name << ").";
+}
+
+/*! Cast the output bytes of the given type into the typed vector */
+template <typename Ty>
+void CastOutput(
+    const TypeMeta&                 meta,
+    const vector<uint8_t>&          bytes,
+    vector<Ty>&                     output) {
+#define DEFINE_CAST_OUTPUT(T, expr) \
+    if (meta.Match<T>()) { \
+        auto* x = (const T*)bytes.data(); \
+        output.resize(bytes.size() / sizeof(T)); \
+        for (size_t i = 0; i < output.size(); i++) \
+            output[i] = static_cast<Ty>(expr); \
+        return; \
+    }
+    DEFINE_CAST_OUTPUT(bool, x[i]);
+    DEFINE_CAST_OUTPUT(int8_t, x[i]);
+    DEFINE_CAST_OUTPUT(uint8_t, x[i]);
+    DEFINE_CAST_OUTPUT(int, x[i]);
+    DEFINE_CAST_OUTPUT(int64_t, x[i]);
+    DEFINE_CAST_OUTPUT(float16, cast::to<float>(x[i]));
+    DEFINE_CAST_OUTPUT(float, x[i]);
+    DEFINE_CAST_OUTPUT(double, x[i]);
+#undef DEFINE_CAST_OUTPUT
+    LOG(FATAL) << "\nThe DType of output is "
+               << TypeMetaToString(meta) << ", which could not "
+               << "be cast to " << TypeMetaToString(
+                   TypeMeta::Make<Ty>()) << ".";
+}
+
+template <typename Tx, typename Ty>
+void ServeRequest(
+    Server_t                                server,
+    const std::vector<const Tx*>&           inputs,
+    const std::vector<std::vector<int64_t>>& input_shapes,
+    std::vector<std::vector<Ty>>&           outputs,
+    std::vector<std::vector<int64_t>>&      output_shapes) {
+    CHECK(server) << "\nGiven server is invalid.";
+    CHECK_EQ(inputs.size(), input_shapes.size());
+    ServingRequest request;
+    request.meta = TypeMeta::Make<Tx>();
+    request.input_shapes = input_shapes;
+    for (auto* input : inputs) request.inputs.push_back(input);
+    server->Serve(&request);
+    outputs.resize(request.outputs.size());
+    output_shapes = request.output_shapes;
+    for (int i = 0; i < request.outputs.size(); i++) {
+        if (request.output_metas[i] == TypeMeta::Make<Ty>()) {
+            outputs[i].resize(request.outputs[i].size() / sizeof(Ty));
+            memcpy(outputs[i].data(), request.outputs[i].data(),
+                request.outputs[i].size());
+        } else {
+            CastOutput(request.output_metas[i],
+                request.outputs[i], outputs[i]);
+        }
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * *
+ *                                       *
+ *               Template                *
+ *                                       *
+ * * * * * * * * * * * * * * * * * * * * */
+
+#define INSTANTIATE_SERVE_REQUEST(Tx, Ty) \
+    template DRAGON_API void ServeRequest<Tx, Ty>( \
+        Server_t, const std::vector<const Tx*>&, \
+        const std::vector<std::vector<int64_t>>&, \
+        std::vector<std::vector<Ty>>&, \
+        std::vector<std::vector<int64_t>>&);
+
+INSTANTIATE_SERVE_REQUEST(float, float);
+INSTANTIATE_SERVE_REQUEST(uint8_t, float);
+INSTANTIATE_SERVE_REQUEST(int, float);
+INSTANTIATE_SERVE_REQUEST(int64_t, float);
+INSTANTIATE_SERVE_REQUEST(float, int64_t);
+INSTANTIATE_SERVE_REQUEST(uint8_t, int64_t);
+INSTANTIATE_SERVE_REQUEST(int, int64_t);
+INSTANTIATE_SERVE_REQUEST(int64_t, int64_t);
+#undef INSTANTIATE_SERVE_REQUEST
+
+}  // namespace dragon
@@ -19,6 +19,66 @@ namespace dragon {
 
 namespace python {
 
+/*!
+ * The backward ops generated for a sequence of forward ops.
+ *
+ * Flows are addressed by the content of forward ops and targets,
+ * the ops and their tensors are created once and kept alive,
+ * then a cached flow runs without making or resolving again.
+ */
+struct GradientFlow {
+    /*! \brief The gradient defs before and after sharing */
+    vector<string> raw_defs;
+    vector<OperatorDef> defs;
+
+    /*! \brief The ops, which are persistent if having UID */
+    vector<OperatorBase*> ops;
+    vector<unique_ptr<OperatorBase> > owned_ops;
+
+    /*! \brief The resolved tensors to rebind the persistent ops */
+    vector<vector<Tensor*> > inputs, outputs;
+
+    int64_t last_tick = 0;
+};
+
+class GradientFlowCache {
+ public:
+    /*! \brief Return the flow of the key, create if missing */
+    GradientFlow* Get(const string& key, bool* created) {
+        if (ws() != ws_ || DispatchEpoch() != epoch_) {
+            // The tensors and ops were resolved in another epoch
+            Clear(); ws_ = ws(); epoch_ = DispatchEpoch();
+        }
+        auto it = flows_.find(key);
+        *created = it == flows_.end();
+        if (*created) {
+            if (flows_.size() >= kMaxFlows) {
+                auto lru = flows_.begin();
+                for (auto iter = flows_.begin();
+                     iter != flows_.end(); ++iter)
+                    if (iter->second->last_tick <
+                        lru->second->last_tick) lru = iter;
+                flows_.erase(lru);
+            }
+            it = flows_.emplace(key, unique_ptr<
+                GradientFlow>(new GradientFlow())).first;
+        }
+        it->second->last_tick = ++tick_;
+        return it->second.get();
+    }
+
+    /*! \brief Release all the flows */
+    void Clear() { flows_.clear(); }
+
+ private:
+    static const size_t kMaxFlows = 16;
+    Map<string, unique_ptr<GradientFlow> > flows_;
+    Workspace* ws_ = nullptr;
+    int64_t epoch_ = -1, tick_ = 0;
+};
+
+GradientFlowCache g_gradient_flows;
+
 void AddGradientMethods(pybind11::module& m) {
     m.def("CreateGradientDefs", [](
         const string&               forward_def,
@@ -43,21 +103,68 @@ void AddGradientMethods(pybind11::module& m) {
         const vector<string>&         input_grads,
         const vector<string>&         ignore_grads,
         const bool                    is_sharing,
-        const bool                    verbose) {
-        // Make => Optimize => Run
-        GraphDef backward_ops;
-        GraphGradientMaker maker;
-        for (auto& grad : input_grads) maker.AddExternalGrad(grad);
-        for (auto& grad : ignore_grads) maker.AddIgnoreGrad(grad);
-        maker.Make(forward_ops, targets, backward_ops);
-        if (is_sharing) maker.Share(backward_ops);
+        const bool                    verbose,
+        const bool                    return_defs) {
+        // Address the flow by the content of forward ops and targets
+        string key(is_sharing ? "1" : "0");
+        for (auto* op : forward_ops) key += op->SerializeAsString();
+        for (const auto* names : { &targets, &input_grads, &ignore_grads }) {
+            key += '\0';
+            for (const auto& name : *names) key += name + ";";
+        }
+        bool created;
+        auto* flow = g_gradient_flows.Get(key, &created);
+        if (created) {
+            // Make => Optimize, only once for this flow
+            GraphDef backward_ops;
+            GraphGradientMaker maker;
+            for (auto& grad : input_grads) maker.AddExternalGrad(grad);
+            for (auto& grad : ignore_grads) maker.AddIgnoreGrad(grad);
+            maker.Make(forward_ops, targets, backward_ops);
+            // Keep the defs before sharing for the tracer,
+            // which will optimize the whole graph later
+            for (const auto& op : backward_ops.op())
+                if (!op.type().empty())
+                    flow->raw_defs.push_back(op.SerializeAsString());
+            if (is_sharing) maker.Share(backward_ops);
+            for (const auto& op : backward_ops.op())
+                if (!op.type().empty()) flow->defs.push_back(op);
+        }
+        vector<pybind11::bytes> grad_ops;
+        if (return_defs) {
+            for (const auto& raw_def : flow->raw_defs)
+                grad_ops.push_back(raw_def);
+        }
         pybind11::gil_scoped_release g;
-        for (auto& op : backward_ops.op()) {
-            if (op.type().empty()) continue;
-            if (verbose) std::cout << op.DebugString() << std::endl;
-            if (op.has_uid()) ws()->RunOperator(op);
-            else ws()->RunOperatorOnce(op);
+        for (int i = 0; i < flow->defs.size(); i++) {
+            const auto& op_def = flow->defs[i];
+            if (verbose) std::cout << op_def.DebugString() << std::endl;
+            if (i == flow->ops.size()) {
+                // Create the op and resolve its tensors on the first run
+                vector<Tensor*> inputs, outputs;
+                if (op_def.has_uid()) {
+                    flow->ops.push_back(ws()->CreateOperator(op_def));
+                    for (const auto& e : op_def.input())
+                        inputs.push_back(ws()->GetTensor(e));
+                    for (const auto& e : op_def.output())
+                        outputs.push_back(ws()->CreateTensor(e));
+                } else {
+                    flow->owned_ops.emplace_back(
+                        NewOperator(op_def, ws()));
+                    flow->ops.push_back(flow->owned_ops.back().get());
+                }
+                flow->inputs.push_back(inputs);
+                flow->outputs.push_back(outputs);
+            }
+            auto* op = flow->ops[i];
+            if (op_def.has_uid()) {
+                // The persistent op may be shared by other flows
+                op->UpdateFrom(flow->inputs[i],
+                    flow->outputs[i], op_def.name());
+            }
+            op->Run(0);
         }
+        return grad_ops;
     });
 }
 
@@ -14,6 +14,10 @@
 #define DRAGON_PYTHON_PY_CONFIG_H_
 
 #include "py_dragon.h"
+#include "core/scratch.h"
+#include "core/spill.h"
+#include "operators/misc/python_op.h"
+#include "utils/cpu_isa.h"
 
 namespace dragon {
 
@@ -23,6 +27,36 @@ void AddConfigMethods(pybind11::module& m) {
     m.def("SetLoggingLevel", [](const string& level) {
         SetLogDestination(StrToLogSeverity(level));
     });
+
+    m.def("GetCPUISA", []() {
+        return CPUISAToString(GetCPUISA());
+    });
+
+    m.def("SetScratchLimit", [](size_t nbytes) {
+        ScratchArena::SetLimit(nbytes);
+    });
+
+    m.def("GetScratchStats", []() {
+        size_t used, peak, capacity;
+        ScratchArena::Stats(&used, &peak, &capacity);
+        return std::make_tuple(used, peak, capacity);
+    });
+
+    m.def("GetSpillStats", []() {
+        size_t used, peak, capacity;
+        SpillArea::Get()->Stats(&used, &peak, &capacity);
+        return std::make_tuple(used, peak, capacity);
+    });
+
+    m.def("GetPythonOpStats", []() {
+        Map<string, std::tuple<int64_t, double, double, double> > ret;
+        for (const auto& it : PythonWorker::Get()->Stats()) {
+            const auto& stats = it.second;
+            ret[it.first] = std::make_tuple(stats.num_runs,
+                stats.gil_wait, stats.run, stats.blocked);
+        }
+        return ret;
+    });
 }
 
 }  // namespace python
@@ -62,10 +62,81 @@ DECLARE_TYPED_REGISTRY(TensorFeederRegistry, TypeId, TensorFeederBase);
 #define REGISTER_TENSOR_FEEDER(type, ...) \
     REGISTER_TYPED_CLASS(TensorFeederRegistry, type, __VA_ARGS__)
 
+/*! \brief Return the element layout of array, false if not viewable */
+inline bool GetPyArrayLayout(
+    PyArrayObject*                  array,
+    vector<int64_t>*                dims,
+    vector<int64_t>*                strides,
+    size_t*                         span) {
+    const int64_t itemsize = PyArray_ITEMSIZE(array);
+    bool viewable = PyArray_ISALIGNED(array) &&
+        PyArray_ISNOTSWAPPED(array);
+    dims->clear(); strides->clear(); *span = 1;
+    for (int i = 0; i < PyArray_NDIM(array); i++) {
+        const int64_t dim = PyArray_DIM(array, i);
+        const int64_t stride = PyArray_STRIDE(array, i);
+        dims->push_back(dim);
+        // The strides of single dimensions are never used
+        strides->push_back(dim > 1 ? stride / itemsize : 0);
+        if (dim > 1 && (stride < 0 || stride % itemsize != 0))
+            viewable = false;
+        if (dim == 0) *span = 0;
+        else if (*span > 0) *span += (dim - 1) * strides->back();
+    }
+    return viewable;
+}
+
+/*! \brief Return a array viewing the tensor, which holds the memory */
+inline PyObject* TensorToPyArrayView(Tensor* tensor, bool readonly) {
+    CHECK_GT(tensor->count(), 0);
+    int npy_type = TypeMetaToNPY(tensor->meta());
+    if (npy_type == -1) {
+        LOG(FATAL) << "Tensor(" + tensor->name() + ") "
+            "with dtype." + TypeMetaToString(tensor->meta()) +
+            " is not supported by numpy.";
+    }
+    vector<npy_intp> dims, strides;
+    for (int i = 0; i < tensor->ndim(); i++) {
+        dims.push_back(tensor->dim(i));
+        strides.push_back(tensor->stride(i) * tensor->meta().itemsize());
+    }
+    auto* data = readonly ?
+        const_cast<void*>(tensor->const_data_ptr<CPUContext>()) :
+            tensor->raw_mutable_data<CPUContext>();
+    PyObject* array = PyArray_New(&PyArray_Type, tensor->ndim(),
+        dims.data(), npy_type, strides.data(), data, 0, readonly ?
+            NPY_ARRAY_ALIGNED : NPY_ARRAY_ALIGNED | NPY_ARRAY_WRITEABLE,
+                nullptr);
+    if (tensor->is_viewable()) {
+        // Share the memory with a holder as the base,
+        // the array stays valid after the tensor is reset
+        auto* holder = new Tensor(tensor->name());
+        holder->ShareView(*tensor, tensor->offset(),
+            tensor->dims(), tensor->strides());
+        PyObject* base = PyCapsule_New(holder, nullptr,
+            [](PyObject* obj)->void {
+                delete static_cast<Tensor*>(
+                    PyCapsule_GetPointer(obj, nullptr));
+        });
+        PyArray_SetBaseObject(
+            reinterpret_cast<PyArrayObject*>(array), base);
+    }
+    return array;
+}
+
 class NumpyFetcher : public TensorFetcherBase {
  public:
     pybind11::object Fetch(const Tensor& tensor) override {
         CHECK_GT(tensor.count(), 0);
+        if (!tensor.is_contiguous()) {
+            // Copy the strided view through a array view
+            PyObject* view = TensorToPyArrayView(
+                const_cast<Tensor*>(&tensor), true);
+            PyObject* array = PyArray_NewCopy(
+                reinterpret_cast<PyArrayObject*>(view), NPY_CORDER);
+            Py_DECREF(view);
+            return pybind11::reinterpret_steal<pybind11::object>(array);
+        }
         vector<npy_intp> npy_dims;
         for (const auto dim : tensor.dims()) npy_dims.push_back(dim);
         int npy_type = TypeMetaToNPY(tensor.meta());
@@ -138,6 +209,12 @@ class NumpyFeeder : public TensorFeederBase {
 
 Workspace* ws();
 
+/*! \brief Return the epoch of the dispatch handles */
+int64_t DispatchEpoch();
+
+/*! \brief Expire the operator and tensor handles taken before */
+void InvalidateDispatch();
+
 }  // namespace python
 
 }  // namespace dragon
@@ -23,6 +23,12 @@ string g_current_workspace;
 
 Workspace* ws() { return g_workspace; }
 
+int64_t g_dispatch_epoch = 0;
+
+int64_t DispatchEpoch() { return g_dispatch_epoch; }
+
+void InvalidateDispatch() { g_dispatch_epoch++; }
+
 TypeId CTypeToFetcher(TypeId type) {
     static Map<TypeId,TypeId> c_type_map {
         { TypeMeta::Id<bool>(), TypeMeta::Id<NumpyFetcher>() },
@@ -44,6 +50,7 @@ REGISTER_TENSOR_FEEDER(TypeMeta::Id<NumpyFeeder>(), NumpyFeeder);
 void SwitchWorkspace(
     const string&           name,
     const bool              create_if_missing = true) {
+    InvalidateDispatch();
     if (g_workspaces.count(name)) {
         g_current_workspace = name;
         g_workspace = g_workspaces[name].get();
@@ -95,11 +102,26 @@ PYBIND11_MODULE(libdragon, m) {
         CHECK(g_workspaces.count(target))
             << "\nTarget Workspace(" << target << ") does not exist.";
         g_workspaces[target]->Move(g_workspaces[source].get());
+        InvalidateDispatch();
         sub_workspaces[target].push_back(source);
         LOG(INFO) << "Move the Workspace(" << source << ") "
             << "into the Workspace(" << target << ").";
     });
 
+    /*! \brief Share the tensors of source into the target by copy-on-write */
+    m.def("ShareWorkspace", [](
+        const string&           target,
+        const string&           source) {
+        CHECK(g_workspaces.count(source))
+            << "\nSource Workspace(" << source << ") does not exist.";
+        CHECK(g_workspaces.count(target))
+            << "\nTarget Workspace(" << target << ") does not exist.";
+        g_workspaces[target]->Share(g_workspaces[source].get());
+        InvalidateDispatch();
+        LOG(INFO) << "Share the Workspace(" << source << ") "
+            << "into the Workspace(" << target << ").";
+    });
+
     /*! \brief Reset the specific workspace */
     m.def("ResetWorkspace", [](const string& name) {
         string target_workspace = g_current_workspace;
@@ -108,6 +130,7 @@ PYBIND11_MODULE(libdragon, m) {
             << "\nWorkspace(" << target_workspace
             << ") does not exist, can not be reset.";
         LOG(INFO) << "Reset the Workspace(" << target_workspace << ")";
+        InvalidateDispatch();
         g_workspaces[target_workspace].reset(new Workspace(target_workspace));
         g_workspace = g_workspaces[target_workspace].get();
         for (auto& sub_workspace : sub_workspaces[target_workspace]) {
@@ -145,8 +168,8 @@ PYBIND11_MODULE(libdragon, m) {
             PyArrayObject*>(value.ptr()), tensor);
     });
 
-    /*! \brief Copy the tensor data to the array */
-    m.def("FetchTensor", [](const string& name) {
+    /*! \brief Copy the tensor data to the array, or return a readonly view */
+    m.def("FetchTensor", [](const string& name, const bool copy) {
         if (!g_workspace->HasTensor(name))
             LOG(FATAL) << "Tensor(" + name + ") "
                 "does not exist. Have you registered it?";
@@ -155,6 +178,11 @@ PYBIND11_MODULE(libdragon, m) {
         CHECK(type_id != 0)
             << "\nTensor(" << tensor->name()
             << ") does not initialize or had been reset.";
+        if (!copy && type_id == TypeMeta::Id<NumpyFetcher>()) {
+            // Share the memory with a readonly numpy object
+            return pybind11::reinterpret_steal<pybind11::object>(
+                TensorToPyArrayView(tensor, true));
+        }
         unique_ptr<TensorFetcherBase> fetcher(CreateFetcher(type_id));
         if (fetcher.get()) {
             // Copy the tensor data to a numpy object
@@ -186,7 +214,15 @@ PYBIND11_MODULE(libdragon, m) {
     AddOperatorMethods(m);
 
     OnImportModule();
-    m.def("OnModuleExit", []() { g_workspaces.clear(); });
+    m.def("OnModuleExit", []() {
+        {
+            // The queued operators need the GIL to finish
+            pybind11::gil_scoped_release g;
+            PythonWorker::Shutdown();
+        }
+        g_gradient_flows.Clear();
+        g_workspaces.clear();
+    });
 }
 
 }  // namespace python
@@ -51,6 +51,58 @@ void AddOperatorMethods(pybind11::module& m) {
         }
         ws()->RunOperatorOnce(def);
     });
+
+    /*! \brief Export the persistent operator as an opaque handle */
+    pybind11::class_<OperatorBase, std::unique_ptr<
+        OperatorBase, pybind11::nodelete> >(m, "OperatorHandle")
+        .def_property_readonly("type", &OperatorBase::type)
+        .def_property_readonly("anchor", &OperatorBase::anchor);
+
+    /*! \brief Return the epoch of the dispatch handles */
+    m.def("DispatchEpoch", &DispatchEpoch);
+
+    /*! \brief Create a persistent operator and return its handle */
+    m.def("CreateOperatorHandle", [](OperatorDef* def) {
+        return ws()->CreateOperator(*def);
+    }, pybind11::return_value_policy::reference);
+
+    /*! \brief Return the handles of tensors, create them if necessary */
+    m.def("GetTensorHandles", [](
+        const vector<string>&   names,
+        const bool              create_if_missing) {
+        vector<Tensor*> tensors;
+        for (const auto& name : names)
+            tensors.push_back(create_if_missing ?
+                ws()->CreateTensor(name) : ws()->GetTensor(name));
+        return tensors;
+    }, pybind11::return_value_policy::reference);
+
+    /*!
+     * \brief Run a persistent operator with the resolved tensors
+     *
+     * Return false if the handles were taken in an expired epoch,
+     * the caller should resolve them again.
+     */
+    m.def("RunOperatorHandle", [](
+        const int64_t           epoch,
+        OperatorBase*           op,
+        const vector<Tensor*>&  inputs,
+        const vector<Tensor*>&  outputs,
+        const string&           anchor) {
+        if (epoch != DispatchEpoch()) return false;
+        pybind11::gil_scoped_release g;
+        op->UpdateFrom(inputs, outputs, anchor); op->Run(0);
+        return true;
+    });
+
+    /*! \brief Set the int64 scalar read by the descriptor arguments */
+    m.def("SetArgumentI64", [](
+        const string&           name,
+        const int64_t           value) {
+        Tensor* tensor = ws()->CreateTensor(name);
+        tensor->Reshape({});
+        tensor->mutable_data<int64_t, CPUContext>()[0] = value;
+    });
 }
 
 }  // namespace python
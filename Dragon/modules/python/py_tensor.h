@@ -14,6 +14,7 @@
 #define DRAGON_PYTHON_PY_TENOSR_H_
 
 #include "py_dragon.h"
+#include "utils/dlpack.h"
 
 namespace dragon {
 
@@ -98,30 +99,50 @@ void AddTensorMethods(pybind11::module& m) {
     m.def("TensorFromPyArray", [](
         const string&               name,
         pybind11::object            py_array) {
-        PyArrayObject* array = PyArray_GETCONTIGUOUS(
-            reinterpret_cast<PyArrayObject*>(py_array.ptr()));
+        PyArrayObject* array =
+            reinterpret_cast<PyArrayObject*>(py_array.ptr());
+        vector<int64_t> dims, strides; size_t span;
+        // Borrow the strided array, or a contiguous copy
+        // if the strides could not be expressed in elements
+        if (GetPyArrayLayout(array, &dims, &strides, &span)) {
+            Py_INCREF(array);
+        } else {
+            array = PyArray_GETCONTIGUOUS(array);
+            GetPyArrayLayout(array, &dims, &strides, &span);
+        }
         const TypeMeta& meta = TypeNPYToMeta(PyArray_TYPE(array));
         if (meta.id() == 0) LOG(FATAL) << "Unsupported data type.";
         Tensor* tensor = ws()->CreateTensor(name);
-        tensor->SetMeta(meta);
-        int ndim = PyArray_NDIM(array);
-        npy_intp* npy_dims = PyArray_DIMS(array);
-        vector<int64_t> dims;
-        for (int i = 0; i < ndim; i++) dims.push_back(npy_dims[i]);
-        tensor->Reshape(dims);
         auto* data = static_cast<void*>(PyArray_DATA(array));
-        if (!tensor->has_memory()) {
-            MixedMemory* memory(new MixedMemory());
-            memory->set_cpu_data(data, tensor->nbytes());
-            tensor->set_memory(memory);
+        MixedMemory* memory = nullptr;
+        if (!PyArray_IS_C_CONTIGUOUS(array)) {
+            memory = new MixedMemory();
+            memory->set_cpu_data(data, span * meta.itemsize());
+            Tensor holder;
+            holder.SetMeta(meta);
+            holder.set_memory(memory);
+            tensor->ShareView(holder, 0, dims, strides);
         } else {
-            if (tensor->DECREFPyArray) tensor->DECREFPyArray();
-            tensor->memory()->set_cpu_data(data, tensor->nbytes());
+            tensor->SetMeta(meta);
+            tensor->Reshape(dims);
+            if (!tensor->has_memory() || tensor->offset() > 0 ||
+                    tensor->is_copy_on_write()) {
+                memory = new MixedMemory();
+                memory->set_cpu_data(data, tensor->nbytes());
+                tensor->set_memory(memory);
+            } else {
+                memory = tensor->memory();
+                memory->set_cpu_data(data, tensor->nbytes());
+            }
         }
-        // Follow the codes of PyTorch
-        // Here we bind the DECREF to Tensor
-        // ResetTensor() or ResetWorkspace() can trigger it
-        tensor->DECREFPyArray = [array]()->void { Py_XDECREF(array); };
+        // Bind the DECREF to the memory instead of the tensor,
+        // as the views or fetched arrays may outlive the tensor
+        memory->set_deleter([array]()->void {
+            if (!Py_IsInitialized()) return;
+            PyGILState_STATE state = PyGILState_Ensure();
+            Py_XDECREF(array);
+            PyGILState_Release(state);
+        });
     });
 
     /*! \brief Create a tensor copied from an existing one */
@@ -175,22 +196,37 @@ void AddTensorMethods(pybind11::module& m) {
     m.def("TensorToPyArray", [](
         const string&               name,
         const bool                  readonly) {
-        Tensor* tensor = ws()->GetTensor(name);
-        CHECK_GT(tensor->count(), 0);
-        vector<npy_intp> dims;
-        for (const auto dim : tensor->dims()) dims.push_back(dim);
-        int npy_type = TypeMetaToNPY(tensor->meta());
-        if (npy_type == -1) {
-            LOG(FATAL) << "Tensor(" + tensor->name() + ") "
-                "with dtype." + TypeMetaToString(tensor->meta()) +
-                " is not supported by numpy.";
-        }
-        auto* data = readonly ?
-            const_cast<void*>(tensor->raw_data<CPUContext>()) :
-                tensor->raw_mutable_data<CPUContext>();
-        PyObject* array = PyArray_SimpleNewFromData(
-            tensor->ndim(), dims.data(), npy_type, data);
-        return pybind11::reinterpret_steal<pybind11::object>(array);
+        return pybind11::reinterpret_steal<pybind11::object>(
+            TensorToPyArrayView(ws()->GetTensor(name), readonly));
+    });
+
+    /*! \brief Return a dlpack capsule zero-copied from an existing tensor */
+    m.def("TensorToDLPack", [](const string& name) {
+        DLManagedTensor* managed = TensorToDLPack(ws()->GetTensor(name));
+        PyObject* capsule = PyCapsule_New(managed, "dltensor",
+            [](PyObject* obj)->void {
+                // Release the capsule that is never consumed
+                if (PyCapsule_IsValid(obj, "dltensor")) {
+                    auto* managed = static_cast<DLManagedTensor*>(
+                        PyCapsule_GetPointer(obj, "dltensor"));
+                    managed->deleter(managed);
+                }
+        });
+        return pybind11::reinterpret_steal<pybind11::object>(capsule);
+    });
+
+    /*! \brief Create a tensor zero-copied from a dlpack capsule */
+    m.def("TensorFromDLPack", [](
+        const string&               name,
+        pybind11::object            capsule) {
+        PyObject* obj = capsule.ptr();
+        CHECK(PyCapsule_IsValid(obj, "dltensor"))
+            << "\nExcepted a dlpack capsule that is not consumed.";
+        auto* managed = static_cast<DLManagedTensor*>(
+            PyCapsule_GetPointer(obj, "dltensor"));
+        TensorFromDLPack(managed, ws()->CreateTensor(name));
+        // The deleter is called by the memory from now on
+        PyCapsule_SetName(obj, "used_dltensor");
     });
 
     /*! \brief Create a tensor from the specified filler */
@@ -217,6 +253,7 @@ void AddTensorMethods(pybind11::module& m) {
                 "been registered in the current workspace.";
         }
         ws()->SetTensorAlias(name, alias);
+        InvalidateDispatch();
     });
 
     /*! \brief Return the CXX Tensor reference */
@@ -36,9 +36,21 @@ option['graph_optimization_level'] = 3
 # Whether to share grads
 option['share_grads'] = True
 
+# The planner of recomputing checkpoints
+option['checkpoint_mode'] = None
+option['checkpoint_budget'] = 0
+
+# Whether to offload the activations between the passes
+option['offload'] = False
+option['offload_distance'] = 2
+
 # Optional graph type
 option['graph_type'] = ''
 
+# The micro-batches of pipeline graph
+option['num_micro_batches'] = 1
+option['micro_batch_inputs'] = []
+
 # Whether to log the meta graphs
 option['log_meta_graph'] = False
 
@@ -49,6 +61,9 @@ option['export_meta_graph'] = ''
 # Whether to log the optimized graphs
 option['log_optimized_graph'] = False
 
+# Whether to shard the updates over the data parallel ranks
+option['shard_update'] = False
+
 
 def GetGlobalOptions():
     """Return all the global options.
@@ -187,6 +202,36 @@ def SetGraphType(graph_type=''):
     option['graph_type'] = graph_type
 
 
+def EnablePipeline(num_micro_batches=4, micro_batch_inputs=None):
+    """Enable the pipeline graph globally.
+
+    The operators are partitioned into stages by the first
+    rank of ``mpi_ranks``, and run the micro-batches in 1F1B order.
+
+    Parameters
+    ----------
+    num_micro_batches : int
+        The number of micro-batches of a run.
+    micro_batch_inputs : sequence of (str, Tensor), optional
+        The inputs to split equally along the first axis.
+
+    Returns
+    -------
+    None
+
+    Examples
+    --------
+    >>> y = dragon.ops.FullyConnected([x, W], num_output=10, mpi_ranks=[1])
+
+    """
+    global option
+    option['graph_type'] = 'Pipeline'
+    option['num_micro_batches'] = num_micro_batches
+    option['micro_batch_inputs'] = [
+        e if isinstance(e, str) else e.name
+            for e in (micro_batch_inputs or [])]
+
+
 def SetGraphOptimizationLevel(level=3):
     """Set the default level of graph optimization.
 
@@ -254,6 +299,27 @@ def LogOptimizedGraph(enabled=True):
     option['log_optimized_graph'] = enabled
 
 
+def ShardUpdate(enabled=True):
+    """Enable to shard the updates over the data parallel ranks.
+
+    Each rank will update and hold the optimizer states
+    of a partition of parameters, i.e., the states are
+    reduced by the number of ranks.
+
+    Parameters
+    ----------
+    enabled : boolean
+        Whether to enable sharding.
+
+    Returns
+    -------
+    None
+
+    """
+    global option
+    option['shard_update'] = enabled
+
+
 def ExportMetaGraph(prefix=''):
     """Enable to export all runnable meta graphs into text files.
 
@@ -298,4 +364,86 @@ def SetLoggingLevel(level):
         'ERROR': logging.ERROR,
         'FATAL': logging.FATAL,
         }[level]
-    )
\ No newline at end of file
+    )
+
+
+def GetCPUISA():
+    """Get the instruction set used by the dispatched CPU kernels.
+
+    Returns
+    -------
+    str
+        One of ``default``, ``sse4.2``, ``avx2`` and ``avx512``.
+
+    Notes
+    -----
+    Set the environment variable ``DRAGON_CPU_ISA`` before importing
+    to select a lower instruction set, e.g. for comparing the results.
+
+    """
+    return C.GetCPUISA()
+
+
+def SetScratchLimit(nbytes=0):
+    """Set the max bytes of a scratch arena.
+
+    Each thread holds an arena for every device and stream,
+    requesting more than the limit will raise an error.
+
+    Parameters
+    ----------
+    nbytes : int, optional, default=0
+        The max bytes, ``0`` for unlimited.
+
+    Returns
+    -------
+    None
+
+    """
+    C.SetScratchLimit(nbytes)
+
+
+def GetScratchStats():
+    """Get the statistics of all the scratch arenas.
+
+    Returns
+    -------
+    dict
+        The bytes of ``used``, ``peak`` and ``capacity``.
+
+    """
+    used, peak, capacity = C.GetScratchStats()
+    return {'used': used, 'peak': peak, 'capacity': capacity}
+
+
+def GetPythonOpStats():
+    """Get the time spent by the python operators in seconds.
+
+    The ``gil_wait`` is the time waiting for the GIL before running,
+    and the ``blocked`` is the time the graph waiting for the worker.
+
+    Returns
+    -------
+    dict
+        The ``num_runs``, ``gil_wait``, ``run`` and ``blocked`` of each operator.
+
+    """
+    return {name: {
+        'num_runs': v[0],
+        'gil_wait': v[1],
+        'run': v[2],
+        'blocked': v[3],
+    } for name, v in C.GetPythonOpStats().items()}
+
+
+def GetSpillStats():
+    """Get the statistics of the spill area of offloaded activations.
+
+    Returns
+    -------
+    dict
+        The bytes of ``used``, ``peak`` and ``capacity``.
+
+    """
+    used, peak, capacity = C.GetSpillStats()
+    return {'used': used, 'peak': peak, 'capacity': capacity}
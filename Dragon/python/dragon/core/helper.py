@@ -343,6 +343,20 @@ class OperatorHelper(object):
     def _apply_CTCLoss(cls, arguments, inputs, outputs):
         return cls._apply_SmoothL1Loss(arguments, inputs, outputs)
 
+    @classmethod
+    def _apply_CTCGreedyDecoder(cls, arguments, inputs, outputs):
+        outputs[0].dtype, outputs[1].dtype = 'int64', 'float32'
+        try:
+            outputs[0].shape = [inputs[0].shape[1], inputs[0].shape[0]]
+            outputs[1].shape = [inputs[0].shape[1]]
+        except:
+            pass
+        return outputs
+
+    @classmethod
+    def _apply_CTCBeamSearchDecoder(cls, arguments, inputs, outputs):
+        return cls._apply_CTCGreedyDecoder(arguments, inputs, outputs)
+
     ###############################################
     #                                             #
     #                    Misc                     #
@@ -0,0 +1,112 @@
+# ------------------------------------------------------------
+# Copyright (c) 2017-present, SeetaTech, Co.,Ltd.
+#
+# Licensed under the BSD 2-Clause License.
+# You should have received a copy of the BSD 2-Clause License
+# along with the software. If not, See,
+#
+#      <https://opensource.org/licenses/BSD-2-Clause>
+#
+# ------------------------------------------------------------
+
+"""List the shared memory collective of local processes.
+
+It is an alternative of MPI for the data parallelism on a single node.
+
+"""
+
+from __future__ import absolute_import
+from __future__ import division
+from __future__ import print_function
+
+
+_GLOBAL_SHM_NAME = None
+_GLOBAL_SHM_SIZE = 1
+_GLOBAL_SHM_RANK = 0
+
+
+def Init(name, size, rank):
+    """Init the shared memory env.
+
+    The processes sharing the ``name`` should be launched on the same node,
+    and the ``name`` should be unique among the running jobs.
+
+    Parameters
+    ----------
+    name : str
+        The name of shared memory segment.
+    size : int
+        The number of processes.
+    rank : int
+        The rank of current process.
+
+    Returns
+    -------
+    None
+
+    Examples
+    --------
+    >>> import dragon.core.shm as shm
+    >>> shm.Init('my_job', size=4, rank=int(os.environ['LOCAL_RANK']))
+
+    """
+    if '/' in name:
+        raise ValueError('The name should not contain "/".')
+    if rank < 0 or rank >= size:
+        raise ValueError('Excepted rank in [0, {}), got {}.'.format(size, rank))
+    global _GLOBAL_SHM_NAME, _GLOBAL_SHM_SIZE, _GLOBAL_SHM_RANK
+    _GLOBAL_SHM_NAME, _GLOBAL_SHM_SIZE, _GLOBAL_SHM_RANK = name, size, rank
+
+
+def Is_Init():
+    """Whether the shared memory env has initialized.
+
+    Returns
+    -------
+    boolean
+
+    """
+    return _GLOBAL_SHM_NAME is not None
+
+
+def Rank():
+    """The rank of current process.
+
+    Returns
+    -------
+    int
+        The rank.
+
+    """
+    return _GLOBAL_SHM_RANK
+
+
+def Size():
+    """The number of processes.
+
+    Returns
+    -------
+    int
+        The size.
+
+    """
+    return _GLOBAL_SHM_SIZE
+
+
+def GetArguments():
+    """Return the arguments of collective operators.
+
+    Returns
+    -------
+    dict
+        The arguments.
+
+    """
+    if not Is_Init():
+        raise RuntimeError('The shared memory env is not initialized.')
+    return {
+        'shm_name': _GLOBAL_SHM_NAME,
+        'shm_size': _GLOBAL_SHM_SIZE,
+        'shm_rank': _GLOBAL_SHM_RANK,
+        'root': 0,
+    }
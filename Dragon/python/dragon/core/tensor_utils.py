@@ -160,14 +160,15 @@ def SetPyArray(tensor, array):
 def ToPyArray(tensor, readonly=False):
     """Create a Array from a existing Tensor.
 
-    Note that memory of Array are *zero-copied*.
+    Note that memory of Array are *zero-copied*,
+    and kept alive by the array even if the tensor is reset.
 
     Parameters
     ----------
     tensor : Tensor or str
         The input tensor.
     readonly : boolean
-        Whether to sync the contents with device.
+        Whether to return a readonly array without mutating the contents.
 
     Returns
     -------
@@ -178,6 +179,51 @@ def ToPyArray(tensor, readonly=False):
     return dragon.C.TensorToPyArray(_stringify_tensor(tensor), readonly)
 
 
+def FromDLPack(dlpack, name=None):
+    """Create a Tensor from a DLPack capsule.
+
+    Note that memory of Tensor are *zero-copied*,
+    and the producer is released with the memory.
+
+    Parameters
+    ----------
+    dlpack : PyCapsule or object
+        The capsule, or a object providing ``__dlpack__``.
+    name : str
+        The optional tensor name.
+
+    Returns
+    -------
+    Tensor
+        The tensor sharing the memory with the capsule.
+
+    """
+    tensor = _try_get_tensor(name)
+    if hasattr(dlpack, '__dlpack__'): dlpack = dlpack.__dlpack__()
+    dragon.C.TensorFromDLPack(_stringify_tensor(tensor), dlpack)
+    return tensor
+
+
+def ToDLPack(tensor):
+    """Create a DLPack capsule from a existing Tensor.
+
+    Note that memory of capsule are *zero-copied*,
+    on the device holding the latest contents.
+
+    Parameters
+    ----------
+    tensor : Tensor or str
+        The input tensor.
+
+    Returns
+    -------
+    PyCapsule
+        The capsule sharing the memory with original tensor.
+
+    """
+    return dragon.C.TensorToDLPack(_stringify_tensor(tensor))
+
+
 def GetStorage(tensor):
     """Get the storage of a existing Tensor.
 
@@ -89,6 +89,31 @@ def MoveWorkspace(target_ws, source_ws):
     _C.MoveWorkspace(target_ws, source_ws)
 
 
+def ShareWorkspace(target_ws, source_ws):
+    """Share the tensors of source workspace into the target workspace.
+
+    The memory is shared by copy-on-write, i.e., it will be copied
+    only if either workspace mutates it.
+
+    Use this to run multiple replicas with the frozen weights.
+
+    Parameters
+    ----------
+    target_ws : str
+        The name of the target workspace.
+    source_ws : str
+        The name of the source workspace.
+
+    Returns
+    -------
+    None
+
+    """
+    if target_ws == '' or source_ws == '':
+        raise ValueError('The target or source name can not be empty.')
+    _C.ShareWorkspace(target_ws, source_ws)
+
+
 def ResetWorkspace(workspace_name=''):
     """Reset the specific workspace.
 
@@ -288,13 +313,18 @@ def SetTensorAlias(tensor, alias):
     return _C.SetTensorAlias(_stringify_tensor(tensor), alias)
 
 
-def FetchTensor(tensor):
+def FetchTensor(tensor, copy=True):
     """Fetch the values of given tensor.
 
+    Set ``copy`` to ``False`` to return a readonly array
+    sharing the memory, which is kept alive by the array.
+
     Parameters
     ----------
     tensor : Tensor or str
         The tensor to fetch.
+    copy : boolean, optional, default=True
+        Whether to copy the values.
 
     Returns
     -------
@@ -302,7 +332,7 @@ def FetchTensor(tensor):
         The values copied from the backend.
 
     """
-    return _C.FetchTensor(_stringify_tensor(tensor))
+    return _C.FetchTensor(_stringify_tensor(tensor), copy)
 
 
 def FeedTensor(tensor, array, force_cpu=False, dtype=None):
@@ -434,7 +464,12 @@ def RunGraph(
         else: return [outputs[i].get_value() for i in range(len(outputs))]
 
 
-def FlowGradients(inputs, targets, input_grads=None, ignored_grads=None):
+def FlowGradients(
+    inputs, targets,
+        input_grads=None,
+            ignored_grads=None,
+                return_defs=False,
+):
     """Compute the gradients of given input flows.
 
     Parameters
@@ -447,10 +482,13 @@ def FlowGradients(inputs, targets, input_grads=None, ignored_grads=None):
         The input grads.
     ignored_grads : sequence of str or None
         The grads that are explicitly ignored.
+    return_defs : boolean
+        Whether to return the serialized gradient defs.
 
     Returns
     -------
-    None
+    None or list of bytes
+        The gradient defs before sharing if ``return_defs``.
 
     """
     option = GetGlobalOptions()
@@ -459,11 +497,14 @@ def FlowGradients(inputs, targets, input_grads=None, ignored_grads=None):
         if (option['log_optimized_graph'] or
             option['log_meta_graph']) else False
 
-    _C.FlowGradients(
+    grad_defs = _C.FlowGradients(
         inputs, targets,
             input_grads if input_grads else [],
                 ignored_grads if ignored_grads else [],
-                    option['share_grads'], required_logging)
+                    option['share_grads'], required_logging,
+                        return_defs)
+
+    return grad_defs if return_defs else None
 
 
 def LogMetaGraph(graph_def):
@@ -51,6 +51,94 @@ def IsGradsShared():
     return option['share_grads']
 
 
+def Checkpoint(mode='SQRT', budget=None):
+    """Select the activations to recompute automatically.
+
+    ``SQRT`` keeps every *sqrt(N)* activations, while ``DP`` keeps
+    the ones minimizing the recomputing within the ``budget`` bytes.
+
+    The recomputing is estimated by the FLOPs of operators.
+    If the sizes are unknown when creating the graph, ``DP`` runs
+    the first step with ``SQRT``, then replans with the recorded sizes.
+
+    Parameters
+    ----------
+    mode : {'SQRT', 'DP'} or None, optional
+        The planning mode, ``None`` to disable.
+    budget : int, optional
+        The bytes of activations to keep for ``DP``.
+
+    Returns
+    -------
+    None
+
+    Examples
+    --------
+    >>> import dragon.memonger as opt
+    >>> opt.Checkpoint('DP', budget=2 << 30)
+
+    """
+    from dragon.config import option
+    if mode is not None and mode not in ('SQRT', 'DP'):
+        raise ValueError('Unknown checkpoint mode: ' + str(mode))
+    option['checkpoint_mode'] = mode
+    option['checkpoint_budget'] = budget if budget else 0
+
+
+def GetCheckpointReport(function):
+    """Return the predicted trade-off of the checkpoints.
+
+    Parameters
+    ----------
+    function : theano.function
+        The compiled function.
+
+    Returns
+    -------
+    str
+        The peak memory versus recomputing of the plans.
+
+    """
+    from dragon.core import workspace
+    return workspace.FetchTensor(
+        '/graph_def/checkpoints/' + function.graph_name)[0]
+
+
+def Offload(enabled=True, distance=2):
+    """Move the activations to host memory between the passes.
+
+    The activations are copied to the pinned memory (CUDA) or
+    an unlinked file under ``DRAGON_SPILL_DIR`` (CPU) after their
+    last forward use, and copied back ``distance`` operators before
+    the first gradient operator reading them.
+
+    It is ignored if the graph recomputes any activations.
+
+    The copies of CUDA tensors are experimental, which are
+    not covered by the tests yet.
+
+    Parameters
+    ----------
+    enabled : boolean
+        Whether to offload the activations.
+    distance : int, optional, default=2
+        The number of operators to overlap the prefetching.
+
+    Returns
+    -------
+    None
+
+    Examples
+    --------
+    >>> import dragon.memonger as opt
+    >>> opt.Offload(distance=4)
+
+    """
+    from dragon.config import option
+    option['offload'] = enabled
+    option['offload_distance'] = distance
+
+
 def Drop(op_func, *args, **kwargs):
     """Drop(Share) the inputs for outputs.
 
@@ -197,7 +197,7 @@ def Reduce(inputs, axes=None, operation='SUM', keep_dims=False, **kwargs):
         The input tensor.
     axes : int or sequence of int, optional
         The axes to reduce.
-    operation : {'SUM', 'MEAN'}, optional
+    operation : {'SUM', 'MEAN', 'MAX', 'MIN', 'PROD', 'L1', 'L2', 'LOGSUMEXP'}, optional
         The operation.
     keep_dims : bool, optional
         Whether to keep dims after reducing.
@@ -327,7 +327,73 @@ def CTCLoss(
     -----
     The magnitude of loss is related to the ``sequence length``.
 
+    The loss is averaged over the batch.
+
     """
     arguments = ParseArgs(locals())
     if use_softmax: arguments['inputs'][0] = Softmax(arguments['inputs'][0], axis=2)
-    return Tensor.CreateOperator('CTCLoss', **arguments)
\ No newline at end of file
+    return Tensor.CreateOperator('CTCLoss', **arguments)
+
+
+@OpSchema.Inputs(1)
+def CTCGreedyDecoder(
+    inputs, blank_first=True, merge_repeated=True,
+        padding_mask=-1, **kwargs):
+    """Decode the most probable class of each step for the ctc.
+
+    The data format of inputs should be *[T, N, C]*.
+
+    The decoded labels of *[N, T]* are padded with ``padding_mask``.
+
+    **Type Constraints**: *float32*
+
+    Parameters
+    ----------
+    inputs : Tensor
+        The probabilities.
+    blank_first : bool, optional
+        Whether to put the blank at ``0``.
+    merge_repeated : bool, optional
+        Whether to merge the repeated labels.
+    padding_mask : int, optional
+        The mask for padding the decoded labels.
+
+    Returns
+    -------
+    sequence of Tensor
+        The decoded labels and the log probabilities.
+
+    """
+    return Tensor.CreateOperator('CTCGreedyDecoder', num_outputs=2, **ParseArgs(locals()))
+
+
+@OpSchema.Inputs(1)
+def CTCBeamSearchDecoder(
+    inputs, blank_first=True, beam_width=10,
+        padding_mask=-1, **kwargs):
+    """Decode the most probable labels with the prefix beam search for the ctc.
+
+    The data format of inputs should be *[T, N, C]*.
+
+    The decoded labels of *[N, T]* are padded with ``padding_mask``.
+
+    **Type Constraints**: *float32*
+
+    Parameters
+    ----------
+    inputs : Tensor
+        The probabilities.
+    blank_first : bool, optional
+        Whether to put the blank at ``0``.
+    beam_width : int, optional
+        The number of prefixes to keep.
+    padding_mask : int, optional
+        The mask for padding the decoded labels.
+
+    Returns
+    -------
+    sequence of Tensor
+        The decoded labels and the log probabilities.
+
+    """
+    return Tensor.CreateOperator('CTCBeamSearchDecoder', num_outputs=2, **ParseArgs(locals()))
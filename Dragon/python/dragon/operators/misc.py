@@ -56,7 +56,7 @@ def Cast(inputs, dtype='float32', inplace=False, **kwargs):
     return Tensor.CreateOperator('Cast', **arguments)
 
 
-def Run(inputs, module, op, param_str='', num_outputs=1, **kwargs):
+def Run(inputs, module, op, param_str='', num_outputs=1, run_async=True, **kwargs):
     """Run a custom operator. (Without GradientFlow)
 
     **Type Constraints**: *None*
@@ -73,6 +73,8 @@ def Run(inputs, module, op, param_str='', num_outputs=1, **kwargs):
         The str describing parameters.
     num_outputs : int
         The number of num_outputs.
+    run_async : bool, optional, default=True
+        Whether to run in the python worker within the graph.
 
     Returns
     -------
@@ -93,7 +95,7 @@ def Run(inputs, module, op, param_str='', num_outputs=1, **kwargs):
     return Tensor.CreateOperator('Run', **ParseArgs(locals()))
 
 
-def Template(inputs, module, op, param_str='', num_outputs=1, **kwargs):
+def Template(inputs, module, op, param_str='', num_outputs=1, run_async=True, **kwargs):
     """Run a custom operator. (With GradientFlow)
 
     **Type Constraints**: *None*
@@ -110,6 +112,8 @@ def Template(inputs, module, op, param_str='', num_outputs=1, **kwargs):
         The str describing parameters.
     num_outputs : int
         The number of num_outputs.
+    run_async : bool, optional, default=True
+        Whether to run in the python worker within the graph.
 
     Returns
     -------
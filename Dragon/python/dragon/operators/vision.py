@@ -100,11 +100,13 @@ def Conv2d(
 @OpSchema.Inputs(2, 3)
 def DepthwiseConv2d(
     inputs, num_output, kernel_shape=3, strides=1, pads=0,
-        padding='VALID', data_format='NCHW', **kwargs):
+        padding='VALID', data_format='NCHW', activation=None, **kwargs):
     """Depthwise 2D Convolution. `[Chollet, 2016] <https://arxiv.org/abs/1610.02357>`_.
 
     Set ``padding`` to *VALID* will use the value of ``pads``.
 
+    Set ``activation`` to *Relu6* will fuse it after the bias.
+
     **Type Constraints**: *float32*
 
     Parameters
@@ -123,6 +125,8 @@ def DepthwiseConv2d(
         The padding algorithm.
     data_format : {'NCHW', 'NHWC'}, optional
         The data_format.
+    activation : {None, 'Relu6'}, optional
+        The fused activation.
 
     Returns
     -------
@@ -136,6 +140,8 @@ def DepthwiseConv2d(
         raise ValueError('Unsupported padding algorithm: {}'.format(padding))
     if data_format not in ('NCHW', 'NHWC'):
         raise ValueError('Unsupported data format: {}'.format(data_format))
+    if activation not in (None, 'Relu6'):
+        raise ValueError('Unsupported activation: {}'.format(activation))
 
     for key in ('kernel_shape', 'strides', 'pads', 'dilations'):
         if key == 'pads': arguments[key] = _normalize_pads(arguments[key], 2)
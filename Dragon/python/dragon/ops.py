@@ -82,6 +82,8 @@ L2Loss = loss_ops.L2Loss
 SigmoidFocalLoss = loss_ops.SigmoidFocalLoss
 SoftmaxFocalLoss = loss_ops.SoftmaxFocalLoss
 CTCLoss = loss_ops.CTCLoss
+CTCGreedyDecoder = loss_ops.CTCGreedyDecoder
+CTCBeamSearchDecoder = loss_ops.CTCBeamSearchDecoder
 
 # Arithmetic
 Add = math_ops.Add
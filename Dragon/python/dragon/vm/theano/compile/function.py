@@ -13,7 +13,9 @@ import os
 import copy
 import numpy as np
 
+import dragon.config as config
 import dragon.core.mpi as mpi
+import dragon.core.shm as shm
 import dragon.core.workspace as ws
 import dragon.core.logging as logging
 import dragon.proto.dragon_pb2 as pb
@@ -114,8 +116,16 @@ def GraphDef_Update(graph_def, updater):
             parallel_arguments['comm'], parallel_arguments['group'] \
                 = mpi.CreateGroup(root=group[0], incl=group)
             parallel_arguments['root'] = group[0]
-        for k, v in parallel_arguments.items():
-            graph_def.arg.add().CopyFrom(MakeArgument(k, v))
+    elif shm.Is_Init():
+        parallel_arguments = shm.GetArguments()
+        parallel_arguments['parallel_mode'] = 'SHM'
+
+    if len(parallel_arguments) > 0 and \
+            config.GetGlobalOptions()['shard_update']:
+        parallel_arguments['shard_update'] = True
+
+    for k, v in parallel_arguments.items():
+        graph_def.arg.add().CopyFrom(MakeArgument(k, v))
 
     for e in updater._param_group:
         pair, arguments = e
@@ -147,12 +157,31 @@ def GraphDef_Opt(graph_def):
 
     `memonger.share_grads(*args, **kwargs)`_ - How the enable gradients sharing.
 
+    `memonger.Checkpoint(*args, **kwargs)`_ - How to enable the checkpoints.
+
+    `memonger.Offload(*args, **kwargs)`_ - How to enable the offloading.
+
     """
     from dragon.config import option
     OX = option['graph_optimization_level']
     if not option['share_grads'] and OX >= 3: OX = 2
     graph_def.arg.add().CopyFrom(MakeArgument('optimization_level', OX))
+    if option['checkpoint_mode'] is not None and OX >= 3:
+        graph_def.arg.add().CopyFrom(MakeArgument(
+            'checkpoint_mode', option['checkpoint_mode']))
+        graph_def.arg.add().CopyFrom(MakeArgument(
+            'checkpoint_budget', option['checkpoint_budget']))
+    if option['offload'] and OX >= 3:
+        graph_def.arg.add().CopyFrom(MakeArgument('offload', 1))
+        graph_def.arg.add().CopyFrom(MakeArgument(
+            'offload_distance', option['offload_distance']))
     graph_def.graph_type = option['graph_type']
+    if option['graph_type'] == 'Pipeline':
+        graph_def.arg.add().CopyFrom(MakeArgument(
+            'num_micro_batches', option['num_micro_batches']))
+        if len(option['micro_batch_inputs']) > 0:
+            graph_def.arg.add().CopyFrom(MakeArgument(
+                'micro_batch_inputs', option['micro_batch_inputs']))
 
 
 def GraphDef_Device(graph_def):
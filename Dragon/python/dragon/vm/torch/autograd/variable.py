@@ -19,6 +19,7 @@ import dragon.core.tensor_utils as tensor_utils
 import dragon.core.workspace as ws
 
 from dragon.vm.torch.tensor import Tensor
+from dragon.vm.torch.jit import get_tracer
 from dragon.vm.torch.pool import TensorPool, OperatorPool
 
 
@@ -60,7 +61,10 @@ def backward(self, gradient=None):
         input_grads.append(self.name + '_grad')
 
     # 3. Flow or Flow or Flow
-    ws.FlowGradients(forward_ops, targets, input_grads, ignored_grads)
+    tracer = get_tracer()
+    grad_defs = ws.FlowGradients(forward_ops, targets, input_grads,
+        ignored_grads, return_defs=tracer is not None)
+    if tracer is not None: tracer.record_gradients(grad_defs)
 
     # 4. Release resources
     # We should release both the operator handles and tensors
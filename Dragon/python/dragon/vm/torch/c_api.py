@@ -13,7 +13,6 @@ from __future__ import absolute_import
 from __future__ import division
 from __future__ import print_function
 
-import copy
 import numpy
 import importlib
 
@@ -36,7 +35,7 @@ class device(object):
         self.type, self.index = type, index
 
     def copy(self):
-        return copy.deepcopy(self)
+        return device(self.type, self.index)
 
     def __eq__(self, other):
         return self.type == other.type and \
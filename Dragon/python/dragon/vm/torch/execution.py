@@ -33,12 +33,61 @@ import dragon.import_c_api as C
 from dragon.config import option
 
 from .c_api import device as _Device
-from .jit import JITRecorder, is_jit_enforced
+from .jit import JITRecorder, is_jit_enforced, get_tracer
 from .autograd.grad_mode import is_grad_enabled
 from .tensor import _RuntimeTensor
 from .pool import TensorPool
 
 
+class _DispatchCache(object):
+    """Cache the handles of operators and tensors for the eager dispatch.
+
+    The handles are resolved by name only once, and
+    they expire once the backend bumps its dispatch epoch,
+    i.e., the workspace is switched, reset or aliased.
+
+    """
+    epoch = -1
+    operators = {}
+    tensors = {}
+
+    @classmethod
+    def refresh(cls):
+        cls.epoch = C.DispatchEpoch()
+        cls.operators.clear()
+        cls.tensors.clear()
+
+    @classmethod
+    def get_tensors(cls, names, create_if_missing):
+        handles = [cls.tensors.get(name, None) for name in names]
+        if None in handles:
+            # Resolve the missing ones in a single call
+            missing = [name for name, handle in
+                zip(names, handles) if handle is None]
+            cls.tensors.update(zip(missing, C.GetTensorHandles(
+                missing, create_if_missing)))
+            handles = [cls.tensors[name] for name in names]
+        return handles
+
+
+def _RunHandle(persistent_key, op_name, inputs_name, outputs_name, make_def):
+    """Run the persistent operator without serializing the def."""
+    cache = _DispatchCache
+    for _ in range(2):
+        handle = cache.operators.get(persistent_key, None)
+        if handle is None:
+            handle = C.CreateOperatorHandle(make_def())
+            cache.operators[persistent_key] = handle
+        if C.RunOperatorHandle(cache.epoch, handle,
+                cache.get_tensors(inputs_name, False),
+                    cache.get_tensors(outputs_name, True), op_name):
+            return
+        # The handles are expired, resolve them again
+        cache.refresh()
+    raise RuntimeError('Failed to dispatch the operator: {}.'
+        .format(persistent_key))
+
+
 def RunOperator(
     inputs, outputs, meta,
         auto_grad=True,
@@ -74,8 +123,13 @@ def RunOperator(
     # Key + Inputs + Outputs => Op
     op_name = 'runtime'
     persistent_key, meta_op = meta
-    op = C.OperatorDef(); op.CopyFrom(meta_op)
-    op.input, op.output = inputs_name, outputs_name
+    verbose = option['log_optimized_graph'] or option['log_meta_graph']
+    op = None
+
+    def _make_def():
+        op = C.OperatorDef(); op.CopyFrom(meta_op)
+        op.input, op.output = inputs_name, outputs_name
+        return op
 
     # Auto-Grad
     if len(inputs) > 0 and auto_grad:
@@ -90,6 +144,7 @@ def RunOperator(
                         input._ignored_grads)
             recorder = JITRecorder()
             recorder.merge(input_recorders)
+            op = _make_def()
             op_name = recorder.append(op)
             op.name = op_name
             for ix in range(len(outputs)):
@@ -105,10 +160,19 @@ def RunOperator(
     # Callback on Run
     if callback_on_run: callback_on_run(op_name)
 
+    # Trace
+    tracer = get_tracer()
+    if tracer is not None:
+        if op is None: op = _make_def(); op.name = op_name
+        tracer.record_operator(op, op_name, inputs + outputs)
+
     # Run
-    dg.workspace.RunOperator(op,
-        verbose=option['log_optimized_graph'] or
-                option['log_meta_graph'])
+    if verbose:
+        dg.workspace.RunOperator(
+            op if op else _make_def(), verbose=True)
+    else:
+        _RunHandle(persistent_key, op_name,
+            inputs_name, outputs_name, _make_def)
 
     # Returns
     if len(outputs) > 1: return outputs
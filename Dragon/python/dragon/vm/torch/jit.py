@@ -9,17 +9,46 @@
 #
 # ------------------------------------------------------------
 
-"""A simple JIT expressions recorder."""
+"""A simple JIT expressions recorder.
+
+Besides the recorder driving the auto-grad, ``trace`` captures
+the executed operators of one step into a static graph,
+and replays it with a single ``RunGraph`` later.
+
+"""
 
 from __future__ import absolute_import
 from __future__ import division
 from __future__ import print_function
 
+import re
+import itertools
+
+import six
+import dragon
+import dragon.import_c_api as C
+import dragon.proto.dragon_pb2 as pb
+
+from dragon.config import option
+from dragon.core import proto_utils, logging
 from dragon.vm.torch.pool import OperatorPool
 
 
 _ENFORCE_JIT_TRACER = False
 
+_ACTIVE_STEP_TRACER = None
+
+# The max number of traces to find two consecutive matched ones
+_MAX_TRACES_PER_ENTRY = 4
+
+# The runtime tensors will be reused by the pool after a step,
+# the traced graph should rename them to the private ones
+_RUNTIME_TENSOR = re.compile(
+    r'^(\$\{POOL\}/\$\{(?:JOIN|DETACH|REFERENCE)\}/Tensor_\d+)(.*)$')
+
+# The suffixed names of the pooled tensors, e.g. the gradients of inputs
+_POOL_TENSOR = re.compile(r'^(\$\{POOL\}/\$\{\w+\}/Tensor_\d+)(.+)$')
+
 
 def _Incrementer():
     i = 0  # Python returns BigInteger
@@ -86,4 +115,375 @@ class enforce_jit(object):
 
 
 def is_jit_enforced():
-    return _ENFORCE_JIT_TRACER
\ No newline at end of file
+    return _ENFORCE_JIT_TRACER
+
+
+def get_tracer():
+    """Return the active step tracer, or ``None``."""
+    return _ACTIVE_STEP_TRACER
+
+
+class StepTracer(object):
+    """Capture the executed operators of a step into a tape.
+
+    The forward operators are captured by ``RunOperator``,
+    and the gradient operators by ``backward``. The descriptor
+    arguments and the feeding hooks are attached as well.
+
+    The step is marked dynamic once the values of tensors
+    are read back, as the python branches may depend on them.
+
+    """
+    def __init__(self):
+        self.tape, self.hooks, self.refs = [], [], []
+        self._arguments = []
+        self.dynamic = False
+
+    def record_value_read(self):
+        self.dynamic = True
+
+    def record_argument(self, name, value):
+        self._arguments.append((name, value))
+
+    def record_operator(self, op_def, anchor, tensors):
+        self.tape.append((op_def.SerializeAs(), anchor, self._arguments))
+        self._arguments = []
+        # Hold the tensors, their names should not be reused
+        self.refs.extend([e for e in tensors
+            if not isinstance(e, six.string_types)])
+
+    def record_gradients(self, grad_defs):
+        for grad_def in grad_defs:
+            self.tape.append((grad_def, None, []))
+
+    def add_replay_hook(self, func, *args):
+        self.hooks.append((func, args))
+
+    def __enter__(self):
+        global _ACTIVE_STEP_TRACER
+        _ACTIVE_STEP_TRACER = self
+        return self
+
+    def __exit__(self, *args):
+        global _ACTIVE_STEP_TRACER
+        _ACTIVE_STEP_TRACER = None
+
+
+class _Renamer(object):
+    """Rename the runtime tensors and anchors of a tape.
+
+    Each time a runtime tensor is overwritten by an operator
+    which does not read it, a new version is made.
+    So that the graph optimizer never sees a recycled name.
+
+    """
+    def __init__(self, prefix, inputs):
+        self.prefix = prefix
+        self.tensors, self.anchors = {}, {}
+        self.tensor_counter = itertools.count()
+        self.anchor_counter = itertools.count()
+        for i, name in enumerate(inputs):
+            self.tensors[name] = '{}/input:{}'.format(prefix, i)
+
+    def get(self, name):
+        if name in self.tensors: return self.tensors[name]
+        match = _POOL_TENSOR.match(name)
+        if match and match.group(1) in self.tensors:
+            return self.tensors[match.group(1)] + match.group(2)
+        return name
+
+    def produce(self, name, inputs):
+        if name not in inputs:
+            match = _RUNTIME_TENSOR.match(name)
+            if name in self.tensors or \
+                    (match and not match.group(2)):
+                self.tensors[name] = '{}/tensor:{}'.format(
+                    self.prefix, next(self.tensor_counter))
+        return self.get(name)
+
+    def anchor(self, name, forward):
+        if forward:
+            self.anchors[name] = '{}/op:{}'.format(
+                self.prefix, next(self.anchor_counter))
+        return self.anchors.get(name, name)
+
+
+def _compile_tape(tracer, prefix, inputs):
+    """Rename the tape into the defs of a graph.
+
+    Returns
+    -------
+    tuple
+        The renamer, the operator defs and the descriptor arguments.
+
+    """
+    renamer = _Renamer(prefix, inputs)
+    op_defs, arguments = [], []
+    for serialized, anchor, op_arguments in tracer.tape:
+        op_def = pb.OperatorDef()
+        op_def.ParseFromString(serialized)
+        forward = anchor is not None
+        old_name = op_def.name
+        op_def.name = renamer.anchor(old_name, forward)
+        op_def.ClearField('uid')
+        for arg in op_def.arg:
+            if arg.name == 'anchor':
+                arg.s = _to_bytes(renamer.anchor(_to_str(arg.s), False))
+        op_inputs = list(op_def.input)
+        op_def.input[:] = [renamer.get(e) for e in op_inputs]
+        op_def.output[:] = [renamer.produce(e, op_inputs)
+                            for e in op_def.output]
+        for name, value in op_arguments:
+            if name.startswith(old_name + '/'):
+                name = op_def.name + name[len(old_name):]
+            arguments.append((name, value))
+        op_defs.append(op_def)
+    return renamer, op_defs, arguments
+
+
+def _to_str(value):
+    return value if isinstance(value, str) else value.decode()
+
+
+def _to_bytes(value):
+    return value.encode() if six.PY3 else value
+
+
+def _flatten(structure, tensors):
+    """Replace the tensors by their indices."""
+    from dragon.vm.torch.tensor import Tensor
+    if isinstance(structure, Tensor):
+        tensors.append(structure)
+        return _Placeholder(len(tensors) - 1)
+    if isinstance(structure, (list, tuple)):
+        return type(structure)(_flatten(e, tensors) for e in structure)
+    return structure
+
+
+def _unflatten(structure, tensors):
+    """Replace the indices by the tensors."""
+    if isinstance(structure, _Placeholder):
+        return tensors[structure.index]
+    if isinstance(structure, (list, tuple)):
+        return type(structure)(_unflatten(e, tensors) for e in structure)
+    return structure
+
+
+class _Placeholder(object):
+    def __init__(self, index):
+        self.index = index
+
+
+class _TracedEntry(object):
+    """The trace and graph for a guard key."""
+    def __init__(self, prefix):
+        self.prefix = prefix
+        self.fingerprint = None
+        self.graph_name = None
+        self.dynamic = False
+        self.num_traces = 0
+        self.num_replays = 0
+
+
+class TracedFunction(object):
+    """Run a step eagerly until its traces match, then replay it as a graph.
+
+    The step is traced on each call, until two consecutive traces have
+    the same operators, arguments and names, then the graph is compiled.
+    The first steps may differ, e.g., the gradients are not zeroed
+    before they are created. If no traces matched in a few calls, the step
+    is considered to have dynamic control flows and always runs eagerly.
+
+    The graphs are guarded by the shapes, types and devices of input tensors,
+    and the values of other arguments. A new key will trace again,
+    until ``max_traces`` graphs have been compiled.
+
+    The step reading the values of tensors, e.g. by ``numpy()`` or ``float()``,
+    always runs eagerly, as the python control flows may depend on them.
+    Besides, every ``check_interval`` replays, the step runs eagerly and
+    is traced again instead, if the operators differ from the graph,
+    the step will always run eagerly from then on.
+
+    """
+    _UID_GENERATOR = itertools.count()
+
+    def __init__(self, func, max_traces=8, check_interval=100):
+        self._func = func
+        self._max_traces = max_traces
+        self._check_interval = check_interval
+        self._uid = next(self._UID_GENERATOR)
+        self._entries = {}
+        self._epoch = None
+
+    def _guard_key(self, args, kwargs):
+        from dragon.vm.torch.tensor import Tensor
+        from dragon.vm.torch.autograd.grad_mode import is_grad_enabled
+        key, inputs = [is_grad_enabled()], []
+        for e in list(args) + [kwargs[k] for k in sorted(kwargs)]:
+            if isinstance(e, Tensor):
+                if e.requires_grad:
+                    # Parameters should be always the same tensors
+                    key.append(('P', e.name))
+                else:
+                    key.append(('T', tuple(e.shape),
+                        e.dtype, str(e.device)))
+                    inputs.append(e)
+            elif e is None or isinstance(e,
+                    (bool, float, six.integer_types, six.string_types)):
+                key.append(('V', e))
+            else:
+                return None, None
+        return tuple(key + sorted(kwargs)), inputs
+
+    def __call__(self, *args, **kwargs):
+        key, inputs = self._guard_key(args, kwargs)
+        if key is None or get_tracer() is not None:
+            # Unknown arguments, or nested in another trace
+            return self._func(*args, **kwargs)
+        epoch = C.DispatchEpoch()
+        if epoch != self._epoch:
+            # The workspace has changed, the graphs are gone
+            self._entries.clear(); self._epoch = epoch
+        entry = self._entries.get(key, None)
+        if entry is None:
+            if len(self._entries) >= self._max_traces:
+                return self._func(*args, **kwargs)
+            entry = self._entries[key] = _TracedEntry(
+                '${{TRACE}}/{}/{}'.format(self._uid, len(self._entries)))
+        if entry.graph_name is not None:
+            entry.num_replays += 1
+            if self._check_interval > 0 and \
+                    entry.num_replays % self._check_interval == 0:
+                return self._check(entry, inputs, args, kwargs)
+            return self._replay(entry, inputs)
+        if entry.dynamic:
+            return self._func(*args, **kwargs)
+        return self._trace(entry, inputs, args, kwargs)
+
+    def _record(self, entry, inputs, args, kwargs):
+        """Run the step eagerly, and return the trace and fingerprint."""
+        with StepTracer() as tracer:
+            outputs = self._func(*args, **kwargs)
+        input_names = [e.name for e in inputs]
+        renamer, op_defs, arguments = \
+            _compile_tape(tracer, entry.prefix, input_names)
+        fingerprint = [e.SerializeToString() for e in op_defs]
+        fingerprint.append(str(arguments).encode())
+        return tracer, outputs, renamer, op_defs, arguments, fingerprint
+
+    def _trace(self, entry, inputs, args, kwargs):
+        tracer, outputs, renamer, op_defs, arguments, fingerprint = \
+            self._record(entry, inputs, args, kwargs)
+        if tracer.dynamic:
+            entry.dynamic = True
+            logging.warning('The traced step reads the values of tensors, '
+                'it will run eagerly.')
+        elif entry.fingerprint != fingerprint:
+            entry.fingerprint = fingerprint
+            entry.num_traces += 1
+            if entry.num_traces >= _MAX_TRACES_PER_ENTRY:
+                entry.dynamic = True
+                logging.warning('The traced step changes between calls, '
+                    'it will run eagerly.')
+        elif len(op_defs) > 0:
+            self._compile(entry, tracer, renamer, op_defs,
+                arguments, inputs, outputs)
+        return outputs
+
+    def _check(self, entry, inputs, args, kwargs):
+        # Run eagerly instead of replaying, the outputs are always right
+        tracer, outputs, _, _, _, fingerprint = \
+            self._record(entry, inputs, args, kwargs)
+        if tracer.dynamic or entry.fingerprint != fingerprint:
+            entry.dynamic, entry.graph_name = True, None
+            logging.warning('The traced step changes after compiling, '
+                'it will run eagerly.')
+        return outputs
+
+    def _compile(self, entry, tracer, renamer,
+                 op_defs, arguments, inputs, outputs):
+        # The inputs are copied into the private tensors on replaying
+        entry.inputs = []
+        for e in inputs:
+            device = proto_utils.GetDeviceOption(
+                e.device.type, e.device.index).SerializeToString()
+            entry.inputs.append((renamer.get(e.name), device))
+            C.TensorFromTensor(renamer.get(e.name), e.name, device, device)
+        for name, value in arguments:
+            C.SetArgumentI64(name, int(value))
+        # Return the tensors with the private names
+        tensors = []
+        entry.structure = _flatten(outputs, tensors)
+        entry.outputs = [(renamer.get(e.name), e.device) for e in tensors]
+        # Keep the tensors which are not private for the outputs
+        graph_outputs = set(e[0] for e in entry.outputs)
+        is_training = False
+        for op_def in op_defs:
+            for e in op_def.output:
+                if not e.startswith(entry.prefix): graph_outputs.add(e)
+            for arg in op_def.arg:
+                if arg.name == 'phase' and _to_str(arg.s) == 'TRAIN':
+                    is_training = True
+            if op_def.type.endswith('Gradient'): is_training = True
+        OX = option['graph_optimization_level']
+        if not option['share_grads'] and OX >= 3: OX = 2
+        graph_def = pb.GraphDef()
+        graph_def.name = 'TracedGraph'
+        graph_def.op.extend(op_defs)
+        graph_def.output.extend(sorted(graph_outputs))
+        graph_def.arg.extend([
+            proto_utils.MakeArgument('optimization_level', OX),
+            proto_utils.MakeArgument('phase',
+                'TRAIN' if is_training else 'TEST'),
+        ])
+        entry.graph_name = dragon.workspace.CreateGraph(graph_def)
+        entry.hooks, entry.refs = tracer.hooks, tracer.refs
+
+    def _replay(self, entry, inputs):
+        from dragon.vm.torch.tensor import Tensor
+        for func, args in entry.hooks: func(*args)
+        for e, (name, device) in zip(inputs, entry.inputs):
+            C.TensorFromTensor(name, e.name, device, device)
+        C.RunGraph(entry.graph_name, '', '')
+        tensors = [Tensor(name=name, own_storage=False, device=device)
+                   for name, device in entry.outputs]
+        return _unflatten(entry.structure, tensors)
+
+
+def trace(func=None, max_traces=8, check_interval=100):
+    """Trace a step function into the static graphs.
+
+    The tensors not requiring grads are fed as the inputs,
+    while those requiring grads, e.g. the parameters,
+    should be the same on every call.
+
+    The step reading the values of tensors will not be replayed,
+    and the others are checked by an eager run every ``check_interval`` calls.
+
+    Parameters
+    ----------
+    func : callable, optional
+        The step function.
+    max_traces : int, optional
+        The max number of graphs for different inputs.
+    check_interval : int, optional
+        The number of replays between the checks, ``0`` to disable.
+
+    Returns
+    -------
+    TracedFunction or callable
+        The traced function, or a decorator if ``func`` is None.
+
+    Examples
+    --------
+    >>> @torch.jit.trace
+    >>> def step(x, y):
+    >>>     loss = criterion(model(x), y)
+    >>>     loss.backward()
+    >>>     optimizer.step()
+    >>>     return loss
+
+    """
+    if func is None:
+        return lambda f: TracedFunction(f, max_traces, check_interval)
+    return TracedFunction(func, max_traces, check_interval)
\ No newline at end of file
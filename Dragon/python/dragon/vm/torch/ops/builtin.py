@@ -13,7 +13,7 @@ from __future__ import absolute_import
 from __future__ import division
 from __future__ import print_function
 
-from dragon.core import mpi
+from dragon.core import mpi, shm
 from dragon.vm.torch.tensor import Tensor, _LeafTensor, _Device
 from dragon.vm.torch.ops.primitive import MakeDevice, WrapScalar
 from dragon.vm.torch.ops.factory import get_module
@@ -1122,7 +1122,8 @@ def _accumulate(grads):
 def _allreduce(grads):
     if not isinstance(grads, (list, tuple)): grads = [grads]
     dev = MakeDevice(inputs=grads)
-    mode = mpi.GetParallelMode() + '_ALLREDUCE'
+    mode = ('SHM' if shm.Is_Init() else
+        mpi.GetParallelMode()) + '_ALLREDUCE'
     key = 'Collective/{}/{}'.format(dev, mode.lower())
     module = get_module(Collective, key, dev, mode=mode)
     return module.forward(grads)
@@ -13,11 +13,10 @@ from __future__ import absolute_import
 from __future__ import division
 from __future__ import print_function
 
-import numpy as np
 import dragon as dg
 
-from dragon.core import proto_utils
 from dragon.vm.torch.module import Module
+from dragon.vm.torch.jit import get_tracer
 
 
 class BaseModule(Module):
@@ -25,9 +24,8 @@ class BaseModule(Module):
         super(BaseModule, self).__init__()
         self._module_key = key
         self._device = dev
-        self._args_dev = proto_utils.\
-            GetDeviceOption('cpu').SerializeToString()
 
     def set_argument_i64(self, name, value):
-        dg.C.FeedTensor(name, np.array(
-            value, dtype=np.int64), self._args_dev)
\ No newline at end of file
+        tracer = get_tracer()
+        if tracer is not None: tracer.record_argument(name, value)
+        dg.C.SetArgumentI64(name, int(value))
\ No newline at end of file
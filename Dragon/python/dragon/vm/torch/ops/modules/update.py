@@ -14,6 +14,7 @@ from __future__ import division
 from __future__ import print_function
 
 import dragon.core.mpi as mpi
+import dragon.core.shm as shm
 from dragon.vm.torch.ops.modules.base import BaseModule
 
 
@@ -50,6 +51,11 @@ class Collective(BaseModule):
         self.register_op()
 
     def register_op(self):
+        if self.mode.startswith('SHM'):
+            arguments = shm.GetArguments()
+            arguments['mode'] = self.mode
+            self.op_meta = {'op_type': 'CollectiveUpdate', 'arguments': arguments}
+            return
         idx, group = mpi.AllowParallel()
         if idx == -1:
             raise RuntimeError('The mpi node({}) dost not in '
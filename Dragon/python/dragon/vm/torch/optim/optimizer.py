@@ -21,6 +21,7 @@ import dragon
 from collections import defaultdict
 
 from dragon.vm.torch.tensor import Tensor
+from dragon.vm.torch.jit import get_tracer
 
 from dragon.vm.torch.ops.builtin import (
     _accumulate, _allreduce, _update,
@@ -55,6 +56,8 @@ class Optimizer(object):
         if dragon.mpi.Is_Init():
             local_rank, _ = dragon.mpi.AllowParallel()
             if local_rank != -1: self._allow_parallel = True
+        elif dragon.shm.Is_Init():
+            self._allow_parallel = True
         self._mutable_parameters = {}
 
     def __repr__(self):
@@ -69,6 +72,10 @@ class Optimizer(object):
         return format_string
 
     def feed_parameters(self, group):
+        tracer = get_tracer()
+        if tracer is not None:
+            # Feed again before replaying the traced step
+            tracer.add_replay_hook(self.feed_parameters, group)
         template = group['slot'] + '/{}'
         for k, v in group.items():
             if k in self._mutable_parameters:
@@ -19,6 +19,7 @@ import dragon
 
 from dragon.core import mapping, tensor_utils, proto_utils
 from dragon.vm.torch.pool import TensorPool
+from dragon.vm.torch.jit import get_tracer
 from dragon.vm.torch.c_api import Size, from_dragon
 from dragon.vm.torch.c_api import device as _Device
 
@@ -156,6 +157,9 @@ class Tensor(object):
             The numpy array.
 
         """
+        tracer = get_tracer()
+        # The traced step can not replay the python branches
+        if tracer is not None: tracer.record_value_read()
         return tensor_utils.ToPyArray(self._tensor, readonly)
 
     def dragon(self):
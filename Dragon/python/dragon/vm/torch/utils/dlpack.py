@@ -0,0 +1,57 @@
+# ------------------------------------------------------------
+# Copyright (c) 2017-present, SeetaTech, Co.,Ltd.
+#
+# Licensed under the BSD 2-Clause License.
+# You should have received a copy of the BSD 2-Clause License
+# along with the software. If not, See,
+#
+#      <https://opensource.org/licenses/BSD-2-Clause>
+#
+# ------------------------------------------------------------
+
+from __future__ import absolute_import
+from __future__ import division
+from __future__ import print_function
+
+from dragon.core import tensor_utils
+from dragon.vm.torch.c_api import from_dragon
+from dragon.vm.torch.pool import TensorPool
+
+
+def to_dlpack(tensor):
+    """Return a DLPack capsule sharing the tensor.
+
+    Parameters
+    ----------
+    tensor : dragon.vm.torch.Tensor
+        The tensor to export.
+
+    Returns
+    -------
+    PyCapsule
+        The capsule of DLPack.
+
+    """
+    return tensor_utils.ToDLPack(tensor.name)
+
+
+def from_dlpack(dlpack):
+    """Create a tensor sharing the DLPack capsule.
+
+    The capsule could only be consumed once.
+
+    Parameters
+    ----------
+    dlpack : PyCapsule
+        The capsule of DLPack.
+
+    Returns
+    -------
+    dragon.vm.torch.Tensor
+        The torch tensor.
+
+    """
+    # We use the scope of ``numpy`` as the external memory
+    tensor = tensor_utils.FromDLPack(
+        dlpack, TensorPool.get('${NUMPY}'))
+    return from_dragon(tensor, own_storage=True)
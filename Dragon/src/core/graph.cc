@@ -55,6 +55,33 @@ GraphBase::GraphBase(const GraphDef& meta_graph, Workspace* ws)
     }
 }
 
+namespace {
+
+/*! Assign the tensors to the least loaded ranks, larger first */
+vector<int64_t> AssignShardRanks(
+    const vector<int64_t>&      sizes,
+    int                         num_ranks) {
+    vector<int64_t> ranks(sizes.size(), 0);
+    if (std::find(sizes.begin(), sizes.end(), 0) != sizes.end()) {
+        // The sizes are unknown, assign by the index instead
+        for (int i = 0; i < (int)ranks.size(); ++i) ranks[i] = i % num_ranks;
+        return ranks;
+    }
+    vector<int> order(sizes.size());
+    for (int i = 0; i < (int)order.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(),
+        [&sizes](int lhs, int rhs) { return sizes[lhs] > sizes[rhs]; });
+    vector<int64_t> loads(num_ranks, 0);
+    for (auto i : order) {
+        auto rank = std::min_element(loads.begin(), loads.end());
+        ranks[i] = rank - loads.begin();
+        *rank += sizes[i];
+    }
+    return ranks;
+}
+
+}  // namespace
+
 /*! Build the update operators from the def */
 
 GraphDef GraphBase::BuildUpdateOps(const GraphDef& input_def) {
@@ -63,6 +90,7 @@ GraphDef GraphBase::BuildUpdateOps(const GraphDef& input_def) {
 
     // Generate Update Ops
     vector<OperatorDef> update_ops;
+    vector<string> params;
     for (const auto& updater : input_def.updater()) {
         vector<string> missing_tensors;
         for (const auto& tensor : updater.tensor()) {
@@ -82,6 +110,7 @@ GraphDef GraphBase::BuildUpdateOps(const GraphDef& input_def) {
             collective_op.add_output(updater.tensor(1));
             op_def.mutable_arg()->CopyFrom(updater.arg());
             update_ops.push_back(op_def);
+            params.push_back(updater.tensor(0));
         } else {
             LOG(INFO) << "Missing tensors. Skip the update to Tensor("
                       << updater.tensor(0) << ")";
@@ -89,26 +118,83 @@ GraphDef GraphBase::BuildUpdateOps(const GraphDef& input_def) {
     }
 
     // Generate Collective Ops if necessary
-    vector<OperatorDef> collective_ops;
-    if (args_.count("parallel_mode")) {
-        if (args_["parallel_mode"].s() == "MPI" ||
-            args_["parallel_mode"].s() == "NCCL") {
-            OperatorDef op_def;
-            op_def.CopyFrom(collective_op);
-            Argument collective_mode;
-            collective_mode.set_name("mode");
-            collective_mode.set_s(
-                args_["parallel_mode"].s() + "_ALLREDUCE");
+    vector<OperatorDef> collective_ops, gather_ops;
+    string parallel_mode = args_.count("parallel_mode") ?
+        args_["parallel_mode"].s() : "";
+    int comm_size = 1, comm_rank = 0;
+    if (parallel_mode == "MPI" || parallel_mode == "NCCL") {
+        if (args_.count("comm") &&
+            args_.count("group") &&
+            args_.count("root")) {
+            collective_op.add_arg()->CopyFrom(args_["comm"]);
+            collective_op.add_arg()->CopyFrom(args_["group"]);
+            collective_op.add_arg()->CopyFrom(args_["root"]);
+        } else {
+            LOG(FATAL) << "MPI was not initialized.";
+        }
+#ifdef WITH_MPI
+        auto comm = (MPI_Comm)args_["comm"].i();
+        MPI_Comm_size(comm, &comm_size);
+        MPI_Comm_rank(comm, &comm_rank);
+#endif
+    } else if (parallel_mode == "SHM") {
+        if (args_.count("shm_name") &&
+            args_.count("shm_size") &&
+            args_.count("shm_rank")) {
+            collective_op.add_arg()->CopyFrom(args_["shm_name"]);
+            collective_op.add_arg()->CopyFrom(args_["shm_size"]);
+            collective_op.add_arg()->CopyFrom(args_["shm_rank"]);
+        } else {
+            LOG(FATAL) << "Shared memory collective was not initialized.";
+        }
+        comm_size = (int)args_["shm_size"].i();
+        comm_rank = (int)args_["shm_rank"].i();
+    } else if (!parallel_mode.empty()) {
+        LOG(FATAL) << "Unsupported parallel mode: " << parallel_mode;
+    }
+
+    if (!parallel_mode.empty()) {
+        OperatorDef op_def;
+        op_def.CopyFrom(collective_op);
+        Argument collective_mode;
+        collective_mode.set_name("mode");
+        if (args_.count("shard_update") && args_["shard_update"].i()) {
+            // Each rank updates the parameters it owns,
+            // so that the optimizer states are partitioned over the ranks
+            vector<int64_t> sizes;
+            for (const auto& param : params)
+                sizes.push_back(ws_->GetTensor(param)->count());
+            auto shard_ranks = AssignShardRanks(sizes, comm_size);
+            if (comm_size > 1 && shard_ranks.size() > 1) {
+                CHECK_GT(Set<int64_t>(shard_ranks.begin(),
+                    shard_ranks.end()).size(), 1)
+                    << "\nAll the parameters are sharded into one rank.";
+            }
+            Argument shard_arg;
+            shard_arg.set_name("shard_ranks");
+            for (auto rank : shard_ranks) shard_arg.add_ints(rank);
+            op_def.add_arg()->CopyFrom(shard_arg);
+            collective_mode.set_s(parallel_mode + "_REDUCE_SCATTER");
             op_def.add_arg()->CopyFrom(collective_mode);
-            if (args_.count("comm") &&
-                args_.count("group") &&
-                args_.count("root")) {
-                op_def.add_arg()->CopyFrom(args_["comm"]);
-                op_def.add_arg()->CopyFrom(args_["group"]);
-                op_def.add_arg()->CopyFrom(args_["root"]);
-            } else {
-                LOG(FATAL) << "MPI was not initialized.";
+            collective_ops.push_back(op_def);
+            // Remove the updates of other ranks
+            vector<OperatorDef> shard_ops;
+            for (int i = 0; i < (int)update_ops.size(); ++i)
+                if (shard_ranks[i] == comm_rank)
+                    shard_ops.push_back(update_ops[i]);
+            update_ops.swap(shard_ops);
+            // Broadcast the updated parameters from the owners
+            op_def.clear_input(); op_def.clear_output();
+            for (const auto& param : params) {
+                op_def.add_input(param);
+                op_def.add_output(param);
             }
+            op_def.mutable_arg(op_def.arg_size() - 1)->set_s(
+                parallel_mode + "_ALLGATHER");
+            gather_ops.push_back(op_def);
+        } else {
+            collective_mode.set_s(parallel_mode + "_ALLREDUCE");
+            op_def.add_arg()->CopyFrom(collective_mode);
             collective_ops.push_back(op_def);
         }
     }
@@ -118,6 +204,7 @@ GraphDef GraphBase::BuildUpdateOps(const GraphDef& input_def) {
     update_graph.clear_updater();
     for (const auto& op : collective_ops) update_graph.add_op()->CopyFrom(op);
     for (const auto& op : update_ops) update_graph.add_op()->CopyFrom(op);
+    for (const auto& op : gather_ops) update_graph.add_op()->CopyFrom(op);
     return update_graph;
 }
 
@@ -138,6 +225,9 @@ bool Graph::Create(
         // For the static graph, do recomputing-aware
         Argument arg; arg.set_name("allow_recomputing");
         arg.set_i(1); op_def.add_arg()->CopyFrom(arg);
+        // For the static graph, the dependencies are tracked
+        arg.set_name("allow_async");
+        arg.set_i(1); op_def.add_arg()->CopyFrom(arg);
         // For the last operator, enforce the synchronization
         if (i == optimized_graph.op_size() - 1) {
             arg.set_name("do_sync");
@@ -146,6 +236,28 @@ bool Graph::Create(
         OperatorBase* op = NewOperator(op_def, ws);
         ops_.push_back(op);
     }
+
+    // Wait for the asynchronous operators before
+    // reading their outputs or writing their tensors
+    for (auto* async_op : ops_) {
+        if (!async_op->is_async()) continue;
+        async_ops_.push_back(async_op);
+        Set<Tensor*> reads, writes;
+        for (int i = 0; i < async_op->InputSize(); i++)
+            reads.insert(&async_op->Input(i));
+        for (int i = 0; i < async_op->OutputSize(); i++)
+            writes.insert(async_op->Output(i));
+        for (auto* op : ops_) {
+            if (op == async_op) continue;
+            bool conflicted = false;
+            for (int i = 0; i < op->InputSize(); i++)
+                conflicted |= writes.count(&op->Input(i)) > 0;
+            for (int i = 0; i < op->OutputSize(); i++)
+                conflicted |= writes.count(op->Output(i)) > 0 ||
+                              reads.count(op->Output(i)) > 0;
+            if (conflicted) async_deps_[op].push_back(async_op);
+        }
+    }
     return true;
 }
 
@@ -153,6 +265,7 @@ bool Graph::Create(
 
 Graph::Graph(const GraphDef& meta_graph, Workspace* ws)
     : GraphBase(meta_graph, ws) {
+    if (this->args_.count("phase")) phase_ = this->args_["phase"].s();
     GraphDef optimized_graph;
     Map< string, vector<int> > subgraph_indices;
     if (meta_graph.updater_size() > 0) {
@@ -162,6 +275,18 @@ Graph::Graph(const GraphDef& meta_graph, Workspace* ws)
          * Note that the graph with update ops is not a dag,
          * we should handle them independently.
          */
+        if (this->args_.count("shard_update") &&
+                this->args_["shard_update"].i()) {
+            // The shards are balanced by the sizes of parameters,
+            // which are filled by the first run of forward graph
+            for (const auto& updater : meta_graph.updater()) {
+                auto* X = ws_->TryGetTensor(updater.tensor(0));
+                if (X && X->count() == 0) {
+                    update_def_ = meta_graph;
+                    return;
+                }
+            }
+        }
         optimized_graph = this->BuildUpdateOps(meta_graph);
     } else {
         int OX = 3;  // defaults: O3
@@ -169,20 +294,71 @@ Graph::Graph(const GraphDef& meta_graph, Workspace* ws)
             OX = this->args_["optimization_level"].i();
         optimized_graph = meta_graph;
         GraphOptimizer optimizer(ws);
-        GraphGradientMaker gradient_maker;
         if (OX >= 1) optimized_graph = optimizer.PruneNodes(meta_graph);
         if (OX >= 2) optimized_graph = optimizer.AddInplace(optimized_graph);
         if (OX >= 3) {
             if (this->args_["phase"].s() == "TRAIN") {
-                optimized_graph = optimizer.MirrorStage(
+                optimized_graph = PlanTraining(
                     optimized_graph, subgraph_indices);
-                gradient_maker.Share(optimized_graph);
             } else {
+                optimized_graph = optimizer.ZeroCopyView(optimized_graph);
+                optimized_graph = optimizer.ZeroCopyConcat(optimized_graph);
                 optimized_graph = optimizer.SimulateGC(optimized_graph);
             }
         }
     }
 
+    Build(optimized_graph, subgraph_indices);
+}
+
+/*! Plan the recomputing and offloading for training */
+
+GraphDef Graph::PlanTraining(
+    const GraphDef&                     input_def,
+    Map< string, vector<int> >&         subgraph_indices) {
+    GraphDef optimized_graph(input_def);
+    GraphOptimizer optimizer(ws_);
+    bool deferred = false;
+    if (this->args_.count("checkpoint_mode")) {
+        string report;
+        optimized_graph = optimizer.PlanCheckpoints(
+            optimized_graph,
+            this->args_["checkpoint_mode"].s(),
+            this->args_.count("checkpoint_budget") ?
+                this->args_["checkpoint_budget"].i() : 0,
+            activations_, &report, &deferred);
+        LOG(INFO) << "Graph(" << name() << ") " << report;
+        ws_->CreateTensor("/graph_def/checkpoints/" + name())
+            ->Reshape({ 1 })->mutable_data<string, CPUContext>()[0]
+                = report;
+    }
+    if (deferred) {
+        // Replan with the sizes recorded by the first run,
+        // which requires the ops to match the planned def
+        checkpoint_def_ = input_def;
+    } else if (this->args_.count("offload") &&
+            this->args_["offload"].i()) {
+        string report;
+        optimized_graph = optimizer.PlanOffload(
+            optimized_graph,
+            this->args_.count("offload_distance") ?
+                std::max(this->args_["offload_distance"].i(),
+                    (int64_t)0) : 2,
+            &report);
+        LOG(INFO) << "Graph(" << name() << ") " << report;
+    }
+    optimized_graph = optimizer.MirrorStage(
+        optimized_graph, subgraph_indices);
+    GraphGradientMaker gradient_maker;
+    gradient_maker.Share(optimized_graph);
+    return optimized_graph;
+}
+
+/*! Create the operators and bind the recomputing subgraph */
+
+void Graph::Build(
+    const GraphDef&                     optimized_graph,
+    const Map< string, vector<int> >&   subgraph_indices) {
     // Try to store the final graph as a tensor for visualization
     bool could_be_serialized = true;
     for (auto& op : optimized_graph.op())
@@ -190,21 +366,20 @@ Graph::Graph(const GraphDef& meta_graph, Workspace* ws)
             could_be_serialized = false;
     if (could_be_serialized) {
         auto* T = ws_->CreateTensor(
-            "/graph_def/optimized/" +
-                meta_graph.name())->Reshape({ 1 });
+            "/graph_def/optimized/" + name())->Reshape({ 1 });
         T->mutable_data<string, CPUContext>()[0]
             = optimized_graph.DebugString();
     }
 
     // Create
-    Create(optimized_graph, ws);
+    Create(optimized_graph, ws_);
 
     // Recomputing-aware
     if (subgraph_indices.size() > 0) {
         Map< string, vector<OperatorBase*> > subgraph;
         for (const auto& it : subgraph_indices) {
             subgraph[it.first] = vector<OperatorBase*>();
-            for (const auto& idx : subgraph_indices[it.first])
+            for (const auto& idx : it.second)
                 subgraph[it.first].push_back(ops_[idx]);
         }
         for (const auto& op : ops_) op->set_subgraph(subgraph);
@@ -218,26 +393,96 @@ bool Graph::Run(
     const string&               exclude,
     int                         stream_id) {
     LOG(DEBUG) << "Run Graph: " << name();
-    for (auto op : ops_) {
-        if (!include.empty())
-            if (op->type().find(include) == string::npos) continue;
-        if (!exclude.empty())
-            if (op->type().find(exclude) != string::npos) continue;
-        op->SwitchToPhase(this->args_["phase"].s());
+
+    if (update_def_.updater_size() > 0) {
+        // Build the deferred update ops with the known sizes
+        GraphDef update_def;
+        update_def.Swap(&update_def_);
+        Create(this->BuildUpdateOps(update_def), ws_);
+    }
+
+    // Filter the operators once for each include/exclude
+    const string key = include + "/" + exclude;
+    auto iter = filtered_ops_.find(key);
+    if (iter == filtered_ops_.end()) {
+        vector<OperatorBase*> ops;
+        for (auto op : ops_) {
+            if (!include.empty())
+                if (op->type().find(include) == string::npos) continue;
+            if (!exclude.empty())
+                if (op->type().find(exclude) != string::npos) continue;
+            op->SwitchToPhase(phase_);
+            ops.push_back(op);
+        }
+        iter = filtered_ops_.emplace(key, ops).first;
+    }
+
+    // Record the sizes to replan on the first complete run
+    bool replan = checkpoint_def_.op_size() > 0 &&
+        include.empty() && exclude.empty();
+
+    for (int i = 0; i < (int)iter->second.size(); ++i) {
+        auto* op = iter->second[i];
+        if (!async_deps_.empty()) {
+            auto deps = async_deps_.find(op);
+            if (deps != async_deps_.end())
+                for (auto* dep : deps->second) dep->Wait();
+        }
         LOG(DEBUG) << "$ Before Operator: " << op->name();
         op->Run(stream_id);
         LOG(DEBUG) << "$ After Operator: " << op->name();
+        // The shared buffers are overwritten by the later ops
+        if (replan) RecordActivations(i);
     }
+
+    // The outputs are ready when returning
+    for (auto* op : async_ops_) op->Wait();
+    if (replan) Replan();
     return true;
 }
 
+/*! Record the size of outputs produced by the given op */
+
+void Graph::RecordActivations(int op_idx) {
+    const auto& op_def = checkpoint_def_.op(op_idx);
+    if (op_def.type().find("Gradient") != string::npos) return;
+    auto* op = ops_[op_idx];
+    if (op->is_async()) op->Wait();
+    for (int i = 0; i < op->OutputSize(); ++i) {
+        auto* Y = op->Output(i);
+        if (Y->count() == 0 || Y->meta().id() == 0) continue;
+        auto& size = activations_[op_def.output(i)];
+        size.count = Y->count(); size.nbytes = Y->nbytes();
+    }
+}
+
+/*! Rebuild the graph with the recorded sizes */
+
+void Graph::Replan() {
+    GraphDef input_def;
+    input_def.Swap(&checkpoint_def_);
+    Map< string, vector<int> > subgraph_indices;
+    auto optimized_graph = PlanTraining(input_def, subgraph_indices);
+    activations_.clear();
+    // Keep the current plan if the sizes are still unknown
+    if (checkpoint_def_.op_size() > 0) {
+        checkpoint_def_.Clear(); return;
+    }
+    for (auto* op : ops_) delete op;
+    ops_.clear(); async_ops_.clear();
+    async_deps_.clear(); filtered_ops_.clear();
+    Build(optimized_graph, subgraph_indices);
+}
+
 /*! New a graph from the raw def */
 
 GraphBase* NewGraph(
     const GraphDef&             meta_graph,
     Workspace*                  ws) {
+    // The graph of update ops always runs sequentially
     if (!meta_graph.has_graph_type() ||
-        meta_graph.graph_type().empty()) {
+        meta_graph.graph_type().empty() ||
+        meta_graph.updater_size() > 0) {
         return new Graph(meta_graph, ws);
     }
     return GraphRegistry()->Create(
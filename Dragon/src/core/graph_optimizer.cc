@@ -1,12 +1,97 @@
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
 #include "core/workspace.h"
 #include "core/graph_gradient.h"
 #include "core/operator_schema.h"
 #include "core/graph_optimizer.h"
 
-#define GRAPH_TEPORAL_OUTPUT_MAX_SIZE 2
-
 namespace dragon {
 
+namespace {
+
+/*! The operators could not reproduce the outputs on recomputing */
+const Set<string>& NonRecomputableOps() {
+    static Set<string> types {
+        "Dropout", "DropPath", "DropBlock2d",
+        "RandomUniform", "RandomNormal", "TruncatedNormal",
+        "GlorotUniform", "GlorotNormal", "ImageData",
+        "Run", "Template", "Assign", "CollectiveUpdate",
+        "MPIBroadcast", "MPIGather", "MPISend", "MPIRecv",
+    };
+    return types;
+}
+
+/*! Return the FLOPs per output element of an operator */
+double FlopsPerElement(const OperatorDef& op, Workspace* ws) {
+    // The nominal reduction size if the weights are unknown
+    const double kDefaultReduction = 64.;
+    const string& type = op.type();
+    if (type == "Conv2d" || type == "ConvTranspose2d" ||
+            type == "DepthwiseConv2d" || type == "FullyConnected") {
+        int64_t num_output = 0;
+        for (const auto& arg : op.arg())
+            if (arg.name() == "num_output") num_output = arg.i();
+        auto* W = op.input_size() > 1 ?
+            ws->TryGetTensor(op.input(1)) : nullptr;
+        if (W && W->count() > 0 && num_output > 0)
+            return 2. * W->count() / num_output;
+        return 2. * kDefaultReduction;
+    } else if (type == "Matmul") {
+        bool transB = false;
+        for (const auto& arg : op.arg())
+            if (arg.name() == "transB") transB = arg.i() != 0;
+        auto* B = op.input_size() > 1 ?
+            ws->TryGetTensor(op.input(1)) : nullptr;
+        if (B && B->count() > 0 && B->ndim() >= 2)
+            return 2. * B->dim(transB ? -1 : -2);
+        return 2. * kDefaultReduction;
+    } else if (type == "Dot" || type == "GramMatrix") {
+        return 2. * kDefaultReduction;
+    } else if (type == "BatchNorm" || type == "GroupNorm" ||
+               type == "L2Norm" || type == "LRN" || type == "Softmax" ||
+               type == "Pool2d" || type == "BilinearResize" ||
+               type == "ROIAlign" || type == "ROIPool") {
+        return 8.;
+    }
+    return 1.;
+}
+
+/*! Return the readable amount of the estimated computation */
+string FlopsString(double value, bool in_flops) {
+    std::stringstream ss;
+    if (!in_flops) {
+        ss << value << " units";
+    } else if (value >= 1e9) {
+        ss << std::fixed << std::setprecision(2)
+           << value / 1e9 << " GFLOPs";
+    } else if (value >= 1e6) {
+        ss << std::fixed << std::setprecision(2)
+           << value / 1e6 << " MFLOPs";
+    } else {
+        ss << value << " FLOPs";
+    }
+    return ss.str();
+}
+
+/*! Return the readable amount of the estimated memory */
+string MemoryString(double value, bool in_bytes) {
+    std::stringstream ss;
+    if (!in_bytes) {
+        ss << value << " units";
+    } else if (value >= 1024. * 1024.) {
+        ss << std::fixed << std::setprecision(2)
+           << value / 1024. / 1024. << " MB";
+    } else {
+        ss << value << " B";
+    }
+    return ss.str();
+}
+
+}  // namespace
+
 /*! Prune the redundant nodes (-O1) */
 
 GraphDef GraphOptimizer::PruneNodes(const GraphDef& input_def) {
@@ -168,6 +253,367 @@ GraphDef GraphOptimizer::AddInplace(const GraphDef& input_def) {
     return output_def;
 }
 
+/*! Select the activations to recompute (-O3) */
+
+GraphDef GraphOptimizer::PlanCheckpoints(
+    const GraphDef&                  input_def,
+    const string&                    mode,
+    int64_t                          budget,
+    const Map<string, Activation>&   activations,
+    string*                          report,
+    bool*                            deferred) {
+    GraphDef output_def(input_def);
+    const auto& non_recomputable_ops = NonRecomputableOps();
+    if (deferred) *deferred = false;
+
+    // Use the size recorded by the last run if it has been allocated
+    auto find_size = [&](const string& name, Activation* size) {
+        const auto& it = activations.find(name);
+        if (it != activations.end()) { *size = it->second; return true; }
+        auto* tensor = ws_->TryGetTensor(name);
+        if (!tensor || tensor->count() == 0 ||
+                tensor->meta().id() == 0) return false;
+        size->count = tensor->count();
+        size->nbytes = tensor->nbytes();
+        return true;
+    };
+
+    // Collect the producers and readers of tensors
+    Map<string, int> num_producers, first_readers;
+    Map<string, vector<int> > readers;
+    Set<string> targets(input_def.output().begin(),
+                        input_def.output().end()), unsafe;
+    for (int i = 0; i < input_def.op_size(); ++i) {
+        const auto& op = input_def.op(i);
+        bool backward = op.type().find("Gradient") != string::npos;
+        for (int j = 0; j < op.input_size(); ++j) {
+            readers[op.input(j)].push_back(i);
+            // Only Input(0) of the forward ops could be dropped
+            if (!backward && j == 0 &&
+                    !first_readers.count(op.input(0)))
+                first_readers[op.input(0)] = i;
+        }
+        for (const auto& output : op.output()) {
+            bool inplace = false;
+            for (const auto& input : op.input())
+                if (input == output) inplace = true;
+            // The inplace writers are recomputed along the chain
+            if (!inplace) num_producers[output] += 1;
+            if (backward || non_recomputable_ops.count(op.type()))
+                unsafe.insert(output);
+        }
+    }
+
+    // Collect the activations could be recomputed in order.
+    // An operator reading two dropped tensors may see one of
+    // them overwritten by recomputing the other, reject it
+    vector<string> candidates;
+    vector<double> sizes, costs;
+    Set<int> dropped_readers;
+    bool in_bytes = true, in_flops = true;
+    double chain_cost = 0.;
+    for (int i = 0; i < input_def.op_size(); ++i) {
+        const auto& op = input_def.op(i);
+        if (op.type().find("Gradient") != string::npos) continue;
+        // The chain to recompute runs the ops since the last candidate
+        Activation size;
+        if (op.output_size() > 0 && find_size(op.output(0), &size)) {
+            chain_cost += FlopsPerElement(op, ws_) * size.count;
+        } else {
+            chain_cost += FlopsPerElement(op, ws_); in_flops = false;
+        }
+        if (non_recomputable_ops.count(op.type())) continue;
+        for (const auto& output : op.output()) {
+            if (num_producers[output] != 1 ||
+                    targets.count(output) || unsafe.count(output) ||
+                    !first_readers.count(output)) continue;
+            bool admissible = true;
+            for (const auto& input : op.input())
+                if (input == output) admissible = false;
+            for (auto idx : readers[output])
+                if (dropped_readers.count(idx)) admissible = false;
+            if (!admissible) continue;
+            for (auto idx : readers[output]) dropped_readers.insert(idx);
+            if (find_size(output, &size)) {
+                sizes.push_back((double)size.nbytes);
+            } else {
+                sizes.push_back(1.); in_bytes = false;
+            }
+            costs.push_back(chain_cost); chain_cost = 0.;
+            candidates.push_back(output);
+        }
+    }
+
+    /* ----------------------------------------------------------
+     *
+     *  Recomputing a dropped tensor runs the chain from the last
+     *  checkpoint, the cost of a segment [a, b] is estimated as
+     *
+     *         C(a, b) = sum_{j = a}^{b} sum_{k = a}^{j} t_k
+     *
+     *  where t_k is the FLOPs of the ops producing k-th output
+     *  since the (k-1)-th, i.e. 2K per element for Conv, FC and
+     *  Matmul (K is the reduction), 8 for Norm, Pool and Resize,
+     *  and 1 for the others.
+     *  The dropped tensors alternate in two shared buffers.
+     *
+     * ---------------------------------------------------------- */
+
+    const int N = (int)candidates.size();
+    vector<double> P(N + 1, 0.), Q(N + 1, 0.);
+    for (int i = 0; i < N; ++i) {
+        P[i + 1] = P[i] + costs[i];
+        Q[i + 1] = Q[i] + P[i + 1];
+    }
+    // The cost of segment [a, b) indexed from zero
+    auto segment_cost = [&](int a, int b) {
+        if (a >= b) return 0.;
+        return (Q[b] - Q[a]) - (b - a) * P[a];
+    };
+    double max_size = 0.;
+    for (auto size : sizes) max_size = std::max(max_size, size);
+
+    // Return the predicted peak and recomputing of a plan
+    auto evaluate = [&](const vector<bool>& kept,
+                        double* peak, double* cost) {
+        *peak = *cost = 0.;
+        double max_dropped = 0.;
+        int start = 0;
+        for (int i = 0; i <= N; ++i) {
+            if (i < N && !kept[i]) {
+                max_dropped = std::max(max_dropped, sizes[i]);
+                continue;
+            }
+            if (i < N) *peak += sizes[i];
+            *cost += segment_cost(start, i);
+            start = i + 1;
+        }
+        *peak += 2. * max_dropped;
+    };
+
+    // Keep every sqrt(N) activations
+    auto plan_sqrt = [&]() {
+        vector<bool> kept(N, false);
+        int stride = std::max(1, (int)std::round(std::sqrt((double)N)));
+        for (int i = stride - 1; i < N; i += stride) kept[i] = true;
+        return kept;
+    };
+
+    // Minimize the recomputing under the budget of kept activations
+    auto plan_dp = [&](double limit) {
+        // Quantize the budget to bound the O(N^2 * G) steps
+        const int G = std::max(8, std::min(256,
+            (int)(1e7 / ((N + 2.) * (N + 2.)))));
+        vector<bool> kept(N, false);
+        limit -= 2. * max_size;
+        if (limit <= 0.) return kept;
+        vector<int> units(N);
+        for (int i = 0; i < N; ++i)
+            units[i] = (int)std::ceil(sizes[i] / limit * G);
+        // F[j][m]: the min cost if j-th is the last checkpoint
+        const double inf = std::numeric_limits<double>::infinity();
+        vector<vector<double> > F(N + 2, vector<double>(G + 1, inf));
+        vector<vector<int> > from(N + 2, vector<int>(G + 1, -1));
+        F[0][0] = 0.;
+        for (int j = 1; j <= N + 1; ++j) {
+            int u = j <= N ? units[j - 1] : 0;
+            for (int i = 0; i < j; ++i) {
+                double seg = segment_cost(i, j - 1);
+                for (int m = u; m <= G; ++m) {
+                    if (F[i][m - u] == inf) continue;
+                    double value = F[i][m - u] + seg;
+                    if (value < F[j][m]) { F[j][m] = value; from[j][m] = i; }
+                }
+            }
+        }
+        int m = 0;
+        for (int k = 1; k <= G; ++k)
+            if (F[N + 1][k] < F[N + 1][m]) m = k;
+        for (int j = N + 1; j > 0;) {
+            int i = from[j][m];
+            if (j <= N) { kept[j - 1] = true; m -= units[j - 1]; }
+            j = i;
+        }
+        return kept;
+    };
+
+    std::stringstream ss;
+    ss << "Checkpoints: " << N << " activations could be recomputed";
+    string plan_mode = mode;
+    if (plan_mode == "DP" && !in_bytes) {
+        ss << "\nThe sizes are unknown before the first run, "
+           << "use SQRT until they are recorded.";
+        plan_mode = "SQRT";
+        if (deferred) *deferred = true;
+    }
+    vector<bool> kept;
+    if (plan_mode == "SQRT") {
+        kept = plan_sqrt();
+    } else if (plan_mode == "DP") {
+        CHECK_GT(budget, 0)
+            << "\nExcepted a positive budget for the DP checkpoints.";
+        kept = plan_dp((double)budget);
+    } else {
+        LOG(FATAL) << "Unknown checkpoint mode: " << mode;
+    }
+
+    // Report the trade-off between the memory and recomputing
+    double peak, cost, base_peak, base_cost;
+    evaluate(vector<bool>(N, true), &base_peak, &base_cost);
+    evaluate(kept, &peak, &cost);
+    int num_kept = 0;
+    for (auto e : kept) num_kept += e;
+    ss << "\nMode: " << plan_mode << ", kept " << num_kept << "/" << N
+       << ", peak " << MemoryString(peak, in_bytes)
+       << " (no checkpoints: " << MemoryString(base_peak, in_bytes) << ")"
+       << ", recompute " << FlopsString(cost, in_flops)
+       << " (forward: " << FlopsString(P[N], in_flops) << ")";
+    if (in_bytes && N > 0) {
+        ss << "\nBudget -> Peak, Recompute:";
+        for (int k = 1; k <= 8; ++k) {
+            double limit = base_peak * k / 8.;
+            double limit_peak, limit_cost;
+            evaluate(plan_dp(limit), &limit_peak, &limit_cost);
+            ss << "\n  " << MemoryString(limit, in_bytes)
+               << " -> " << MemoryString(limit_peak, in_bytes)
+               << ", " << FlopsString(limit_cost, in_flops);
+        }
+    }
+    if (report) *report = ss.str();
+
+    // Tag the first readers to drop the activations
+    for (int i = 0; i < N; ++i) {
+        if (kept[i]) continue;
+        auto* op = output_def.mutable_op(first_readers[candidates[i]]);
+        Argument arg; arg.set_name("mirror_stage"); arg.set_i(1);
+        op->add_arg()->CopyFrom(arg);
+    }
+    return output_def;
+}
+
+/*! Move the activations to host between the passes (-O3) */
+
+GraphDef GraphOptimizer::PlanOffload(
+    const GraphDef&                  input_def,
+    int64_t                          distance,
+    string*                          report) {
+    // The recomputing chains read the activations without
+    // knowing them, and the inserted ops shift the indices
+    for (const auto& op : input_def.op()) {
+        for (const auto& arg : op.arg()) {
+            if (arg.name() == "mirror_stage" && arg.i()) {
+                LOG(WARNING) << "Skip the offloading, "
+                             << "as the graph recomputes the activations.";
+                if (report) *report = "Offload: skipped";
+                return input_def;
+            }
+        }
+    }
+
+    /* ----------------------------------------------------------
+     *
+     *  An activation is live in the forward pass until its last
+     *  forward use (F), and in the backward pass from its first
+     *  backward use (B) to the last one (L).
+     *
+     *  It is offloaded after F, prefetched ``distance`` ops
+     *  before B, and freed after L, if the gap is wide enough.
+     *
+     * ---------------------------------------------------------- */
+
+    const int N = input_def.op_size();
+    Set<string> targets(input_def.output().begin(),
+                        input_def.output().end());
+    Set<string> unsafe;
+    Map<string, int> producers, last_forward;
+    Map<string, int> first_backward, last_backward;
+    vector<string> activations;
+    for (int i = 0; i < N; ++i) {
+        const auto& op = input_def.op(i);
+        bool backward = op.type().find("Gradient") != string::npos;
+        for (const auto& input : op.input()) {
+            if (!backward) {
+                last_forward[input] = i;
+            } else {
+                if (!first_backward.count(input))
+                    first_backward[input] = i;
+                last_backward[input] = i;
+            }
+        }
+        for (const auto& output : op.output()) {
+            if (backward) { unsafe.insert(output); continue; }
+            // The inplace writers extend the forward use
+            if (!producers.count(output)) {
+                producers[output] = i;
+                activations.push_back(output);
+            }
+            last_forward[output] = i;
+        }
+    }
+
+    Map<int, vector<OperatorDef> > inserted_ops;
+    auto add_op = [&](int before, const string& type,
+                      const string& name, int producer, bool spill) {
+        OperatorDef op_def = type == "Prefetch" ?
+            MakeOperatorDef(type, "", vector<string>(),
+                vector<string>({ name })) :
+            MakeOperatorDef(type, "", vector<string>({ name }),
+                vector<string>());
+        if (!spill) {
+            Argument arg; arg.set_name("spill"); arg.set_i(0);
+            op_def.add_arg()->CopyFrom(arg);
+        }
+        const auto& producer_def = input_def.op(producer);
+        if (producer_def.has_device_option())
+            op_def.mutable_device_option()->CopyFrom(
+                producer_def.device_option());
+        inserted_ops[before].push_back(op_def);
+    };
+
+    // Select the activations in the order of producing
+    int num_offloaded = 0;
+    double total_bytes = 0.;
+    bool in_bytes = true;
+    for (const auto& X : activations) {
+        if (X.empty() || X == "NULL" || X.find("/share/") == 0 ||
+                targets.count(X) || unsafe.count(X) ||
+                !first_backward.count(X)) continue;
+        const int F = last_forward[X];
+        const int B = first_backward[X];
+        const int L = last_backward[X];
+        if (B - F - 1 <= distance) continue;
+        add_op(F + 1, "Offload", X, producers[X], true);
+        add_op(B - (int)distance, "Prefetch", X, producers[X], true);
+        add_op(L + 1, "Offload", X, producers[X], false);
+        // Use the size of last run if it has been allocated
+        auto* tensor = ws_->TryGetTensor(X);
+        if (tensor && tensor->count() > 0 && tensor->meta().id() > 0) {
+            total_bytes += (double)tensor->nbytes();
+        } else {
+            total_bytes += 1.; in_bytes = false;
+        }
+        num_offloaded++;
+    }
+
+    GraphDef output_def(input_def);
+    output_def.clear_op();
+    for (int i = 0; i <= N; ++i) {
+        auto it = inserted_ops.find(i);
+        if (it != inserted_ops.end())
+            for (const auto& op_def : it->second)
+                output_def.add_op()->CopyFrom(op_def);
+        if (i < N) output_def.add_op()->CopyFrom(input_def.op(i));
+    }
+    if (report) {
+        std::stringstream ss;
+        ss << "Offload: " << num_offloaded << " activations, "
+           << MemoryString(total_bytes, in_bytes)
+           << ", prefetch distance " << distance;
+        *report = ss.str();
+    }
+    return output_def;
+}
+
 /*! Plan the recomputing for inputs (-O3) */
 
 GraphDef GraphOptimizer::MirrorStage(
@@ -216,13 +662,15 @@ GraphDef GraphOptimizer::MirrorStage(
                         rename_map[op.output(j)];
                     continue;
                 }
-                for (int k = 0; k < GRAPH_TEPORAL_OUTPUT_MAX_SIZE; ++k) {
+                // Take the first buffer not used by this op
+                for (int k = 0; ; ++k) {
                     v2_name = "/share/buffer/symbol:" + std::to_string(k);
+                    bool used = false;
                     for (const auto& buffer : used_buffers)
-                        if (buffer.find(v2_name) != string::npos) { v2_name.clear(); }
-                    if (!v2_name.empty()) { used_buffers.emplace_back(v2_name); break; }
+                        if (buffer == v2_name ||
+                            buffer.find(v2_name + "/") == 0) used = true;
+                    if (!used) { used_buffers.emplace_back(v2_name); break; }
                 }
-                CHECK(!v2_name.empty()) << "\nNo enough buffers for outputs.";
                 ws_->CreateTensor(v2_name)->set_version(0);
                 if (!versions.count(v2_name)) versions[v2_name] = 0;
                 version_name = "/ver:" + std::to_string(versions[v2_name]++);
@@ -307,6 +755,15 @@ GraphDef GraphOptimizer::SimulateGC(const GraphDef& input_def) {
             ref_count[input] += 1;
         if (dimension_ops.count(op.type()))
             blacklist_outputs.insert(op.input(0));
+        for (const auto& arg : op.arg()) {
+            // The memory shared by views can not be recycled
+            if (arg.name() == "zero_copy" && arg.i()) {
+                for (const auto& e : op.input())
+                    blacklist_outputs.insert(e);
+                for (const auto& e : op.output())
+                    blacklist_outputs.insert(e);
+            }
+        }
         if (star_ops.count(op.type())) {
             for (const auto& arg : op.arg())
                 if (arg.name() == "shape_like")
@@ -367,6 +824,123 @@ GraphDef GraphOptimizer::SimulateGC(const GraphDef& input_def) {
     return output_def;
 }
 
+/*! Write the inputs of concat into its output (-O3) */
+
+GraphDef GraphOptimizer::ZeroCopyConcat(const GraphDef& input_def) {
+    GraphDef output_def(input_def);
+    Set<string> persistent, dimension_ops = {
+        "Shape", "Reshape", "Flatten",
+            "ExpandDims", "Squeeze",
+    };
+    Map<string, int> first_seen, last_seen;
+    Map<string, string> producer_type;
+    Set<string> viewed_outputs;
+
+    // The graph inputs and targets should not be viewed
+    for (const auto& e : input_def.input()) persistent.insert(e);
+    for (const auto& e : input_def.output()) persistent.insert(e);
+
+    // Collect the lifetime and producer of each tensor
+    for (int i = 0; i < input_def.op_size(); ++i) {
+        const OperatorDef& op = input_def.op(i);
+        for (const auto& e : op.input()) last_seen[e] = i;
+        for (const auto& e : op.output()) {
+            if (!first_seen.count(e)) first_seen[e] = i;
+            last_seen[e] = i;
+            if (!producer_type.count(e))
+                producer_type[e] = op.type();
+        }
+        for (const auto& arg : op.arg())
+            if (arg.name() == "zero_copy" && arg.i())
+                for (const auto& e : op.output())
+                    viewed_outputs.insert(e);
+    }
+
+    for (int i = 0; i < input_def.op_size(); ++i) {
+        const OperatorDef& op = input_def.op(i);
+        if (op.type() != "Concat" || op.input_size() < 2) continue;
+        bool has_arg = false;
+        for (const auto& arg : op.arg())
+            if (arg.name() == "zero_copy") has_arg = true;
+        if (has_arg) continue;
+        const string& y = op.output(0);
+        if (first_seen[y] != i) continue;
+        bool viewable = true;
+        Set<string> inputs;
+        for (const auto& x : op.input()) {
+            // Each input should be produced by a non-dimension op,
+            // and disappear after being concatenated
+            viewable &= x != "NULL" && !persistent.count(x) &&
+                first_seen.count(x) > 0 && first_seen[x] < i &&
+                last_seen[x] == i && !inputs.count(x) &&
+                !dimension_ops.count(producer_type[x]) &&
+                !viewed_outputs.count(x);
+            inputs.insert(x);
+        }
+        if (!viewable) continue;
+        // Readers before the concat should run in-place,
+        // otherwise they may alias the memory without offset
+        for (int j = 0; j < i && viewable; ++j) {
+            const OperatorDef& reader = input_def.op(j);
+            for (const auto& u : reader.input()) {
+                if (!inputs.count(u)) continue;
+                bool inplace = false;
+                for (const auto& v : reader.output())
+                    if (u == v) inplace = true;
+                if (!inplace) { viewable = false; break; }
+            }
+        }
+        if (!viewable) continue;
+        Argument arg; arg.set_name("zero_copy"); arg.set_i(1);
+        output_def.mutable_op(i)->add_arg()->CopyFrom(arg);
+    }
+
+    return output_def;
+}
+
+/*! Share the memory for the outputs of layout ops (-O3) */
+
+GraphDef GraphOptimizer::ZeroCopyView(const GraphDef& input_def) {
+    GraphDef output_def(input_def);
+    Set<string> targets, view_ops = {
+        "Transpose", "Slice", "Crop",
+    };
+    Map<string, int> first_written, last_written;
+
+    // The targets could be fetched without materialization
+    for (const auto& e : input_def.output()) targets.insert(e);
+
+    for (int i = 0; i < input_def.op_size(); ++i) {
+        for (const auto& e : input_def.op(i).output()) {
+            if (!first_written.count(e)) first_written[e] = i;
+            last_written[e] = i;
+        }
+    }
+
+    for (int i = 0; i < input_def.op_size(); ++i) {
+        const OperatorDef& op = input_def.op(i);
+        if (!view_ops.count(op.type())) continue;
+        bool has_arg = false;
+        for (const auto& arg : op.arg())
+            if (arg.name() == "zero_copy") has_arg = true;
+        if (has_arg) continue;
+        // The viewed input should not be overwritten later
+        const string& x = op.input(0);
+        bool viewable = x != "NULL" &&
+            (!last_written.count(x) || last_written[x] < i);
+        // Neither the views, which alias the input memory
+        for (const auto& y : op.output())
+            viewable &= y != "NULL" && y != x &&
+                !targets.count(y) && first_written[y] == i &&
+                    last_written[y] == i;
+        if (!viewable) continue;
+        Argument arg; arg.set_name("zero_copy"); arg.set_i(1);
+        output_def.mutable_op(i)->add_arg()->CopyFrom(arg);
+    }
+
+    return output_def;
+}
+
 /*! Traverse from input gradients to dying the nodes */
 
 void GraphOptimizer::ForwardPruneTraversal(
@@ -0,0 +1,504 @@
+#include "core/workspace.h"
+#include "core/graph_optimizer.h"
+#include "core/graph_pipeline.h"
+#include "utils/proto_utils.h"
+
+namespace dragon {
+
+namespace {
+
+/*! The tensor exchanged between two stages */
+struct PipelineEdge {
+    string name;
+    int src, dst, tag;
+    bool send_backward, recv_backward;
+};
+
+/*! Return a float argument */
+Argument MakeFloatArgument(const string& name, float value) {
+    Argument arg;
+    arg.set_name(name);
+    arg.set_f(value);
+    return arg;
+}
+
+/*! Return the communication op between this stage and the peer */
+OperatorDef MakeExchangeDef(
+    const string&               type,
+    const vector<string>&       names,
+    const vector<int64_t>&      tags,
+    int                         peer) {
+    OperatorDef op_def;
+    op_def.set_type(type);
+    op_def.set_name(type + "/" + std::to_string(peer));
+    for (const auto& name : names) {
+        if (type == "MPISend") op_def.add_input(name);
+        else op_def.add_output(name);
+    }
+    Argument arg;
+    arg.set_name("tags");
+    for (auto tag : tags) arg.add_ints(tag);
+    op_def.add_arg()->CopyFrom(arg);
+    arg.Clear(); arg.set_name("peer"); arg.set_i(peer);
+    op_def.add_arg()->CopyFrom(arg);
+#ifdef WITH_MPI
+    MPI_Group world_group;
+    MPI_Comm_group(MPI_COMM_WORLD, &world_group);
+    arg.Clear(); arg.set_name("comm");
+    arg.set_i((int64_t)MPI_COMM_WORLD);
+    op_def.add_arg()->CopyFrom(arg);
+    arg.Clear(); arg.set_name("group");
+    arg.set_i((int64_t)world_group);
+    op_def.add_arg()->CopyFrom(arg);
+#endif
+    return op_def;
+}
+
+}  // namespace
+
+/*! Default constructor of <PipelineGraph> */
+
+PipelineGraph::PipelineGraph(const GraphDef& meta_graph, Workspace* ws)
+    : GraphBase(meta_graph, ws) {
+    if (args_.count("phase")) phase_ = args_["phase"].s();
+    if (args_.count("num_micro_batches"))
+        num_micro_batches_ = (int)args_["num_micro_batches"].i();
+    CHECK_GT(num_micro_batches_, 0)
+        << "\nExcepted a positive number of micro-batches.";
+    if (args_.count("micro_batch_inputs")) {
+        for (const auto& e : args_["micro_batch_inputs"].strings())
+            micro_batch_inputs_.push_back(e);
+    }
+    GraphOptimizer optimizer(ws);
+    Create(Partition(optimizer.PruneNodes(meta_graph)), ws);
+}
+
+/*! Return the operators of this stage with the exchanges */
+
+GraphDef PipelineGraph::Partition(const GraphDef& input_def) {
+    const int num_ops = input_def.op_size();
+
+    // Collect the explicit ranks
+    vector<int> ranks(num_ops, -1);
+    Set<int> rank_set;
+    for (int i = 0; i < num_ops; i++) {
+        for (const auto& arg : input_def.op(i).arg()) {
+            if (arg.name() == "mpi_ranks" && arg.ints_size() > 0) {
+                ranks[i] = (int)arg.ints(0);
+                rank_set.insert(ranks[i]);
+            }
+        }
+    }
+
+    int world_rank = 0;
+#ifdef WITH_MPI
+    int mpi_initialized;
+    MPI_Initialized(&mpi_initialized);
+    if (mpi_initialized) MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+#endif
+    stage_ranks_.assign(rank_set.begin(), rank_set.end());
+    std::sort(stage_ranks_.begin(), stage_ranks_.end());
+    if (stage_ranks_.empty()) stage_ranks_.push_back(world_rank);
+#ifndef WITH_MPI
+    CHECK_EQ(stage_ranks_.size(), 1)
+        << "\nMPI was not compiled, "
+        << "could not run the pipeline across ranks.";
+#endif
+    auto stage_iter = std::find(stage_ranks_.begin(),
+        stage_ranks_.end(), world_rank);
+    stage_ = stage_iter == stage_ranks_.end() ? -1 :
+        (int)(stage_iter - stage_ranks_.begin());
+
+    // Inherit the rank of the first consumer
+    Map<string, std::pair<int, int> > consumers;
+    for (int i = num_ops - 1; i >= 0; i--) {
+        const auto& op = input_def.op(i);
+        if (ranks[i] < 0) {
+            int first = num_ops;
+            for (const auto& out : op.output()) {
+                auto it = consumers.find(out);
+                if (it != consumers.end() && it->second.first < first) {
+                    first = it->second.first;
+                    ranks[i] = it->second.second;
+                }
+            }
+        }
+        if (ranks[i] >= 0)
+            for (const auto& in : op.input())
+                consumers[in] = { i, ranks[i] };
+    }
+
+    // Inherit the rank of the latest producers, or the first stage
+    Map<string, int> producers;
+    for (int i = 0; i < num_ops; i++) {
+        const auto& op = input_def.op(i);
+        if (ranks[i] < 0) {
+            for (const auto& in : op.input()) {
+                auto it = producers.find(in);
+                if (it != producers.end())
+                    ranks[i] = std::max(ranks[i], it->second);
+            }
+        }
+        if (ranks[i] < 0) ranks[i] = stage_ranks_[0];
+        for (const auto& out : op.output()) producers[out] = ranks[i];
+    }
+
+    vector<int> stages(num_ops);
+    vector<bool> backwards(num_ops);
+    for (int i = 0; i < num_ops; i++) {
+        stages[i] = (int)(std::find(stage_ranks_.begin(),
+            stage_ranks_.end(), ranks[i]) - stage_ranks_.begin());
+        backwards[i] = input_def.op(i).type()
+            .find("Gradient") != string::npos;
+        has_backward_ |= backwards[i];
+    }
+
+    // Find the tensors crossing the stages
+    vector<PipelineEdge> edges;
+    Set<string> edge_keys;
+    Map<string, std::pair<int, bool> > latest;
+    for (int i = 0; i < num_ops; i++) {
+        const auto& op = input_def.op(i);
+        for (const auto& in : op.input()) {
+            auto it = latest.find(in);
+            if (it == latest.end() || it->second.first == stages[i])
+                continue;
+            PipelineEdge edge = {
+                in, it->second.first, stages[i],
+                (int)edges.size(), it->second.second, backwards[i],
+            };
+            auto key = in + "/" + std::to_string(edge.src) +
+                "/" + std::to_string(edge.dst);
+            if (edge_keys.count(key)) continue;
+            edge_keys.insert(key);
+            CHECK(edge.recv_backward || !edge.send_backward)
+                << "\nTensor(" << in << ") is produced by the backward, "
+                << "but consumed by the forward.";
+            if (!edge.send_backward && !edge.recv_backward) {
+                CHECK_LT(edge.src, edge.dst)
+                    << "\nTensor(" << in << ") of the forward flows from "
+                    << "stage " << edge.src << " to " << edge.dst << ".";
+            } else if (edge.send_backward) {
+                CHECK_GT(edge.src, edge.dst)
+                    << "\nTensor(" << in << ") of the backward flows from "
+                    << "stage " << edge.src << " to " << edge.dst << ".";
+            }
+            edges.push_back(edge);
+        }
+        for (const auto& out : op.output())
+            latest[out] = { stages[i], backwards[i] };
+    }
+
+    GraphDef local_def(input_def);
+    local_def.clear_op();
+    if (stage_ < 0) return local_def;
+
+    auto add_op = [&](const OperatorDef& op_def, Role role) {
+        local_def.add_op()->CopyFrom(op_def);
+        def_roles_.push_back(role);
+    };
+
+    // Generate the exchanges and operators of each pass
+    Set<string> consumed, produced;
+    for (bool backward : { false, true }) {
+        Role role = backward ? BACKWARD : FORWARD;
+        for (int peer = 0; peer < num_stages(); peer++) {
+            vector<string> names; vector<int64_t> tags;
+            for (const auto& edge : edges) {
+                if (edge.dst == stage_ && edge.src == peer &&
+                        edge.recv_backward == backward) {
+                    names.push_back(edge.name);
+                    tags.push_back(edge.tag);
+                }
+            }
+            if (names.empty()) continue;
+            add_op(MakeExchangeDef("MPIRecv", names,
+                tags, stage_ranks_[peer]), role);
+            if (!backward)
+                for (const auto& name : names) produced.insert(name);
+        }
+        for (int i = 0; i < num_ops; i++) {
+            if (stages[i] != stage_ || backwards[i] != backward) continue;
+            const auto& op = input_def.op(i);
+            add_op(op, role);
+            if (backward) continue;
+            for (const auto& in : op.input())
+                if (!produced.count(in)) consumed.insert(in);
+            for (const auto& out : op.output()) {
+                // Skip the persistent tensors updated inplace
+                if (!consumed.count(out)) produced.insert(out);
+            }
+        }
+        for (int peer = 0; peer < num_stages(); peer++) {
+            vector<string> names; vector<int64_t> tags;
+            for (const auto& edge : edges) {
+                if (edge.src == stage_ && edge.dst == peer &&
+                        edge.send_backward == backward) {
+                    names.push_back(edge.name);
+                    tags.push_back(edge.tag);
+                    (backward ? backward_sends_ :
+                        forward_sends_).push_back(edge.name);
+                }
+            }
+            if (names.empty()) continue;
+            add_op(MakeExchangeDef("MPISend", names,
+                tags, stage_ranks_[peer]), role);
+        }
+    }
+    activations_.assign(produced.begin(), produced.end());
+    std::sort(activations_.begin(), activations_.end());
+
+    // Average the outputs and gradients over the micro-batches
+    if (num_micro_batches_ > 1) {
+        vector<string> outputs, grads;
+        for (const auto& e : input_def.output())
+            if (produced.count(e)) outputs.push_back(e);
+        Set<string> backward_outputs;
+        for (int i = 0; i < local_def.op_size(); i++)
+            if (def_roles_[i] == BACKWARD)
+                for (const auto& out : local_def.op(i).output())
+                    backward_outputs.insert(out);
+        for (const auto& gradient : input_def.gradient()) {
+            const string grad = gradient.wrt() + "_grad";
+            if (backward_outputs.count(grad) &&
+                std::find(grads.begin(), grads.end(), grad) == grads.end())
+                grads.push_back(grad);
+        }
+        const float scale = 1.f / num_micro_batches_;
+        for (int k = 0; k < 2; k++) {
+            const auto& names = k == 0 ? outputs : grads;
+            if (names.empty()) continue;
+            vector<string> accs;
+            for (const auto& name : names) accs.push_back(name + "[acc]");
+            for (int i = 0; i < (int)names.size(); i++) {
+                add_op(MakeOperatorDef("Copy", "",
+                    vector<string>({ names[i] }),
+                    vector<string>({ accs[i] })),
+                    k == 0 ? OUTPUT_INIT : GRAD_INIT);
+            }
+            add_op(MakeOperatorDef("Accumulate", "", names, accs,
+                vector<Argument>({ MakeFloatArgument("alpha", 1.f),
+                                   MakeFloatArgument("beta", 1.f) })),
+                k == 0 ? OUTPUT_ACC : GRAD_ACC);
+            // The last micro-batch is already accumulated,
+            // it is safe to overwrite it with the mean
+            add_op(MakeOperatorDef("Accumulate", "", accs, names,
+                vector<Argument>({ MakeFloatArgument("alpha", scale),
+                                   MakeFloatArgument("beta", 0.f) })),
+                k == 0 ? OUTPUT_MEAN : GRAD_MEAN);
+        }
+    }
+    return local_def;
+}
+
+/*! Create a graph from the partitioned def */
+
+bool PipelineGraph::Create(
+    const GraphDef&             optimized_graph,
+    Workspace*                  ws) {
+    bool has_device_option = optimized_graph.has_device_option();
+    for (int i = 0; i < optimized_graph.op_size(); i++) {
+        OperatorDef op_def(optimized_graph.op(i));
+        LOG(DEBUG) << "Create Operator " << op_def.name()
+                   << ": " << op_def.type();
+        // Inherit device option if necessary
+        if (!op_def.has_device_option() && has_device_option)
+            op_def.mutable_device_option()->CopyFrom(
+                optimized_graph.device_option());
+        // Enforce the synchronization at the end of a pass
+        if (i == optimized_graph.op_size() - 1 ||
+                def_roles_[i] != def_roles_[i + 1]) {
+            Argument arg; arg.set_name("do_sync");
+            arg.set_i(1); op_def.add_arg()->CopyFrom(arg);
+        }
+        OperatorBase* op = NewOperator(op_def, ws);
+        if (!phase_.empty()) op->SwitchToPhase(phase_);
+        ops_.push_back(op);
+        roles_.push_back(def_roles_[i]);
+    }
+    return true;
+}
+
+/*! Run the operators of a role */
+
+void PipelineGraph::RunOps(Role role, int stream_id) {
+    for (int i = 0; i < (int)ops_.size(); i++) {
+        if (roles_[i] != role) continue;
+        LOG(DEBUG) << "$ Before Operator: " << ops_[i]->name();
+        ops_[i]->Run(stream_id);
+        LOG(DEBUG) << "$ After Operator: " << ops_[i]->name();
+    }
+}
+
+/*! View the inputs as the rows of a micro-batch */
+
+void PipelineGraph::SliceInputs(int micro_batch) {
+    const int64_t M = num_micro_batches_;
+    for (auto& e : sliced_inputs_) {
+        auto* X = e.first;
+        const auto& batch = *e.second;
+        auto dims = batch.dims();
+        const int64_t begin = dims[0] * micro_batch / M;
+        const int64_t end = dims[0] * (micro_batch + 1) / M;
+        dims[0] = end - begin;
+        X->ShareView(batch, batch.offset() + begin *
+            batch.strides()[0] * batch.meta().itemsize(),
+                dims, batch.strides());
+    }
+}
+
+/*! Move the activations of a micro-batch into the stash */
+
+void PipelineGraph::Stash(int micro_batch) {
+    auto& stash = stash_[micro_batch];
+    for (const auto& name : activations_) {
+        auto* X = ws_->GetTensor(name);
+        unique_ptr<Tensor> stashed;
+        if (X->is_viewable()) {
+            stashed.reset(new Tensor(name));
+            stashed->ShareView(*X,
+                X->offset(), X->dims(), X->strides());
+            // The next micro-batch will write another memory
+            Rotate(X);
+        }
+        stash.push_back(std::move(stashed));
+    }
+}
+
+/*! Move the activations of a micro-batch back */
+
+void PipelineGraph::Restore(int micro_batch) {
+    auto it = stash_.find(micro_batch);
+    CHECK(it != stash_.end())
+        << "\nThe micro-batch " << micro_batch << " is not stashed.";
+    for (int i = 0; i < (int)activations_.size(); i++) {
+        const auto* stashed = it->second[i].get();
+        if (stashed == nullptr) continue;
+        ws_->GetTensor(activations_[i])->ShareView(*stashed,
+            stashed->offset(), stashed->dims(), stashed->strides());
+    }
+    stash_.erase(it);
+}
+
+/*! Switch a tensor to a free memory, keep the used one */
+
+void PipelineGraph::Rotate(Tensor* X) {
+    if (!X->is_viewable() || !X->is_contiguous()) { X->Reset(); return; }
+    auto& pool = memory_pool_[X->name()];
+    // The memory is free if only held by the pool
+    Tensor* free = nullptr;
+    bool pooled = false;
+    for (auto it = pool.begin(); it != pool.end();) {
+        auto* holder = it->get();
+        if (X->IsViewOf(*holder)) {
+            pooled = true;
+        } else if (!holder->is_memory_shared()) {
+            if (holder->memory()->nbytes() < X->nbytes()) {
+                // The micro-batch has grown, never fit again
+                it = pool.erase(it); continue;
+            }
+            if (!free) free = holder;
+        }
+        ++it;
+    }
+    if (!pooled) {
+        pool.emplace_back(new Tensor(X->name()));
+        pool.back()->ShareView(*X, X->offset(), X->dims(), X->strides());
+    }
+    if (free) {
+        X->ShareView(*free, 0, X->dims(), X->strides());
+    } else {
+        X->Reset();
+    }
+}
+
+/*! Run the forward pass of a micro-batch */
+
+void PipelineGraph::Forward(int micro_batch, bool stash, int stream_id) {
+    SliceInputs(micro_batch);
+    RunOps(FORWARD, stream_id);
+    if (num_micro_batches_ > 1)
+        RunOps(micro_batch == 0 ? OUTPUT_INIT : OUTPUT_ACC, stream_id);
+    if (stash) {
+        Stash(micro_batch);
+    } else {
+        // The sending memory is held by the exchange,
+        // rotate to avoid overwriting it by the next micro-batch
+        for (const auto& name : forward_sends_)
+            Rotate(ws_->GetTensor(name));
+    }
+}
+
+/*! Run the backward pass of a micro-batch */
+
+void PipelineGraph::Backward(int micro_batch, int stream_id) {
+    Restore(micro_batch);
+    SliceInputs(micro_batch);
+    RunOps(BACKWARD, stream_id);
+    if (num_micro_batches_ > 1)
+        RunOps(micro_batch == 0 ? GRAD_INIT : GRAD_ACC, stream_id);
+    for (const auto& name : backward_sends_)
+        Rotate(ws_->GetTensor(name));
+}
+
+/*! Run all the micro-batches once synchronously */
+
+bool PipelineGraph::Run(
+    const string&               include,
+    const string&               exclude,
+    int                         stream_id) {
+    CHECK(include.empty() && (exclude.empty() || exclude == "Gradient"))
+        << "\nThe pipeline could only run the forward or all operators.";
+    LOG(DEBUG) << "Run Graph: " << name();
+    if (stage_ < 0) return true;
+    const int M = num_micro_batches_;
+
+    // Hold the whole batch of inputs
+    sliced_inputs_.clear();
+    for (const auto& name : micro_batch_inputs_) {
+        if (!ws_->HasTensor(name)) continue;
+        auto* X = ws_->GetTensor(name);
+        // Equal micro-batches make the mean of them the mean of batch
+        CHECK(X->is_viewable() && X->ndim() > 0 && X->dim(0) % M == 0)
+            << "\nCould not split Tensor(" << name << ") "
+            << "into " << M << " equal micro-batches.";
+        unique_ptr<Tensor> batch(new Tensor(name));
+        batch->ShareView(*X, X->offset(), X->dims(), X->strides());
+        sliced_inputs_.emplace_back(X, std::move(batch));
+    }
+
+    if (!has_backward_ || !exclude.empty()) {
+        for (int i = 0; i < M; i++) Forward(i, false, stream_id);
+    } else {
+        // The 1F1B schedule
+        const int num_warmups = std::min(
+            num_stages() - stage_ - 1, M);
+        int num_forwards = 0, num_backwards = 0;
+        while (num_forwards < num_warmups)
+            Forward(num_forwards++, true, stream_id);
+        while (num_forwards < M) {
+            Forward(num_forwards++, true, stream_id);
+            Backward(num_backwards++, stream_id);
+        }
+        while (num_backwards < M)
+            Backward(num_backwards++, stream_id);
+    }
+
+    // Restore the whole batch of inputs
+    for (auto& e : sliced_inputs_) {
+        const auto& batch = *e.second;
+        e.first->ShareView(batch, batch.offset(),
+            batch.dims(), batch.strides());
+    }
+    sliced_inputs_.clear();
+
+    if (M > 1) {
+        RunOps(OUTPUT_MEAN, stream_id);
+        if (exclude.empty()) RunOps(GRAD_MEAN, stream_id);
+    }
+    return true;
+}
+
+REGISTER_GRAPH(Pipeline, PipelineGraph);
+
+}  // namespace dragon
@@ -1,9 +1,18 @@
+#include <atomic>
+
 #include "core/mixedmem.h"
 #include "utils/cuda_device.h"
 #include "utils/string.h"
 
 namespace dragon {
 
+#ifdef WITH_MKL
+int64_t MixedMemory::NewEpoch() {
+    static std::atomic<int64_t> epoch(0);
+    return ++epoch;
+}
+#endif
+
 void MixedMemory::ToCPU(size_t nbytes) {
     switch (state_) {
         case UNINITIALIZED:
@@ -65,23 +74,27 @@ const void* MixedMemory::cnml_data() {
 }
 
 void* MixedMemory::mutable_cpu_data(size_t nbytes) {
+    RenewEpoch();
     ToCPU(nbytes);
     state_ = STATE_AT_CPU;
     return cpu_ptr_;
 }
 
 void* MixedMemory::mutable_cuda_data(size_t nbytes) {
+    RenewEpoch();
     ToCUDA(nbytes);
     state_ = STATE_AT_CUDA;
     return cuda_ptr_;
 }
 
 void* MixedMemory::mutable_cnml_data() {
+    RenewEpoch();
     state_ = STATE_AT_CNML;
     return cnml_ptr_;
 }
 
 void MixedMemory::set_cpu_data(void* cpu_ptr, size_t nbytes) {
+    RenewEpoch();
     bool use_cudahost_mem = false;
 #ifdef WITH_CUDA_HOST_MEM
     use_cudahost_mem = true;
@@ -94,18 +107,49 @@ void MixedMemory::set_cpu_data(void* cpu_ptr, size_t nbytes) {
 #ifdef WITH_CUDA
     if (own_cpu_ptr_ && cpu_ptr_ &&
             use_cudahost_mem) cudaFreeHost(cpu_ptr_);
-    if (cuda_ptr_ && nbytes > nbytes_) {
+    if (cuda_ptr_ && (nbytes > nbytes_ || !own_cuda_ptr_)) {
         // Maintain the cuda ptr as regular mems
-        CUDAContext::Delete(cuda_ptr_);
-        cuda_ptr_ = nullptr;
+        if (own_cuda_ptr_) CUDAContext::Delete(cuda_ptr_);
+        cuda_ptr_ = nullptr; own_cuda_ptr_ = true;
     }
 #endif
+    if (deleter_) { deleter_(); deleter_ = nullptr; }
     cpu_ptr_ = cpu_ptr;
     nbytes_ = nbytes;
     state_ = STATE_AT_CPU;
     own_cpu_ptr_ = false;
 }
 
+void MixedMemory::set_cuda_data(
+    void*                   cuda_ptr,
+    size_t                  nbytes,
+    int                     device_id) {
+#ifdef WITH_CUDA
+    RenewEpoch();
+    bool use_cudahost_mem = false;
+#ifdef WITH_CUDA_HOST_MEM
+    use_cudahost_mem = true;
+#endif
+    if (own_cuda_ptr_ && cuda_ptr_) CUDAContext::Delete(cuda_ptr_);
+    if (cpu_ptr_ && (nbytes > nbytes_ || !own_cpu_ptr_)) {
+        // Maintain the cpu ptr as regular mems
+        if (own_cpu_ptr_) {
+            if (use_cudahost_mem) cudaFreeHost(cpu_ptr_);
+            else CPUContext::Delete(cpu_ptr_);
+        }
+        cpu_ptr_ = nullptr; own_cpu_ptr_ = true;
+    }
+    if (deleter_) { deleter_(); deleter_ = nullptr; }
+    cuda_ptr_ = cuda_ptr;
+    nbytes_ = nbytes;
+    ptr_device_ = device_id;
+    state_ = STATE_AT_CUDA;
+    own_cuda_ptr_ = false;
+#else
+    CUDA_NOT_COMPILED;
+#endif
+}
+
 MixedMemory::~MixedMemory() {
     bool use_cudahost_mem = false;
 #ifdef WITH_CUDA_HOST_MEM
@@ -119,8 +163,9 @@ MixedMemory::~MixedMemory() {
 #ifdef WITH_CUDA
     if (own_cpu_ptr_ && cpu_ptr_ &&
             use_cudahost_mem) cudaFreeHost(cpu_ptr_);
-    if (cuda_ptr_) CUDAContext::Delete(cuda_ptr_);
+    if (cuda_ptr_ && own_cuda_ptr_) CUDAContext::Delete(cuda_ptr_);
 #endif
+    if (deleter_) deleter_();
 }
 
 void MixedMemory::SwitchToDevice(int device_id) {
@@ -139,10 +184,11 @@ void MixedMemory::SwitchToCUDADevice(int device_id) {
             new_ptr_ = CUDAContext::New(nbytes_);
             CUDAContext::MemcpyEx<CUDAContext, CUDAContext>(
                 nbytes_, new_ptr_, cuda_ptr_, ptr_device_);
-            CUDAContext::Delete(cuda_ptr_);
+            if (own_cuda_ptr_) CUDAContext::Delete(cuda_ptr_);
             // Update the pointer
             cuda_ptr_ = new_ptr_;
             ptr_device_ = device_id;
+            own_cuda_ptr_ = true;
         }
     }
 #endif
@@ -1,6 +1,7 @@
 #include "core/operator.h"
 #include "core/workspace.h"
 #include "utils/logging.h"
+#include "utils/op_kernel.h"
 
 namespace dragon {
 
@@ -90,6 +91,21 @@ void OperatorBase::UpdateFrom(const OperatorDef& def) {
         outputs_[i] = ws()->CreateTensor(def.output(i));
 }
 
+/*! Modify this operator with the resolved tensors */
+
+void OperatorBase::UpdateFrom(
+    const vector<Tensor*>&      inputs,
+    const vector<Tensor*>&      outputs,
+    const string&               anchor) {
+    CHECK_EQ(inputs.size(), inputs_.size())
+        << "\nThe number of inputs of " << type() << "Op is fixed.";
+    CHECK_EQ(outputs.size(), outputs_.size())
+        << "\nThe number of outputs of " << type() << "Op is fixed.";
+    if (anchor_ != anchor) anchor_ = anchor;
+    inputs_ = inputs;
+    outputs_ = outputs;
+}
+
 /*! Create a operator instance from the factory  */
 
 OperatorBase* TryCreateOperator(
@@ -209,6 +225,67 @@ void Operator<Context>::ReleaseResource() {
     }
 }
 
+/*! Materialize the strided view into a contiguous tensor */
+
+template <typename T, class Context>
+void _Contiguous(
+    Tensor*                     X,
+    Tensor*                     buffer,
+    Tensor*                     x_strides,
+    Tensor*                     y_dims,
+    Context*                    ctx) {
+    buffer->Reshape(X->dims());
+    auto* XSS = x_strides->template data<int, Context>();
+    auto* YDS = y_dims->template data<int, Context>();
+    auto* Xdata = static_cast<const T*>(
+        X->template const_data_ptr<Context>());
+    auto* Ydata = buffer->template mutable_data<T, Context>();
+    kernel::Transpose(buffer->count(), buffer->ndim(),
+        XSS, YDS, Xdata, Ydata, ctx);
+    // The viewed memory is released after sharing the buffer
+    X->ShareView(*buffer, 0, buffer->dims(), buffer->strides());
+}
+
+template <class Context>
+void Operator<Context>::Contiguous(Tensor* X) {
+    auto* x_strides = ws()->CreateTensor(
+        "/share/contiguous/x_strides")->Reshape({ X->ndim() });
+    auto* y_dims = ws()->CreateTensor(
+        "/share/contiguous/y_dims")->Reshape({ X->ndim() });
+    auto* XSS = x_strides->template mutable_data<int, CPUContext>();
+    auto* YDS = y_dims->template mutable_data<int, CPUContext>();
+    for (int i = 0; i < X->ndim(); i++) {
+        XSS[i] = (int)X->stride(i); YDS[i] = (int)X->dim(i);
+    }
+    // Reuse the buffer of last run unless others still hold it
+    auto& buffer = contiguous_buffers_[X];
+    if (!buffer || buffer->is_memory_shared())
+        buffer.reset(new Tensor(X->name() + "/contiguous"));
+    auto* Y = buffer.get();
+    if (XIsType((*X), bool)) _Contiguous<bool>(X, Y, x_strides, y_dims, ctx());
+    else if (XIsType((*X), int8_t)) _Contiguous<int8_t>(X, Y, x_strides, y_dims, ctx());
+    else if (XIsType((*X), uint8_t)) _Contiguous<uint8_t>(X, Y, x_strides, y_dims, ctx());
+    else if (XIsType((*X), int)) _Contiguous<int>(X, Y, x_strides, y_dims, ctx());
+    else if (XIsType((*X), int64_t)) _Contiguous<int64_t>(X, Y, x_strides, y_dims, ctx());
+    else if (XIsType((*X), float16)) _Contiguous<float16>(X, Y, x_strides, y_dims, ctx());
+    else if (XIsType((*X), float)) _Contiguous<float>(X, Y, x_strides, y_dims, ctx());
+    else if (XIsType((*X), double)) _Contiguous<double>(X, Y, x_strides, y_dims, ctx());
+    else LOG(FATAL) << DTypeHelper(*X, {
+        "bool", "int8", "uint8", "int32", "int64",
+            "float16", "float32", "float64",
+    });
+}
+
+template <> void Operator<CNMLContext>::Contiguous(Tensor* X) {
+    LOG(FATAL) << "Strided views are not supported for CNMLContext.";
+}
+
+#ifndef WITH_CUDA
+template <> void Operator<CUDAContext>::Contiguous(Tensor* X) {
+    CUDA_NOT_COMPILED;
+}
+#endif
+
 /*! Operator Registry */
 
 DEFINE_REGISTRY(
@@ -290,5 +367,9 @@ template void Operator<CNMLContext>::PrepareResource();
 template void Operator<CPUContext>::ReleaseResource();
 template void Operator<CUDAContext>::ReleaseResource();
 template void Operator<CNMLContext>::ReleaseResource();
+template void Operator<CPUContext>::Contiguous(Tensor*);
+#ifdef WITH_CUDA
+template void Operator<CUDAContext>::Contiguous(Tensor*);
+#endif
 
 }  // namespace dragon
\ No newline at end of file
@@ -0,0 +1,221 @@
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <set>
+#include <tuple>
+
+#include "core/scratch.h"
+
+namespace dragon {
+
+#define SCRATCH_ALIGN 256
+
+namespace {
+
+typedef std::tuple<TypeId, int, int> ArenaKey;
+
+/*! The last arena of current thread, to skip the lookup */
+TLS_OBJECT ScratchArena* g_last_arena = nullptr;
+TLS_OBJECT TypeId g_last_type = 0;
+TLS_OBJECT int g_last_device = 0, g_last_stream = 0;
+
+/*! The arenas of a thread, which are freed at the thread exit */
+struct ThreadArenas {
+    ThreadArenas();
+    ~ThreadArenas();
+    std::map<ArenaKey, unique_ptr<ScratchArena> > arenas;
+};
+
+std::mutex& ArenaMutex() {
+    // Never destroyed, the threads may exit after the statics
+    static std::mutex* mutex = new std::mutex();
+    return *mutex;
+}
+
+std::set<ThreadArenas*>& ArenaRegistry() {
+    static std::set<ThreadArenas*>* registry = new std::set<ThreadArenas*>();
+    return *registry;
+}
+
+ThreadArenas::ThreadArenas() {
+    std::lock_guard<std::mutex> lock(ArenaMutex());
+    ArenaRegistry().insert(this);
+}
+
+ThreadArenas::~ThreadArenas() {
+    std::map<ArenaKey, unique_ptr<ScratchArena> > released;
+    {
+        std::lock_guard<std::mutex> lock(ArenaMutex());
+        ArenaRegistry().erase(this);
+        released.swap(arenas);
+    }
+    g_last_arena = nullptr;
+}
+
+thread_local ThreadArenas g_thread_arenas;
+
+std::atomic<size_t> g_scratch_limit(0);
+
+/*! The stream of the innermost scope */
+TLS_OBJECT int g_current_stream = 0;
+
+}  // namespace
+
+/*! Allocate the given bytes from the top */
+
+void* ScratchArena::Alloc(size_t nbytes) {
+    nbytes = std::max((nbytes + SCRATCH_ALIGN - 1)
+        / SCRATCH_ALIGN * SCRATCH_ALIGN, (size_t)SCRATCH_ALIGN);
+    // Find a chunk fitting the bytes after the top
+    for (auto& chunk : chunks_) {
+        if (chunk.begin + chunk.nbytes <= used_) continue;
+        const size_t offset = std::max(used_, chunk.begin);
+        if (offset + nbytes > chunk.begin + chunk.nbytes) continue;
+        used_ = offset + nbytes;
+        peak_ = std::max(peak_, used_);
+        Publish();
+        return (uint8_t*)chunk.data + (offset - chunk.begin);
+    }
+    // Append a new chunk, which doubles the capacity
+    const size_t max_bytes = limit();
+    size_t chunk_nbytes = std::max(nbytes, capacity_);
+    if (max_bytes > 0 && capacity_ + chunk_nbytes > max_bytes)
+        chunk_nbytes = std::max(nbytes, max_bytes - std::min(
+            max_bytes, capacity_));
+    CHECK(max_bytes == 0 || capacity_ + chunk_nbytes <= max_bytes)
+        << "\nRequest " << nbytes << " bytes of scratch, "
+        << "while " << capacity_ << " bytes are in use."
+        << "\nThe scratch would exceed the limit of "
+        << max_bytes << " bytes.";
+    chunks_.push_back({ new_func_(chunk_nbytes), capacity_, chunk_nbytes });
+    used_ = capacity_ + nbytes;
+    capacity_ += chunk_nbytes;
+    peak_ = std::max(peak_, used_);
+    Publish();
+    return chunks_.back().data;
+}
+
+/*! Allocate the bytes reusing the last shared block */
+
+void* ScratchArena::AllocShared(size_t nbytes) {
+    if (shared_end_ > 0 &&
+        shared_end_ == used_ &&
+        shared_begin_ >= floor_) used_ = shared_begin_;
+    void* data = Alloc(nbytes);
+    shared_end_ = used_;
+    shared_begin_ = used_ - std::max((nbytes + SCRATCH_ALIGN - 1)
+        / SCRATCH_ALIGN * SCRATCH_ALIGN, (size_t)SCRATCH_ALIGN);
+    return data;
+}
+
+/*! Release the scratch allocated after the mark */
+
+void ScratchArena::Release(size_t mark) {
+    used_ = std::min(used_, mark);
+    if (shared_end_ > used_) shared_begin_ = shared_end_ = 0;
+    if (used_ == 0 && chunks_.size() > 1) {
+        // Coalesce the chunks into the high-water size
+        const size_t nbytes = peak_;
+        Clear();
+        chunks_.push_back({ new_func_(nbytes), 0, nbytes });
+        capacity_ = nbytes;
+    }
+    Publish();
+}
+
+/*! Free all the chunks */
+
+void ScratchArena::Clear() {
+    for (auto& chunk : chunks_) delete_func_(chunk.data);
+    chunks_.clear();
+    used_ = capacity_ = shared_begin_ = shared_end_ = 0;
+    Publish();
+}
+
+/*! Store the counters for the readers of other threads */
+
+void ScratchArena::Publish() {
+    stats_[0].store(used_, std::memory_order_relaxed);
+    stats_[1].store(peak_, std::memory_order_relaxed);
+    stats_[2].store(capacity_, std::memory_order_relaxed);
+}
+
+/*! Return the arena by the type, device and stream */
+
+ScratchArena* ScratchArena::Get(
+    TypeId                      type,
+    int                         device_id,
+    int                         stream_id,
+    NewFunction                 new_func,
+    DeleteFunction              delete_func) {
+    if (g_last_arena && g_last_type == type &&
+        g_last_device == device_id &&
+        g_last_stream == stream_id) return g_last_arena;
+    // Register the arenas of this thread before locking
+    auto& arenas = g_thread_arenas.arenas;
+    // Lock for the <Stats> reading the arenas of all threads
+    std::lock_guard<std::mutex> lock(ArenaMutex());
+    auto& arena = arenas[ArenaKey(type, device_id, stream_id)];
+    if (!arena) arena.reset(new ScratchArena(new_func, delete_func));
+    g_last_arena = arena.get();
+    g_last_type = type;
+    g_last_device = device_id;
+    g_last_stream = stream_id;
+    return g_last_arena;
+}
+
+/*! Return the statistics of all the arenas */
+
+void ScratchArena::Stats(
+    size_t*                     used,
+    size_t*                     peak,
+    size_t*                     capacity) {
+    std::lock_guard<std::mutex> lock(ArenaMutex());
+    *used = *peak = *capacity = 0;
+    for (auto* thread_arenas : ArenaRegistry()) {
+        for (auto& it : thread_arenas->arenas) {
+            *used += it.second->used();
+            *peak += it.second->peak();
+            *capacity += it.second->capacity();
+        }
+    }
+}
+
+/*! Set the max bytes of an arena, 0 for unlimited */
+
+void ScratchArena::SetLimit(size_t nbytes) { g_scratch_limit = nbytes; }
+
+/*! Return the max bytes of an arena */
+
+size_t ScratchArena::limit() { return g_scratch_limit; }
+
+/*! Return the stream of the innermost scope */
+
+int ScratchArena::current_stream() { return g_current_stream; }
+
+/*! Constructor of <ScratchScope> */
+
+ScratchScope::ScratchScope(ScratchArena* arena, int stream_id)
+    : arena_(arena), mark_(arena->Mark()),
+      prev_floor_(arena->floor_),
+      prev_shared_begin_(arena->shared_begin_),
+      prev_shared_end_(arena->shared_end_),
+      prev_stream_(g_current_stream) {
+    arena_->floor_ = mark_;
+    g_current_stream = stream_id;
+}
+
+/*! Deconstructor of <ScratchScope> */
+
+ScratchScope::~ScratchScope() {
+    arena_->Release(mark_);
+    // Restore the shared block of the outer scope
+    arena_->floor_ = prev_floor_;
+    arena_->shared_begin_ = prev_shared_begin_;
+    arena_->shared_end_ = prev_shared_end_;
+    g_current_stream = prev_stream_;
+}
+
+#undef SCRATCH_ALIGN
+
+}  // namespace dragon
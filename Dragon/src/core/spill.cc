@@ -0,0 +1,162 @@
+#include <cstdlib>
+#include <thread>
+
+#if defined(__linux__) || defined(__APPLE__)
+#define WITH_SPILL_MMAP
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+#include "core/context.h"
+#include "core/spill.h"
+
+namespace dragon {
+
+#define SPILL_ALIGN 4096
+
+/*! Return the global spill area */
+
+SpillArea* SpillArea::Get() {
+    // Never destroyed, the queued copies may outlive the statics
+    static SpillArea* area = new SpillArea();
+    return area;
+}
+
+/*! Default constructor of <SpillArea> */
+
+SpillArea::SpillArea() {
+    std::thread(&SpillArea::ThreadRun, this).detach();
+}
+
+/*! Map a block from the spill file, nullptr if failed */
+
+void* SpillArea::NewMapped(size_t nbytes) {
+#ifdef WITH_SPILL_MMAP
+    if (fd_ == -1) {
+        const char* dir = getenv("DRAGON_SPILL_DIR");
+        string path = string(dir ? dir : "/tmp") + "/dragon_spill_XXXXXX";
+        fd_ = mkstemp(&path[0]);
+        if (fd_ >= 0) {
+            // The file is removed once the process exits
+            unlink(path.c_str());
+        } else {
+            LOG(WARNING) << "Failed to create the spill file under "
+                         << path.substr(0, path.rfind('/'))
+                         << ", use the heap memory instead.";
+            fd_ = -2;
+        }
+    }
+    if (fd_ < 0) return nullptr;
+    if (ftruncate(fd_, (off_t)(file_size_ + nbytes)) != 0) return nullptr;
+    void* data = mmap(nullptr, nbytes, PROT_READ | PROT_WRITE,
+        MAP_SHARED, fd_, (off_t)file_size_);
+    if (data == MAP_FAILED) return nullptr;
+    file_size_ += nbytes;
+    return data;
+#else
+    return nullptr;
+#endif
+}
+
+/*! Allocate a block of the given bytes */
+
+void* SpillArea::Alloc(size_t nbytes, bool pinned) {
+    nbytes = (nbytes + SPILL_ALIGN - 1) / SPILL_ALIGN * SPILL_ALIGN;
+    std::lock_guard<std::mutex> lock(mutex_);
+    void* data = nullptr;
+    // Take the smallest free block, unless it wastes over a half
+    auto& free_blocks = free_blocks_[pinned ? 1 : 0];
+    auto it = free_blocks.lower_bound(nbytes);
+    if (it != free_blocks.end() && it->first / 2 <= nbytes) {
+        data = it->second;
+        free_blocks.erase(it);
+    } else {
+        if (pinned) {
+#ifdef WITH_CUDA
+            CUDA_CHECK(cudaMallocHost(&data, nbytes));
+#endif
+        } else {
+            data = NewMapped(nbytes);
+        }
+        if (!data) data = malloc(nbytes);
+        CHECK(data) << "\nMalloc spill: " << nbytes << " bytes failed.";
+        blocks_[data] = Block({ nbytes, pinned });
+        capacity_ += nbytes;
+    }
+    used_ += blocks_[data].nbytes;
+    peak_ = std::max(peak_, used_);
+    return data;
+}
+
+/*! Return the block for reusing */
+
+void SpillArea::Free(void* data) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = blocks_.find(data);
+    CHECK(it != blocks_.end()) << "\nFree an unknown spill block.";
+    used_ -= it->second.nbytes;
+    free_blocks_[it->second.pinned ? 1 : 0].emplace(
+        it->second.nbytes, data);
+}
+
+/*! Store the entry of a tensor, free the replaced one */
+
+void SpillArea::Put(const void* key, const Entry& entry) {
+    void* replaced = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(key);
+        if (it != entries_.end()) replaced = it->second.data;
+        entries_[key] = entry;
+    }
+    // The entry is never taken if its prefetch was filtered out
+    if (replaced) Free(replaced);
+}
+
+/*! Remove the entry of a tensor, return false if missing */
+
+bool SpillArea::Take(const void* key, Entry* entry) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) return false;
+    *entry = it->second;
+    entries_.erase(it);
+    return true;
+}
+
+/*! Queue a copy and return the future of it */
+
+std::future<void> SpillArea::Submit(std::function<void()> job) {
+    std::packaged_task<void()> task(job);
+    auto future = task.get_future();
+    {
+        std::lock_guard<std::mutex> lock(job_mutex_);
+        jobs_.push_back(std::move(task));
+    }
+    cond_.notify_one();
+    return future;
+}
+
+/*! Run the queued copies one by one */
+
+void SpillArea::ThreadRun() {
+    while (true) {
+        std::packaged_task<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(job_mutex_);
+            cond_.wait(lock, [this]() { return !jobs_.empty(); });
+            task = std::move(jobs_.front());
+            jobs_.pop_front();
+        }
+        task();
+    }
+}
+
+/*! Return the bytes in use, the high-water and all blocks */
+
+void SpillArea::Stats(size_t* used, size_t* peak, size_t* capacity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    *used = used_; *peak = peak_; *capacity = capacity_;
+}
+
+}  // namespace dragon
@@ -18,22 +18,52 @@ void Workspace::InitWorkspace() {
 
 Workspace* Workspace::Move(Workspace* ws) {
     CHECK(ws) << "The given Workspace is invalid.";
-    if (workspace_map_.count(ws->name()))
-        return workspace_map_[ws->name()];
-    return workspace_map_[ws->name()] = ws;
+    std::lock_guard<std::mutex> lock(tensor_mutex_);
+    return workspace_map_.emplace(ws->name(), ws).first->second;
+}
+
+/*! Return the external workspaces */
+
+vector<Workspace*> Workspace::remotes() const {
+    vector<Workspace*> ret;
+    std::lock_guard<std::mutex> lock(tensor_mutex_);
+    for (const auto& it : workspace_map_) ret.push_back(it.second);
+    return ret;
+}
+
+/*! Share the tensors of a external workspace by copy-on-write */
+
+void Workspace::Share(Workspace* ws) {
+    CHECK(ws) << "The given Workspace is invalid.";
+    if (ws == this) return;
+    std::unique_lock<std::mutex> lock1(tensor_mutex_, std::defer_lock);
+    std::unique_lock<std::mutex> lock2(ws->tensor_mutex_, std::defer_lock);
+    std::lock(lock1, lock2);
+    for (const auto& it : ws->tensor_map_) {
+        // Internal tensors, e.g. caches and flags, are not shared
+        if (it.first == "NULL" || it.first[0] == '/') continue;
+        if (!it.second->is_viewable()) continue;
+        auto& tensor = tensor_map_[it.first];
+        if (!tensor) tensor.reset(new Tensor(it.first));
+        tensor->ShareCopyOnWrite(*it.second);
+    }
 }
 
 /*! Destory all the tensors */
 
 void Workspace::Clear() {
     // Clear tensors, then re-initialization
-    for (auto& kv : tensor_map_) kv.second->Reset();
+    {
+        std::lock_guard<std::mutex> lock(tensor_mutex_);
+        for (auto& kv : tensor_map_) kv.second->Reset();
+    }
     InitWorkspace();
 }
 
 /*! Query the real name of specified tensor */
 
 string Workspace::GetTensorName(const string& name) const {
+    std::lock_guard<std::mutex> lock(tensor_mutex_);
     const auto& it = tensor_alias_map_.find(name);
     if (it != tensor_alias_map_.end()) return it->second;
     return name;
@@ -48,14 +78,17 @@ Tensor* Workspace::TryGetTensor(
     string query = GetTensorName(name);
 
     // Search the local workspace
-    const auto& it = tensor_map_.find(query);
-    if (it != tensor_map_.end()) return it->second.get();
+    {
+        std::lock_guard<std::mutex> lock(tensor_mutex_);
+        const auto& it = tensor_map_.find(query);
+        if (it != tensor_map_.end()) return it->second.get();
+    }
 
     if (use_remote) {
         // Search the remote workspaces
-        for (auto& it : workspace_map_) {
-            if (it.second->HasTensor(query))
-                return it.second->GetTensor(query);
+        for (auto* ws : remotes()) {
+            Tensor* tensor = ws->TryGetTensor(query);
+            if (tensor) return tensor;
         }
     }
     return nullptr;
@@ -66,8 +99,10 @@ Tensor* Workspace::TryGetTensor(
 Tensor* Workspace::CreateTensor(const string& name) {
     Tensor* tensor = TryGetTensor(name);
     if (!tensor) {
-        tensor_map_[name] = unique_ptr<Tensor>(new Tensor(name));
-        return tensor_map_[name].get();
+        std::lock_guard<std::mutex> lock(tensor_mutex_);
+        auto& created = tensor_map_[name];
+        if (!created) created.reset(new Tensor(name));
+        return created.get();
     }
     return tensor;
 }
@@ -97,13 +132,16 @@ void Workspace::ResetTensor(const string& name) {
 vector<string> Workspace::GetTensors() const {
     vector<string> locals;
     // Search the local workspace
-    for (const auto& it : tensor_map_)
-        locals.push_back(it.first);
+    {
+        std::lock_guard<std::mutex> lock(tensor_mutex_);
+        for (const auto& it : tensor_map_)
+            locals.push_back(it.first);
+    }
 
     // Serach the remote workspaces
-    for (const auto& it : workspace_map_) {
-        vector<string> remotes = it.second->GetTensors();
-        locals.insert(locals.end(), remotes.begin(), remotes.end());
+    for (auto* ws : remotes()) {
+        vector<string> names = ws->GetTensors();
+        locals.insert(locals.end(), names.begin(), names.end());
     }
     return locals;
 }
@@ -114,12 +152,16 @@ bool Workspace::HasFiller(
     const string&               name,
     bool                        use_remote) const {
     // Search the local workspace
-    bool result = tensor_filler_map_.count(name) > 0;
+    bool result;
+    {
+        std::lock_guard<std::mutex> lock(tensor_mutex_);
+        result = tensor_filler_map_.count(name) > 0;
+    }
     if (!use_remote) return result;
 
     // Search the remote workspaces
-    for (auto& it : workspace_map_)
-        result |= it.second->HasFiller(name);
+    for (auto* ws : remotes())
+        result |= ws->HasFiller(name);
     return result;
 }
 
@@ -129,7 +171,8 @@ void Workspace::CreateFiller(
     CHECK_GT(filler.tensor().size(), 0)
         << "\nTensor with an empty name can not be filled.";
     if (HasFiller(filler.tensor())) return;
-    tensor_filler_map_[filler.tensor()] = filler;
+    std::lock_guard<std::mutex> lock(tensor_mutex_);
+    tensor_filler_map_.emplace(filler.tensor(), filler);
 }
 
 /*! Return the specified filler */
@@ -137,13 +180,16 @@ void Workspace::CreateFiller(
 const TensorFillerProto* Workspace::GetFiller(
     const string&               name) const {
     // Search the local workspace
-    const auto& it = tensor_filler_map_.find(name);
-    if (it != tensor_filler_map_.end()) return &it->second;
+    {
+        std::lock_guard<std::mutex> lock(tensor_mutex_);
+        const auto& it = tensor_filler_map_.find(name);
+        if (it != tensor_filler_map_.end()) return &it->second;
+    }
 
     // Search the remote workspaces
-    for (const auto& it : workspace_map_) {
-        if (it.second->HasFiller(name))
-            return it.second->GetFiller(name);
+    for (auto* ws : remotes()) {
+        const auto* filler = ws->GetFiller(name);
+        if (filler) return filler;
     }
     return nullptr;
 }
@@ -151,14 +197,17 @@ const TensorFillerProto* Workspace::GetFiller(
 /*! Create a operator in this workspace */
 
 OperatorBase* Workspace::CreateOperator(const OperatorDef& def) {
-    const auto& it = operator_map_.find(def.uid());
-    if (it == operator_map_.end()) {
-        for (auto& input : def.input()) CreateTensor(input);
-        auto* new_op = NewOperator(def, this);
-        operator_map_[def.uid()] = unique_ptr<
-            OperatorBase>(new_op); return new_op;
+    {
+        std::lock_guard<std::mutex> lock(tensor_mutex_);
+        const auto& it = operator_map_.find(def.uid());
+        if (it != operator_map_.end()) return it->second.get();
     }
-    return it->second.get();
+    // The constructor creates the tensors, run it without the lock
+    for (auto& input : def.input()) CreateTensor(input);
+    unique_ptr<OperatorBase> new_op(NewOperator(def, this));
+    std::lock_guard<std::mutex> lock(tensor_mutex_);
+    return operator_map_.emplace(def.uid(),
+        std::move(new_op)).first->second.get();
 }
 
 /*! Run the specified existing operator */
@@ -190,10 +239,11 @@ GraphBase* Workspace::CreateGraph(const GraphDef& def) {
     GraphDef mutable_def(def);
     mutable_def.set_name(unique_name);
 
-    graph_map_[unique_name] = unique_ptr<GraphBase>(
-        NewGraph(mutable_def, this));
-
-    return graph_map_[unique_name].get();
+    unique_ptr<GraphBase> new_graph(NewGraph(mutable_def, this));
+    std::lock_guard<std::mutex> lock(tensor_mutex_);
+    auto& graph = graph_map_[unique_name];
+    graph = std::move(new_graph);
+    return graph.get();
 }
 
 /*! Run the specifed graph by name and rules */
@@ -203,16 +253,22 @@ void Workspace::RunGraph(
     const string&               include,
     const string&               exclude,
     int                         stream_id) {
-    if (!graph_map_.count(graph_name))
-        LOG(FATAL) << "Graph(" << graph_name
-                   << ") does not exist.";
-    graph_map_[graph_name]->Run(include, exclude, stream_id);
+    GraphBase* graph = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(tensor_mutex_);
+        const auto& it = graph_map_.find(graph_name);
+        if (it != graph_map_.end()) graph = it->second.get();
+    }
+    if (!graph) LOG(FATAL) << "Graph(" << graph_name
+                           << ") does not exist.";
+    graph->Run(include, exclude, stream_id);
 }
 
 /*! Return all the stored graph names */
 
 vector<string> Workspace::GetGraphs() const {
     vector<string> names;
+    std::lock_guard<std::mutex> lock(tensor_mutex_);
     for (const auto& it : graph_map_) {
         names.push_back(it.first);
     } return names;
@@ -224,6 +280,7 @@ bool Workspace::SetTensorAlias(
     const string&               name,
     const string&               alias) {
     if (alias == name) return false;
+    std::lock_guard<std::mutex> lock(tensor_mutex_);
     if (tensor_alias_map_.count(alias) > 0)
         return tensor_alias_map_[alias] == name;
     tensor_alias_map_[alias] = name;
@@ -238,6 +295,7 @@ string Workspace::GetDummyName(
     const string&               domain,
     const bool                  zero_based) {
     string required_name = base_name + suffix;
+    std::lock_guard<std::mutex> lock(tensor_mutex_);
     if (dummy_name_map_.count(domain) == 0) {
         dummy_name_map_[domain] = Map<string, int64_t>();
     }
@@ -1,3 +1,4 @@
+#include "utils/cpu_isa.h"
 #include "utils/op_kernel.h"
 #include "utils/math_functions.h"
 #include "utils/omp_alternative.h"
@@ -8,6 +9,16 @@ namespace kernel {
 
 /*! Softmax <T = float32, Device = CPU> */
 
+CPU_ISA_INLINE void _RowMaxElem(
+    const int               i,
+    const float*            x,
+    float*                  y) {
+    y[i] = std::max(y[i], x[i]);
+}
+
+DEFINE_CPU_ISA_LOOP(_RowMaxElem,
+    (const float* x, float* y), (x, y));
+
 template<> void Softmax<float, CPUContext>(
     const int               count,
     const int               classes,
@@ -23,10 +34,8 @@ template<> void Softmax<float, CPUContext>(
        ctx->Copy<float, CPUContext, CPUContext>(
             inner_dim, scale, x + i * dim);
         for (int j = 0; j < classes; ++j) {
-            for (int k = 0; k < inner_dim; k++)
-                scale[k] = std::max(
-                    scale[k], x[i * dim + j * inner_dim + k]
-                );
+            DISPATCH_CPU_ISA(_RowMaxElem, inner_dim,
+                x + i * dim + j * inner_dim, scale);
         }
         math::Gemm<float, CPUContext>(
             CblasNoTrans, CblasNoTrans,
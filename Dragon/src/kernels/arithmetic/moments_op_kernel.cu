@@ -1,6 +1,7 @@
 #ifdef WITH_CUDA
 
 #include "core/context_cuda.h"
+#include "core/scratch.h"
 #include "utils/cast.h"
 #include "utils/op_kernel.h"
 #include "utils/math_utils.h"
@@ -275,7 +276,10 @@ void _Moments(
     for (int i = 0; i < ndims; ++i) dimsT[i] = dims[axesT[i]];
 
     const int dbytes = sizeof(int) * ndims;
-    int* XSS = (int*)ctx->New(dbytes), *YDS = (int*)ctx->New(dbytes);
+    auto* arena = ScratchArena::Get<CUDAContext>(ctx->stream_id());
+    ScratchScope scratch_scope(arena, ctx->stream_id());
+    int* XSS = (int*)arena->Alloc(dbytes);
+    int* YDS = (int*)arena->Alloc(dbytes);
     ctx->Memcpy<CUDAContext, CPUContext>(dbytes, XSS, stridesT.data());
     ctx->Memcpy<CUDAContext, CPUContext>(dbytes, YDS, dimsT.data());
 
@@ -285,7 +289,6 @@ void _Moments(
         (ndims, outer_dim, inner_dim, XSS, YDS, x, mean, var);
 
     ctx->FinishDeviceCompution();
-    ctx->Delete(XSS); ctx->Delete(YDS);
 }
 
 #define DEFINE_MOMENTS_KERNEL_LAUNCHER(Tx, Ty) \
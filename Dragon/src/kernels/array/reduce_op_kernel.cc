@@ -0,0 +1,268 @@
+#include "utils/op_kernel.h"
+#include "utils/math_functions.h"
+#include "kernels/array/reduce_op_kernel.h"
+
+namespace dragon {
+
+namespace kernel {
+
+/*! Reduce <T = ?, Device = CPU> */
+
+template <typename T>
+void _ReduceLauncher(
+    const string&           operation,
+    const int               num_dims,
+    const int*              dims,
+    const int               num_axes,
+    const int*              axes,
+    const float             scale,
+    const T*                x,
+    T*                      y) {
+    typedef typename ReduceAccType<T>::type AccT;
+#define REDUCE_WITH(Reducer) \
+    _Reduce(num_dims, dims, num_axes, axes, Reducer, x, y)
+    if (operation == "SUM" || operation == "MEAN") {
+        REDUCE_WITH(SumReducer<T>(AccT(scale)));
+    } else if (operation == "MAX") {
+        REDUCE_WITH(MaxReducer<T>());
+    } else if (operation == "MIN") {
+        REDUCE_WITH(MinReducer<T>());
+    } else if (operation == "PROD") {
+        REDUCE_WITH(ProdReducer<T>());
+    } else if (operation == "L1") {
+        REDUCE_WITH(L1Reducer<T>(AccT(scale)));
+    } else if (operation == "L2") {
+        REDUCE_WITH(L2Reducer<T>(AccT(scale)));
+    } else if (operation == "LOGSUMEXP") {
+        // Shift by the maximum to avoid the overflow
+        REDUCE_WITH(MaxReducer<T>());
+        REDUCE_WITH(LogSumExpReducer<T>(y));
+    } else {
+        LOG(FATAL) << "Unknown reduction: " << operation;
+    }
+#undef REDUCE_WITH
+}
+
+/*! ReduceGrad <T = ?, Device = CPU> */
+
+template <typename T>
+struct _SumGrad {
+    explicit _SumGrad(const float scale) : scale(scale) {}
+    T operator()(const T x, const T y, const T dy) const {
+        return T(dy * scale);
+    }
+    const float scale;
+};
+
+template <typename T>
+struct _MaxMinGrad {
+    // The gradient flows to all the extremes
+    T operator()(const T x, const T y, const T dy) const {
+        return x == y ? dy : T(0);
+    }
+};
+
+template <typename T>
+struct _ProdGrad {
+    // The inputs are assumed to be non-zero
+    T operator()(const T x, const T y, const T dy) const {
+        return x != T(0) ? T(dy * y / x) : T(0);
+    }
+};
+
+template <typename T>
+struct _L1Grad {
+    explicit _L1Grad(const float scale) : scale(scale) {}
+    T operator()(const T x, const T y, const T dy) const {
+        return T(dy * scale * ((x > T(0)) - (x < T(0))));
+    }
+    const float scale;
+};
+
+template <typename T>
+struct _L2Grad {
+    explicit _L2Grad(const float scale) : scale(scale) {}
+    T operator()(const T x, const T y, const T dy) const {
+        return y > T(0) ? T(dy * scale * x / y) : T(0);
+    }
+    const float scale;
+};
+
+template <typename T>
+struct _LogSumExpGrad {
+    typedef typename ReduceAccType<T>::type AccT;
+    T operator()(const T x, const T y, const T dy) const {
+        return T(AccT(dy) * std::exp(AccT(x) - AccT(y)));
+    }
+};
+
+template <typename T>
+void _ReduceGradLauncher(
+    const string&           operation,
+    const int               num_dims,
+    const int*              x_dims,
+    const int*              y_dims,
+    const float             scale,
+    const T*                x,
+    const T*                y,
+    const T*                dy,
+    T*                      dx) {
+#define REDUCE_GRAD_WITH(Grad) \
+    _ReduceGrad(num_dims, x_dims, y_dims, Grad, x, y, dy, dx)
+    if (operation == "SUM" || operation == "MEAN") {
+        REDUCE_GRAD_WITH(_SumGrad<T>(scale));
+    } else if (operation == "MAX" || operation == "MIN") {
+        REDUCE_GRAD_WITH(_MaxMinGrad<T>());
+    } else if (operation == "PROD") {
+        REDUCE_GRAD_WITH(_ProdGrad<T>());
+    } else if (operation == "L1") {
+        REDUCE_GRAD_WITH(_L1Grad<T>(scale));
+    } else if (operation == "L2") {
+        REDUCE_GRAD_WITH(_L2Grad<T>(scale));
+    } else if (operation == "LOGSUMEXP") {
+        REDUCE_GRAD_WITH(_LogSumExpGrad<T>());
+    } else {
+        LOG(FATAL) << "Unknown reduction: " << operation;
+    }
+#undef REDUCE_GRAD_WITH
+}
+
+/*! Kernel Launchers */
+
+#define DEFINE_REDUCE_KERNEL_LAUNCHER(T) \
+    template <> void ReduceSum<T, CPUContext>( \
+        const int               num_dims, \
+        const int*              dims, \
+        const int               num_axes, \
+        const int*              axes, \
+        const float             scale, \
+        const T*                x, \
+        T*                      y, \
+        CPUContext*             ctx) { \
+        _ReduceLauncher<T>("SUM", num_dims, dims, \
+            num_axes, axes, scale, x, y); \
+    } \
+    template <> void Reduce<T, CPUContext>( \
+        const string&           operation, \
+        const int               num_dims, \
+        const int*              dims, \
+        const int               num_axes, \
+        const int*              axes, \
+        const float             scale, \
+        const T*                x, \
+        T*                      y, \
+        CPUContext*             ctx) { \
+        _ReduceLauncher<T>(operation, num_dims, dims, \
+            num_axes, axes, scale, x, y); \
+    }
+
+#define DEFINE_REDUCE_GRAD_KERNEL_LAUNCHER(T) \
+    template<> void ReduceSumGrad<T, CPUContext>( \
+        const int               count, \
+        const int               ndims, \
+        const int*              x_dims, \
+        const int*              y_dims, \
+        const int*              y_strides, \
+        const float             scale, \
+        const T*                dy, \
+        T*                      dx, \
+        CPUContext*             ctx) { \
+        /*! The ``x`` and ``y`` are unused */ \
+        _ReduceGradLauncher<T>("SUM", ndims, x_dims, \
+            y_dims, scale, dx, dy, dy, dx); \
+    } \
+    template<> void ReduceGrad<T, CPUContext>( \
+        const string&           operation, \
+        const int               count, \
+        const int               ndims, \
+        const int*              x_dims, \
+        const int*              y_dims, \
+        const int*              y_strides, \
+        const float             scale, \
+        const T*                x, \
+        const T*                y, \
+        const T*                dy, \
+        T*                      dx, \
+        CPUContext*             ctx) { \
+        _ReduceGradLauncher<T>(operation, ndims, \
+            x_dims, y_dims, scale, x, y, dy, dx); \
+    }
+
+DEFINE_REDUCE_KERNEL_LAUNCHER(int8_t);
+DEFINE_REDUCE_KERNEL_LAUNCHER(uint8_t);
+DEFINE_REDUCE_KERNEL_LAUNCHER(int);
+DEFINE_REDUCE_KERNEL_LAUNCHER(int64_t);
+DEFINE_REDUCE_KERNEL_LAUNCHER(float);
+DEFINE_REDUCE_KERNEL_LAUNCHER(double);
+
+DEFINE_REDUCE_GRAD_KERNEL_LAUNCHER(int8_t);
+DEFINE_REDUCE_GRAD_KERNEL_LAUNCHER(uint8_t);
+DEFINE_REDUCE_GRAD_KERNEL_LAUNCHER(int);
+DEFINE_REDUCE_GRAD_KERNEL_LAUNCHER(int64_t);
+DEFINE_REDUCE_GRAD_KERNEL_LAUNCHER(float);
+DEFINE_REDUCE_GRAD_KERNEL_LAUNCHER(double);
+
+/*! Reduce <T = float16, Device = CPU> */
+
+template <> void ReduceSum<float16, CPUContext>(
+    const int               num_dims,
+    const int*              dims,
+    const int               num_axes,
+    const int*              axes,
+    const float             scale,
+    const float16*          x,
+    float16*                y,
+    CPUContext*             ctx) {
+    CPU_FP16_NOT_SUPPORTED;
+}
+
+template <> void Reduce<float16, CPUContext>(
+    const string&           operation,
+    const int               num_dims,
+    const int*              dims,
+    const int               num_axes,
+    const int*              axes,
+    const float             scale,
+    const float16*          x,
+    float16*                y,
+    CPUContext*             ctx) {
+    CPU_FP16_NOT_SUPPORTED;
+}
+
+/*! ReduceGrad <T = float16, Device = CPU> */
+
+template<> void ReduceSumGrad<float16, CPUContext>(
+    const int               count,
+    const int               ndims,
+    const int*              x_dims,
+    const int*              y_dims,
+    const int*              y_strides,
+    const float             scale,
+    const float16*          dy,
+    float16*                dx,
+    CPUContext*             ctx) {
+    CPU_FP16_NOT_SUPPORTED;
+}
+
+template<> void ReduceGrad<float16, CPUContext>(
+    const string&           operation,
+    const int               count,
+    const int               ndims,
+    const int*              x_dims,
+    const int*              y_dims,
+    const int*              y_strides,
+    const float             scale,
+    const float16*          x,
+    const float16*          y,
+    const float16*          dy,
+    float16*                dx,
+    CPUContext*             ctx) {
+    CPU_FP16_NOT_SUPPORTED;
+}
+
+#undef DEFINE_REDUCE_KERNEL_LAUNCHER
+#undef DEFINE_REDUCE_GRAD_KERNEL_LAUNCHER
+
+}  // namespace kernel
+
+}  // namepsace dragon
@@ -0,0 +1,577 @@
+/*!
+ * Copyright (c) 2017-present, SeetaTech, Co.,Ltd.
+ *
+ * Licensed under the BSD 2-Clause License.
+ * You should have received a copy of the BSD 2-Clause License
+ * along with the software. If not, See,
+ *
+ *      <https://opensource.org/licenses/BSD-2-Clause>
+ *
+ * ------------------------------------------------------------
+ */
+
+#ifndef DRAGON_KERNELS_ARRAY_REDUCE_OP_KERNEL_H_
+#define DRAGON_KERNELS_ARRAY_REDUCE_OP_KERNEL_H_
+
+#include <cmath>
+#include <limits>
+
+#include "core/common.h"
+#include "core/scratch.h"
+#include "utils/omp_alternative.h"
+
+namespace dragon {
+
+namespace kernel {
+
+/*!
+ * The CPU reduction engine.
+ *
+ * The adjacent axes which are both reduced or kept are merged first,
+ * then the input is reduced by one of the strategies:
+ *
+ *     Colwise: the innermost axis is reduced, an output accumulates
+ *              the contiguous runs with the independent lanes.
+ *     Rowwise: the innermost axis is kept, a task accumulates a block
+ *              of contiguous outputs along the runs.
+ *
+ * The other reduced axes are visited by an odometer, i.e. without the
+ * division per element. The partial results of blocks are combined
+ * pairwise, which bounds the rounding error by O(log n), and a long
+ * reduction is split across the threads if the outputs are too few.
+ *
+ * A reducer defines the accumulate type ``AccT`` and the functions:
+ * ``Init()``, ``Map(x, y_idx)``, ``Reduce(a, b)``, ``Finalize(a, y_idx)``.
+ */
+
+/*! The accumulate type: float32 for float32, float64 for the others */
+
+template <typename T> struct ReduceAccType { typedef double type; };
+template <> struct ReduceAccType<float> { typedef float type; };
+
+#define DEFINE_REDUCER_TYPES(T) \
+    typedef typename ReduceAccType<T>::type AccT
+
+/*! y = scale * \sum{x} */
+
+template <typename T, typename Ty = T>
+struct SumReducer {
+    DEFINE_REDUCER_TYPES(T);
+    explicit SumReducer(const AccT scale) : scale(scale) {}
+    AccT Init() const { return AccT(0); }
+    AccT Map(const T x, const int) const { return AccT(x); }
+    AccT Reduce(const AccT a, const AccT b) const { return a + b; }
+    Ty Finalize(const AccT a, const int) const { return Ty(a * scale); }
+    const AccT scale;
+};
+
+/*! y = \max{x} */
+
+template <typename T, typename Ty = T>
+struct MaxReducer {
+    DEFINE_REDUCER_TYPES(T);
+    AccT Init() const { return std::numeric_limits<AccT>::lowest(); }
+    AccT Map(const T x, const int) const { return AccT(x); }
+    AccT Reduce(const AccT a, const AccT b) const { return std::max(a, b); }
+    Ty Finalize(const AccT a, const int) const { return Ty(a); }
+};
+
+/*! y = \min{x} */
+
+template <typename T, typename Ty = T>
+struct MinReducer {
+    DEFINE_REDUCER_TYPES(T);
+    AccT Init() const { return std::numeric_limits<AccT>::max(); }
+    AccT Map(const T x, const int) const { return AccT(x); }
+    AccT Reduce(const AccT a, const AccT b) const { return std::min(a, b); }
+    Ty Finalize(const AccT a, const int) const { return Ty(a); }
+};
+
+/*! y = \prod{x} */
+
+template <typename T, typename Ty = T>
+struct ProdReducer {
+    DEFINE_REDUCER_TYPES(T);
+    AccT Init() const { return AccT(1); }
+    AccT Map(const T x, const int) const { return AccT(x); }
+    AccT Reduce(const AccT a, const AccT b) const { return a * b; }
+    Ty Finalize(const AccT a, const int) const { return Ty(a); }
+};
+
+/*! y = scale * \sum{|x|} */
+
+template <typename T, typename Ty = T>
+struct L1Reducer {
+    DEFINE_REDUCER_TYPES(T);
+    explicit L1Reducer(const AccT scale) : scale(scale) {}
+    AccT Init() const { return AccT(0); }
+    AccT Map(const T x, const int) const { return std::abs(AccT(x)); }
+    AccT Reduce(const AccT a, const AccT b) const { return a + b; }
+    Ty Finalize(const AccT a, const int) const { return Ty(a * scale); }
+    const AccT scale;
+};
+
+/*! y = \sqrt{scale * \sum{x^2}} */
+
+template <typename T, typename Ty = T>
+struct L2Reducer {
+    DEFINE_REDUCER_TYPES(T);
+    explicit L2Reducer(const AccT scale) : scale(scale) {}
+    AccT Init() const { return AccT(0); }
+    AccT Map(const T x, const int) const { return AccT(x) * AccT(x); }
+    AccT Reduce(const AccT a, const AccT b) const { return a + b; }
+    Ty Finalize(const AccT a, const int) const {
+        return Ty(std::sqrt(a * scale));
+    }
+    const AccT scale;
+};
+
+/*!
+ * y = \log{\sum{\exp(x - m)}} + m
+ *
+ * The shift ``m`` is the maximum computed by a previous pass,
+ * and is overwritten by the result in-place.
+ */
+
+template <typename T, typename Ty = T>
+struct LogSumExpReducer {
+    DEFINE_REDUCER_TYPES(T);
+    explicit LogSumExpReducer(const Ty* shift) : shift(shift) {}
+    AccT Shift(const int y_idx) const {
+        // Leave the infinite shift to the log
+        const AccT m = AccT(shift[y_idx]);
+        return std::isfinite(m) ? m : AccT(0);
+    }
+    AccT Init() const { return AccT(0); }
+    AccT Map(const T x, const int y_idx) const {
+        return std::exp(AccT(x) - Shift(y_idx));
+    }
+    AccT Reduce(const AccT a, const AccT b) const { return a + b; }
+    Ty Finalize(const AccT a, const int y_idx) const {
+        return Ty(std::log(a) + Shift(y_idx));
+    }
+    const Ty* shift;
+};
+
+/*! y = scale * \sum{(x - mean)^2}, i.e. the second pass of moments */
+
+template <typename T, typename Ty = T>
+struct CenteredL2Reducer {
+    DEFINE_REDUCER_TYPES(T);
+    CenteredL2Reducer(const Ty* mean, const AccT scale)
+        : mean(mean), scale(scale) {}
+    AccT Init() const { return AccT(0); }
+    AccT Map(const T x, const int y_idx) const {
+        const AccT d = AccT(x) - AccT(mean[y_idx]);
+        return d * d;
+    }
+    AccT Reduce(const AccT a, const AccT b) const { return a + b; }
+    Ty Finalize(const AccT a, const int) const { return Ty(a * scale); }
+    const Ty* mean; const AccT scale;
+};
+
+#undef DEFINE_REDUCER_TYPES
+
+/*! The elements accumulated by a lane */
+#define REDUCE_LANES 16
+
+/*! The elements (Colwise) or runs (Rowwise) of a pairwise leaf */
+#define REDUCE_BLOCK 1024
+#define REDUCE_ROW_BLOCK 64
+
+/*! The contiguous outputs of a Rowwise task */
+#define REDUCE_COL_BLOCK 512
+
+inline int _ReduceThreads(const int count) {
+#ifdef WITH_OMP
+    return GET_OMP_THREADS(count);
+#else
+    return 1;
+#endif
+}
+
+/*! Combine the partials of equal size, as a binary counter does */
+
+template <class Reducer>
+class _PairwiseStack {
+ public:
+    typedef typename Reducer::AccT AccT;
+
+    _PairwiseStack(const Reducer& r, const int width)
+        : r_(r), width_(width), top_(0), count_(0),
+          stack_(width * 33) {}
+
+    /*! \brief Return the leaf to accumulate */
+    AccT* leaf() { return &stack_[top_ * width_]; }
+
+    /*! \brief Push the accumulated leaf */
+    void Push() {
+        AccT* v = leaf();
+        for (int64_t c = ++count_; !(c & 1); c >>= 1) {
+            AccT* u = &stack_[--top_ * width_];
+            for (int k = 0; k < width_; ++k) u[k] = r_.Reduce(u[k], v[k]);
+            v = u;
+        }
+        top_++;
+    }
+
+    /*! \brief Combine the remaining partials into ``acc`` */
+    void Result(AccT* acc) {
+        for (int k = 0; k < width_; ++k) acc[k] = r_.Init();
+        for (int i = top_ - 1; i >= 0; --i) {
+            const AccT* u = &stack_[i * width_];
+            for (int k = 0; k < width_; ++k) acc[k] = r_.Reduce(u[k], acc[k]);
+        }
+    }
+
+ private:
+    const Reducer& r_;
+    int width_, top_;
+    int64_t count_;
+    vector<AccT> stack_;
+};
+
+/*! Reduce ``n`` contiguous elements with the independent lanes */
+
+template <typename T, class Reducer>
+typename Reducer::AccT _LaneReduce(
+    const Reducer&          r,
+    const int               n,
+    const int               y_idx,
+    const T*                x) {
+    typedef typename Reducer::AccT AccT;
+    AccT lanes[REDUCE_LANES];
+    for (int l = 0; l < REDUCE_LANES; ++l) lanes[l] = r.Init();
+    int j = 0;
+    for (; j + REDUCE_LANES <= n; j += REDUCE_LANES) {
+        _Pragma("omp simd")
+        for (int l = 0; l < REDUCE_LANES; ++l)
+            lanes[l] = r.Reduce(lanes[l], r.Map(x[j + l], y_idx));
+    }
+    for (int w = REDUCE_LANES / 2; w > 0; w /= 2)
+        for (int l = 0; l < w; ++l)
+            lanes[l] = r.Reduce(lanes[l], lanes[l + w]);
+    for (; j < n; ++j) lanes[0] = r.Reduce(lanes[0], r.Map(x[j], y_idx));
+    return lanes[0];
+}
+
+/*! The odometer over the reduced axes */
+
+class _ReduceOdometer {
+ public:
+    _ReduceOdometer(
+        const vector<int>&  dims,
+        const vector<int>&  strides,
+        int                 pos)
+        : dims_(dims), strides_(strides),
+          index_(dims.size(), 0), offset_(0) {
+        for (int d = (int)dims.size() - 1; d >= 0; --d) {
+            index_[d] = pos % dims[d]; pos /= dims[d];
+            offset_ += index_[d] * strides[d];
+        }
+    }
+
+    int offset() const { return offset_; }
+
+    void Next() {
+        for (int d = (int)dims_.size() - 1; d >= 0; --d) {
+            offset_ += strides_[d];
+            if (++index_[d] < dims_[d]) return;
+            offset_ -= dims_[d] * strides_[d]; index_[d] = 0;
+        }
+    }
+
+ private:
+    const vector<int>& dims_;
+    const vector<int>& strides_;
+    vector<int> index_;
+    int offset_;
+};
+
+/*! Return the offset of an output index over the kept axes */
+
+inline int _ReduceKeptOffset(
+    const int               num_dims,
+    const int*              dims,
+    const int*              strides,
+    int                     index) {
+    int offset = 0;
+    for (int d = num_dims - 1; d >= 0; --d) {
+        offset += (index % dims[d]) * strides[d]; index /= dims[d];
+    }
+    return offset;
+}
+
+/*! Colwise: reduce the positions ``[begin, end)`` of an output */
+
+template <typename T, class Reducer>
+typename Reducer::AccT _ColwiseReduceRange(
+    const Reducer&          r,
+    const vector<int>&      outer_dims,
+    const vector<int>&      outer_strides,
+    const int               inner_dim,
+    const int               begin,
+    const int               end,
+    const int               y_idx,
+    const T*                x) {
+    typedef typename Reducer::AccT AccT;
+    _PairwiseStack<Reducer> stack(r, 1);
+    _ReduceOdometer runs(outer_dims, outer_strides, begin / inner_dim);
+    for (int p = begin, j = begin % inner_dim; p < end; j = 0) {
+        const int n = std::min(inner_dim - j, end - p);
+        const T* X = x + runs.offset() + j;
+        for (int b = 0; b < n; b += REDUCE_BLOCK) {
+            *stack.leaf() = _LaneReduce(r,
+                std::min(REDUCE_BLOCK, n - b), y_idx, X + b);
+            stack.Push();
+        }
+        p += n; runs.Next();
+    }
+    AccT acc; stack.Result(&acc);
+    return acc;
+}
+
+/*! Rowwise: reduce the positions ``[begin, end)`` of ``width`` outputs */
+
+template <typename T, class Reducer>
+void _RowwiseReduceRange(
+    const Reducer&          r,
+    const vector<int>&      dims,
+    const vector<int>&      strides,
+    const int               begin,
+    const int               end,
+    const int               width,
+    const int               y_idx,
+    const T*                x,
+    typename Reducer::AccT* acc) {
+    typedef typename Reducer::AccT AccT;
+    _PairwiseStack<Reducer> stack(r, width);
+    _ReduceOdometer runs(dims, strides, begin);
+    for (int p = begin; p < end; p += REDUCE_ROW_BLOCK) {
+        AccT* leaf = stack.leaf();
+        for (int k = 0; k < width; ++k) leaf[k] = r.Init();
+        const int n = std::min(REDUCE_ROW_BLOCK, end - p);
+        for (int i = 0; i < n; ++i, runs.Next()) {
+            const T* X = x + runs.offset();
+            _Pragma("omp simd")
+            for (int k = 0; k < width; ++k)
+                leaf[k] = r.Reduce(leaf[k], r.Map(X[k], y_idx + k));
+        }
+        stack.Push();
+    }
+    stack.Result(acc);
+}
+
+/*! Combine the partials ``[n, stride]`` pairwise into the first row */
+
+template <class Reducer>
+void _TreeReduce(
+    const Reducer&                  r,
+    const int                       n,
+    const int                       stride,
+    typename Reducer::AccT*         partials) {
+    for (int w = 1; w < n; w *= 2) {
+        for (int i = 0; i + w < n; i += 2 * w) {
+            auto* a = partials + i * stride;
+            const auto* b = partials + (i + w) * stride;
+            for (int k = 0; k < stride; ++k) a[k] = r.Reduce(a[k], b[k]);
+        }
+    }
+}
+
+/*! Reduce ``x`` along ``axes`` into ``y`` */
+
+template <typename T, typename Ty, class Reducer>
+void _Reduce(
+    const int               num_dims,
+    const int*              dims,
+    const int               num_axes,
+    const int*              axes,
+    const Reducer&          r,
+    const T*                x,
+    Ty*                     y) {
+    typedef typename Reducer::AccT AccT;
+    // Merge the adjacent axes, and drop the unit axes
+    vector<int> is_reduced(num_dims, 0), mdims, mreduced;
+    for (int i = 0; i < num_axes; ++i) is_reduced[axes[i]] = 1;
+    for (int i = 0; i < num_dims; ++i) {
+        if (dims[i] == 1) continue;
+        if (!mdims.empty() && mreduced.back() == is_reduced[i]) {
+            mdims.back() *= dims[i];
+        } else {
+            mdims.push_back(dims[i]);
+            mreduced.push_back(is_reduced[i]);
+        }
+    }
+    vector<int> kdims, kstrides, rdims, rstrides;
+    int x_count = 1, y_count = 1, r_count = 1;
+    for (int i = (int)mdims.size() - 1; i >= 0; --i) {
+        auto& d = mreduced[i] ? rdims : kdims;
+        auto& s = mreduced[i] ? rstrides : kstrides;
+        d.insert(d.begin(), mdims[i]);
+        s.insert(s.begin(), x_count);
+        x_count *= mdims[i];
+        (mreduced[i] ? r_count : y_count) *= mdims[i];
+    }
+    const int num_threads = _ReduceThreads(x_count);
+
+    if (r_count == 1) {
+        // Case #0: Nothing to reduce
+#ifdef WITH_OMP
+        #pragma omp parallel for num_threads(num_threads)
+#endif
+        for (int i = 0; i < y_count; ++i)
+            y[i] = r.Finalize(r.Reduce(r.Init(), r.Map(x[i], i)), i);
+        return;
+    }
+
+    if (mreduced.back()) {
+        // Case #1: Colwise Reduce
+        const int inner_dim = rdims.back();
+        rdims.pop_back(); rstrides.pop_back();
+        const int num_kdims = (int)kdims.size();
+        // Split each output if the outputs are too few
+        const int splits = y_count >= num_threads ? 1 :
+            std::min(num_threads, r_count / REDUCE_BLOCK + 1);
+        auto* arena = ScratchArena::Get<CPUContext>();
+        ScratchScope scratch_scope(arena);
+        auto* partials = splits == 1 ? nullptr : (AccT*)
+            arena->Alloc(sizeof(AccT) * splits * y_count);
+#ifdef WITH_OMP
+        #pragma omp parallel for num_threads(num_threads)
+#endif
+        for (int t = 0; t < y_count * splits; ++t) {
+            const int i = t / splits, s = t % splits;
+            const int begin = int((int64_t)r_count * s / splits);
+            const int end = int((int64_t)r_count * (s + 1) / splits);
+            const T* X = x + _ReduceKeptOffset(
+                num_kdims, kdims.data(), kstrides.data(), i);
+            const AccT acc = _ColwiseReduceRange(r, rdims,
+                rstrides, inner_dim, begin, end, i, X);
+            if (splits == 1) y[i] = r.Finalize(acc, i);
+            else partials[s * y_count + i] = acc;
+        }
+        if (splits > 1) {
+            _TreeReduce(r, splits, y_count, partials);
+            for (int i = 0; i < y_count; ++i)
+                y[i] = r.Finalize(partials[i], i);
+        }
+    } else {
+        // Case #2: Rowwise Reduce
+        const int inner_dim = kdims.back();
+        const int num_kdims = (int)kdims.size() - 1;
+        const int col_blocks = (inner_dim + REDUCE_COL_BLOCK - 1)
+            / REDUCE_COL_BLOCK;
+        const int tasks = (y_count / inner_dim) * col_blocks;
+        // Split the runs if the tasks are too few
+        const int splits = tasks >= num_threads ? 1 :
+            std::min(num_threads, r_count / REDUCE_ROW_BLOCK + 1);
+        auto* arena = ScratchArena::Get<CPUContext>();
+        ScratchScope scratch_scope(arena);
+        auto* partials = (AccT*)arena->Alloc(
+            sizeof(AccT) * splits * y_count);
+#ifdef WITH_OMP
+        #pragma omp parallel for num_threads(num_threads)
+#endif
+        for (int t = 0; t < tasks * splits; ++t) {
+            const int task = t / splits, s = t % splits;
+            const int outer = task / col_blocks;
+            const int k0 = (task % col_blocks) * REDUCE_COL_BLOCK;
+            const int width = std::min(REDUCE_COL_BLOCK, inner_dim - k0);
+            const int begin = int((int64_t)r_count * s / splits);
+            const int end = int((int64_t)r_count * (s + 1) / splits);
+            const int y_idx = outer * inner_dim + k0;
+            const T* X = x + k0 + _ReduceKeptOffset(num_kdims,
+                kdims.data(), kstrides.data(), outer);
+            _RowwiseReduceRange(r, rdims, rstrides, begin, end,
+                width, y_idx, X, partials + s * y_count + y_idx);
+        }
+        _TreeReduce(r, splits, y_count, partials);
+#ifdef WITH_OMP
+        #pragma omp parallel for num_threads(_ReduceThreads(y_count))
+#endif
+        for (int i = 0; i < y_count; ++i)
+            y[i] = r.Finalize(partials[i], i);
+    }
+}
+
+/*!
+ * Broadcast ``y`` and ``dy`` to compute ``dx = g(x, y, dy)``.
+ *
+ * The gradient functor defines ``operator()(x, y, dy)``.
+ */
+
+template <typename T, class Grad>
+void _ReduceGrad(
+    const int               num_dims,
+    const int*              x_dims,
+    const int*              y_dims,
+    const Grad&             g,
+    const T*                x,
+    const T*                y,
+    const T*                dy,
+    T*                      dx) {
+    // Merge the adjacent axes, and drop the unit axes
+    vector<int> mdims, mreduced;
+    for (int i = 0; i < num_dims; ++i) {
+        if (x_dims[i] == 1) continue;
+        const int reduced = y_dims[i] == 1;
+        if (!mdims.empty() && mreduced.back() == reduced) {
+            mdims.back() *= x_dims[i];
+        } else {
+            mdims.push_back(x_dims[i]);
+            mreduced.push_back(reduced);
+        }
+    }
+    if (mdims.empty()) { mdims.push_back(1); mreduced.push_back(0); }
+    // The outer axes are visited by odometer on ``y``
+    const int inner_dim = mdims.back();
+    const bool inner_reduced = mreduced.back() != 0;
+    vector<int> outer_dims(mdims.begin(), mdims.end() - 1);
+    vector<int> outer_strides(outer_dims.size());
+    int x_count = inner_dim;
+    for (int i = (int)outer_dims.size() - 1, y_stride = inner_reduced ?
+            1 : inner_dim; i >= 0; --i) {
+        outer_strides[i] = mreduced[i] ? 0 : y_stride;
+        if (!mreduced[i]) y_stride *= outer_dims[i];
+        x_count *= outer_dims[i];
+    }
+    const int num_rows = x_count / inner_dim;
+    const int num_threads = _ReduceThreads(x_count);
+    const int rows_per_task = std::max(1, (REDUCE_BLOCK * 16) / inner_dim);
+    const int tasks = (num_rows + rows_per_task - 1) / rows_per_task;
+#ifdef WITH_OMP
+    #pragma omp parallel for num_threads(num_threads)
+#endif
+    for (int t = 0; t < tasks; ++t) {
+        const int row_end = std::min(num_rows, (t + 1) * rows_per_task);
+        _ReduceOdometer rows(outer_dims, outer_strides, t * rows_per_task);
+        for (int i = t * rows_per_task; i < row_end; ++i, rows.Next()) {
+            const T* X = x + i * inner_dim;
+            T* dX = dx + i * inner_dim;
+            const T* Y = y + rows.offset();
+            const T* dY = dy + rows.offset();
+            if (inner_reduced) {
+                const T y_val = Y[0], dy_val = dY[0];
+                _Pragma("omp simd")
+                for (int j = 0; j < inner_dim; ++j)
+                    dX[j] = g(X[j], y_val, dy_val);
+            } else {
+                _Pragma("omp simd")
+                for (int j = 0; j < inner_dim; ++j)
+                    dX[j] = g(X[j], Y[j], dY[j]);
+            }
+        }
+    }
+}
+
+#undef REDUCE_LANES
+#undef REDUCE_BLOCK
+#undef REDUCE_ROW_BLOCK
+#undef REDUCE_COL_BLOCK
+
+}  // namespace kernel
+
+}  // namespace dragon
+
+#endif  // DRAGON_KERNELS_ARRAY_REDUCE_OP_KERNEL_H_
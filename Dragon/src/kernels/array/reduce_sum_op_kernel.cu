@@ -1,6 +1,7 @@
 #ifdef WITH_CUDA
 
 #include "core/context_cuda.h"
+#include "core/scratch.h"
 #include "utils/cast.h"
 #include "utils/op_kernel.h"
 #include "utils/math_utils.h"
@@ -228,7 +229,10 @@ void _ReduceSum(
     for (int i = 0; i < ndims; ++i) dimsT[i] = dims[axesT[i]];
     
     const int dbytes = sizeof(int) * ndims;
-    int* XSS = (int*)ctx->New(dbytes), *YDS = (int*)ctx->New(dbytes);
+    auto* arena = ScratchArena::Get<CUDAContext>(ctx->stream_id());
+    ScratchScope scratch_scope(arena, ctx->stream_id());
+    int* XSS = (int*)arena->Alloc(dbytes);
+    int* YDS = (int*)arena->Alloc(dbytes);
     ctx->Memcpy<CUDAContext, CPUContext>(dbytes, XSS, stridesT.data());
     ctx->Memcpy<CUDAContext, CPUContext>(dbytes, YDS, dimsT.data());
 
@@ -238,7 +242,6 @@ void _ReduceSum(
         (ndims, outer_dim, inner_dim, XSS, YDS, scale, x, y);
 
     ctx->FinishDeviceCompution();
-    ctx->Delete(XSS); ctx->Delete(YDS);
 
 }
 
@@ -378,9 +381,60 @@ template<> void ReduceSumGrad<float16, CUDAContext>(
                 reinterpret_cast<half*>(dx));
 }
 
+/*! Reduce <T = ?, Device = CUDA> */
+
+#define DEFINE_REDUCE_KERNEL_LAUNCHER(T) \
+    template <> void Reduce<T, CUDAContext>( \
+        const string&           operation, \
+        const int               ndims, \
+        const int*              dims, \
+        const int               naxes, \
+        const int*              axes, \
+        const float             scale, \
+        const T*                x, \
+        T*                      y, \
+        CUDAContext*            ctx) { \
+        if (operation == "SUM" || operation == "MEAN") { \
+            ReduceSum(ndims, dims, naxes, axes, scale, x, y, ctx); \
+        } else { \
+            LOG(FATAL) << "Not Implemented: " << operation \
+                       << " reduction on CUDA."; \
+        } \
+    } \
+    template <> void ReduceGrad<T, CUDAContext>( \
+        const string&           operation, \
+        const int               count, \
+        const int               ndim, \
+        const int*              x_dims, \
+        const int*              y_dims, \
+        const int*              y_strides, \
+        const float             scale, \
+        const T*                x, \
+        const T*                y, \
+        const T*                dy, \
+        T*                      dx, \
+        CUDAContext*            ctx) { \
+        if (operation == "SUM" || operation == "MEAN") { \
+            ReduceSumGrad(count, ndim, x_dims, y_dims, \
+                y_strides, scale, dy, dx, ctx); \
+        } else { \
+            LOG(FATAL) << "Not Implemented: " << operation \
+                       << " reduction on CUDA."; \
+        } \
+    }
+
+DEFINE_REDUCE_KERNEL_LAUNCHER(int8_t);
+DEFINE_REDUCE_KERNEL_LAUNCHER(uint8_t);
+DEFINE_REDUCE_KERNEL_LAUNCHER(int);
+DEFINE_REDUCE_KERNEL_LAUNCHER(int64_t);
+DEFINE_REDUCE_KERNEL_LAUNCHER(float16);
+DEFINE_REDUCE_KERNEL_LAUNCHER(float);
+DEFINE_REDUCE_KERNEL_LAUNCHER(double);
+
 #undef FIXED_DIVISOR_DIV_MOD
 #undef DEFINE_REDUCE_SUM_KERNEL_LAUNCHER
 #undef DEFINE_REDUCE_SUM_GRAD_KERNEL_LAUNCHER
+#undef DEFINE_REDUCE_KERNEL_LAUNCHER
 
 }  // namespace kernel
 
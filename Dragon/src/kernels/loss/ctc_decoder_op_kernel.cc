@@ -0,0 +1,206 @@
+#include <limits>
+
+#include "utils/cpu_isa.h"
+#include "utils/op_kernel.h"
+
+namespace dragon {
+
+namespace kernel {
+
+/*! CTCGreedyDecode <T = float32, Device = CPU> */
+
+CPU_ISA_INLINE void _CTCGreedyDecodeElem(
+    const int               i,
+    const int               T,
+    const int               N,
+    const int               C,
+    const int               blank,
+    const bool              merge_repeated,
+    const int64_t           padding_mask,
+    const float*            prob,
+    int64_t*                decoded,
+    float*                  log_prob) {
+    int64_t* path = decoded + (size_t)i * T;
+    int len = 0, prev = -1;
+    double score = 0.;
+    for (int t = 0; t < T; ++t) {
+        const float* p = prob + ((size_t)t * N + i) * C;
+        const int k = (int)(std::max_element(p, p + C) - p);
+        score += std::log(std::max(p[k], FLT_MIN));
+        if (k != blank && !(merge_repeated && k == prev)) path[len++] = k;
+        prev = k;
+    }
+    std::fill(path + len, path + T, padding_mask);
+    log_prob[i] = (float)score;
+}
+
+DEFINE_CPU_ISA_THREADED_LOOP(_CTCGreedyDecodeElem,
+    (const int T, const int N, const int C, const int blank,
+     const bool merge_repeated, const int64_t padding_mask,
+     const float* prob, int64_t* decoded, float* log_prob),
+    (T, N, C, blank, merge_repeated, padding_mask,
+     prob, decoded, log_prob));
+
+template <> void CTCGreedyDecode<float, CPUContext>(
+    const int               max_seq_len,
+    const int               batch_size,
+    const int               num_classes,
+    const int               blank,
+    const bool              merge_repeated,
+    const int64_t           padding_mask,
+    const float*            prob,
+    int64_t*                decoded,
+    float*                  log_prob,
+    CPUContext*             ctx) {
+    DISPATCH_CPU_ISA(_CTCGreedyDecodeElem,
+        batch_size, max_seq_len * batch_size * num_classes,
+            max_seq_len, batch_size, num_classes, blank,
+                merge_repeated, padding_mask, prob, decoded, log_prob);
+}
+
+/*!
+ * CTCBeamSearchDecode <T = float32, Device = CPU>
+ *
+ * The prefix beam search [Hannun et al., 2014] keeps the probabilities
+ * of a prefix ending in blank (pb) and non-blank (pnb) in log-space.
+ * The prefixes are nodes of a trie, so a extension is found among
+ * the few children of a node instead of comparing the label sequences.
+ *
+ * Only the ``beam_width`` most probable non-blank classes of a step
+ * are used to extend the prefixes.
+ */
+
+struct _CTCPrefix {
+    _CTCPrefix(const int parent, const int label)
+        : parent(parent), label(label), child(-1), sibling(-1), stamp(-1),
+          pb(-std::numeric_limits<double>::infinity()),
+          pnb(-std::numeric_limits<double>::infinity()),
+          total(-std::numeric_limits<double>::infinity()) {}
+    int parent, label, child, sibling, stamp;
+    double pb, pnb, total, next_pb, next_pnb;
+};
+
+inline double _LogAddExp(const double a, const double b) {
+    if (a < b) return _LogAddExp(b, a);
+    if (b == -std::numeric_limits<double>::infinity()) return a;
+    return a + std::log1p(std::exp(b - a));
+}
+
+inline void _CTCBeamSearchDecodeElem(
+    const int               i,
+    const int               T,
+    const int               N,
+    const int               C,
+    const int               blank,
+    const int               beam_width,
+    const int64_t           padding_mask,
+    const float*            prob,
+    int64_t*                decoded,
+    float*                  log_prob) {
+    const double kNegInf = -std::numeric_limits<double>::infinity();
+    const int num_cands = std::min(beam_width, C - 1);
+    vector<_CTCPrefix> trie(1, _CTCPrefix(-1, -1));
+    vector<int> beams(1, 0), touched, cands(C);
+    vector<double> lp(C);
+    trie.reserve((size_t)T * beam_width * num_cands + 1);
+    trie[0].pb = trie[0].total = 0.;
+
+    auto touch = [&](const int node, const int t) {
+        auto& prefix = trie[node];
+        if (prefix.stamp != t) {
+            prefix.stamp = t;
+            prefix.next_pb = prefix.next_pnb = kNegInf;
+            touched.push_back(node);
+        }
+        return node;
+    };
+
+    auto extend = [&](const int node, const int c) {
+        for (int k = trie[node].child; k >= 0; k = trie[k].sibling)
+            if (trie[k].label == c) return k;
+        trie.push_back(_CTCPrefix(node, c));
+        const int k = (int)trie.size() - 1;
+        trie[k].sibling = trie[node].child;
+        return trie[node].child = k;
+    };
+
+    for (int t = 0; t < T; ++t) {
+        const float* p = prob + ((size_t)t * N + i) * C;
+        for (int c = 0; c < C; ++c) {
+            lp[c] = std::log(std::max(p[c], FLT_MIN));
+            cands[c] = c;
+        }
+        std::swap(cands[blank], cands[C - 1]);
+        std::partial_sort(cands.begin(), cands.begin() + num_cands,
+            cands.begin() + C - 1, [&](const int a, const int b) {
+                return lp[a] > lp[b]; });
+
+        touched.clear();
+        for (const int node : beams) {
+            const double pb = trie[node].pb, pnb = trie[node].pnb;
+            const double total = trie[node].total;
+            const int last = trie[node].label;
+            // Stay with a blank or a repeated last label
+            auto& self = trie[touch(node, t)];
+            self.next_pb = _LogAddExp(self.next_pb, total + lp[blank]);
+            if (last >= 0) {
+                self.next_pnb = _LogAddExp(self.next_pnb, pnb + lp[last]);
+            }
+            // Extend with a new label, which repeats only after a blank
+            for (int j = 0; j < num_cands; ++j) {
+                const int c = cands[j];
+                const int child = touch(extend(node, c), t);
+                auto& next = trie[child];
+                next.next_pnb = _LogAddExp(next.next_pnb,
+                    (c == last ? pb : total) + lp[c]);
+            }
+        }
+
+        for (const int node : touched) {
+            auto& prefix = trie[node];
+            prefix.pb = prefix.next_pb;
+            prefix.pnb = prefix.next_pnb;
+            prefix.total = _LogAddExp(prefix.pb, prefix.pnb);
+        }
+        const int num_beams = std::min(beam_width, (int)touched.size());
+        std::partial_sort(touched.begin(), touched.begin() + num_beams,
+            touched.end(), [&](const int a, const int b) {
+                return trie[a].total > trie[b].total; });
+        beams.assign(touched.begin(), touched.begin() + num_beams);
+    }
+
+    // Walk the best prefix back to the root
+    int64_t* path = decoded + (size_t)i * T;
+    int len = 0;
+    for (int node = beams[0]; node > 0; node = trie[node].parent) len++;
+    std::fill(path + len, path + T, padding_mask);
+    for (int node = beams[0]; node > 0; node = trie[node].parent)
+        path[--len] = trie[node].label;
+    log_prob[i] = (float)trie[beams[0]].total;
+}
+
+template <> void CTCBeamSearchDecode<float, CPUContext>(
+    const int               max_seq_len,
+    const int               batch_size,
+    const int               num_classes,
+    const int               blank,
+    const int               beam_width,
+    const int64_t           padding_mask,
+    const float*            prob,
+    int64_t*                decoded,
+    float*                  log_prob,
+    CPUContext*             ctx) {
+    const int work = max_seq_len * batch_size * num_classes;
+#ifdef WITH_OMP
+    #pragma omp parallel for num_threads(GET_OMP_THREADS(work))
+#endif
+    for (int i = 0; i < batch_size; ++i) {
+        _CTCBeamSearchDecodeElem(i, max_seq_len, batch_size,
+            num_classes, blank, beam_width, padding_mask,
+                prob, decoded, log_prob);
+    }
+}
+
+}  // namespace kernel
+
+}  // namepsace dragon
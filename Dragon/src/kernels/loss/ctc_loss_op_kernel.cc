@@ -0,0 +1,172 @@
+#include <limits>
+
+#include "utils/cpu_isa.h"
+#include "utils/op_kernel.h"
+
+namespace dragon {
+
+namespace kernel {
+
+/*!
+ * The CPU engine runs the forward-backward of a sequence per task.
+ *
+ * The variables are rescaled at each step [Graves & Gomez, 2006, §4.1],
+ * and the log-likelihood is accumulated from the scales. It keeps the
+ * recursions as multiply-adds over the label states, which vectorize,
+ * while the log-add-exp of a pure log-space form could not.
+ *
+ * The states are stored with two zero guards on both sides,
+ * so that the transitions ``s - 2`` and ``s + 2`` have no branches.
+ * The forward variables of all the sequences take the ``alpha``
+ * of ``T * \sum_{i} (2 * L_i + 5)`` elements.
+ */
+
+#define CTC_GUARD 2
+
+/*! CTCLoss <T = float32, Device = CPU> */
+
+CPU_ISA_INLINE double _CTCRescale(
+    const int               n,
+    double*                 x) {
+    double sum = 0.;
+    for (int s = 0; s < n; ++s) sum += x[s];
+    const double inv = sum > 0. ? 1. / sum : 0.;
+    for (int s = 0; s < n; ++s) x[s] *= inv;
+    return sum;
+}
+
+/*! Gather the probabilities of the label states and their reciprocals */
+
+CPU_ISA_INLINE void _CTCGather(
+    const int               S,
+    const int*              ext,
+    const float*            p,
+    double*                 y,
+    double*                 rec) {
+    for (int s = 0; s < S; ++s) y[s] = std::max(p[ext[s]], FLT_MIN);
+    for (int s = 0; s < S; ++s) rec[s] = 1. / y[s];
+}
+
+CPU_ISA_INLINE void _CTCLossElem(
+    const int               i,
+    const int               T,
+    const int               N,
+    const int               C,
+    const int               blank,
+    const int*              label_lengths,
+    const int*              label_offsets,
+    const int*              labels,
+    const float*            prob,
+    double*                 alpha,
+    float*                  loss,
+    float*                  grad) {
+    const int L = label_lengths[i], S = 2 * L + 1;
+    const int W = S + 2 * CTC_GUARD;
+    const int* label = labels + label_offsets[i];
+    double* A = alpha + (size_t)T * (label_offsets[i] * 2 + i * (1 + 2 * CTC_GUARD));
+
+    // The extended labels are [blank, l_1, blank, ..., l_L, blank]
+    vector<int> ext(S, blank);
+    vector<double> skip(W, 0.), y(S), rec(S);
+    for (int j = 0; j < L; ++j) {
+        ext[2 * j + 1] = label[j];
+        if (j > 0 && label[j] != label[j - 1])
+            skip[2 * j + 1 + CTC_GUARD] = 1.;
+    }
+    const double* sk = skip.data() + CTC_GUARD;
+
+    // Forward: a_t(s) = (a_{t-1}(s) + a_{t-1}(s-1) + a_{t-1}(s-2)) * y_t(s)
+    double log_prob = 0.;
+    std::fill(A, A + (size_t)T * W, 0.);
+    for (int t = 0; t < T; ++t) {
+        _CTCGather(S, ext.data(), prob + ((size_t)t * N + i) * C,
+            y.data(), rec.data());
+        double* a = A + (size_t)t * W + CTC_GUARD;
+        if (t == 0) {
+            a[0] = y[0]; if (S > 1) a[1] = y[1];
+        } else {
+            const double* ap = a - W;
+            for (int s = 0; s < S; ++s)
+                a[s] = (ap[s] + ap[s - 1] + sk[s] * ap[s - 2]) * y[s];
+        }
+        log_prob += std::log(_CTCRescale(S, a));
+    }
+
+    const double* a_last = A + (size_t)(T - 1) * W + CTC_GUARD;
+    const double tail = a_last[S - 1] + (S > 1 ? a_last[S - 2] : 0.);
+    if (tail <= 0.) {
+        // The sequence is too short to emit the labels
+        loss[i] = std::numeric_limits<float>::infinity(); return;
+    }
+    loss[i] = (float)-(log_prob + std::log(tail));
+
+    // Backward: b_t(s) = (b_{t+1}(s) + b_{t+1}(s+1) + b_{t+1}(s+2)) * y_t(s),
+    // and the gradient w.r.t y_t(k) is -\sum_{s in lab(k)} r_t(s) / y_t(k),
+    // where r_t(s) = (a_t(s) * b_t(s) / y_t(s)) / \sum_{s} (...)
+    vector<double> beta(2 * W, 0.), gamma(S);
+    double* bn = beta.data() + CTC_GUARD;
+    double* bc = beta.data() + W + CTC_GUARD;
+    for (int t = T - 1; t >= 0; --t) {
+        _CTCGather(S, ext.data(), prob + ((size_t)t * N + i) * C,
+            y.data(), rec.data());
+        const double* a = A + (size_t)t * W + CTC_GUARD;
+        if (t == T - 1) {
+            bc[S - 1] = y[S - 1]; if (S > 1) bc[S - 2] = y[S - 2];
+        } else {
+            for (int s = 0; s < S; ++s)
+                bc[s] = (bn[s] + bn[s + 1] + sk[s + 2] * bn[s + 2]) * y[s];
+        }
+        _CTCRescale(S, bc);
+        double z = 0.;
+        for (int s = 0; s < S; ++s) {
+            gamma[s] = a[s] * bc[s] * rec[s];
+            z += gamma[s];
+        }
+        const double inv_z = z > 0. ? 1. / z : 0.;
+        for (int s = 0; s < S; ++s) gamma[s] *= inv_z * rec[s];
+        float* gt = grad + ((size_t)t * N + i) * C;
+        for (int s = 0; s < S; ++s) gt[ext[s]] -= (float)gamma[s];
+        std::swap(bn, bc);
+    }
+}
+
+DEFINE_CPU_ISA_THREADED_LOOP(_CTCLossElem,
+    (const int T, const int N, const int C, const int blank,
+     const int* label_lengths, const int* label_offsets,
+     const int* labels, const float* prob,
+     double* alpha, float* loss, float* grad),
+    (T, N, C, blank, label_lengths, label_offsets,
+     labels, prob, alpha, loss, grad));
+
+template <> void CTCLoss<float, CPUContext>(
+    const int               max_seq_len,
+    const int               batch_size,
+    const int               num_classes,
+    const int               blank,
+    const int*              label_lengths,
+    const int*              packed_labels,
+    const float*            prob,
+    double*                 alpha,
+    float*                  loss,
+    float*                  grad,
+    CPUContext*             ctx) {
+    vector<int> label_offsets(batch_size, 0);
+    int work = 0;
+    for (int i = 0; i < batch_size; ++i) {
+        if (i > 0) label_offsets[i] =
+            label_offsets[i - 1] + label_lengths[i - 1];
+        work += max_seq_len * (2 * label_lengths[i] + 1);
+    }
+    std::fill(grad, grad + (size_t)max_seq_len
+        * batch_size * num_classes, 0.f);
+    DISPATCH_CPU_ISA(_CTCLossElem,
+        batch_size, work, max_seq_len, batch_size, num_classes,
+            blank, label_lengths, label_offsets.data(),
+                packed_labels, prob, alpha, loss, grad);
+}
+
+#undef CTC_GUARD
+
+}  // namespace kernel
+
+}  // namepsace dragon
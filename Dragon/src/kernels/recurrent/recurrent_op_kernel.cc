@@ -0,0 +1,182 @@
+#include "utils/op_kernel.h"
+#include "utils/omp_alternative.h"
+
+namespace dragon {
+
+namespace kernel {
+
+template <typename T>
+T _Sigmoid(T x) { return T(1) / (T(1) + exp(-x)); }
+
+/*! RNNCell <T = float32, Device = CPU> */
+
+template <> void RNNCell<float, CPUContext>(
+    const int               N,
+    const int               C,
+    const bool              use_relu,
+    const float*            xw,
+    const float*            hr,
+    const float*            br,
+    float*                  h,
+    CPUContext*             ctx) {
+    const int count = N * C;
+#ifdef WITH_OMP
+    #pragma omp parallel for num_threads(GET_OMP_THREADS(count))
+#endif
+    for (int i = 0; i < count; ++i) {
+        const float v = xw[i] + hr[i] + br[i % C];
+        h[i] = use_relu ? std::max(v, 0.f) : std::tanh(v);
+    }
+}
+
+/*! RNNCellGrad <T = float32, Device = CPU> */
+
+template <> void RNNCellGrad<float, CPUContext>(
+    const int               N,
+    const int               C,
+    const bool              use_relu,
+    const float*            h,
+    const float*            dh,
+    float*                  dx,
+    CPUContext*             ctx) {
+    const int count = N * C;
+#ifdef WITH_OMP
+    #pragma omp parallel for num_threads(GET_OMP_THREADS(count))
+#endif
+    for (int i = 0; i < count; ++i) {
+        dx[i] = use_relu ? (h[i] > 0.f ? dh[i] : 0.f)
+                         : dh[i] * (1.f - h[i] * h[i]);
+    }
+}
+
+/*! LSTMUnit <T = float32, Device = CPU> */
+
+template <> void LSTMUnit<float, CPUContext>(
+    const int               N,
+    const int               C,
+    const float*            cx,
+    const float*            xw,
+    const float*            hr,
+    const float*            br,
+    float*                  xact,
+    float*                  c,
+    float*                  h,
+    CPUContext*             ctx) {
+    //  Gates are packed as [i, f, g, o] (CuDNN layout)
+    const int count = N * C;
+#ifdef WITH_OMP
+    #pragma omp parallel for num_threads(GET_OMP_THREADS(count))
+#endif
+    for (int idx = 0; idx < count; ++idx) {
+        const int n = idx / C, j = idx % C;
+        const int x = n * 4 * C + j;
+        const float i = _Sigmoid(xw[x] + hr[x] + br[j]);
+        const float f = _Sigmoid(xw[x + C] + hr[x + C] + br[j + C]);
+        const float g = std::tanh(xw[x + 2 * C] + hr[x + 2 * C] + br[j + 2 * C]);
+        const float o = _Sigmoid(xw[x + 3 * C] + hr[x + 3 * C] + br[j + 3 * C]);
+        xact[x] = i; xact[x + C] = f;
+        xact[x + 2 * C] = g; xact[x + 3 * C] = o;
+        c[idx] = f * cx[idx] + i * g;
+        h[idx] = o * std::tanh(c[idx]);
+    }
+}
+
+/*! LSTMUnitGrad <T = float32, Device = CPU> */
+
+template <> void LSTMUnitGrad<float, CPUContext>(
+    const int               N,
+    const int               C,
+    const float*            cx,
+    const float*            xact,
+    const float*            c,
+    const float*            dc,
+    const float*            dh,
+    float*                  dcx,
+    float*                  dx,
+    CPUContext*             ctx) {
+    const int count = N * C;
+#ifdef WITH_OMP
+    #pragma omp parallel for num_threads(GET_OMP_THREADS(count))
+#endif
+    for (int idx = 0; idx < count; ++idx) {
+        const int n = idx / C, j = idx % C;
+        const int x = n * 4 * C + j;
+        const float i = xact[x], f = xact[x + C];
+        const float g = xact[x + 2 * C], o = xact[x + 3 * C];
+        const float tanh_c = std::tanh(c[idx]);
+        //  dc_{t} = dh_{t} * d(h_{t}) / d(c_{t}) + dc_{t + 1} * f_{t + 1}
+        const float dc_sum = dh[idx] * o * (1.f - tanh_c * tanh_c) + dc[idx];
+        dcx[idx] = dc_sum * f;
+        dx[x] = dc_sum * g * i * (1.f - i);
+        dx[x + C] = dc_sum * cx[idx] * f * (1.f - f);
+        dx[x + 2 * C] = dc_sum * i * (1.f - g * g);
+        dx[x + 3 * C] = dh[idx] * tanh_c * o * (1.f - o);
+    }
+}
+
+/*! GRUUnit <T = float32, Device = CPU> */
+
+template <> void GRUUnit<float, CPUContext>(
+    const int               N,
+    const int               C,
+    const float*            hx,
+    const float*            xw,
+    const float*            hr,
+    const float*            br,
+    float*                  xact,
+    float*                  hn,
+    float*                  h,
+    CPUContext*             ctx) {
+    //  Gates are packed as [r, z, n] (CuDNN layout),
+    //  where n = tanh(W_n * x + b_Wn + r * (R_n * h + b_Rn))
+    const int count = N * C;
+#ifdef WITH_OMP
+    #pragma omp parallel for num_threads(GET_OMP_THREADS(count))
+#endif
+    for (int idx = 0; idx < count; ++idx) {
+        const int n = idx / C, j = idx % C;
+        const int x = n * 3 * C + j;
+        const float r = _Sigmoid(xw[x] + hr[x] + br[j]);
+        const float z = _Sigmoid(xw[x + C] + hr[x + C] + br[j + C]);
+        hn[idx] = hr[x + 2 * C] + br[j + 2 * C];
+        const float nt = std::tanh(xw[x + 2 * C] + r * hn[idx]);
+        xact[x] = r; xact[x + C] = z; xact[x + 2 * C] = nt;
+        h[idx] = (1.f - z) * nt + z * hx[idx];
+    }
+}
+
+/*! GRUUnitGrad <T = float32, Device = CPU> */
+
+template <> void GRUUnitGrad<float, CPUContext>(
+    const int               N,
+    const int               C,
+    const float*            hx,
+    const float*            xact,
+    const float*            hn,
+    const float*            dh,
+    float*                  dhx,
+    float*                  dx,
+    float*                  dhr,
+    CPUContext*             ctx) {
+    const int count = N * C;
+#ifdef WITH_OMP
+    #pragma omp parallel for num_threads(GET_OMP_THREADS(count))
+#endif
+    for (int idx = 0; idx < count; ++idx) {
+        const int n = idx / C, j = idx % C;
+        const int x = n * 3 * C + j;
+        const float r = xact[x], z = xact[x + C], nt = xact[x + 2 * C];
+        const float dn = dh[idx] * (1.f - z) * (1.f - nt * nt);
+        const float dr = dn * hn[idx] * r * (1.f - r);
+        const float dz = dh[idx] * (hx[idx] - nt) * z * (1.f - z);
+        dhx[idx] = dh[idx] * z;
+        dx[x] = dhr[x] = dr;
+        dx[x + C] = dhr[x + C] = dz;
+        dx[x + 2 * C] = dn;
+        dhr[x + 2 * C] = dn * r;
+    }
+}
+
+}  // namespace kernel
+
+}  // namepsace dragon
@@ -1,5 +1,5 @@
+#include "utils/cpu_isa.h"
 #include "utils/op_kernel.h"
-#include "utils/omp_alternative.h"
 
 namespace dragon {
 
@@ -7,6 +7,26 @@ namespace kernel {
 
 /*! AdamUpdate <T = float32, Device = CPU> */
 
+CPU_ISA_INLINE void _AdamUpdateElem(
+    const int               i,
+    const float             lr,
+    const float             beta1,
+    const float             beta2,
+    const float             eps,
+    float*                  g,
+    float*                  m,
+    float*                  v) {
+    float gi = g[i];
+    float mi = m[i] = m[i] * beta1 + gi * (1 - beta1);
+    float vi = v[i] = v[i] * beta2 + gi * gi * (1 - beta2);
+    g[i] = lr * mi / (std::sqrt(vi) + eps);
+}
+
+DEFINE_CPU_ISA_PARALLEL_LOOP(_AdamUpdateElem,
+    (const float lr, const float beta1, const float beta2,
+        const float eps, float* g, float* m, float* v),
+    (lr, beta1, beta2, eps, g, m, v));
+
 template <> void AdamUpdate<float, CPUContext>(
     const int               count,
     const float             lr,
@@ -17,15 +37,8 @@ template <> void AdamUpdate<float, CPUContext>(
     float*                  m,
     float*                  v,
     CPUContext*             ctx) {
-#ifdef WITH_OMP
-    #pragma omp parallel for num_threads(GET_OMP_THREADS(count))
-#endif
-    for (int i = 0; i < count; ++i) {
-        float gi = g[i];
-        float mi = m[i] = m[i] * beta1 + gi * (1 - beta1);
-        float vi = v[i] = v[i] * beta2 + gi * gi * (1 - beta2);
-        g[i] = lr * mi / (std::sqrt(vi) + eps);
-    }
+    DISPATCH_CPU_ISA(_AdamUpdateElem,
+        count, lr, beta1, beta2, eps, g, m, v);
 }
 
 }  // namespace kernel
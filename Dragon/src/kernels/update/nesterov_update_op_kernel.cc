@@ -1,5 +1,5 @@
+#include "utils/cpu_isa.h"
 #include "utils/op_kernel.h"
-#include "utils/omp_alternative.h"
 
 namespace dragon {
 
@@ -7,6 +7,21 @@ namespace kernel {
 
 /*! NesterovUpdate <T = float32, Device = CPU> */
 
+CPU_ISA_INLINE void _NesterovUpdateElem(
+    const int               i,
+    const float             lr,
+    const float             momentum,
+    float*                  g,
+    float*                  h) {
+    float hi = h[i];
+    float hi_new = h[i] = momentum * hi + lr * g[i];
+    g[i] = (1 + momentum) * hi_new - momentum * hi;
+}
+
+DEFINE_CPU_ISA_PARALLEL_LOOP(_NesterovUpdateElem,
+    (const float lr, const float momentum, float* g, float* h),
+    (lr, momentum, g, h));
+
 template <> void NesterovUpdate<float, CPUContext>(
     const int               count,
     const float             lr,
@@ -14,14 +29,8 @@ template <> void NesterovUpdate<float, CPUContext>(
     float*                  g,
     float*                  h,
     CPUContext*             ctx) {
-#ifdef WITH_OMP
-    #pragma omp parallel for num_threads(GET_OMP_THREADS(count))
-#endif
-    for (int i = 0; i < count; ++i) {
-        float hi = h[i];
-        float hi_new = h[i] = momentum * hi + lr * g[i];
-        g[i] = (1 + momentum) * hi_new - momentum * hi;
-    }
+    DISPATCH_CPU_ISA(_NesterovUpdateElem,
+        count, lr, momentum, g, h);
 }
 
 }  // namespace kernel
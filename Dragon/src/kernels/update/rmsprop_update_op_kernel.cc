@@ -1,5 +1,5 @@
+#include "utils/cpu_isa.h"
 #include "utils/op_kernel.h"
-#include "utils/omp_alternative.h"
 
 namespace dragon {
 
@@ -7,6 +7,22 @@ namespace kernel {
 
 /*! RMSPropUpdate <T = float32, Device = CPU> */
 
+CPU_ISA_INLINE void _RMSPropUpdateElem(
+    const int               i,
+    const float             lr,
+    const float             decay,
+    const float             eps,
+    float*                  g,
+    float*                  h) {
+    float gi = g[i];
+    float hi = h[i] = decay * h[i] + (1 - decay) * gi * gi;
+    g[i] = lr * g[i] / (std::sqrt(hi) + eps);
+}
+
+DEFINE_CPU_ISA_PARALLEL_LOOP(_RMSPropUpdateElem,
+    (const float lr, const float decay, const float eps, float* g, float* h),
+    (lr, decay, eps, g, h));
+
 template <> void RMSPropUpdate<float, CPUContext>(
     const int               count,
     const float             lr,
@@ -15,14 +31,8 @@ template <> void RMSPropUpdate<float, CPUContext>(
     float*                  g,
     float*                  h,
     CPUContext*             ctx) {
-#ifdef WITH_OMP
-    #pragma omp parallel for num_threads(GET_OMP_THREADS(count))
-#endif
-    for (int i = 0; i < count; ++i) {
-        float gi = g[i];
-        float hi = h[i] = decay * h[i] + (1 - decay) * gi * gi;
-        g[i] = lr * g[i] / (std::sqrt(hi) + eps);
-    }
+    DISPATCH_CPU_ISA(_RMSPropUpdateElem,
+        count, lr, decay, eps, g, h);
 }
 
 }  // namespace kernel
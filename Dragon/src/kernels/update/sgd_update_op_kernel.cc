@@ -1,5 +1,5 @@
+#include "utils/cpu_isa.h"
 #include "utils/op_kernel.h"
-#include "utils/omp_alternative.h"
 
 namespace dragon {
 
@@ -7,6 +7,20 @@ namespace kernel {
 
 /*! SGDUpdate <T = float32, Device = CPU> */
 
+CPU_ISA_INLINE void _SGDUpdateElem(
+    const int               i,
+    const float             lr,
+    const float             momentum,
+    float*                  g,
+    float*                  h) {
+    float hi = h[i];
+    g[i] = h[i] = momentum * hi + lr * g[i];
+}
+
+DEFINE_CPU_ISA_PARALLEL_LOOP(_SGDUpdateElem,
+    (const float lr, const float momentum, float* g, float* h),
+    (lr, momentum, g, h));
+
 template <> void SGDUpdate<float, CPUContext>(
     const int               count,
     const float             lr,
@@ -14,13 +28,8 @@ template <> void SGDUpdate<float, CPUContext>(
     float*                  g,
     float*                  h,
     CPUContext*             ctx) {
-#ifdef WITH_OMP
-    #pragma omp parallel for num_threads(GET_OMP_THREADS(count))
-#endif
-    for (int i = 0; i < count; ++i) {
-        float hi = h[i];
-        g[i] = h[i] = momentum * hi + lr * g[i];
-    }
+    DISPATCH_CPU_ISA(_SGDUpdateElem,
+        count, lr, momentum, g, h);
 }
 
 }  // namespace kernel
@@ -1,14 +1,130 @@
+#include "utils/cpu_isa.h"
 #include "utils/op_kernel.h"
 
 namespace dragon {
 
 namespace kernel {
 
+/*!
+ * The CPU engine computes a image plane (NCHW) or row (NHWC) per task,
+ * vectorizes along the width (NCHW) or channels (NHWC), and specializes
+ * the most common 3x3 and 5x5 kernels with a stride of 1 or 2.
+ */
+
+/*! Return the outputs ``[lo, hi)`` where ``o * stride + k - pad`` is in ``[0, size)`` */
+
+CPU_ISA_INLINE void _ValidRange(
+    const int               size,
+    const int               out_size,
+    const int               stride,
+    const int               pad,
+    const int               k,
+    int*                    lo,
+    int*                    hi) {
+    const int first = pad - k, last = size - 1 + pad - k;
+    *lo = first > 0 ? (first + stride - 1) / stride : 0;
+    *hi = last < 0 ? 0 : std::min(last / stride + 1, out_size);
+    *lo = std::min(*lo, *hi);
+}
+
+CPU_ISA_INLINE float _Relu6(const float x) {
+    return std::min(std::max(x, 0.f), 6.f);
+}
+
+/*!
+ * Call ``fn<KH, KW, S>`` for the specialized kernels,
+ * ``fn<-1, -1, -1>`` will read the runtime arguments instead.
+ */
+
+#define DEPTHWISE_CONV2D_SPECIALIZE(fn, ...) \
+    if (kernel_h == 3 && kernel_w == 3 && stride_h == 1 && stride_w == 1) { \
+        fn<3, 3, 1>(__VA_ARGS__); \
+    } else if (kernel_h == 3 && kernel_w == 3 && stride_h == 2 && stride_w == 2) { \
+        fn<3, 3, 2>(__VA_ARGS__); \
+    } else if (kernel_h == 5 && kernel_w == 5 && stride_h == 1 && stride_w == 1) { \
+        fn<5, 5, 1>(__VA_ARGS__); \
+    } else if (kernel_h == 5 && kernel_w == 5 && stride_h == 2 && stride_w == 2) { \
+        fn<5, 5, 2>(__VA_ARGS__); \
+    } else { \
+        fn<-1, -1, -1>(__VA_ARGS__); \
+    }
+
+#define DEPTHWISE_CONV2D_CONSTANTS \
+    const int KH = KKH < 0 ? kernel_h : KKH; \
+    const int KW = KKW < 0 ? kernel_w : KKW; \
+    const int SH = SS < 0 ? stride_h : SS; \
+    const int SW = SS < 0 ? stride_w : SS
+
 /*! DepthwiseConv2d <T = float32, Device = CPU> */
 
-template <typename T>
-void _DepthwiseConv2d_NCHW(
-    const int               N,
+template <int KKH, int KKW, int SS>
+CPU_ISA_INLINE void _DepthwiseConv2dPlane_NCHW(
+    const int               H,
+    const int               W,
+    const int               out_h,
+    const int               out_w,
+    const int               kernel_h,
+    const int               kernel_w,
+    const int               stride_h,
+    const int               stride_w,
+    const int               pad_h,
+    const int               pad_w,
+    const bool              relu6,
+    const float*            x,
+    const float*            w,
+    const float             bias,
+    float*                  y) {
+    DEPTHWISE_CONV2D_CONSTANTS;
+    // The interior columns read no padding
+    int ow_lo, ow_hi, unused;
+    _ValidRange(W, out_w, SW, pad_w, 0, &ow_lo, &unused);
+    _ValidRange(W, out_w, SW, pad_w, KW - 1, &unused, &ow_hi);
+    ow_hi = std::max(ow_lo, ow_hi);
+    for (int oh = 0; oh < out_h; ++oh) {
+        const int ih_start = oh * SH - pad_h;
+        const int fh_lo = std::max(0, -ih_start);
+        const int fh_hi = std::min(KH, H - ih_start);
+        const int x_start = ih_start * W - pad_w;
+        float* yr = y + oh * out_w;
+        for (int ow = 0; ow < out_w; ++ow) {
+            if (ow == ow_lo) ow = ow_hi;
+            if (ow >= out_w) break;
+            const int iw_start = ow * SW;
+            float sum = bias;
+            for (int fh = fh_lo; fh < fh_hi; ++fh) {
+                for (int fw = 0; fw < KW; ++fw) {
+                    const int iw = iw_start + fw - pad_w;
+                    if (iw >= 0 && iw < W) sum += w[fh * KW + fw] *
+                        x[x_start + fh * W + iw_start + fw];
+                }  // End fw
+            }  // End fh
+            yr[ow] = relu6 ? _Relu6(sum) : sum;
+        }  // End the border columns
+        // Accumulate a kernel row per pass to vectorize the columns
+        _Pragma("omp simd")
+        for (int ow = ow_lo; ow < ow_hi; ++ow) yr[ow] = bias;
+        for (int fh = fh_lo; fh < fh_hi; ++fh) {
+            const float* wr = w + fh * KW;
+            const int xr_start = x_start + fh * W;
+            _Pragma("omp simd")
+            for (int ow = ow_lo; ow < ow_hi; ++ow) {
+                const int iw_start = xr_start + ow * SW;
+                float sum = yr[ow];
+                for (int fw = 0; fw < KW; ++fw) {
+                    sum += wr[fw] * x[iw_start + fw];
+                }  // End fw
+                yr[ow] = sum;
+            }  // End the interior columns
+        }  // End fh
+        if (relu6) {
+            _Pragma("omp simd")
+            for (int ow = ow_lo; ow < ow_hi; ++ow) yr[ow] = _Relu6(yr[ow]);
+        }
+    }  // End oh
+}
+
+CPU_ISA_INLINE void _DepthwiseConv2dElem_NCHW(
+    const int               i,
     const int               C,
     const int               H,
     const int               W,
@@ -16,60 +132,36 @@ void _DepthwiseConv2d_NCHW(
     const int               out_w,
     const int               kernel_h,
     const int               kernel_w,
-    const int               stride,
+    const int               stride_h,
+    const int               stride_w,
     const int               pad_h,
     const int               pad_w,
-    const T*                x,
-    const T*                w,
-    T*                      y) {
-    for (int OB = 0; OB < N; ++OB) {
-    for (int OC = 0; OC < C; ++OC) {
-        const int yc_offset = OB * C + OC;
-        const int xc_start = yc_offset * H * W;
-        const int fc_start = OC * kernel_h * kernel_w;
-        for (int OH = 0; OH < out_h; ++OH) {
-            const int yh_offset = yc_offset * out_h + OH;
-            const int ih_start = OH * stride - pad_h;
-            const int ih_end = ih_start + kernel_h;
-            for (int OW = 0; OW < out_w; ++OW) {
-                T sum = 0;
-                const int iw_start = OW * stride - pad_w;
-                const int iw_end = iw_start + kernel_w;
-                if (ih_start >= 0 && iw_start >= 0 &&
-                        ih_end < H && iw_end < W) {
-                    // Loop that doesn't need to check for boundary conditions.
-                    for (int fh = 0; fh < kernel_h; ++fh) {
-                        const int ih = ih_start + fh;
-                        const int x_start = xc_start + ih * W;
-                        const int f_start = fc_start + fh * kernel_w;
-                        for (int fw = 0; fw < kernel_w; ++fw) {
-                            const int iw = iw_start + fw;
-                            sum += x[x_start + iw] * w[f_start + fw];
-                        }  // End fw
-                    } // End fh
-                } else {
-                    // Loop that needs to check for boundary conditions.
-                    for (int fh = 0; fh < kernel_h; ++fh) {
-                        const int ih = ih_start + fh;
-                        const int x_start = xc_start + ih * W;
-                        const int f_start = fc_start + fh * kernel_w;
-                        for (int fw = 0; fw < kernel_w; ++fw) {
-                            const int iw = iw_start + fw;
-                            if (ih >= 0 && ih < H && iw >= 0 && iw < W) {
-                                sum += x[x_start + iw] * w[f_start + fw];
-                            }
-                        }  // End fw
-                    }  // End fh
-                }
-                y[yh_offset * out_w + OW] = sum;
-            }  // End OW
-        }  // End OH
-    }}  // End OC && OB
+    const bool              relu6,
+    const float*            x,
+    const float*            w,
+    const float*            b,
+    float*                  y) {
+    const int c = i % C;
+    DEPTHWISE_CONV2D_SPECIALIZE(_DepthwiseConv2dPlane_NCHW,
+        H, W, out_h, out_w, kernel_h, kernel_w,
+            stride_h, stride_w, pad_h, pad_w, relu6,
+                x + i * H * W, w + c * kernel_h * kernel_w,
+                    b != nullptr ? b[c] : 0.f,
+                        y + i * out_h * out_w);
 }
 
-template <typename T>
-void _DepthwiseConv2d_NHWC(
-    const int               N,
+DEFINE_CPU_ISA_THREADED_LOOP(_DepthwiseConv2dElem_NCHW,
+    (const int C, const int H, const int W,
+     const int out_h, const int out_w,
+     const int kernel_h, const int kernel_w,
+     const int stride_h, const int stride_w,
+     const int pad_h, const int pad_w, const bool relu6,
+     const float* x, const float* w, const float* b, float* y),
+    (C, H, W, out_h, out_w, kernel_h, kernel_w,
+     stride_h, stride_w, pad_h, pad_w, relu6, x, w, b, y));
+
+CPU_ISA_INLINE void _DepthwiseConv2dElem_NHWC(
+    const int               i,
     const int               C,
     const int               H,
     const int               W,
@@ -77,59 +169,68 @@ void _DepthwiseConv2d_NHWC(
     const int               out_w,
     const int               kernel_h,
     const int               kernel_w,
-    const int               stride,
+    const int               stride_h,
+    const int               stride_w,
     const int               pad_h,
     const int               pad_w,
-    const T*                x,
-    const T*                w,
-    T*                      y) {
-    for (int OB = 0; OB < N; ++OB) {
-        const int xb_start = OB * H;
-        const int yb_start = OB * out_h;
-        for (int OH = 0; OH < out_h; ++OH) {
-            const int ih_start = OH * stride - pad_h;
-            const int ih_end = ih_start + kernel_h;
-            const int yh_start = (yb_start + OH) * out_w;
-            for (int OW = 0; OW < out_w; ++OW) {
-                const int iw_start = OW * stride - pad_w;
-                const int iw_end = iw_start + kernel_w;
-                const int yw_start = (yh_start + OW) * C;
-                for (int OC = 0; OC < C; ++OC) {
-                    const int fc_start = OC * kernel_h;
-                    T sum = 0;
-                    if (ih_start >= 0 && iw_start >= 0 &&
-                            ih_end < H && iw_end < W) {
-                        // Loop that doesn't need to check for boundary conditions.
-                        for (int fh = 0; fh < kernel_h; ++fh) {
-                            const int ih = ih_start + fh;
-                            const int x_start = (xb_start + ih) * W;
-                            const int f_start = (fc_start + fh) * kernel_w;
-                            for (int fw = 0; fw < kernel_w; ++fw) {
-                                const int iw = iw_start + fw;
-                                const int x_idx = (x_start + iw) * C + OC;
-                                sum += x[x_idx] * w[f_start + fw];
-                            }  // End fw
-                        } // End fh
-                    } else {
-                        // Loop that needs to check for boundary conditions.
-                        for (int fh = 0; fh < kernel_h; ++fh) {
-                            const int ih = ih_start + fh;
-                            const int x_start = (xb_start + ih) * W;
-                            const int f_start = (fc_start + fh) * kernel_w;
-                            for (int fw = 0; fw < kernel_w; ++fw) {
-                                const int iw = iw_start + fw;
-                                if (ih >= 0 && ih < H && iw >= 0 && iw < W) {
-                                    const int x_idx = (x_start + iw) * C + OC;
-                                    sum += x[x_idx] * w[f_start + fw];
-                                }
-                            }  // End fw
-                        }  // End fh
-                    }
-                    y[yw_start + OC] = sum;
-                }  // End OC
-            }  // End OW
-        }  // End OH
-    }  // End OB
+    const bool              relu6,
+    const float*            x,
+    const float*            w,
+    const float*            b,
+    float*                  y) {
+    // ``w`` is transposed into [kernel_h, kernel_w, C]
+    const int n = i / out_h, oh = i % out_h;
+    const int ih_start = oh * stride_h - pad_h;
+    const int fh_lo = std::max(0, -ih_start);
+    const int fh_hi = std::min(kernel_h, H - ih_start);
+    for (int ow = 0; ow < out_w; ++ow) {
+        const int iw_start = ow * stride_w - pad_w;
+        const int fw_lo = std::max(0, -iw_start);
+        const int fw_hi = std::min(kernel_w, W - iw_start);
+        float* yc = y + (i * out_w + ow) * C;
+        if (b != nullptr) {
+            _Pragma("omp simd")
+            for (int c = 0; c < C; ++c) yc[c] = b[c];
+        } else {
+            _Pragma("omp simd")
+            for (int c = 0; c < C; ++c) yc[c] = 0.f;
+        }
+        for (int fh = fh_lo; fh < fh_hi; ++fh) {
+            const int x_start = (n * H + ih_start + fh) * W + iw_start;
+            for (int fw = fw_lo; fw < fw_hi; ++fw) {
+                const float* xc = x + (x_start + fw) * C;
+                const float* wc = w + (fh * kernel_w + fw) * C;
+                _Pragma("omp simd")
+                for (int c = 0; c < C; ++c) yc[c] += xc[c] * wc[c];
+            }  // End fw
+        }  // End fh
+        if (relu6) {
+            _Pragma("omp simd")
+            for (int c = 0; c < C; ++c) yc[c] = _Relu6(yc[c]);
+        }
+    }  // End ow
+}
+
+DEFINE_CPU_ISA_THREADED_LOOP(_DepthwiseConv2dElem_NHWC,
+    (const int C, const int H, const int W,
+     const int out_h, const int out_w,
+     const int kernel_h, const int kernel_w,
+     const int stride_h, const int stride_w,
+     const int pad_h, const int pad_w, const bool relu6,
+     const float* x, const float* w, const float* b, float* y),
+    (C, H, W, out_h, out_w, kernel_h, kernel_w,
+     stride_h, stride_w, pad_h, pad_w, relu6, x, w, b, y));
+
+/*! Transpose the filters between [C, K] and [K, C] */
+
+void _TransposeFilters(
+    const int               rows,
+    const int               cols,
+    const float*            x,
+    float*                  y) {
+    for (int i = 0; i < rows; ++i)
+        for (int j = 0; j < cols; ++j)
+            y[j * rows + i] = x[i * cols + j];
 }
 
 template <> void DepthwiseConv2d<float, CPUContext>(
@@ -141,27 +242,171 @@ template <> void DepthwiseConv2d<float, CPUContext>(
     const int               out_w,
     const int               kernel_h,
     const int               kernel_w,
-    const int               stride,
+    const int               stride_h,
+    const int               stride_w,
     const int               pad_h,
     const int               pad_w,
     const string&           data_format,
+    const bool              relu6,
     const float*            x,
     const float*            w,
+    const float*            b,
     float*                  y,
     CPUContext*             ctx) {
+    const int count = N * C * out_h * out_w;
     if (data_format == "NCHW") {
-        _DepthwiseConv2d_NCHW<float>(
-            N, C, H, W, out_h, out_w,
-                kernel_h, kernel_w, stride,
-                    pad_h, pad_w, x, w, y);
+        DISPATCH_CPU_ISA(_DepthwiseConv2dElem_NCHW,
+            N * C, count, C, H, W, out_h, out_w,
+                kernel_h, kernel_w, stride_h, stride_w,
+                    pad_h, pad_w, relu6, x, w, b, y);
+    } else if (data_format == "NHWC") {
+        vector<float> wt(C * kernel_h * kernel_w);
+        _TransposeFilters(C, kernel_h * kernel_w, w, wt.data());
+        DISPATCH_CPU_ISA(_DepthwiseConv2dElem_NHWC,
+            N * out_h, count, C, H, W, out_h, out_w,
+                kernel_h, kernel_w, stride_h, stride_w,
+                    pad_h, pad_w, relu6, x, wt.data(), b, y);
+    } else LOG(FATAL) << "Unknown data format: " << data_format;
+}
+
+/*! DepthwiseConv2dGrad <T = float32, Device = CPU> */
+
+template <int KKH, int KKW, int SS>
+CPU_ISA_INLINE void _DepthwiseConv2dGradPlane_NCHW(
+    const int               H,
+    const int               W,
+    const int               out_h,
+    const int               out_w,
+    const int               kernel_h,
+    const int               kernel_w,
+    const int               stride_h,
+    const int               stride_w,
+    const int               pad_h,
+    const int               pad_w,
+    const float*            dy,
+    const float*            w,
+    float*                  dx) {
+    DEPTHWISE_CONV2D_CONSTANTS;
+    _Pragma("omp simd")
+    for (int i = 0; i < H * W; ++i) dx[i] = 0.f;
+    for (int oh = 0; oh < out_h; ++oh) {
+        const int ih_start = oh * SH - pad_h;
+        const int fh_lo = std::max(0, -ih_start);
+        const int fh_hi = std::min(KH, H - ih_start);
+        const float* dyr = dy + oh * out_w;
+        for (int fh = fh_lo; fh < fh_hi; ++fh) {
+            const int x_start = (ih_start + fh) * W - pad_w;
+            for (int fw = 0; fw < KW; ++fw) {
+                int lo, hi;
+                _ValidRange(W, out_w, SW, pad_w, fw, &lo, &hi);
+                const float wv = w[fh * KW + fw];
+                // Each output scatters to a distinct input
+                _Pragma("omp simd")
+                for (int ow = lo; ow < hi; ++ow)
+                    dx[x_start + ow * SW + fw] += dyr[ow] * wv;
+            }  // End fw
+        }  // End fh
+    }  // End oh
+}
+
+CPU_ISA_INLINE void _DepthwiseConv2dGradElem_NCHW(
+    const int               i,
+    const int               C,
+    const int               H,
+    const int               W,
+    const int               out_h,
+    const int               out_w,
+    const int               kernel_h,
+    const int               kernel_w,
+    const int               stride_h,
+    const int               stride_w,
+    const int               pad_h,
+    const int               pad_w,
+    const float*            dy,
+    const float*            w,
+    float*                  dx) {
+    const int c = i % C;
+    const float* wc = w + c * kernel_h * kernel_w;
+    if (stride_h == 1 && stride_w == 1 &&
+            pad_h < kernel_h && pad_w < kernel_w) {
+        // It is a convolution of the gradients with the flipped filters
+        vector<float> wf(wc, wc + kernel_h * kernel_w);
+        std::reverse(wf.begin(), wf.end());
+        DEPTHWISE_CONV2D_SPECIALIZE(_DepthwiseConv2dPlane_NCHW,
+            out_h, out_w, H, W, kernel_h, kernel_w, 1, 1,
+                kernel_h - 1 - pad_h, kernel_w - 1 - pad_w, false,
+                    dy + i * out_h * out_w, wf.data(), 0.f,
+                        dx + i * H * W);
     } else {
-        _DepthwiseConv2d_NHWC<float>(
-            N, C, H, W, out_h, out_w,
-                kernel_h, kernel_w, stride,
-                    pad_h, pad_w, x, w, y);
+        DEPTHWISE_CONV2D_SPECIALIZE(_DepthwiseConv2dGradPlane_NCHW,
+            H, W, out_h, out_w, kernel_h, kernel_w,
+                stride_h, stride_w, pad_h, pad_w,
+                    dy + i * out_h * out_w, wc, dx + i * H * W);
     }
 }
 
+DEFINE_CPU_ISA_THREADED_LOOP(_DepthwiseConv2dGradElem_NCHW,
+    (const int C, const int H, const int W,
+     const int out_h, const int out_w,
+     const int kernel_h, const int kernel_w,
+     const int stride_h, const int stride_w,
+     const int pad_h, const int pad_w,
+     const float* dy, const float* w, float* dx),
+    (C, H, W, out_h, out_w, kernel_h, kernel_w,
+     stride_h, stride_w, pad_h, pad_w, dy, w, dx));
+
+CPU_ISA_INLINE void _DepthwiseConv2dGradElem_NHWC(
+    const int               i,
+    const int               C,
+    const int               H,
+    const int               W,
+    const int               out_h,
+    const int               out_w,
+    const int               kernel_h,
+    const int               kernel_w,
+    const int               stride_h,
+    const int               stride_w,
+    const int               pad_h,
+    const int               pad_w,
+    const float*            dy,
+    const float*            w,
+    float*                  dx) {
+    // Gather the outputs of each input to avoid the conflicts,
+    // ``w`` is transposed into [kernel_h, kernel_w, C]
+    const int n = i / H, ih = i % H;
+    for (int iw = 0; iw < W; ++iw) {
+        float* dxc = dx + (i * W + iw) * C;
+        _Pragma("omp simd")
+        for (int c = 0; c < C; ++c) dxc[c] = 0.f;
+        for (int fh = 0; fh < kernel_h; ++fh) {
+            const int oh_offset = ih + pad_h - fh;
+            if (oh_offset < 0 || oh_offset % stride_h) continue;
+            const int oh = oh_offset / stride_h;
+            if (oh >= out_h) continue;
+            for (int fw = 0; fw < kernel_w; ++fw) {
+                const int ow_offset = iw + pad_w - fw;
+                if (ow_offset < 0 || ow_offset % stride_w) continue;
+                const int ow = ow_offset / stride_w;
+                if (ow >= out_w) continue;
+                const float* dyc = dy + ((n * out_h + oh) * out_w + ow) * C;
+                const float* wc = w + (fh * kernel_w + fw) * C;
+                _Pragma("omp simd")
+                for (int c = 0; c < C; ++c) dxc[c] += dyc[c] * wc[c];
+            }  // End fw
+        }  // End fh
+    }  // End iw
+}
+
+DEFINE_CPU_ISA_THREADED_LOOP(_DepthwiseConv2dGradElem_NHWC,
+    (const int C, const int H, const int W,
+     const int out_h, const int out_w,
+     const int kernel_h, const int kernel_w,
+     const int stride_h, const int stride_w,
+     const int pad_h, const int pad_w,
+     const float* dy, const float* w, float* dx),
+    (C, H, W, out_h, out_w, kernel_h, kernel_w,
+     stride_h, stride_w, pad_h, pad_w, dy, w, dx));
+
 template <> void DepthwiseConv2dGrad<float, CPUContext>(
     const int               N,
     const int               C,
@@ -171,7 +416,8 @@ template <> void DepthwiseConv2dGrad<float, CPUContext>(
     const int               out_w,
     const int               kernel_h,
     const int               kernel_w,
-    const int               stride,
+    const int               stride_h,
+    const int               stride_w,
     const int               pad_h,
     const int               pad_w,
     const string&           data_format,
@@ -179,9 +425,170 @@ template <> void DepthwiseConv2dGrad<float, CPUContext>(
     const float*            w,
     float*                  dx,
     CPUContext*             ctx) {
-    NOT_IMPLEMENTED;
+    const int count = N * C * out_h * out_w;
+    if (data_format == "NCHW") {
+        DISPATCH_CPU_ISA(_DepthwiseConv2dGradElem_NCHW,
+            N * C, count, C, H, W, out_h, out_w,
+                kernel_h, kernel_w, stride_h, stride_w,
+                    pad_h, pad_w, dy, w, dx);
+    } else if (data_format == "NHWC") {
+        vector<float> wt(C * kernel_h * kernel_w);
+        _TransposeFilters(C, kernel_h * kernel_w, w, wt.data());
+        DISPATCH_CPU_ISA(_DepthwiseConv2dGradElem_NHWC,
+            N * H, count, C, H, W, out_h, out_w,
+                kernel_h, kernel_w, stride_h, stride_w,
+                    pad_h, pad_w, dy, wt.data(), dx);
+    } else LOG(FATAL) << "Unknown data format: " << data_format;
 }
 
+/*! DepthwiseConv2dWGrad <T = float32, Device = CPU> */
+
+template <int KKH, int KKW, int SS>
+CPU_ISA_INLINE void _DepthwiseConv2dWGradPlane_NCHW(
+    const int               H,
+    const int               W,
+    const int               out_h,
+    const int               out_w,
+    const int               kernel_h,
+    const int               kernel_w,
+    const int               stride_h,
+    const int               stride_w,
+    const int               pad_h,
+    const int               pad_w,
+    const float*            dy,
+    const float*            x,
+    float*                  acc) {
+    // ``acc`` holds the partial sums of [kernel_h, kernel_w, out_w]
+    DEPTHWISE_CONV2D_CONSTANTS;
+    for (int oh = 0; oh < out_h; ++oh) {
+        const int ih_start = oh * SH - pad_h;
+        const int fh_lo = std::max(0, -ih_start);
+        const int fh_hi = std::min(KH, H - ih_start);
+        const float* dyr = dy + oh * out_w;
+        for (int fh = fh_lo; fh < fh_hi; ++fh) {
+            for (int fw = 0; fw < KW; ++fw) {
+                int lo, hi;
+                _ValidRange(W, out_w, SW, pad_w, fw, &lo, &hi);
+                const int x_start = (ih_start + fh) * W - pad_w + fw;
+                float* accr = acc + (fh * KW + fw) * out_w;
+                _Pragma("omp simd")
+                for (int ow = lo; ow < hi; ++ow)
+                    accr[ow] += dyr[ow] * x[x_start + ow * SW];
+            }  // End fw
+        }  // End fh
+    }  // End oh
+}
+
+CPU_ISA_INLINE void _DepthwiseConv2dWGradElem_NCHW(
+    const int               c,
+    const int               N,
+    const int               C,
+    const int               H,
+    const int               W,
+    const int               out_h,
+    const int               out_w,
+    const int               kernel_h,
+    const int               kernel_w,
+    const int               stride_h,
+    const int               stride_w,
+    const int               pad_h,
+    const int               pad_w,
+    const float*            dy,
+    const float*            x,
+    float*                  dw) {
+    // Reduce the batch in a task to avoid the conflicts
+    vector<float> acc(kernel_h * kernel_w * out_w, 0.f);
+    for (int n = 0; n < N; ++n) {
+        const int i = n * C + c;
+        DEPTHWISE_CONV2D_SPECIALIZE(_DepthwiseConv2dWGradPlane_NCHW,
+            H, W, out_h, out_w, kernel_h, kernel_w,
+                stride_h, stride_w, pad_h, pad_w,
+                    dy + i * out_h * out_w,
+                        x + i * H * W, acc.data());
+    }
+    float* dwc = dw + c * kernel_h * kernel_w;
+    for (int k = 0; k < kernel_h * kernel_w; ++k) {
+        const float* accr = acc.data() + k * out_w;
+        float sum = 0.f;
+        _Pragma("omp simd reduction(+:sum)")
+        for (int ow = 0; ow < out_w; ++ow) sum += accr[ow];
+        dwc[k] = sum;
+    }
+}
+
+DEFINE_CPU_ISA_THREADED_LOOP(_DepthwiseConv2dWGradElem_NCHW,
+    (const int N, const int C, const int H, const int W,
+     const int out_h, const int out_w,
+     const int kernel_h, const int kernel_w,
+     const int stride_h, const int stride_w,
+     const int pad_h, const int pad_w,
+     const float* dy, const float* x, float* dw),
+    (N, C, H, W, out_h, out_w, kernel_h, kernel_w,
+     stride_h, stride_w, pad_h, pad_w, dy, x, dw));
+
+/*! The channels reduced by a task of NHWC */
+#define DEPTHWISE_CONV2D_CHANNEL_BLOCK 32
+
+CPU_ISA_INLINE void _DepthwiseConv2dWGradElem_NHWC(
+    const int               i,
+    const int               N,
+    const int               C,
+    const int               H,
+    const int               W,
+    const int               out_h,
+    const int               out_w,
+    const int               kernel_h,
+    const int               kernel_w,
+    const int               stride_h,
+    const int               stride_w,
+    const int               pad_h,
+    const int               pad_w,
+    const float*            dy,
+    const float*            x,
+    float*                  dw) {
+    // Reduce a block of channels in a task to avoid the conflicts,
+    // ``dw`` is transposed into [kernel_h, kernel_w, C]
+    const int c_start = i * DEPTHWISE_CONV2D_CHANNEL_BLOCK;
+    const int CB = std::min(DEPTHWISE_CONV2D_CHANNEL_BLOCK, C - c_start);
+    for (int k = 0; k < kernel_h * kernel_w; ++k) {
+        float* dwc = dw + k * C + c_start;
+        for (int c = 0; c < CB; ++c) dwc[c] = 0.f;
+    }
+    for (int n = 0; n < N; ++n) {
+        for (int oh = 0; oh < out_h; ++oh) {
+            const int ih_start = oh * stride_h - pad_h;
+            const int fh_lo = std::max(0, -ih_start);
+            const int fh_hi = std::min(kernel_h, H - ih_start);
+            for (int ow = 0; ow < out_w; ++ow) {
+                const int iw_start = ow * stride_w - pad_w;
+                const int fw_lo = std::max(0, -iw_start);
+                const int fw_hi = std::min(kernel_w, W - iw_start);
+                const float* dyc = dy + c_start +
+                    ((n * out_h + oh) * out_w + ow) * C;
+                for (int fh = fh_lo; fh < fh_hi; ++fh) {
+                    const int x_start = (n * H + ih_start + fh) * W + iw_start;
+                    for (int fw = fw_lo; fw < fw_hi; ++fw) {
+                        const float* xc = x + (x_start + fw) * C + c_start;
+                        float* dwc = dw + (fh * kernel_w + fw) * C + c_start;
+                        _Pragma("omp simd")
+                        for (int c = 0; c < CB; ++c) dwc[c] += dyc[c] * xc[c];
+                    }  // End fw
+                }  // End fh
+            }  // End ow
+        }  // End oh
+    }  // End n
+}
+
+DEFINE_CPU_ISA_THREADED_LOOP(_DepthwiseConv2dWGradElem_NHWC,
+    (const int N, const int C, const int H, const int W,
+     const int out_h, const int out_w,
+     const int kernel_h, const int kernel_w,
+     const int stride_h, const int stride_w,
+     const int pad_h, const int pad_w,
+     const float* dy, const float* x, float* dw),
+    (N, C, H, W, out_h, out_w, kernel_h, kernel_w,
+     stride_h, stride_w, pad_h, pad_w, dy, x, dw));
+
 template <> void DepthwiseConv2dWGrad<float, CPUContext>(
     const int               N,
     const int               C,
@@ -191,7 +598,8 @@ template <> void DepthwiseConv2dWGrad<float, CPUContext>(
     const int               out_w,
     const int               kernel_h,
     const int               kernel_w,
-    const int               stride,
+    const int               stride_h,
+    const int               stride_w,
     const int               pad_h,
     const int               pad_w,
     const string&           data_format,
@@ -199,9 +607,28 @@ template <> void DepthwiseConv2dWGrad<float, CPUContext>(
     const float*            x,
     float*                  dw,
     CPUContext*             ctx) {
-    NOT_IMPLEMENTED;
+    const int count = N * C * out_h * out_w;
+    if (data_format == "NCHW") {
+        DISPATCH_CPU_ISA(_DepthwiseConv2dWGradElem_NCHW,
+            C, count, N, C, H, W, out_h, out_w,
+                kernel_h, kernel_w, stride_h, stride_w,
+                    pad_h, pad_w, dy, x, dw);
+    } else if (data_format == "NHWC") {
+        vector<float> dwt(C * kernel_h * kernel_w);
+        const int num_blocks = (C + DEPTHWISE_CONV2D_CHANNEL_BLOCK - 1)
+            / DEPTHWISE_CONV2D_CHANNEL_BLOCK;
+        DISPATCH_CPU_ISA(_DepthwiseConv2dWGradElem_NHWC,
+            num_blocks, count, N, C, H, W, out_h, out_w,
+                kernel_h, kernel_w, stride_h, stride_w,
+                    pad_h, pad_w, dy, x, dwt.data());
+        _TransposeFilters(kernel_h * kernel_w, C, dwt.data(), dw);
+    } else LOG(FATAL) << "Unknown data format: " << data_format;
 }
 
+#undef DEPTHWISE_CONV2D_SPECIALIZE
+#undef DEPTHWISE_CONV2D_CONSTANTS
+#undef DEPTHWISE_CONV2D_CHANNEL_BLOCK
+
 }  // namespace kernel
 
-}  // namepsace dragon
\ No newline at end of file
+}  // namepsace dragon
@@ -19,11 +19,14 @@ __global__ void _DepthwiseConv2d_NCHW(
     const int               out_w,
     const int               kernel_h,
     const int               kernel_w,
-    const int               stride,
+    const int               stride_h,
+    const int               stride_w,
     const int               pad_h,
     const int               pad_w,
+    const bool              relu6,
     const T*                x,
     const T*                w,
+    const T*                b,
     T*                      y) {
     const int KH = KKH < 0 ? kernel_h : KKH;
     const int KW = KKW < 0 ? kernel_w : KKW;
@@ -33,8 +36,8 @@ __global__ void _DepthwiseConv2d_NCHW(
         const int OC = (idx / out_w / out_h) % C;
         const int OB = idx / out_w / out_h / C;
 
-        const int ih_start = OH * stride - pad_h;
-        const int iw_start = OW * stride - pad_w;
+        const int ih_start = OH * stride_h - pad_h;
+        const int iw_start = OW * stride_w - pad_w;
         const int ih_end = ih_start + KH;
         const int iw_end = iw_start + KW;
 
@@ -80,6 +83,8 @@ __global__ void _DepthwiseConv2d_NCHW(
                 }  // End fw
             }  // End fh
         }
+        if (b != nullptr) sum += b[OC];
+        if (relu6) sum = min(max(sum, T(0)), T(6));
         y[idx] = sum;
     }
 }
@@ -94,11 +99,14 @@ __global__ void _DepthwiseConv2d_NHWC(
     const int               out_w,
     const int               kernel_h,
     const int               kernel_w,
-    const int               stride,
+    const int               stride_h,
+    const int               stride_w,
     const int               pad_h,
     const int               pad_w,
+    const bool              relu6,
     const T*                x,
     const T*                w,
+    const T*                b,
     T*                      y) {
     const int KH = KKH < 0 ? kernel_h : KKH;
     const int KW = KKW < 0 ? kernel_w : KKW;
@@ -106,10 +114,10 @@ __global__ void _DepthwiseConv2d_NHWC(
         const int OC = idx % C;
         const int OW = (idx / C) % out_w;
         const int OH = (idx / C / out_w) % out_h;
-        const int OB = idx / C / out_h / out_h;
+        const int OB = idx / C / out_w / out_h;
 
-        const int ih_start = OH * stride - pad_h;
-        const int iw_start = OW * stride - pad_w;
+        const int ih_start = OH * stride_h - pad_h;
+        const int iw_start = OW * stride_w - pad_w;
         const int ih_end = ih_start + KH;
         const int iw_end = iw_start + KW;
 
@@ -157,6 +165,8 @@ __global__ void _DepthwiseConv2d_NHWC(
                 }  // End fw
             }  // End fh
         }
+        if (b != nullptr) sum += b[OC];
+        if (relu6) sum = min(max(sum, T(0)), T(6));
         y[idx] = sum;
     }
 }
@@ -170,12 +180,15 @@ template <> void DepthwiseConv2d<float, CUDAContext>(
     const int               out_w,
     const int               kernel_h,
     const int               kernel_w,
-    const int               stride,
+    const int               stride_h,
+    const int               stride_w,
     const int               pad_h,
     const int               pad_w,
     const string&           data_format,
+    const bool              relu6,
     const float*            x,
     const float*            w,
+    const float*            b,
     float*                  y,
     CUDAContext*            ctx) {
     const auto count = N * C * out_h * out_w;
@@ -185,15 +198,15 @@ template <> void DepthwiseConv2d<float, CUDAContext>(
                 << < CUDA_BLOCKS(count), CUDA_THREADS,
                      0, ctx->cuda_stream() >> >
                 (count, C, H, W, out_h, out_w,
-                    kernel_h, kernel_w, stride,
-                        pad_h, pad_w, x, w, y);
+                    kernel_h, kernel_w, stride_h, stride_w,
+                        pad_h, pad_w, relu6, x, w, b, y);
         } else {
             _DepthwiseConv2d_NCHW<float, -1, -1>
                 << < CUDA_BLOCKS(count), CUDA_THREADS,
                      0, ctx->cuda_stream() >> >
                 (count, C, H, W, out_h, out_w,
-                    kernel_h, kernel_w, stride,
-                        pad_h, pad_w, x, w, y);
+                    kernel_h, kernel_w, stride_h, stride_w,
+                        pad_h, pad_w, relu6, x, w, b, y);
         }
     } else if (data_format == "NHWC") {
         if (kernel_h == 3 && kernel_w == 3) {
@@ -201,15 +214,15 @@ template <> void DepthwiseConv2d<float, CUDAContext>(
                 << < CUDA_BLOCKS(count), CUDA_THREADS,
                      0, ctx->cuda_stream() >> >
                 (count, C, H, W, out_h, out_w,
-                    kernel_h, kernel_w, stride,
-                        pad_h, pad_w, x, w, y);
+                    kernel_h, kernel_w, stride_h, stride_w,
+                        pad_h, pad_w, relu6, x, w, b, y);
         } else {
             _DepthwiseConv2d_NHWC<float, -1, -1>
                 << < CUDA_BLOCKS(count), CUDA_THREADS,
                      0, ctx->cuda_stream() >> >
                 (count, C, H, W, out_h, out_w,
-                    kernel_h, kernel_w, stride,
-                        pad_h, pad_w, x, w, y);
+                    kernel_h, kernel_w, stride_h, stride_w,
+                        pad_h, pad_w, relu6, x, w, b, y);
         }
     } else LOG(FATAL) << "Unknown data format: " << data_format;
 }
@@ -224,7 +237,8 @@ __global__ void _DepthwiseConv2dGrad_NCHW(
     const int               out_w,
     const int               kernel_h,
     const int               kernel_w,
-    const int               stride,
+    const int               stride_h,
+    const int               stride_w,
     const int               pad_h,
     const int               pad_w,
     const T*                dy,
@@ -238,10 +252,10 @@ __global__ void _DepthwiseConv2dGrad_NCHW(
         const int IC = (idx / W / H) % C;
         const int IB = idx / W / H / C;
 
-        const int oh_start = max(0, (IH - KH + pad_h + stride) / stride);
-        const int oh_end = min(out_h - 1, (IH + pad_h) / stride);
-        const int ow_start = max(0, (IW - KW + pad_w + stride) / stride);
-        const int ow_end = min(out_w - 1, (IW + pad_w) / stride);
+        const int oh_start = max(0, (IH - KH + pad_h + stride_h) / stride_h);
+        const int oh_end = min(out_h - 1, (IH + pad_h) / stride_h);
+        const int ow_start = max(0, (IW - KW + pad_w + stride_w) / stride_w);
+        const int ow_end = min(out_w - 1, (IW + pad_w) / stride_w);
 
         const int fc_start = IC * KH * KW;
         const int yc_start = (IB * C + IC) * (out_h * out_w);
@@ -249,11 +263,11 @@ __global__ void _DepthwiseConv2dGrad_NCHW(
         T sum = 0;
 #pragma unroll
         for (int oh = oh_start; oh <= oh_end; ++oh) {
-            const int fh = IH + pad_h - oh * stride;
+            const int fh = IH + pad_h - oh * stride_h;
             const int f_start = fc_start + fh * KW;
             const int y_start = yc_start + oh * out_w;
             for (int ow = ow_start; ow <= ow_end; ++ow) {
-                const int fw = IW + pad_w - ow * stride;
+                const int fw = IW + pad_w - ow * stride_w;
 #if __CUDA_ARCH__ >= 350
                 sum += __ldg(dy + y_start + ow) * __ldg(w + f_start + fw);
 #else
@@ -274,7 +288,8 @@ template <> void DepthwiseConv2dGrad<float, CUDAContext>(
     const int               out_w,
     const int               kernel_h,
     const int               kernel_w,
-    const int               stride,
+    const int               stride_h,
+    const int               stride_w,
     const int               pad_h,
     const int               pad_w,
     const string&           data_format,
@@ -282,21 +297,21 @@ template <> void DepthwiseConv2dGrad<float, CUDAContext>(
     const float*            w,
     float*                  dx,
     CUDAContext*            ctx) {
-    const auto count = N * C * out_h * out_w;
+    const auto count = N * C * H * W;
     if (data_format == "NCHW") {
         if (kernel_h == 3 && kernel_w == 3) {
             _DepthwiseConv2dGrad_NCHW<float, 3, 3>
                 << < CUDA_BLOCKS(count), CUDA_THREADS,
                      0, ctx->cuda_stream() >> >
                 (count, C, H, W, out_h, out_w,
-                    kernel_h, kernel_w, stride,
+                    kernel_h, kernel_w, stride_h, stride_w,
                         pad_h, pad_w, dy, w, dx);
         } else {
             _DepthwiseConv2dGrad_NCHW<float, -1, -1>
                 << < CUDA_BLOCKS(count), CUDA_THREADS,
                      0, ctx->cuda_stream() >> >
                 (count, C, H, W, out_h, out_w,
-                    kernel_h, kernel_w, stride,
+                    kernel_h, kernel_w, stride_h, stride_w,
                         pad_h, pad_w, dy, w, dx);
         }
     } else if (data_format == "NHWC") {
@@ -320,7 +335,8 @@ __global__ void _DepthwiseConv2dWGrad_NCHW(
     const int               out_w,
     const int               kernel_h,
     const int               kernel_w,
-    const int               stride,
+    const int               stride_h,
+    const int               stride_w,
     const int               pad_h,
     const int               pad_w,
     const T*                dy,
@@ -334,8 +350,8 @@ __global__ void _DepthwiseConv2dWGrad_NCHW(
         const int OC = (idx / out_w / out_h) % C;
         const int OB = idx / out_w / out_h / C;
 
-        const int ih_start = OH * stride - pad_h;
-        const int iw_start = OW * stride - pad_w;
+        const int ih_start = OH * stride_h - pad_h;
+        const int iw_start = OW * stride_w - pad_w;
         const int ih_end = ih_start + KH;
         const int iw_end = iw_start + KW;
 
@@ -397,7 +413,8 @@ template <> void DepthwiseConv2dWGrad<float, CUDAContext>(
     const int               out_w,
     const int               kernel_h,
     const int               kernel_w,
-    const int               stride,
+    const int               stride_h,
+    const int               stride_w,
     const int               pad_h,
     const int               pad_w,
     const string&           data_format,
@@ -412,14 +429,14 @@ template <> void DepthwiseConv2dWGrad<float, CUDAContext>(
                 << < CUDA_BLOCKS(count), CUDA_THREADS,
                      0, ctx->cuda_stream() >> >
                 (count, C, H, W, out_h, out_w,
-                    kernel_h, kernel_w, stride,
+                    kernel_h, kernel_w, stride_h, stride_w,
                         pad_h, pad_w, dy, x, dw);
         } else {
             _DepthwiseConv2dWGrad_NCHW<float, -1, -1>
                 << < CUDA_BLOCKS(count), CUDA_THREADS,
                      0, ctx->cuda_stream() >> >
                 (count, C, H, W, out_h, out_w,
-                    kernel_h, kernel_w, stride,
+                    kernel_h, kernel_w, stride_h, stride_w,
                         pad_h, pad_w, dy, x, dw);
         }
     } else if (data_format == "NHWC") {
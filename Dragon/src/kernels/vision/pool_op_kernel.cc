@@ -1,3 +1,4 @@
+#include "utils/cpu_isa.h"
 #include "utils/op_kernel.h"
 #include "utils/math_functions.h"
 
@@ -5,12 +6,74 @@ namespace dragon {
 
 namespace kernel {
 
+/*!
+ * The CPU engine computes a image plane (NCHW) or row (NHWC) per task.
+ * NCHW vectorizes along the pooled width by accumulating a window
+ * position per pass, NHWC vectorizes along the channels.
+ * NCHW max pooling selects along the contiguous rows of the window first,
+ * then along its columns with the stride, to avoid the strided loads of X.
+ *
+ * The mask of max pooling is optional, and records the first maximum
+ * in the window as ``h * W + w`` (NCHW) or ``(h * W + w) * C + c`` (NHWC).
+ * It is selected along with the value, which vectorizes as the blends.
+ */
+
+/*! Return the outputs ``[lo, hi)`` where ``o * stride + k - pad`` is in ``[0, size)`` */
+
+CPU_ISA_INLINE void _PoolRange(
+    const int               size,
+    const int               out_size,
+    const int               stride,
+    const int               pad,
+    const int               k,
+    int*                    lo,
+    int*                    hi) {
+    const int first = pad - k, last = size - 1 + pad - k;
+    *lo = first > 0 ? (first + stride - 1) / stride : 0;
+    *hi = last < 0 ? 0 : std::min(last / stride + 1, out_size);
+    *lo = std::min(*lo, *hi);
+}
+
+/*! Return the outputs ``[lo, hi)`` whose window covers the input ``i`` */
+
+CPU_ISA_INLINE void _PoolCover(
+    const int               i,
+    const int               out_size,
+    const int               kernel,
+    const int               stride,
+    const int               pad,
+    int*                    lo,
+    int*                    hi) {
+    const int first = i + pad - kernel + 1;
+    *lo = first > 0 ? (first + stride - 1) / stride : 0;
+    *hi = std::min((i + pad) / stride + 1, out_size);
+}
+
+/*! Return the window area including the padding */
+
+CPU_ISA_INLINE int _PoolArea(
+    const int               start,
+    const int               size,
+    const int               kernel,
+    const int               pad) {
+    return std::min(start + kernel, size + pad) - start;
+}
+
+/*! Specialize the width stride to turn the strided loads into shuffles */
+#define POOL2D_SPECIALIZE(fn, ...) \
+    if (stride_w == 1) { \
+        fn<1>(__VA_ARGS__); \
+    } else if (stride_w == 2) { \
+        fn<2>(__VA_ARGS__); \
+    } else { \
+        fn<-1>(__VA_ARGS__); \
+    }
+
 /*! MAXPool2d <T = float32, Device = CPU> */
 
-template <typename T>
-void _MAXPool2d_NCHW(
-    const int               N,
-    const int               C,
+template <int SS>
+CPU_ISA_INLINE void _MAXPool2dPlane_NCHW(
+    const int               i,
     const int               H,
     const int               W,
     const int               pool_h,
@@ -24,48 +87,109 @@ void _MAXPool2d_NCHW(
     const float*            x,
     int*                    mask,
     float*                  y) {
-    const int64_t x_offset = H * W, y_offset = pool_h * pool_w;
-    const int64_t X_offset = C * x_offset, Y_offset = C * y_offset;
-
-    for (int n = 0; n < N; ++n) {
-        auto* X = x + n * X_offset;
-        auto* Y = y + n * Y_offset;
-        auto* M = mask + n * Y_offset;
-        for (int c = 0; c < C; ++c) {
-            for (int ph = 0; ph < pool_h; ++ph) {
+    const int SW = SS < 0 ? stride_w : SS;
+    const float* X = x + i * H * W;
+    // The max over the window rows, padded to leave out the bounds
+    const int row_size = std::max(
+        (pool_w - 1) * SW + kernel_w, pad_w + W);
+    vector<float> R(row_size, -FLT_MAX);
+    vector<int> RI(mask != nullptr ? row_size : 0, -1);
+    float* Rw = R.data() + pad_w;
+    int* RIw = RI.data() + pad_w;
+    for (int ph = 0; ph < pool_h; ++ph) {
+        const int start_h = ph * stride_h - pad_h;
+        const int h_lo = std::max(start_h, 0);
+        const int h_hi = std::min(start_h + kernel_h, H);
+        const int y_start = (i * pool_h + ph) * pool_w;
+        float* Y = y + y_start;
+        int* M = mask != nullptr ? mask + y_start : nullptr;
+        // Select along the contiguous rows, the upper row wins the ties
+        const bool empty = h_lo >= h_hi;
+        const float* Xh = X + (empty ? 0 : h_lo) * W;
+        if (M != nullptr) {
+            _Pragma("omp simd")
+            for (int w = 0; w < W; ++w) {
+                const bool sel = !empty && Xh[w] > -FLT_MAX;
+                Rw[w] = sel ? Xh[w] : -FLT_MAX;
+                RIw[w] = sel ? h_lo * W + w : -1;
+            }
+            for (int h = h_lo + 1; h < h_hi; ++h) {
+                Xh = X + h * W;
+                _Pragma("omp simd")
+                for (int w = 0; w < W; ++w) {
+                    const bool sel = Xh[w] > Rw[w];
+                    Rw[w] = sel ? Xh[w] : Rw[w];
+                    RIw[w] = sel ? h * W + w : RIw[w];
+                }
+            }
+        } else {
+            _Pragma("omp simd")
+            for (int w = 0; w < W; ++w)
+                Rw[w] = empty ? -FLT_MAX : Xh[w];
+            for (int h = h_lo + 1; h < h_hi; ++h) {
+                Xh = X + h * W;
+                _Pragma("omp simd")
+                for (int w = 0; w < W; ++w)
+                    Rw[w] = Xh[w] > Rw[w] ? Xh[w] : Rw[w];
+            }
+        }
+        // Select along the window columns with the stride
+        if (M != nullptr) {
+            _Pragma("omp simd")
+            for (int pw = 0; pw < pool_w; ++pw) {
+                Y[pw] = R[pw * SW]; M[pw] = RI[pw * SW];
+            }
+            for (int kw = 1; kw < kernel_w; ++kw) {
+                const float* Rk = R.data() + kw;
+                const int* RIk = RI.data() + kw;
+                _Pragma("omp simd")
                 for (int pw = 0; pw < pool_w; ++pw) {
-                    int start_h = ph * stride_h - pad_h;
-                    int start_w = pw * stride_w - pad_w;
-                    int end_h = std::min(start_h + kernel_h, H);
-                    int end_w = std::min(start_w + kernel_w, W);
-                    start_h = std::max(start_h, 0);
-                    start_w = std::max(start_w, 0);
-                    const int pool_idx = ph * pool_w + pw;
-                    float max_val = -FLT_MAX;
-                    int max_idx = -1;
-                    for (int h = start_h; h < end_h; ++h) {
-                        for (int w = start_w; w < end_w; ++w) {
-                            const int idx = h * W + w;
-                            if (X[idx] > max_val) {
-                                max_val = X[idx];
-                                max_idx = idx;
-                            }
-                        }
-                    }
-                    Y[pool_idx] = max_val;
-                    M[pool_idx] = max_idx;
+                    // Keep the first maximum in the order of window
+                    const float val = Rk[pw * SW];
+                    const int idx = RIk[pw * SW];
+                    const bool sel = val > Y[pw] ||
+                        (val == Y[pw] && idx < M[pw]);
+                    Y[pw] = sel ? val : Y[pw];
+                    M[pw] = sel ? idx : M[pw];
+                }
+            }
+        } else {
+            _Pragma("omp simd")
+            for (int pw = 0; pw < pool_w; ++pw) Y[pw] = R[pw * SW];
+            for (int kw = 1; kw < kernel_w; ++kw) {
+                const float* Rk = R.data() + kw;
+                _Pragma("omp simd")
+                for (int pw = 0; pw < pool_w; ++pw) {
+                    const float val = Rk[pw * SW];
+                    Y[pw] = val > Y[pw] ? val : Y[pw];
                 }
-            } 
-            X += x_offset;
-            Y += y_offset;
-            M += y_offset;
+            }
         }
-    }
+    }  // End ph
 }
 
-template <typename T>
-void _MAXPool2d_NHWC(
-    const int               N,
+CPU_ISA_INLINE void _MAXPool2dElem_NCHW(
+    const int               i,
+    const int               H,
+    const int               W,
+    const int               pool_h,
+    const int               pool_w,
+    const int               kernel_h,
+    const int               kernel_w,
+    const int               stride_h,
+    const int               stride_w,
+    const int               pad_h,
+    const int               pad_w,
+    const float*            x,
+    int*                    mask,
+    float*                  y) {
+    POOL2D_SPECIALIZE(_MAXPool2dPlane_NCHW, i, H, W, pool_h, pool_w,
+        kernel_h, kernel_w, stride_h, stride_w,
+            pad_h, pad_w, x, mask, y);
+}
+
+CPU_ISA_INLINE void _MAXPool2dElem_NHWC(
+    const int               i,
     const int               C,
     const int               H,
     const int               W,
@@ -80,46 +204,170 @@ void _MAXPool2d_NHWC(
     const float*            x,
     int*                    mask,
     float*                  y) {
-    const int64_t X_offset = H * W * C,
-        Y_offset = pool_h * pool_w * C;
-
-    for (int n = 0; n < N; ++n) {
-        auto* X = x + n * X_offset;
-        auto* Y = y + n * Y_offset;
-        auto* M = mask + n * Y_offset;
-        for (int ph = 0; ph < pool_h; ph++) {
-            for (int pw = 0; pw < pool_w; ++pw) {
-                int start_h = ph * stride_h - pad_h;
-                int start_w = pw * stride_w - pad_w;
-                int end_h = std::min(start_h + kernel_h, H);
-                int end_w = std::min(start_w + kernel_w, W);
-                start_h = std::max(start_h, 0);
-                start_w = std::max(start_w, 0);
-                const int base_pool_idx = ph * pool_w + pw;
-                for (int c = 0; c < C; ++c) {
-                    const int pool_idx = base_pool_idx * C + c;
-                    float max_val = -FLT_MAX;
-                    int max_idx = -1;
-                    for (int h = start_h; h < end_h; ++h) {
-                        for (int w = start_w; w < end_w; ++w) {
-                            const int idx = (h * W + w) * C + c;
-                            if (X[idx] > max_val) {
-                                max_val = X[idx];
-                                max_idx = idx;
-                            }
-                        }
+    const int n = i / pool_h, ph = i % pool_h;
+    const int start_h = ph * stride_h - pad_h;
+    const int h_lo = std::max(start_h, 0);
+    const int h_hi = std::min(start_h + kernel_h, H);
+    const float* X = x + n * H * W * C;
+    for (int pw = 0; pw < pool_w; ++pw) {
+        const int start_w = pw * stride_w - pad_w;
+        const int w_lo = std::max(start_w, 0);
+        const int w_hi = std::min(start_w + kernel_w, W);
+        const int y_start = (i * pool_w + pw) * C;
+        float* Y = y + y_start;
+        int* M = mask != nullptr ? mask + y_start : nullptr;
+        _Pragma("omp simd")
+        for (int c = 0; c < C; ++c) Y[c] = -FLT_MAX;
+        if (M != nullptr) {
+            _Pragma("omp simd")
+            for (int c = 0; c < C; ++c) M[c] = -1;
+        }
+        for (int h = h_lo; h < h_hi; ++h) {
+            for (int w = w_lo; w < w_hi; ++w) {
+                const int x_start = (h * W + w) * C;
+                const float* Xc = X + x_start;
+                if (M != nullptr) {
+                    _Pragma("omp simd")
+                    for (int c = 0; c < C; ++c) {
+                        const int sel = -int(Xc[c] > Y[c]);
+                        Y[c] = std::max(Y[c], Xc[c]);
+                        M[c] = ((x_start + c) & sel) | (M[c] & ~sel);
                     }
-                    Y[pool_idx] = max_val;
-                    M[pool_idx] = max_idx;
+                } else {
+                    _Pragma("omp simd")
+                    for (int c = 0; c < C; ++c) Y[c] = std::max(Y[c], Xc[c]);
                 }
+            }  // End w
+        }  // End h
+    }  // End pw
+}
+
+/*! The lanes to select the global maximum independently */
+#define GLOBAL_POOL_LANES 16
+
+CPU_ISA_INLINE void _GlobalMAXPool2dElem_NCHW(
+    const int               i,
+    const int               HxW,
+    const float*            x,
+    int*                    mask,
+    float*                  y) {
+    const int L = GLOBAL_POOL_LANES;
+    const float* X = x + i * HxW;
+    float val = -FLT_MAX;
+    if (HxW < L) {
+        for (int j = 0; j < HxW; ++j) val = X[j] > val ? X[j] : val;
+    } else {
+        // Keep a maximum per lane, the last block overlaps the previous
+        float V[GLOBAL_POOL_LANES];
+        _Pragma("omp simd")
+        for (int l = 0; l < L; ++l) V[l] = X[HxW - L + l];
+        for (int j = 0; j + L < HxW; j += L) {
+            _Pragma("omp simd")
+            for (int l = 0; l < L; ++l)
+                V[l] = X[j + l] > V[l] ? X[j + l] : V[l];
+        }
+        // Merge the lanes by halves
+        for (int n = L / 2; n > 0; n /= 2) {
+            _Pragma("omp simd")
+            for (int l = 0; l < n; ++l)
+                V[l] = V[l + n] > V[l] ? V[l + n] : V[l];
+        }
+        val = V[0];
+    }
+    y[i] = val;
+    if (mask != nullptr) {
+        // Select the first index of maximum, -1 if all are -FLT_MAX
+        int idx = -1;
+        if (val > -FLT_MAX && HxW < L) {
+            for (int j = HxW - 1; j >= 0; --j) idx = X[j] == val ? j : idx;
+        } else if (val > -FLT_MAX) {
+            // Visit the blocks backwards, the earlier index overwrites
+            int VI[GLOBAL_POOL_LANES];
+            _Pragma("omp simd")
+            for (int l = 0; l < L; ++l) VI[l] = HxW;
+            for (int j = HxW - L; j > 0; j -= L) {
+                _Pragma("omp simd")
+                for (int l = 0; l < L; ++l)
+                    VI[l] = X[j + l] == val ? j + l : VI[l];
+            }
+            _Pragma("omp simd")
+            for (int l = 0; l < L; ++l) VI[l] = X[l] == val ? l : VI[l];
+            for (int n = L / 2; n > 0; n /= 2) {
+                _Pragma("omp simd")
+                for (int l = 0; l < n; ++l)
+                    VI[l] = VI[l + n] < VI[l] ? VI[l + n] : VI[l];
             }
+            idx = VI[0];
         }
-        x += X_offset;
-        y += Y_offset;
-        mask += Y_offset;
+        mask[i] = idx;
     }
 }
 
+#undef GLOBAL_POOL_LANES
+
+CPU_ISA_INLINE void _GlobalMAXPool2dElem_NHWC(
+    const int               n,
+    const int               C,
+    const int               HxW,
+    const float*            x,
+    int*                    mask,
+    float*                  y) {
+    const float* X = x + n * HxW * C;
+    float* Y = y + n * C;
+    int* M = mask != nullptr ? mask + n * C : nullptr;
+    _Pragma("omp simd")
+    for (int c = 0; c < C; ++c) Y[c] = -FLT_MAX;
+    if (M != nullptr) {
+        _Pragma("omp simd")
+        for (int c = 0; c < C; ++c) M[c] = -1;
+    }
+    for (int j = 0; j < HxW; ++j) {
+        const float* Xc = X + j * C;
+        if (M != nullptr) {
+            _Pragma("omp simd")
+            for (int c = 0; c < C; ++c) {
+                const int sel = -int(Xc[c] > Y[c]);
+                Y[c] = std::max(Y[c], Xc[c]);
+                M[c] = ((j * C + c) & sel) | (M[c] & ~sel);
+            }
+        } else {
+            _Pragma("omp simd")
+            for (int c = 0; c < C; ++c) Y[c] = std::max(Y[c], Xc[c]);
+        }
+    }
+}
+
+DEFINE_CPU_ISA_THREADED_LOOP(_MAXPool2dElem_NCHW,
+    (const int H, const int W, const int pool_h, const int pool_w,
+     const int kernel_h, const int kernel_w,
+     const int stride_h, const int stride_w,
+     const int pad_h, const int pad_w,
+     const float* x, int* mask, float* y),
+    (H, W, pool_h, pool_w, kernel_h, kernel_w,
+     stride_h, stride_w, pad_h, pad_w, x, mask, y));
+
+DEFINE_CPU_ISA_THREADED_LOOP(_MAXPool2dElem_NHWC,
+    (const int C, const int H, const int W,
+     const int pool_h, const int pool_w,
+     const int kernel_h, const int kernel_w,
+     const int stride_h, const int stride_w,
+     const int pad_h, const int pad_w,
+     const float* x, int* mask, float* y),
+    (C, H, W, pool_h, pool_w, kernel_h, kernel_w,
+     stride_h, stride_w, pad_h, pad_w, x, mask, y));
+
+DEFINE_CPU_ISA_THREADED_LOOP(_GlobalMAXPool2dElem_NCHW,
+    (const int HxW, const float* x, int* mask, float* y),
+    (HxW, x, mask, y));
+
+DEFINE_CPU_ISA_THREADED_LOOP(_GlobalMAXPool2dElem_NHWC,
+    (const int C, const int HxW, const float* x, int* mask, float* y),
+    (C, HxW, x, mask, y));
+
+/*! Whether the window covers the whole image */
+#define IS_GLOBAL_POOLING \
+    (kernel_h == H && kernel_w == W && pad_h == 0 && pad_w == 0)
+
 template<> void MAXPool2d<float, CPUContext>(
     const int               N,
     const int               C,
@@ -138,23 +386,35 @@ template<> void MAXPool2d<float, CPUContext>(
     int*                    mask,
     float*                  y,
     CPUContext*             ctx) {
+    const int count = N * C * H * W;
     if (data_format == "NCHW") {
-        _MAXPool2d_NCHW<float>(
-            N, C, H, W, pool_h, pool_w, kernel_h, kernel_w,
-                stride_h, stride_w, pad_h, pad_w, x, mask, y);
+        if (IS_GLOBAL_POOLING) {
+            DISPATCH_CPU_ISA(_GlobalMAXPool2dElem_NCHW,
+                N * C, count, H * W, x, mask, y);
+        } else {
+            DISPATCH_CPU_ISA(_MAXPool2dElem_NCHW,
+                N * C, count, H, W, pool_h, pool_w,
+                    kernel_h, kernel_w, stride_h, stride_w,
+                        pad_h, pad_w, x, mask, y);
+        }
     } else if (data_format == "NHWC") {
-        _MAXPool2d_NHWC<float>(
-            N, C, H, W, pool_h, pool_w, kernel_h, kernel_w,
-                stride_h, stride_w, pad_h, pad_w, x, mask, y);
+        if (IS_GLOBAL_POOLING) {
+            DISPATCH_CPU_ISA(_GlobalMAXPool2dElem_NHWC,
+                N, count, C, H * W, x, mask, y);
+        } else {
+            DISPATCH_CPU_ISA(_MAXPool2dElem_NHWC,
+                N * pool_h, count, C, H, W, pool_h, pool_w,
+                    kernel_h, kernel_w, stride_h, stride_w,
+                        pad_h, pad_w, x, mask, y);
+        }
     } else LOG(FATAL) << "Unknown data format: " << data_format;
 }
 
 /*! AVGPool2d <T = float32, Device = CPU> */
 
-template<typename T>
-void _AVGPool2d_NCHW(
-    const int               N,
-    const int               C,
+template <int SS>
+CPU_ISA_INLINE void _AVGPool2dPlane_NCHW(
+    const int               i,
     const int               H,
     const int               W,
     const int               pool_h,
@@ -167,41 +427,54 @@ void _AVGPool2d_NCHW(
     const int               pad_w,
     const float*            x,
     float*                  y) {
-    const int64_t x_offset = H * W, y_offset = pool_h * pool_w;
-    const int64_t X_offset = C * x_offset, Y_offset = C * y_offset;
-
-    for (int n = 0; n < N; ++n) {
-        auto* X = x + n * X_offset;
-        auto* Y = y + n * Y_offset;
-        for (int c = 0; c < C; ++c) {
-            for (int ph = 0; ph < pool_h; ++ph) {
-                for (int pw = 0; pw < pool_w; ++pw) {
-                    int start_h = ph * stride_h - pad_h;
-                    int start_w = pw * stride_w - pad_w;
-                    int end_h = std::min(start_h + kernel_h, H + pad_h);
-                    int end_w = std::min(start_w + kernel_w, W + pad_w);
-                    int pool_area = (end_h - start_h) * (end_w - start_w);
-                    end_h = std::min(end_h, H);
-                    end_w = std::min(end_w, W);
-                    start_h = std::max(start_h, 0);
-                    start_w = std::max(start_w, 0);
-                    const int pool_idx = ph * pool_w + pw;
-                    T sum_val = 0;
-                    for (int h = start_h; h < end_h; ++h)
-                        for (int w = start_w; w < end_w; ++w)
-                            sum_val += X[h * W + w];
-                    Y[pool_idx] = sum_val / pool_area;
-                } 
-            }
-            X += x_offset;
-            Y += y_offset;
+    const int SW = SS < 0 ? stride_w : SS;
+    const float* X = x + i * H * W;
+    for (int ph = 0; ph < pool_h; ++ph) {
+        const int start_h = ph * stride_h - pad_h;
+        const int kh_lo = std::max(0, -start_h);
+        const int kh_hi = std::min(kernel_h, H - start_h);
+        float* Y = y + (i * pool_h + ph) * pool_w;
+        _Pragma("omp simd")
+        for (int pw = 0; pw < pool_w; ++pw) Y[pw] = 0.f;
+        for (int kh = kh_lo; kh < kh_hi; ++kh) {
+            const int x_start = (start_h + kh) * W - pad_w;
+            for (int kw = 0; kw < kernel_w; ++kw) {
+                int lo, hi;
+                _PoolRange(W, pool_w, SW, pad_w, kw, &lo, &hi);
+                _Pragma("omp simd")
+                for (int pw = lo; pw < hi; ++pw)
+                    Y[pw] += X[x_start + pw * SW + kw];
+            }  // End kw
+        }  // End kh
+        const int area_h = _PoolArea(start_h, H, kernel_h, pad_h);
+        for (int pw = 0; pw < pool_w; ++pw) {
+            const int start_w = pw * SW - pad_w;
+            Y[pw] /= float(area_h * _PoolArea(start_w, W, kernel_w, pad_w));
         }
-    }
+    }  // End ph
 }
 
-template<typename T>
-void _AVGPool2d_NHWC(
-    const int               N,
+CPU_ISA_INLINE void _AVGPool2dElem_NCHW(
+    const int               i,
+    const int               H,
+    const int               W,
+    const int               pool_h,
+    const int               pool_w,
+    const int               kernel_h,
+    const int               kernel_w,
+    const int               stride_h,
+    const int               stride_w,
+    const int               pad_h,
+    const int               pad_w,
+    const float*            x,
+    float*                  y) {
+    POOL2D_SPECIALIZE(_AVGPool2dPlane_NCHW, i, H, W, pool_h, pool_w,
+        kernel_h, kernel_w, stride_h, stride_w,
+            pad_h, pad_w, x, y);
+}
+
+CPU_ISA_INLINE void _AVGPool2dElem_NHWC(
+    const int               i,
     const int               C,
     const int               H,
     const int               W,
@@ -215,39 +488,91 @@ void _AVGPool2d_NHWC(
     const int               pad_w,
     const float*            x,
     float*                  y) {
-    const int64_t X_offset = H * W * C,
-        Y_offset = pool_h * pool_w * C;
+    const int n = i / pool_h, ph = i % pool_h;
+    const int start_h = ph * stride_h - pad_h;
+    const int h_lo = std::max(start_h, 0);
+    const int h_hi = std::min(start_h + kernel_h, H);
+    const int area_h = _PoolArea(start_h, H, kernel_h, pad_h);
+    const float* X = x + n * H * W * C;
+    for (int pw = 0; pw < pool_w; ++pw) {
+        const int start_w = pw * stride_w - pad_w;
+        const int w_lo = std::max(start_w, 0);
+        const int w_hi = std::min(start_w + kernel_w, W);
+        const float scale = 1.f / float(area_h *
+            _PoolArea(start_w, W, kernel_w, pad_w));
+        float* Y = y + (i * pool_w + pw) * C;
+        _Pragma("omp simd")
+        for (int c = 0; c < C; ++c) Y[c] = 0.f;
+        for (int h = h_lo; h < h_hi; ++h) {
+            for (int w = w_lo; w < w_hi; ++w) {
+                const float* Xc = X + (h * W + w) * C;
+                _Pragma("omp simd")
+                for (int c = 0; c < C; ++c) Y[c] += Xc[c];
+            }  // End w
+        }  // End h
+        _Pragma("omp simd")
+        for (int c = 0; c < C; ++c) Y[c] *= scale;
+    }  // End pw
+}
 
-    for (int n = 0; n < N; ++n) {
-        auto* X = x + n * X_offset;
-        auto* Y = y + n * Y_offset;
-        for (int ph = 0; ph < pool_h; ph++) {
-            for (int pw = 0; pw < pool_w; ++pw) {
-                int start_h = ph * stride_h - pad_h;
-                int start_w = pw * stride_w - pad_w;
-                int end_h = std::min(start_h + kernel_h, H + pad_h);
-                int end_w = std::min(start_w + kernel_w, W + pad_w);
-                int pool_area = (end_h - start_h) * (end_w - start_w);
-                end_h = std::min(end_h, H);
-                end_w = std::min(end_w, W);
-                start_h = std::max(start_h, 0);
-                start_w = std::max(start_w, 0);
-                const int base_pool_idx = ph * pool_w + pw;
-                for (int c = 0; c < C; ++c) {
-                    const int pool_idx = base_pool_idx * C + c;
-                    T sum_val = 0;
-                    for (int h = start_h; h < end_h; ++h)
-                        for (int w = start_w; w < end_w; ++w)
-                            sum_val += X[(h * W + w) * C + c];
-                    Y[pool_idx] = sum_val / pool_area;
-                }
-            }
-        }
-        X += X_offset;
-        Y += Y_offset;
+CPU_ISA_INLINE void _GlobalAVGPool2dElem_NCHW(
+    const int               i,
+    const int               HxW,
+    const float*            x,
+    float*                  y) {
+    const float* X = x + i * HxW;
+    float val = 0.f;
+    _Pragma("omp simd reduction(+:val)")
+    for (int j = 0; j < HxW; ++j) val += X[j];
+    y[i] = val / float(HxW);
+}
+
+CPU_ISA_INLINE void _GlobalAVGPool2dElem_NHWC(
+    const int               n,
+    const int               C,
+    const int               HxW,
+    const float*            x,
+    float*                  y) {
+    const float* X = x + n * HxW * C;
+    const float scale = 1.f / float(HxW);
+    float* Y = y + n * C;
+    _Pragma("omp simd")
+    for (int c = 0; c < C; ++c) Y[c] = 0.f;
+    for (int j = 0; j < HxW; ++j) {
+        const float* Xc = X + j * C;
+        _Pragma("omp simd")
+        for (int c = 0; c < C; ++c) Y[c] += Xc[c];
     }
+    _Pragma("omp simd")
+    for (int c = 0; c < C; ++c) Y[c] *= scale;
 }
 
+DEFINE_CPU_ISA_THREADED_LOOP(_AVGPool2dElem_NCHW,
+    (const int H, const int W, const int pool_h, const int pool_w,
+     const int kernel_h, const int kernel_w,
+     const int stride_h, const int stride_w,
+     const int pad_h, const int pad_w,
+     const float* x, float* y),
+    (H, W, pool_h, pool_w, kernel_h, kernel_w,
+     stride_h, stride_w, pad_h, pad_w, x, y));
+
+DEFINE_CPU_ISA_THREADED_LOOP(_AVGPool2dElem_NHWC,
+    (const int C, const int H, const int W,
+     const int pool_h, const int pool_w,
+     const int kernel_h, const int kernel_w,
+     const int stride_h, const int stride_w,
+     const int pad_h, const int pad_w,
+     const float* x, float* y),
+    (C, H, W, pool_h, pool_w, kernel_h, kernel_w,
+     stride_h, stride_w, pad_h, pad_w, x, y));
+
+DEFINE_CPU_ISA_THREADED_LOOP(_GlobalAVGPool2dElem_NCHW,
+    (const int HxW, const float* x, float* y), (HxW, x, y));
+
+DEFINE_CPU_ISA_THREADED_LOOP(_GlobalAVGPool2dElem_NHWC,
+    (const int C, const int HxW, const float* x, float* y),
+    (C, HxW, x, y));
+
 template<> void AVGPool2d<float, CPUContext>(
     const int               N,
     const int               C,
@@ -265,21 +590,56 @@ template<> void AVGPool2d<float, CPUContext>(
     const float*            x,
     float*                  y,
     CPUContext*             ctx) {
+    const int count = N * C * H * W;
     if (data_format == "NCHW") {
-        _AVGPool2d_NCHW<float>(
-            N, C, H, W, pool_h, pool_w, kernel_h, kernel_w,
-                stride_h, stride_w, pad_h, pad_w, x, y);
+        if (IS_GLOBAL_POOLING) {
+            DISPATCH_CPU_ISA(_GlobalAVGPool2dElem_NCHW,
+                N * C, count, H * W, x, y);
+        } else {
+            DISPATCH_CPU_ISA(_AVGPool2dElem_NCHW,
+                N * C, count, H, W, pool_h, pool_w,
+                    kernel_h, kernel_w, stride_h, stride_w,
+                        pad_h, pad_w, x, y);
+        }
     } else if (data_format == "NHWC") {
-        _AVGPool2d_NHWC<float>(
-            N, C, H, W, pool_h, pool_w, kernel_h, kernel_w,
-                stride_h, stride_w, pad_h, pad_w, x, y);
+        if (IS_GLOBAL_POOLING) {
+            DISPATCH_CPU_ISA(_GlobalAVGPool2dElem_NHWC,
+                N, count, C, H * W, x, y);
+        } else {
+            DISPATCH_CPU_ISA(_AVGPool2dElem_NHWC,
+                N * pool_h, count, C, H, W, pool_h, pool_w,
+                    kernel_h, kernel_w, stride_h, stride_w,
+                        pad_h, pad_w, x, y);
+        }
     } else LOG(FATAL) << "Unknown data format: " << data_format;
 }
 
 /*! MAXPool2dGrad <T = float32, Device = CPU> */
 
-template <typename T>
-void _MAXPool2dGrad_NCHW(
+CPU_ISA_INLINE void _MAXPool2dGradElem(
+    const int               i,
+    const int               x_dim,
+    const int               y_dim,
+    const float*            dy,
+    const int*              mask,
+    float*                  dx) {
+    // The mask indexes a plane (NCHW) or image (NHWC) of each task
+    const float* dY = dy + i * y_dim;
+    const int* M = mask + i * y_dim;
+    float* dX = dx + i * x_dim;
+    _Pragma("omp simd")
+    for (int j = 0; j < x_dim; ++j) dX[j] = 0.f;
+    // Skip the windows falling into the padding
+    for (int j = 0; j < y_dim; ++j)
+        if (M[j] >= 0) dX[M[j]] += dY[j];
+}
+
+DEFINE_CPU_ISA_THREADED_LOOP(_MAXPool2dGradElem,
+    (const int x_dim, const int y_dim,
+     const float* dy, const int* mask, float* dx),
+    (x_dim, y_dim, dy, mask, dx));
+
+template<> void MAXPool2dGrad<float, CPUContext>(
     const int               N,
     const int               C,
     const int               H,
@@ -292,37 +652,26 @@ void _MAXPool2dGrad_NCHW(
     const int               stride_w,
     const int               pad_h,
     const int               pad_w,
+    const string&           data_format,
     const float*            dy,
     const int*              mask,
     float*                  dx,
     CPUContext*             ctx) {
-    const int64_t x_offset = H * W, y_offset = pool_h * pool_w;
-    const int64_t X_offset = C * x_offset, Y_offset = C * y_offset;
-    math::Set<float, CPUContext>(N * C * H * W, 0, dx, ctx);
-
-    for (int n = 0; n < N; ++n) {
-        auto* dY = dy + n * Y_offset;
-        auto* dX = dx + n * X_offset;
-        auto* M = mask + n * Y_offset;
-        for (int c = 0; c < C; ++c) {
-            for (int ph = 0; ph < pool_h; ++ph) {
-                for (int pw = 0; pw < pool_w; ++pw) {
-                    const int pool_idx = ph * pool_w + pw;
-                    const int idx = M[pool_idx];
-                    dX[idx] += dY[pool_idx];
-                }
-            }
-            dX += x_offset;
-            dY += y_offset;
-            M += y_offset;
-        }
-    }
+    const int count = N * C * H * W;
+    if (data_format == "NCHW") {
+        DISPATCH_CPU_ISA(_MAXPool2dGradElem, N * C, count,
+            H * W, pool_h * pool_w, dy, mask, dx);
+    } else if (data_format == "NHWC") {
+        DISPATCH_CPU_ISA(_MAXPool2dGradElem, N, count,
+            H * W * C, pool_h * pool_w * C, dy, mask, dx);
+    } else LOG(FATAL) << "Unknown data format: " << data_format;
 }
 
-template <typename T>
-void _MAXPool2dGrad_NHWC(
-    const int               N,
-    const int               C,
+/*! AVGPool2dGrad <T = float32, Device = CPU> */
+
+template <int SS>
+CPU_ISA_INLINE void _AVGPool2dGradPlane_NCHW(
+    const int               i,
     const int               H,
     const int               W,
     const int               pool_h,
@@ -334,35 +683,39 @@ void _MAXPool2dGrad_NHWC(
     const int               pad_h,
     const int               pad_w,
     const float*            dy,
-    const int*              mask,
-    float*                  dx,
-    CPUContext*             ctx) {
-    const int64_t X_offset = H * W * C,
-        Y_offset = pool_h * pool_w * C;
-    math::Set<float, CPUContext>(N * H * W * C, 0, dx, ctx);
-
-    for (int n = 0; n < N; ++n) {
-        auto* dY = dy + n * X_offset;
-        auto* dX = dx + n * Y_offset;
-        auto* M = mask + n * Y_offset;
-        for (int ph = 0; ph < pool_h; ph++) {
-            for (int pw = 0; pw < pool_w; ++pw) {
-                const int base_pool_idx = ph * pool_w + pw;
-                for (int c = 0; c < C; ++c) {
-                    const int pool_idx = base_pool_idx * C + c;
-                    const int idx = M[pool_idx];
-                    dX[idx] += dY[pool_idx];
-                }
-            }
+    float*                  dx) {
+    const int SW = SS < 0 ? stride_w : SS;
+    float* dX = dx + i * H * W;
+    _Pragma("omp simd")
+    for (int j = 0; j < H * W; ++j) dX[j] = 0.f;
+    vector<float> dY(pool_w);
+    for (int ph = 0; ph < pool_h; ++ph) {
+        const int start_h = ph * stride_h - pad_h;
+        const int kh_lo = std::max(0, -start_h);
+        const int kh_hi = std::min(kernel_h, H - start_h);
+        const int area_h = _PoolArea(start_h, H, kernel_h, pad_h);
+        const float* dYr = dy + (i * pool_h + ph) * pool_w;
+        for (int pw = 0; pw < pool_w; ++pw) {
+            const int start_w = pw * SW - pad_w;
+            dY[pw] = dYr[pw] / float(area_h *
+                _PoolArea(start_w, W, kernel_w, pad_w));
         }
-        dX += X_offset;
-        dY += Y_offset;
-    }
+        for (int kh = kh_lo; kh < kh_hi; ++kh) {
+            const int x_start = (start_h + kh) * W - pad_w;
+            for (int kw = 0; kw < kernel_w; ++kw) {
+                int lo, hi;
+                _PoolRange(W, pool_w, SW, pad_w, kw, &lo, &hi);
+                // Each output scatters to a distinct input
+                _Pragma("omp simd")
+                for (int pw = lo; pw < hi; ++pw)
+                    dX[x_start + pw * SW + kw] += dY[pw];
+            }  // End kw
+        }  // End kh
+    }  // End ph
 }
 
-template<> void MAXPool2dGrad<float, CPUContext>(
-    const int               N,
-    const int               C,
+CPU_ISA_INLINE void _AVGPool2dGradElem_NCHW(
+    const int               i,
     const int               H,
     const int               W,
     const int               pool_h,
@@ -373,27 +726,15 @@ template<> void MAXPool2dGrad<float, CPUContext>(
     const int               stride_w,
     const int               pad_h,
     const int               pad_w,
-    const string&           data_format,
     const float*            dy,
-    const int*              mask,
-    float*                  dx,
-    CPUContext*             ctx) {
-    if (data_format == "NCHW") {
-        _MAXPool2dGrad_NCHW<float>(
-            N, C, H, W, pool_h, pool_w, kernel_h, kernel_w,
-                stride_h, stride_w, pad_h, pad_w, dy, mask, dx, ctx);
-    } else if (data_format == "NHWC") {
-        _MAXPool2dGrad_NHWC<float>(
-            N, C, H, W, pool_h, pool_w, kernel_h, kernel_w,
-                stride_h, stride_w, pad_h, pad_w, dy, mask, dx, ctx);
-    } else LOG(FATAL) << "Unknown data format: " << data_format;
+    float*                  dx) {
+    POOL2D_SPECIALIZE(_AVGPool2dGradPlane_NCHW, i, H, W, pool_h, pool_w,
+        kernel_h, kernel_w, stride_h, stride_w,
+            pad_h, pad_w, dy, dx);
 }
 
-/*! AVGPool2dGrad <T = float32, Device = CPU> */
-
-template <typename T>
-void _AVGPool2dGrad_NCHW(
-    const int               N,
+CPU_ISA_INLINE void _AVGPool2dGradElem_NHWC(
+    const int               i,
     const int               C,
     const int               H,
     const int               W,
@@ -406,92 +747,82 @@ void _AVGPool2dGrad_NCHW(
     const int               pad_h,
     const int               pad_w,
     const float*            dy,
-    float*                  dx,
-    CPUContext*             ctx) {
-    const int64_t x_offset = H * W, y_offset = pool_h * pool_w;
-    const int64_t X_offset = C * x_offset, Y_offset = C * y_offset;
-    math::Set<float, CPUContext>(N * C * H * W, 0, dx, ctx);
-
-    for (int n = 0; n < N; ++n) {
-        auto* dY = dy + n * Y_offset;
-        auto* dX = dx + n * X_offset;
-        for (int c = 0; c < C; ++c) {
-            for (int ph = 0; ph < pool_h; ++ph) {
-                for (int pw = 0; pw < pool_w; ++pw) {
-                    int start_h = ph * stride_h - pad_h;
-                    int start_w = pw * stride_w - pad_w;
-                    int end_h = std::min(start_h + kernel_h, H + pad_h);
-                    int end_w = std::min(start_w + kernel_w, W + pad_w);
-                    int pool_area = (end_h - start_h) * (end_w - start_w);
-                    end_h = std::min(end_h, H);
-                    end_w = std::min(end_w, W);
-                    start_h = std::max(start_h, 0);
-                    start_w = std::max(start_w, 0);
-                    const int pool_idx = ph * pool_w + pw;
-                    for (int h = start_h; h < end_h; ++h) {
-                        for (int w = start_w; w < end_w; ++w) {
-                            const int idx = h * W + w;
-                            dX[idx] += (dY[pool_idx] / pool_area);
-                        }
-                    }
-                }
-            } 
-            dX += x_offset;
-            dY += y_offset;
-        }
-    }
+    float*                  dx) {
+    // Gather the outputs of each input to avoid the conflicts
+    const int n = i / H, h = i % H;
+    int ph_lo, ph_hi, pw_lo, pw_hi;
+    _PoolCover(h, pool_h, kernel_h, stride_h, pad_h, &ph_lo, &ph_hi);
+    for (int w = 0; w < W; ++w) {
+        float* dX = dx + (i * W + w) * C;
+        _Pragma("omp simd")
+        for (int c = 0; c < C; ++c) dX[c] = 0.f;
+        _PoolCover(w, pool_w, kernel_w, stride_w, pad_w, &pw_lo, &pw_hi);
+        for (int ph = ph_lo; ph < ph_hi; ++ph) {
+            const int area_h = _PoolArea(
+                ph * stride_h - pad_h, H, kernel_h, pad_h);
+            for (int pw = pw_lo; pw < pw_hi; ++pw) {
+                const float scale = 1.f / float(area_h * _PoolArea(
+                    pw * stride_w - pad_w, W, kernel_w, pad_w));
+                const float* dY = dy + ((n * pool_h + ph) * pool_w + pw) * C;
+                _Pragma("omp simd")
+                for (int c = 0; c < C; ++c) dX[c] += dY[c] * scale;
+            }  // End pw
+        }  // End ph
+    }  // End w
 }
 
-template <typename T>
-void _AVGPool2dGrad_NHWC(
-    const int               N,
+CPU_ISA_INLINE void _GlobalAVGPool2dGradElem_NCHW(
+    const int               i,
+    const int               HxW,
+    const float*            dy,
+    float*                  dx) {
+    const float val = dy[i] / float(HxW);
+    float* dX = dx + i * HxW;
+    _Pragma("omp simd")
+    for (int j = 0; j < HxW; ++j) dX[j] = val;
+}
+
+CPU_ISA_INLINE void _GlobalAVGPool2dGradElem_NHWC(
+    const int               n,
     const int               C,
-    const int               H,
-    const int               W,
-    const int               pool_h,
-    const int               pool_w,
-    const int               kernel_h,
-    const int               kernel_w,
-    const int               stride_h,
-    const int               stride_w,
-    const int               pad_h,
-    const int               pad_w,
+    const int               HxW,
     const float*            dy,
-    float*                  dx,
-    CPUContext*             ctx) {
-    const int64_t X_offset = H * W * C,
-        Y_offset = pool_h * pool_w * C;
-    math::Set<float, CPUContext>(N * H * W * C, 0, dx, ctx);
-
-    for (int n = 0; n < N; ++n) {
-        auto* dY = dy + n * X_offset;
-        auto* dX = dx + n * Y_offset;
-        for (int ph = 0; ph < pool_h; ph++) {
-            for (int pw = 0; pw < pool_w; ++pw) {
-                int start_h = ph * stride_h - pad_h;
-                int start_w = pw * stride_w - pad_w;
-                int end_h = std::min(start_h + kernel_h, H + pad_h);
-                int end_w = std::min(start_w + kernel_w, W + pad_w);
-                int pool_area = (end_h - start_h) * (end_w - start_w);
-                end_h = std::min(end_h, H);
-                end_w = std::min(end_w, W);
-                start_h = std::max(start_h, 0);
-                start_w = std::max(start_w, 0);
-                const int base_pool_idx = ph * pool_w + pw;
-                for (int c = 0; c < C; ++c) {
-                    const int pool_idx = base_pool_idx * C + c;
-                    for (int h = start_h; h < end_h; ++h)
-                        for (int w = start_w; w < end_w; ++w)
-                            dX[(h * W + w) * C + c] +=
-                                (dY[pool_idx] / pool_area);
-                }
-            }
-        }
-        dX += X_offset;
-        dY += Y_offset;
+    float*                  dx) {
+    const float scale = 1.f / float(HxW);
+    const float* dY = dy + n * C;
+    for (int j = 0; j < HxW; ++j) {
+        float* dX = dx + (n * HxW + j) * C;
+        _Pragma("omp simd")
+        for (int c = 0; c < C; ++c) dX[c] = dY[c] * scale;
     }
 }
 
+DEFINE_CPU_ISA_THREADED_LOOP(_AVGPool2dGradElem_NCHW,
+    (const int H, const int W, const int pool_h, const int pool_w,
+     const int kernel_h, const int kernel_w,
+     const int stride_h, const int stride_w,
+     const int pad_h, const int pad_w,
+     const float* dy, float* dx),
+    (H, W, pool_h, pool_w, kernel_h, kernel_w,
+     stride_h, stride_w, pad_h, pad_w, dy, dx));
+
+DEFINE_CPU_ISA_THREADED_LOOP(_AVGPool2dGradElem_NHWC,
+    (const int C, const int H, const int W,
+     const int pool_h, const int pool_w,
+     const int kernel_h, const int kernel_w,
+     const int stride_h, const int stride_w,
+     const int pad_h, const int pad_w,
+     const float* dy, float* dx),
+    (C, H, W, pool_h, pool_w, kernel_h, kernel_w,
+     stride_h, stride_w, pad_h, pad_w, dy, dx));
+
+DEFINE_CPU_ISA_THREADED_LOOP(_GlobalAVGPool2dGradElem_NCHW,
+    (const int HxW, const float* dy, float* dx), (HxW, dy, dx));
+
+DEFINE_CPU_ISA_THREADED_LOOP(_GlobalAVGPool2dGradElem_NHWC,
+    (const int C, const int HxW, const float* dy, float* dx),
+    (C, HxW, dy, dx));
+
 template<> void AVGPool2dGrad<float, CPUContext>(
     const int               N,
     const int               C,
@@ -509,17 +840,33 @@ template<> void AVGPool2dGrad<float, CPUContext>(
     const float*            dy,
     float*                  dx,
     CPUContext*             ctx) {
+    const int count = N * C * H * W;
     if (data_format == "NCHW") {
-        _AVGPool2dGrad_NCHW<float>(
-            N, C, H, W, pool_h, pool_w, kernel_h, kernel_w,
-                stride_h, stride_w, pad_h, pad_w, dy, dx, ctx);
+        if (IS_GLOBAL_POOLING) {
+            DISPATCH_CPU_ISA(_GlobalAVGPool2dGradElem_NCHW,
+                N * C, count, H * W, dy, dx);
+        } else {
+            DISPATCH_CPU_ISA(_AVGPool2dGradElem_NCHW,
+                N * C, count, H, W, pool_h, pool_w,
+                    kernel_h, kernel_w, stride_h, stride_w,
+                        pad_h, pad_w, dy, dx);
+        }
     } else if (data_format == "NHWC") {
-        _AVGPool2dGrad_NHWC<float>(
-            N, C, H, W, pool_h, pool_w, kernel_h, kernel_w,
-                stride_h, stride_w, pad_h, pad_w, dy, dx, ctx);
+        if (IS_GLOBAL_POOLING) {
+            DISPATCH_CPU_ISA(_GlobalAVGPool2dGradElem_NHWC,
+                N, count, C, H * W, dy, dx);
+        } else {
+            DISPATCH_CPU_ISA(_AVGPool2dGradElem_NHWC,
+                N * H, count, C, H, W, pool_h, pool_w,
+                    kernel_h, kernel_w, stride_h, stride_w,
+                        pad_h, pad_w, dy, dx);
+        }
     } else LOG(FATAL) << "Unknown data format: " << data_format;
 }
 
+#undef IS_GLOBAL_POOLING
+#undef POOL2D_SPECIALIZE
+
 }  // namespace kernel
 
-}  // namepsace dragon
\ No newline at end of file
+}  // namepsace dragon
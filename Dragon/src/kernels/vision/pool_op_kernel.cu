@@ -53,7 +53,7 @@ __global__ void _MAXPool2d_NCHW(
             }
         }
         y[y_idx] = max_val;
-        mask[y_idx] = max_idx;
+        if (mask != nullptr) mask[y_idx] = max_idx;
     }
 }
 
@@ -100,7 +100,7 @@ __global__ void _MAXPool2d_NHWC(
             }
         }
         y[y_idx] = max_val;
-        mask[y_idx] = max_idx;
+        if (mask != nullptr) mask[y_idx] = max_idx;
     }
 }
 
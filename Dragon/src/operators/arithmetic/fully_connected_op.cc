@@ -27,11 +27,20 @@ void FullyConnectedOp<Context>::TransRunWithType() {
     auto* Wdata = Input(1).template data<T, Context>();
     auto* Ydata = Output(0)->template mutable_data<T, Context>();
 
-    math::Gemm(
-        CblasNoTrans, CblasTrans,
-            M, N, K,
-                1.f, Xdata, Wdata,
-                    0.f, Ydata, ctx());
+    if (PackWeights<T>()) {
+        auto* Pdata = W_cache.Get<T>(Input(1), CblasBMatrix,
+            CblasTrans, M, N, K, ws()->CreateTensor(
+                mount_name("fully_connected/packed_weights")), ctx());
+        math::GemmPacked(
+            CblasBMatrix, CblasNoTrans, CblasTrans,
+                M, N, K, Xdata, Pdata, 0.f, Ydata, ctx());
+    } else {
+        math::Gemm(
+            CblasNoTrans, CblasTrans,
+                M, N, K,
+                    1.f, Xdata, Wdata,
+                        0.f, Ydata, ctx());
+    }
 
     if (InputSize() > 2) {
         DECLARE_MULTIPLIER(multiplier, M);
@@ -60,11 +69,20 @@ void FullyConnectedOp<Context>::NoTransRunWithType() {
     auto* Wdata = Input(1).template data<T, Context>();
     auto* Ydata = Output(0)->template mutable_data<T, Context>();
 
-    math::Gemm(
-        CblasNoTrans, CblasNoTrans,
-            M, N, K,
-                1.f, Xdata, Wdata,
-                    0.f, Ydata, ctx());
+    if (PackWeights<T>()) {
+        auto* Pdata = W_cache.Get<T>(Input(1), CblasBMatrix,
+            CblasNoTrans, M, N, K, ws()->CreateTensor(
+                mount_name("fully_connected/packed_weights")), ctx());
+        math::GemmPacked(
+            CblasBMatrix, CblasNoTrans, CblasNoTrans,
+                M, N, K, Xdata, Pdata, 0.f, Ydata, ctx());
+    } else {
+        math::Gemm(
+            CblasNoTrans, CblasNoTrans,
+                M, N, K,
+                    1.f, Xdata, Wdata,
+                        0.f, Ydata, ctx());
+    }
 
     if (InputSize() > 2) {
         DECLARE_MULTIPLIER(multiplier, M);
@@ -9,14 +9,12 @@ void MatmulOp<Context>::RunWithType() {
     auto* Bdata = Input(1).template data<T, Context>();
     auto* Cdata = Output(0)->template mutable_data<T, Context>();
 
-    for (int i = 0; i < batch_size; ++i) {
-        math::Gemm(
-            transA ? CblasTrans : CblasNoTrans,
-            transB ? CblasTrans : CblasNoTrans,
-            M, N, K1,
-            1.f, Adata + i * A_stride, Bdata + i * B_stride,
-            0.f, Cdata + i * C_stride, ctx());
-    }
+    math::GemmStridedBatched(
+        transA ? CblasTrans : CblasNoTrans,
+        transB ? CblasTrans : CblasNoTrans,
+        batch_size, M, N, K1,
+        1.f, Adata, A_stride, Bdata, B_stride,
+        0.f, Cdata, C_stride, ctx());
 }
 
 template <class Context>
@@ -76,40 +74,38 @@ void MatmulGradientOp<Context>::RunWithType() {
         dBdata = Output(1)->template mutable_data<T, Context>();
     }
 
-    for (int i = 0; i < batch_size; ++i) {
-        if (Output(0)->name() != "NULL") {
-            if (transA) {
-                math::Gemm(
-                    transB ? CblasTrans : CblasNoTrans,
-                    CblasTrans,
-                    K1, M, N,
-                    1.f, Bdata + i * B_stride, dCdata + i * C_stride,
-                    0.f, dAdata + i * A_stride, ctx());
-            } else {
-                math::Gemm(
-                    CblasNoTrans,
-                    transB ? CblasNoTrans : CblasTrans,
-                    M, K1, N,
-                    1.f, dCdata + i * C_stride, Bdata + i * B_stride,
-                    0.f, dAdata + i * A_stride, ctx());
-            }
+    if (Output(0)->name() != "NULL") {
+        if (transA) {
+            math::GemmStridedBatched(
+                transB ? CblasTrans : CblasNoTrans,
+                CblasTrans,
+                batch_size, K1, M, N,
+                1.f, Bdata, B_stride, dCdata, C_stride,
+                0.f, dAdata, A_stride, ctx());
+        } else {
+            math::GemmStridedBatched(
+                CblasNoTrans,
+                transB ? CblasNoTrans : CblasTrans,
+                batch_size, M, K1, N,
+                1.f, dCdata, C_stride, Bdata, B_stride,
+                0.f, dAdata, A_stride, ctx());
         }
-        if (Output(1)->name() != "NULL") {
-            if (transB) {
-                math::Gemm(
-                    CblasTrans,
-                    transA ? CblasTrans : CblasNoTrans,
-                    N, K1, M,
-                    1.f, dCdata + i * C_stride, Adata + i * A_stride,
-                    0.f, dBdata + i * B_stride, ctx());
-            } else {
-                math::Gemm(
-                    transA ? CblasNoTrans : CblasTrans,
-                    CblasNoTrans,
-                    K1, N, M,
-                    1.f, Adata + i * A_stride, dCdata + i * C_stride,
-                    0.f, dBdata + i * B_stride, ctx());
-            }
+    }
+    if (Output(1)->name() != "NULL") {
+        if (transB) {
+            math::GemmStridedBatched(
+                CblasTrans,
+                transA ? CblasTrans : CblasNoTrans,
+                batch_size, N, K1, M,
+                1.f, dCdata, C_stride, Adata, A_stride,
+                0.f, dBdata, B_stride, ctx());
+        } else {
+            math::GemmStridedBatched(
+                transA ? CblasNoTrans : CblasTrans,
+                CblasNoTrans,
+                batch_size, K1, N, M,
+                1.f, Adata, A_stride, dCdata, C_stride,
+                0.f, dBdata, B_stride, ctx());
         }
     }
 }
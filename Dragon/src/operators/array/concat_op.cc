@@ -13,13 +13,37 @@ namespace dragon {
 
 template <class Context> template <typename T>
 void ConcatOp<Context>::RunWithType() {
+    // Inputs could be written into the output directly,
+    // only if each of them is a contiguous slice
+    bool use_views = zero_copy && outer_dim == 1;
+
+    if (use_views) {
+        bool bound = true;
+        concat_offset = 0;
+        for (int i = 0; i < InputSize(); i++) {
+            bound &= Input(i).IsViewOf(*Output(0)) &&
+                Input(i).offset() == concat_offset * inner_dim
+                    * sizeof(T) && XIsType(Input(i), T);
+            concat_offset += Input(i).dim(axis);
+        }
+        // Producers have written into the slices, nothing to do
+        if (bound && Output(0)->template IsType<T>()) return;
+        // Detach the stale views before overwriting the output
+        for (int i = 0; i < InputSize(); i++) {
+            if (Input(i).IsViewOf(*Output(0))) {
+                Output(0)->Reset();
+                Output(0)->Reshape(concat_dims);
+                break;
+            }
+        }
+    }
+
     auto* Ydata = Output(0)->template mutable_data<T, Context>();
 
     concat_offset = 0;
 
     for (int i = 0; i < InputSize(); i++) {
         auto* Xdata = Input(i).template data<T, Context>();
-        int64_t count = Input(i).count();
         x_concat_dim = Input(i).dim(axis);
 
         kernel::Concat(
@@ -27,6 +51,10 @@ void ConcatOp<Context>::RunWithType() {
                 x_concat_dim, y_concat_dim,
                     concat_offset, Xdata, Ydata, ctx());
 
+        // Let the producer write into the output next time
+        if (use_views) Input(i).ShareView(*Output(0),
+            concat_offset * inner_dim * sizeof(T));
+
         concat_offset += x_concat_dim;
     }
 }
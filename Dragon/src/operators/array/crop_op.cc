@@ -125,6 +125,23 @@ template <class Context>
 void CropOp<Context>::RunOnDevice() {
     Setup();
 
+    if (zero_copy && Input(0).is_viewable()) {
+        // Narrow the view with the starts
+        size_t offset = 0;
+        vector<int64_t> y_dims, y_strides;
+        for (int i = 0; i < st.size(); i++) {
+            offset += st[i] * Input(0).stride(i);
+            if (!keep_dims[i]) continue;
+            y_dims.push_back(y_dimsV[i]);
+            y_strides.push_back(Input(0).stride(i));
+        }
+        Output(0)->ShareView(Input(0), Input(0).offset() +
+            offset * Input(0).meta().itemsize(),
+                y_dims, y_strides); return;
+    } else if (!Input(0).is_contiguous()) {
+        this->Contiguous(&Input(0));
+    }
+
     // Just copy the contents
     if (Input(0).dims() == y_dimsV) {
         Output(0)->template CopyFrom<Context>(
@@ -16,9 +16,7 @@ void ExpandDimsOp<Context>::RunOnDevice() {
     vector<int64_t> dims = Input(0).dims();
     dims.insert(dims.begin() + axis, 1);
 
-    Output(0)->Reshape(dims);
-    Output(0)->SetMeta(Input(0).meta());
-    Output(0)->Share(Input(0).memory());
+    this->ShareInput(dims);
 }
 
 DEPLOY_CPU(ExpandDims);
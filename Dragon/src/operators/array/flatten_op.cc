@@ -36,9 +36,7 @@ void FlattenOp<Context>::RunOnDevice() {
                 output_dims.push_back(Input(0).dim(i));
         }
     }
-    Output(0)->Reshape(output_dims);
-    Output(0)->SetMeta(Input(0).meta());
-    Output(0)->Share(Input(0).memory());
+    this->ShareInput(output_dims);
 }
 
 DEPLOY_CPU(Flatten);
@@ -44,15 +44,16 @@ void ReduceOp<Context>::RunWithType() {
     auto* Xdata = Input(0).template data<T, Context>();
     auto* Ydata = Output(0)->template mutable_data<T, Context>();
 
-    auto scale = operation == "SUM" ? 1.f : 1.f /
-        (Input(0).count() / Output(0)->count());
+    auto scale = operation == "MEAN" ? 1.f /
+        (Input(0).count() / Output(0)->count()) : 1.f;
 
-    if (Input(0).count() == 1) {
+    if (Input(0).count() == 1 &&
+            operation != "L1" && operation != "L2") {
         // Just copy the contents
         ctx()->template Copy<T, Context, Context>(
             Output(0)->count(), Ydata, Xdata);
     } else {
-        kernel::ReduceSum(
+        kernel::Reduce(operation,
             (int)dims32.size(), dims32.data(),
                 (int)axes32.size(), axes32.data(),
                     scale, Xdata, Ydata, ctx());
@@ -108,14 +109,16 @@ void ReduceGradientOp<Context>::RunWithType() {
     auto* dYdata = Input(-1).template data<T, Context>();
     auto* dXdata = Output(0)->template mutable_data<T, Context>();
 
-    auto scale = operation == "SUM" ? 1.f : 1.f /
-        (Input(0).count() / Input(-1).count());
+    auto scale = operation == "MEAN" ? 1.f /
+        (Input(0).count() / Input(-1).count()) : 1.f;
 
-    if (Input(0).count() == 1) {
+    const bool is_linear = operation == "SUM" || operation == "MEAN";
+
+    if (is_linear && Input(0).count() == 1) {
         // Just copy the contents
         ctx()->template Copy<T, Context, Context>(
             Output(0)->count(), dXdata, dYdata);
-    } else if (Input(-1).count() == 1) {
+    } else if (is_linear && Input(-1).count() == 1) {
         // Directly set the dX from a constant Scalar
         T dYHost = Input(-1).template data<T, CPUContext>()[0];
         dYHost = cast::to<T>(cast::to<float>(dYHost) * scale);
@@ -136,9 +139,19 @@ void ReduceGradientOp<Context>::RunWithType() {
         auto* YDS = y_dimsT.template data<int, Context>();
         auto* YSS = y_stridesT.template data<int, Context>();
 
-        // Apply a simple Nd-Broadcast solution
-        kernel::ReduceSumGrad(Output(0)->count(), Output(0)->ndim(),
-            XDS, YDS, YSS, scale, dYdata, dXdata, ctx());
+        if (is_linear) {
+            // Apply a simple Nd-Broadcast solution
+            kernel::ReduceSumGrad(Output(0)->count(), Output(0)->ndim(),
+                XDS, YDS, YSS, scale, dYdata, dXdata, ctx());
+        } else {
+            // The nonlinear reductions broadcast both the y and dy
+            auto* Xdata = Input(0).template data<T, Context>();
+            auto* Ydata = Input(1).template data<T, Context>();
+            kernel::ReduceGrad(operation,
+                Output(0)->count(), Output(0)->ndim(),
+                    XDS, YDS, YSS, scale, Xdata, Ydata,
+                        dYdata, dXdata, ctx());
+        }
     }
 }
 
@@ -163,8 +176,22 @@ DEPLOY_CUDA(ReduceGradient);
 #endif
 
 OPERATOR_SCHEMA(ReduceGradient)
-    .NumInputs(2).NumOutputs(1);
+    .NumInputs(2, 3).NumOutputs(1);
+
+class GetReduceGradient final : public GradientMakerBase {
+ public:
+    GRADIENT_MAKER_CTOR(GetReduceGradient);
+    vector<OperatorDef> MakeDefs() override {
+        vector<string> inputs({ I(0), GO(0) });
+        // The nonlinear reductions are backward with the output
+        for (const auto& arg : def.arg())
+            if (arg.name() == "operation" && arg.s() != "SUM" &&
+                    arg.s() != "MEAN") inputs.insert(inputs.begin() + 1, O(0));
+        return SingleDef(def.type() + "Gradient", "", inputs,
+            vector<string>({ GI(0) }));
+    }
+};
 
-REGISTER_GRADIENT(Reduce, SimpleGradientMaker);
+REGISTER_GRADIENT(Reduce, GetReduceGradient);
 
 }  // namespace dragon
\ No newline at end of file
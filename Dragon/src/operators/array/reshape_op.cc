@@ -59,9 +59,7 @@ void ReshapeOp<Context>::RunOnDevice() {
         << "\nCan not change the total size."
         << Input(0).DimString()
         << " -> " << Tensor::DimString(new_shape);
-    Output(0)->Reshape(new_shape);
-    Output(0)->SetMeta(Input(0).meta());
-    Output(0)->Share(Input(0).memory());
+    this->ShareInput(new_shape);
 }
 
 DEPLOY_CPU(Reshape);
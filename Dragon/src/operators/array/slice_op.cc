@@ -18,7 +18,11 @@ namespace dragon {
 
 template <class Context> template <typename T>
 void SliceOp<Context>::RunWithType() {
-    auto* Xdata = Input(0).template data<T, Context>();
+    const T* Xdata = nullptr;
+    if (!zero_copy || !Input(0).is_viewable()) {
+        if (!Input(0).is_contiguous()) this->Contiguous(&Input(0));
+        Xdata = Input(0).template data<T, Context>();
+    }
 
     for (int i = 0; i < N; i++) {
         if (!slice_points.empty()) {
@@ -31,6 +35,15 @@ void SliceOp<Context>::RunWithType() {
             << " for dimension " << Input(0).dim(axis) << ".";
 
         slice_dims[axis] = y_slice_dim;
+
+        if (zero_copy && Input(0).is_viewable()) {
+            // Offset the view along the slice axis
+            Output(i)->ShareView(Input(0), Input(0).offset() +
+                slice_offset * Input(0).stride(axis) * sizeof(T),
+                    slice_dims, Input(0).strides());
+            slice_offset += y_slice_dim; continue;
+        }
+
         Output(i)->Reshape(slice_dims);
 
         auto* Ydata = Output(i)->template mutable_data<T, Context>();
@@ -24,9 +24,7 @@ void SqueezeOp<Context>::RunOnDevice() {
         }
     }
 
-    Output(0)->Reshape(dims);
-    Output(0)->SetMeta(Input(0).meta());
-    Output(0)->Share(Input(0).memory());
+    this->ShareInput(dims);
 }
 
 DEPLOY_CPU(Squeeze);
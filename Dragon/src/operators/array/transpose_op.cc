@@ -32,6 +32,19 @@ void TransposeOp<Context>::RunOnDevice() {
         << "but Tensor(" << Input(0).name() << ")'s dims are "
         << Input(0).DimString();
 
+    if (zero_copy && Input(0).is_viewable()) {
+        // Permute the strides without moving the elements
+        vector<int64_t> output_dims, output_strides;
+        for (int i = 0; i < given_num_axes; i++) {
+            output_dims.push_back(Input(0).dim(perm(i)));
+            output_strides.push_back(Input(0).stride(perm(i)));
+        }
+        Output(0)->ShareView(Input(0), Input(0).offset(),
+            output_dims, output_strides); return;
+    } else if (!Input(0).is_contiguous()) {
+        this->Contiguous(&Input(0));
+    }
+
     x_strides.Reshape({ given_num_axes });
     y_dims.Reshape({ given_num_axes });
 
@@ -52,6 +52,40 @@ void ScanOp<Context>::InitTemplate() {
         if (default_outputs[i].empty()) continue;
         terms[default_outputs[i]] = func_def.output(i) + "@1";
     }
+    template_terms = terms;
+    InitStepTemplate();
+}
+
+template <class Context>
+void ScanOp<Context>::InitStepTemplate() {
+    // The step template runs one step of the function,
+    // reading the "@step" slices and the "@prev" states
+    Map<string, string> step_terms;
+    for (int i = 0; i < nseqs; i++)
+        step_terms[Input(i).name()] = Input(i).name() + "@step";
+    for (int i = 0; i < nout; i++) {
+        if (default_outputs[i].empty()) continue;
+        step_terms[default_outputs[i]] = func_def.output(i) + "@prev";
+    }
+    step_def.mutable_device_option()
+        ->CopyFrom(def().device_option());
+    for (int i = 0; i < nrepeats; i++) {
+        OperatorDef* op = step_def.add_op();
+        op->CopyFrom(func_def.op(i));
+        op->set_name(name() + "(BodyOp." +
+            std::to_string(i + nseqs) + ")@step");
+        for (int j = 0; j < op->input_size(); j++) {
+            string* input = op->mutable_input(j);
+            if (step_terms.count(*input)) *input = step_terms[*input];
+        }
+        for (int j = 0; j < op->output_size(); j++) {
+            string* output = op->mutable_output(j);
+            step_terms[*output] = *output + "@step";
+            *output = step_terms[*output];
+        }
+    }
+    for (int i = 0; i < nout; i++)
+        step_def.add_output(func_def.output(i) + "@step");
 }
 
 template <class Context>
@@ -75,7 +109,7 @@ void ScanOp<Context>::UpdateTerms(int cur_step) {
 }
 
 template <class Context>
-void ScanOp<Context>::UnrollTemplate() {
+void ScanOp<Context>::DetermineSteps() {
     if (step_type == "Dynamic") {
         CHECK(!step_tensor.empty())
             << "Dynamic nsteps must provide a step tensor.";
@@ -85,8 +119,13 @@ void ScanOp<Context>::UnrollTemplate() {
     CHECK_GE(nsteps, 1);
     for (int i = 0; i < nseqs; i++)
         CHECK_EQ(Input(i).dim(axis), nsteps);
-    if (graphs.count(nsteps)) return;
+}
 
+template <class Context>
+void ScanOp<Context>::UnrollTemplate() {
+    if (unrolled_defs.count(nsteps)) return;
+
+    terms = template_terms;
     new_def.CopyFrom(template_def);
     new_def.set_name(name() + "(ScanLen." + std::to_string(nsteps) + ")");
     Argument phase; phase.set_name("phase");
@@ -147,19 +186,92 @@ void ScanOp<Context>::UnrollTemplate() {
         // Solve all the all steps
         new_def.add_output(Output(i)->name());
     }
-    // Upload
-    auto* ops_tensor = ws()->CreateTensor(
-        mount_name("raw_ops"))->Reshape({ 1 });
-    auto* data = ops_tensor->template mutable_data<string, CPUContext>();
-    data[0] = new_def.SerializeAsString();
+    unrolled_defs[nsteps] = new_def.SerializeAsString();
+}
+
+template <class Context>
+void ScanOp<Context>::RunSteps() {
+    if (!step_graph) {
+        for (int i = 0; i < nseqs; i++)
+            ws()->CreateTensor(Input(i).name() + "@step");
+        for (int i = 0; i < nout; i++) {
+            if (default_outputs[i].empty()) continue;
+            ws()->CreateTensor(func_def.output(i) + "@prev");
+        }
+        step_def.set_name(name() + "(ScanStep)");
+        Argument phase; phase.set_name("phase");
+        phase.set_s(this->phase()); step_def.add_arg()->CopyFrom(phase);
+        step_graph.reset(new Graph(step_def, ws()));
+    }
+
+    // Copy the slice or slot along the axis
+    auto CopyStep = [this](
+        const Tensor&       src,
+        Tensor*             dst,
+        int64_t             t,
+        bool                to_slot) {
+        const Tensor& seq = to_slot ? *dst : src;
+        const Tensor& step = to_slot ? src : *dst;
+        const int64_t outer_dim = seq.count(0, axis);
+        const size_t inner_bytes =
+            step.count(axis) * src.meta().itemsize();
+        auto* x = (const uint8_t*)src.template raw_data<Context>();
+        auto* y = (uint8_t*)dst->template
+            raw_mutable_data<Context>(src.meta());
+        for (int64_t i = 0; i < outer_dim; i++) {
+            const size_t seq_offset = (i * nsteps + t) * inner_bytes;
+            const size_t step_offset = i * inner_bytes;
+            ctx()->template MemcpyAsync<Context, Context>(inner_bytes,
+                y + (to_slot ? seq_offset : step_offset),
+                    x + (to_slot ? step_offset : seq_offset));
+        }
+    };
+
+    for (int64_t t = 0; t < nsteps; t++) {
+        for (int i = 0; i < nseqs; i++) {
+            auto* X = ws()->GetTensor(Input(i).name() + "@step");
+            auto dims = Input(i).dims(); dims[axis] = 1;
+            X->Reshape(dims);
+            CopyStep(Input(i), X, t, false);
+        }
+        for (int i = 0; i < nout; i++) {
+            if (default_outputs[i].empty()) continue;
+            auto* H = ws()->GetTensor(func_def.output(i) + "@prev");
+            const Tensor* src = t == 0 ?
+                ws()->GetTensor(default_outputs[i]) :
+                    ws()->GetTensor(func_def.output(i) + "@step");
+            H->ReshapeLike(*src)->CopyFrom(*src, ctx());
+        }
+        step_graph->Run("", "");
+        for (int i = 0; i < nout; i++) {
+            if (Output(i)->name() == "NULL") continue;
+            auto* Y = ws()->GetTensor(func_def.output(i) + "@step");
+            if (t == 0) {
+                auto dims = Y->dims(); dims[axis] *= nsteps;
+                Output(i)->Reshape(dims);
+            }
+            CopyStep(*Y, Output(i), t, true);
+        }
+    }
 }
 
 template <class Context>
 void ScanOp<Context>::RunOnDevice() {
+    DetermineSteps();
+    //  Inference reuses one step graph for all lengths,
+    //  while training unrolls the steps to keep them for BPTT
+    if (phase() == "TEST") { RunSteps(); return; }
     UnrollTemplate();
     if (!graphs.count(nsteps)) {
-        graphs[nsteps].reset(new Graph(new_def, ws()));
+        GraphDef unrolled_def;
+        unrolled_def.ParseFromString(unrolled_defs[nsteps]);
+        graphs[nsteps].reset(new Graph(unrolled_def, ws()));
     }
+    // Upload the unrolled def for the gradient
+    auto* ops_tensor = ws()->CreateTensor(
+        mount_name("raw_ops"))->Reshape({ 1 });
+    auto* data = ops_tensor->template mutable_data<string, CPUContext>();
+    data[0] = unrolled_defs[nsteps];
     cur_graph = graphs[nsteps].get();
     cur_graph->Run("", "");
 }
@@ -174,12 +286,6 @@ template <class Context>
 void ScanGradientOp<Context>::MakeOps(
     const GraphDef&         forward_def,
     GraphDef&               new_def) {
-    if (step_type == "Dynamic")
-        nsteps = ws()->GetTensor(step_tensor)
-                     ->template data<int, CPUContext>()[0];
-    else if (step_type == "Default") nsteps = Input(0).dim(axis);
-    if (graphs.count(nsteps)) return;
-
     // Init maker
     GraphGradientMaker maker;
     maker.SetTerms(terms);
@@ -209,15 +315,20 @@ void ScanGradientOp<Context>::MakeOps(
 
 template <class Context>
 void ScanGradientOp<Context>::RunOnDevice() {
-    Tensor* ops = ws()->GetTensor(mount_name("raw_ops"));
-    GraphDef forward_def, new_def;
-    forward_def.ParseFromString(ops->data<string, CPUContext>()[0]);
-    new_def.CopyFrom(forward_def);
-    MakeOps(forward_def, new_def);
+    if (step_type == "Dynamic")
+        nsteps = ws()->GetTensor(step_tensor)
+                     ->template data<int, CPUContext>()[0];
+    else if (step_type == "Default") nsteps = Input(0).dim(axis);
 
     // Persist for different scan steps
-    if (!graphs.count(nsteps)) 
+    if (!graphs.count(nsteps)) {
+        Tensor* ops = ws()->GetTensor(mount_name("raw_ops"));
+        GraphDef forward_def, new_def;
+        forward_def.ParseFromString(ops->data<string, CPUContext>()[0]);
+        new_def.CopyFrom(forward_def);
+        MakeOps(forward_def, new_def);
         graphs[nsteps].reset(new Graph(new_def, ws()));
+    }
     cur_graph = graphs[nsteps].get();
     cur_graph->Run("Gradient", "");
 }
@@ -0,0 +1,76 @@
+#include "utils/op_kernel.h"
+#include "operators/loss/ctc_decoder_op.h"
+
+namespace dragon {
+
+#define DETERMINE_RUNTIME_ARGUMENTS(X) \
+    CHECK_EQ(X.ndim(), 3) \
+        << "\nThe probabilities should be in the format of [T, N, C]."; \
+    max_seq_len = X.dim(0); \
+    batch_size = X.dim(1); \
+    num_classes = X.dim(2); \
+    blank = blank_first ? 0 : num_classes - 1; \
+    Output(0)->Reshape({ batch_size, max_seq_len }); \
+    Output(1)->Reshape({ batch_size })
+
+template <class Context> template <typename T>
+void CTCGreedyDecoderOp<Context>::RunWithType() {
+    auto* Pdata = Input(0).template data<T, Context>();
+    auto* Ydata = Output(0)->template mutable_data<int64_t, Context>();
+    auto* Sdata = Output(1)->template mutable_data<float, Context>();
+
+    kernel::CTCGreedyDecode(
+        max_seq_len, batch_size, num_classes, blank,
+            merge_repeated, padding_mask,
+                Pdata, Ydata, Sdata, ctx());
+}
+
+template <class Context>
+void CTCGreedyDecoderOp<Context>::RunOnDevice() {
+    DETERMINE_RUNTIME_ARGUMENTS(Input(0));
+
+    if (XIsType(Input(0), float)) RunWithType<float>();
+    else LOG(FATAL) << DTypeHelper(Input(0), { "float32" });
+}
+
+#ifdef WITH_CUDA
+DEPLOY_CPU_CUDA(CTCGreedyDecoder);
+#else
+DEPLOY_CPU(CTCGreedyDecoder);
+#endif
+OPERATOR_SCHEMA(CTCGreedyDecoder).NumInputs(1).NumOutputs(2);
+
+NO_GRADIENT(CTCGreedyDecoder);
+
+template <class Context> template <typename T>
+void CTCBeamSearchDecoderOp<Context>::RunWithType() {
+    auto* Pdata = Input(0).template data<T, Context>();
+    auto* Ydata = Output(0)->template mutable_data<int64_t, Context>();
+    auto* Sdata = Output(1)->template mutable_data<float, Context>();
+
+    kernel::CTCBeamSearchDecode(
+        max_seq_len, batch_size, num_classes, blank,
+            beam_width, padding_mask,
+                Pdata, Ydata, Sdata, ctx());
+}
+
+template <class Context>
+void CTCBeamSearchDecoderOp<Context>::RunOnDevice() {
+    DETERMINE_RUNTIME_ARGUMENTS(Input(0));
+
+    if (XIsType(Input(0), float)) RunWithType<float>();
+    else LOG(FATAL) << DTypeHelper(Input(0), { "float32" });
+}
+
+#ifdef WITH_CUDA
+DEPLOY_CPU_CUDA(CTCBeamSearchDecoder);
+#else
+DEPLOY_CPU(CTCBeamSearchDecoder);
+#endif
+OPERATOR_SCHEMA(CTCBeamSearchDecoder).NumInputs(1).NumOutputs(2);
+
+NO_GRADIENT(CTCBeamSearchDecoder);
+
+#undef DETERMINE_RUNTIME_ARGUMENTS
+
+}  // namespace dragon
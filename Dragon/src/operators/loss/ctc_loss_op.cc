@@ -1,12 +1,87 @@
 #include "core/workspace.h"
-#include "utils/filler.h"
+#include "utils/op_kernel.h"
+#include "utils/math_functions.h"
 #include "operators/loss/ctc_loss_op.h"
 
 namespace dragon {
 
-DEPLOY_CPU(CTCLoss);
+template <class Context> template <typename Ty>
+void CTCLossOp<Context>::RunWithType() {
+    const auto max_seq_len = Input(0).dim(0);
+    const auto batch_size = Input(0).dim(1);
+    const auto num_classes = Input(0).dim(2);
+    const auto max_num_labels = Input(1).dim(1);
+    const int blank = blank_first ? 0 : (int)num_classes - 1;
+
+    // Pack the labels before the padding
+    packed_labels.clear(); label_lengths.resize(batch_size);
+    auto* Ldata = Input(1).template data<Ty, CPUContext>();
+    for (int n = 0; n < batch_size; ++n) {
+        auto* start = Ldata + n * max_num_labels;
+        int len = 0;
+        for (; len < max_num_labels; ++len) {
+            const int label = (int)start[len];
+            if (label == padding_mask) break;
+            CHECK(label >= 0 && label < num_classes && label != blank)
+                << "\nExcepted the labels in [0, " << num_classes
+                << ") excluding the blank " << blank
+                << ", got " << label << ".";
+            packed_labels.push_back(label);
+        }
+        label_lengths[n] = len;
+    }
+
+    auto* gradT = ws()->CreateTensor(mount_name("ctc/grads"));
+    gradT->ReshapeLike(Input(0));
+
+    // The forward variables of [T, 2 * L + 5] for each sequence
+    const size_t num_states = max_seq_len * (
+        2 * packed_labels.size() + 5 * batch_size);
+    auto WSdata = ws()->template caches<Context>({
+        num_states * sizeof(double), batch_size * sizeof(float) });
+
+    auto* Pdata = Input(0).template data<float, Context>();
+    auto* Gdata = gradT->template mutable_data<float, Context>();
+    auto* Ydata = Output(0)->template mutable_data<float, Context>();
+    auto* Adata = (double*)WSdata[0];
+    auto* Sdata = (float*)WSdata[1];
+
+    kernel::CTCLoss(
+        max_seq_len, batch_size, num_classes, blank,
+            label_lengths.data(), packed_labels.data(),
+                Pdata, Adata, Sdata, Gdata, ctx());
+
+    // Average the losses and the gradients over the batch
+    Ydata[0] = std::accumulate(Sdata,
+        Sdata + batch_size, 0.f) / batch_size;
+    math::Scale(gradT->count(), 1.f / batch_size,
+        Gdata, Gdata, ctx());
+}
+
+template <class Context>
+void CTCLossOp<Context>::RunOnDevice() {
+    CHECK_EQ(Input(0).ndim(), 3)
+        << "\nThe probabilities should be in the format of [T, N, C].";
+    CHECK_EQ(Input(0).dim(1), Input(1).dim(0))
+        << "\nExcepted " << Input(0).dim(1)
+        << " groups(i.e. batch_size) of labels,"
+        << "\nbut got " << Input(1).dim(0) << ".";
+
+    Output(0)->Reshape({ 1 });
+
+    if (XIsType(Input(0), float)) {
+        if (XIsType(Input(1), int)) RunWithType<int>();
+        else if (XIsType(Input(1), int64_t)) RunWithType<int64_t>();
+        else if (XIsType(Input(1), float)) RunWithType<float>();
+        else LOG(FATAL) << DTypeHelper(Input(1),
+            { "int32", "int64", "float32" });
+    } else LOG(FATAL) << DTypeHelper(Input(0), { "float32" });
+}
+
 #ifdef WITH_CUDA
-DEPLOY_CUDA(CTCLoss);
+DEPLOY_CPU_CUDA(CTCLoss);
+#else
+DEPLOY_CPU(CTCLoss);
 #endif
 OPERATOR_SCHEMA(CTCLoss).NumInputs(2).NumOutputs(1);
 
@@ -0,0 +1,134 @@
+#include <cstring>
+
+#include "operators/misc/offload_op.h"
+
+namespace dragon {
+
+namespace {
+
+/*! Queue the copy of bytes, then call the done on the copy thread */
+template <class Context>
+std::future<void> CopyAsync(
+    Context*                    ctx,
+    void*                       dst,
+    const void*                 src,
+    size_t                      nbytes,
+    bool                        to_host,
+    std::function<void()>       done);
+
+template <> std::future<void> CopyAsync<CPUContext>(
+    CPUContext*                 ctx,
+    void*                       dst,
+    const void*                 src,
+    size_t                      nbytes,
+    bool                        to_host,
+    std::function<void()>       done) {
+    return SpillArea::Get()->Submit([=]() {
+        memcpy(dst, src, nbytes); done();
+    });
+}
+
+#ifdef WITH_CUDA
+template <> std::future<void> CopyAsync<CUDAContext>(
+    CUDAContext*                ctx,
+    void*                       dst,
+    const void*                 src,
+    size_t                      nbytes,
+    bool                        to_host,
+    std::function<void()>       done) {
+    // Start the copy after the kernels queued on the stream
+    cudaEvent_t ready;
+    CUDA_CHECK(cudaEventCreateWithFlags(&ready, cudaEventDisableTiming));
+    CUDA_CHECK(cudaEventRecord(ready, ctx->cuda_stream()));
+    const int device_id = ctx->device_id();
+    return SpillArea::Get()->Submit([=]() {
+        DeviceGuard guard(device_id);
+        // The streams of copy thread never run the kernels
+        auto stream = CUDAContext::cuda_object()->GetStream(device_id, 1);
+        CUDA_CHECK(cudaStreamWaitEvent(stream, ready, 0));
+        CUDA_CHECK(cudaMemcpyAsync(dst, src, nbytes, to_host ?
+            cudaMemcpyDeviceToHost : cudaMemcpyHostToDevice, stream));
+        CUDA_CHECK(cudaStreamSynchronize(stream));
+        CUDA_CHECK(cudaEventDestroy(ready));
+        done();
+    });
+}
+#endif
+
+}  // namespace
+
+template <class Context>
+void OffloadOp<Context>::Wait() {
+    if (pending.valid()) pending.get();
+}
+
+template <class Context>
+void OffloadOp<Context>::RunOnDevice() {
+    auto& X = Input(0);
+    Wait();
+
+    // The external memory or strings could not be moved
+    if (X.count() == 0 || !X.is_viewable() ||
+            XIsType(X, string)) return;
+    if (!spill) { X.Reset(); return; }
+    // The shared memory is still held by others after spilling,
+    // and the prefetched copy would not be seen by them
+    if (!X.is_contiguous() || X.is_memory_shared()) return;
+
+    auto* spill_area = SpillArea::Get();
+    SpillArea::Entry entry;
+    entry.nbytes = X.nbytes();
+    entry.dims = X.dims();
+    entry.meta = X.meta();
+    entry.data = spill_area->Alloc(entry.nbytes,
+        !std::is_same<Context, CPUContext>::value);
+    const void* x = X.template raw_data<Context>();
+
+    // Hold the memory until the copy is finished
+    std::shared_ptr<Tensor> holder(new Tensor(X.name()));
+    holder->ShareView(X, X.offset(), X.dims(), X.strides());
+    spill_area->Put(&X, entry);
+    X.Reset();
+
+    pending = CopyAsync(ctx(), entry.data, x,
+        entry.nbytes, true, [holder]() mutable { holder.reset(); });
+    if (!this->is_async_) Wait();
+}
+
+template <class Context>
+void PrefetchOp<Context>::Wait() {
+    if (pending.valid()) pending.get();
+}
+
+template <class Context>
+void PrefetchOp<Context>::RunOnDevice() {
+    auto* Y = Output(0);
+    Wait();
+
+    auto* spill_area = SpillArea::Get();
+    SpillArea::Entry entry;
+    if (!spill_area->Take(Y, &entry)) return;
+
+    Y->Reshape(entry.dims);
+    auto* y = Y->template raw_mutable_data<Context>(entry.meta);
+    void* data = entry.data;
+    pending = CopyAsync(ctx(), y, data, entry.nbytes,
+        false, [spill_area, data]() { spill_area->Free(data); });
+    if (!this->is_async_) Wait();
+}
+
+DEPLOY_CPU(Offload);
+#ifdef WITH_CUDA
+DEPLOY_CUDA(Offload);
+#endif
+OPERATOR_SCHEMA(Offload).NumInputs(1).NumOutputs(0);
+NO_GRADIENT(Offload);
+
+DEPLOY_CPU(Prefetch);
+#ifdef WITH_CUDA
+DEPLOY_CUDA(Prefetch);
+#endif
+OPERATOR_SCHEMA(Prefetch).NumInputs(0).NumOutputs(1);
+NO_GRADIENT(Prefetch);
+
+}  // namespace dragon
@@ -2,11 +2,17 @@
 
 #ifdef WITH_PYTHON
 
+#include <chrono>
+#include <thread>
+
 #include <pybind11/pybind11.h>
 
 #ifdef WITH_PYTHON3
 #define PyBytes_FromStringAndSize \
     PyUnicode_FromStringAndSize
+#else
+#define PyGILState_Check() \
+    (PyGILState_GetThisThreadState() == _PyThreadState_Current)
 #endif
 
 #define Bytes(str) \
@@ -16,6 +22,96 @@
 
 namespace dragon {
 
+namespace {
+
+std::once_flag g_worker_flag;
+PythonWorker* g_worker = nullptr;
+
+}  // namespace
+
+/*! Return the global worker */
+
+PythonWorker* PythonWorker::Get() {
+    // Never destroyed, the interpreter may finalize before us
+    std::call_once(g_worker_flag, []() { g_worker = new PythonWorker(); });
+    return g_worker;
+}
+
+/*! Stop the global worker after the queued jobs */
+
+void PythonWorker::Shutdown() {
+    if (!g_worker) return;
+    {
+        std::lock_guard<std::mutex> lock(g_worker->mutex_);
+        if (g_worker->stopped_) return;
+        g_worker->stopped_ = true;
+    }
+    g_worker->cond_.notify_all();
+    g_worker->thread_.join();
+}
+
+/*! Default constructor of <PythonWorker> */
+
+PythonWorker::PythonWorker()
+    : stopped_(false), thread_(&PythonWorker::ThreadRun, this) {}
+
+/*! Queue a job and return the future of it */
+
+std::future<void> PythonWorker::Submit(std::function<void()> job) {
+    std::packaged_task<void()> task(job);
+    auto future = task.get_future();
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!stopped_) {
+            jobs_.push_back(std::move(task));
+            lock.unlock(); cond_.notify_one();
+            return future;
+        }
+    }
+    // Run on the caller if the worker was stopped
+    task(); return future;
+}
+
+/*! Run the queued jobs until stopped */
+
+void PythonWorker::ThreadRun() {
+    while (true) {
+        std::packaged_task<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cond_.wait(lock, [this]() {
+                return !jobs_.empty() || stopped_;
+            });
+            if (jobs_.empty()) return;
+            task = std::move(jobs_.front());
+            jobs_.pop_front();
+        }
+        task();
+    }
+}
+
+/*! Add the time of an operator */
+
+void PythonWorker::Record(
+    const string&               name,
+    double                      gil_wait,
+    double                      run,
+    double                      blocked) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& stats = stats_[name];
+    if (run > 0) stats.num_runs++;
+    stats.gil_wait += gil_wait;
+    stats.run += run;
+    stats.blocked += blocked;
+}
+
+/*! Return the time of all operators */
+
+Map<string, PythonOpStats> PythonWorker::Stats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
 template <class Context>
 RunOp<Context>::RunOp(const OperatorDef& def, Workspace* ws)
     : Operator<Context>(def, ws),
@@ -25,6 +121,10 @@ RunOp<Context>::RunOp(const OperatorDef& def, Workspace* ws)
     // Optimization for all python ops
     if (!AllowRun()) return; this->do_sync_ = false;
 
+    // Hand off to the worker if the graph tracks the dependencies
+    this->is_async_ = OperatorBase::Arg<bool>("allow_async", false)
+        && OperatorBase::Arg<bool>("run_async", true);
+
     // Init interpreter & load module
     Py_Initialize();
     PyObject* py_module = PyImport_ImportModule(module.c_str());
@@ -67,12 +167,17 @@ string RunOp<Context>::CallMethodHelper(
 }
 
 template <class Context>
-void RunOp<Context>::RunOnDevice() {
+void RunOp<Context>::Call(
+    const string&               phase,
+    const string&               method,
+    const string&               fallback) {
+    auto start = std::chrono::steady_clock::now();
     // GIL may have been released
     pybind11::gil_scoped_acquire g;
+    auto acquired = std::chrono::steady_clock::now();
 
     // Reset phase
-    PyObject_SetAttr(self, Bytes("phase"), CS2Bytes(phase()));
+    PyObject_SetAttr(self, Bytes("phase"), CS2Bytes(phase));
 
     // Backward compatibility: reshape(inputs, outputs)
     if (PyObject_HasAttr(self, Bytes("reshape"))) {
@@ -82,15 +187,54 @@ void RunOp<Context>::RunOnDevice() {
     }
 
     // Overloaded run inferfaces
-    if (PyObject_HasAttr(self, Bytes("forward"))) {
+    if (PyObject_HasAttr(self, Bytes(method.c_str()))) {
         CHECK(PyObject_CallMethod(
-            self, "forward", "OO", inputs, outputs))
-                << CallMethodHelper("forward");
-    } else if (PyObject_HasAttr(self, Bytes("run"))) {
+            self, method.c_str(), "OO", inputs, outputs))
+                << CallMethodHelper(method);
+    } else if (PyObject_HasAttr(self, Bytes(fallback.c_str()))) {
         CHECK(PyObject_CallMethod(
-            self, "run", "OO", inputs, outputs))
-                << CallMethodHelper("run");
+            self, fallback.c_str(), "OO", inputs, outputs))
+                << CallMethodHelper(fallback);
     }
+
+    std::chrono::duration<double> gil_wait = acquired - start;
+    std::chrono::duration<double> run =
+        std::chrono::steady_clock::now() - acquired;
+    PythonWorker::Get()->Record(name(),
+        gil_wait.count(), run.count(), 0.);
+}
+
+template <class Context>
+void RunOp<Context>::Launch(
+    const string&               method,
+    const string&               fallback) {
+    // The last run should finish before the next
+    Wait();
+    // The worker could not take the GIL held by this thread
+    if (this->is_async_ && !PyGILState_Check()) {
+        string phase = this->phase();
+        pending = PythonWorker::Get()->Submit(
+            [this, phase, method, fallback]() {
+                Call(phase, method, fallback);
+            });
+    } else {
+        Call(phase(), method, fallback);
+    }
+}
+
+template <class Context>
+void RunOp<Context>::Wait() {
+    if (!pending.valid()) return;
+    auto start = std::chrono::steady_clock::now();
+    pending.get();
+    std::chrono::duration<double> blocked =
+        std::chrono::steady_clock::now() - start;
+    PythonWorker::Get()->Record(name(), 0., 0., blocked.count());
+}
+
+template <class Context>
+void RunOp<Context>::RunOnDevice() {
+    Launch("forward", "run");
 }
 
 DEPLOY_CPU(Run);
@@ -103,30 +247,7 @@ NO_GRADIENT(Run);
 
 template <class Context>
 void TemplateGradientOp<Context>::RunOnDevice() {
-    // GIL may have been released
-    pybind11::gil_scoped_acquire g;
-
-    // Reset phase
-    PyObject_SetAttr(this->self,
-        Bytes("phase"), CS2Bytes(phase()));
-
-    // Backward compatibility: reshape(inputs, outputs)
-    if (PyObject_HasAttr(this->self, Bytes("reshape"))) {
-        CHECK(PyObject_CallMethod(this->self, "reshape",
-            "OO", this->inputs, this->outputs))
-                << this->CallMethodHelper("reshape");
-    }
-
-    // Overloaded run inferfaces
-    if (PyObject_HasAttr(this->self, Bytes("backward"))) {
-        CHECK(PyObject_CallMethod(this->self, "backward",
-            "OO", this->inputs, this->outputs))
-                << this->CallMethodHelper("backward");
-    } else if (PyObject_HasAttr(this->self, Bytes("grad"))) {
-        CHECK(PyObject_CallMethod(this->self, "grad",
-            "OO", this->inputs, this->outputs))
-                << this->CallMethodHelper("grad");
-    }
+    this->Launch("backward", "grad");
 }
 
 DEPLOY_CPU(Template);
@@ -0,0 +1,119 @@
+#include "operators/mpi/mpi_send_recv_op.h"
+
+#ifdef WITH_MPI
+
+namespace dragon {
+
+namespace {
+
+/*! The types could be exchanged, indexed by the header */
+const vector<string>& TransferTypes() {
+    static vector<string> types {
+        "bool", "int8", "uint8", "int32", "int64",
+            "float16", "float32", "float64",
+    };
+    return types;
+}
+
+/*! The count of MPI is an int, larger bytes are sent in chunks */
+const size_t kMaxChunkBytes = (size_t)INT_MAX;
+
+}  // namespace
+
+template <class Context>
+void MPISendOp<Context>::Wait() {
+    if (!requests.empty()) {
+        MPI_Waitall((int)requests.size(),
+            requests.data(), MPI_STATUSES_IGNORE);
+    }
+    requests.clear(); headers.clear(); buffers.clear();
+}
+
+template <class Context>
+void MPISendOp<Context>::RunOnDevice() {
+    CHECK(comm != MPI_COMM_NULL)
+        << "\nMPISendOp, name: " << name()
+        << ", does not belong to any group, can't run.";
+    CHECK_EQ(tags.size(), InputSize());
+
+    Wait();
+    // The kernels on the stream should finish before sending
+    ctx()->FinishDeviceCompution();
+
+    const auto& types = TransferTypes();
+    headers.resize(InputSize());
+    for (int i = 0; i < InputSize(); i++) {
+        auto& X = Input(i);
+        auto idx = std::find(types.begin(), types.end(),
+            TypeMetaToString(X.meta())) - types.begin();
+        CHECK_LT(idx, (int64_t)types.size())
+            << "\n" << DTypeHelper(X, { "bool", "int8", "uint8",
+                "int32", "int64", "float16", "float32", "float64" });
+        CHECK_LE(X.ndim(), 32);
+        CHECK(X.is_viewable())
+            << "\nTensor(" << X.name() << ") does not own a memory.";
+        // Hold the memory until the request is finished
+        buffers.emplace_back(new Tensor(X.name()));
+        buffers.back()->ShareView(X, X.offset(), X.dims(), X.strides());
+        auto& header = headers[i];
+        header.push_back(X.ndim());
+        for (auto dim : X.dims()) header.push_back(dim);
+        header.push_back(idx);
+        requests.emplace_back();
+        MPI_Isend(header.data(), (int)header.size(), MPI_LONG_LONG,
+            peer, (int)tags[i], comm, &requests.back());
+        auto* x = (const uint8_t*)X.template raw_data<Context>();
+        for (size_t offset = 0; offset < X.nbytes();
+                offset += kMaxChunkBytes) {
+            requests.emplace_back();
+            MPI_Isend(x + offset,
+                (int)std::min(kMaxChunkBytes, X.nbytes() - offset),
+                    MPI_BYTE, peer, (int)tags[i], comm, &requests.back());
+        }
+    }
+}
+
+DEPLOY_CPU(MPISend);
+#ifdef WITH_CUDA
+DEPLOY_CUDA(MPISend);
+#endif
+OPERATOR_SCHEMA(MPISend).NumInputs(1, INT_MAX).NumOutputs(0);
+NO_GRADIENT(MPISend);
+
+template <class Context>
+void MPIRecvOp<Context>::RunOnDevice() {
+    CHECK(comm != MPI_COMM_NULL)
+        << "\nMPIRecvOp, name: " << name()
+        << ", does not belong to any group, can't run.";
+    CHECK_EQ(tags.size(), OutputSize());
+
+    const auto& types = TransferTypes();
+    // The header is [ndim, dim_0, ..., dim_{ndim - 1}, type]
+    int64_t header[34];
+    for (int i = 0; i < OutputSize(); i++) {
+        MPI_Recv(header, 34, MPI_LONG_LONG, peer,
+            (int)tags[i], comm, MPI_STATUS_IGNORE);
+        auto* Y = Output(i);
+        const int64_t ndim = header[0];
+        Y->Reshape(vector<int64_t>(header + 1, header + 1 + ndim));
+        auto* y = (uint8_t*)Y->template raw_mutable_data<Context>(
+            TypeStringToMeta(types[header[ndim + 1]]));
+        for (size_t offset = 0; offset < Y->nbytes();
+                offset += kMaxChunkBytes) {
+            MPI_Recv(y + offset,
+                (int)std::min(kMaxChunkBytes, Y->nbytes() - offset),
+                    MPI_BYTE, peer, (int)tags[i], comm, MPI_STATUS_IGNORE);
+        }
+    }
+}
+
+DEPLOY_CPU(MPIRecv);
+#ifdef WITH_CUDA
+DEPLOY_CUDA(MPIRecv);
+#endif
+OPERATOR_SCHEMA(MPIRecv).NumInputs(0).NumOutputs(1, INT_MAX);
+NO_GRADIENT(MPIRecv);
+
+}  // namespace dragon
+
+#endif  // WITH_MPI
@@ -1,5 +1,6 @@
 #include "core/workspace.h"
 #include "utils/math_functions.h"
+#include "utils/op_kernel.h"
 #include "operators/norm/l2_norm_op.h"
 
 namespace dragon {
@@ -31,17 +32,32 @@ void L2NormOp<Context>::RunWithType() {
     auto* Bdata = ws()->template caches<T, Context>({ buffer.count() })[0];
     auto* Ndata = norm->template mutable_data<T, Context>();
 
-    math::Set(norm->count(), cast::to<T>(eps), Ndata, ctx());
+    if (std::is_same<Context, CPUContext>::value) {
+        // Compute T1 = \sqrt{\sum_{i} x_{i,j}^{2}} in a single pass
+        int dims3[3] = { (int)outer_dim, (int)dim, (int)inner_dim };
+        int axis1 = 1;
+        kernel::Reduce("L2", 3, dims3, 1, &axis1,
+            mode == "MEAN" ? 1.f / dim : 1.f, Xdata, Ndata, ctx());
+        // Compute T2 = \sqrt{(T1)^{2} + eps}
+        math::Square(norm->count(), Ndata, Ndata, ctx());
+        math::AddScalar(norm->count(), eps, Ndata, ctx());
+        math::Sqrt(norm->count(), Ndata, Ndata, ctx());
+    } else {
+        math::Set(norm->count(), cast::to<T>(eps), Ndata, ctx());
+        for (int n = 0; n < outer_dim; n++) {
+            math::Square(buffer.count(),
+                Xdata + n * buffer.count(), Bdata, ctx());
+            // Compute T1 = \sum_{i} x_{i,j}^{2}
+            math::Gemv(
+                CblasTrans, dim, inner_dim,
+                    mode == "MEAN" ? 1.f / dim : 1.f, Bdata, Dmult,
+                        1.f, Ndata + n * inner_dim, ctx());
+        }
+        // Compute T2 = \sqrt{T1}
+        math::Sqrt(norm->count(), Ndata, Ndata, ctx());
+    }
 
     for (int n = 0; n < outer_dim; n++) {
-        math::Square(buffer.count(), Xdata, Bdata, ctx());
-        // Compute T1 = \sum_{i} x_{i,j}^{2}
-        math::Gemv(
-            CblasTrans, dim, inner_dim,
-                mode == "MEAN" ? 1.f / dim : 1.f, Bdata, Dmult,
-                    1.f, Ndata, ctx());
-        // Compute T2 = \sqrt{T1}
-        math::Sqrt(inner_dim, Ndata, Ndata, ctx());
         // Compute T3 = x / [(T2)]_{dim}
         math::Gemm(
             CblasNoTrans, CblasNoTrans,
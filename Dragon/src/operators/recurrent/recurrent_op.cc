@@ -1,16 +1,412 @@
 #include "core/workspace.h"
+#include "utils/filler.h"
 #include "utils/op_kernel.h"
 #include "utils/math_functions.h"
 #include "operators/recurrent/recurrent_op.h"
 
 namespace dragon {
 
+template <class Context>
+void RecurrentOpBase<Context>::ResetDims() {
+    CHECK_EQ(Input(0).ndim(), 3)
+        << "\nExcepted the input to be (seq_length, batch_size, input_dim), "
+        << "got " << Input(0).DimString();
+    input_dims = Input(0).dims();
+    seq_length = Input(0).dim(0);
+    batch_size = Input(0).dim(1);
+    input_dim = Input(0).dim(2);
+    const int64_t D = num_directions, H = hidden_size, G = num_gates;
+    output_dims = { seq_length, batch_size, D * H };
+    hidden_dims = { num_layers * D, batch_size, H };
+
+    // Follow the packed layout of RNNParamSet:
+    // [matrices of all layers, biases of all layers]
+    int64_t matrix_count = 0, bias_count = 0;
+    w_offsets.resize(num_layers * D * 2);
+    b_offsets.resize(num_layers * D * 2);
+    for (int64_t i = 0; i < num_layers * D; ++i) {
+        const int64_t in_dim = i < D ? input_dim : D * H;
+        w_offsets[i * 2] = matrix_count;
+        matrix_count += G * H * in_dim;
+        w_offsets[i * 2 + 1] = matrix_count;
+        matrix_count += G * H * H;
+        b_offsets[i * 2] = bias_count;
+        b_offsets[i * 2 + 1] = bias_count + G * H;
+        bias_count += G * H * 2;
+    }
+    for (auto& offset : b_offsets) offset += matrix_count;
+    CHECK_EQ(matrix_count + bias_count, Input(1).count())
+        << "\nModel request " << "Tensor(" << Input(1).name() << ")'s "
+        << "size is " << matrix_count + bias_count << ", \n"
+        << "but now is " << Input(1).count() << ", "
+        << "did you feed the incorrect Tensor before ?";
+
+    // Determine the reserve space for backward
+    const int64_t TN = seq_length * batch_size;
+    reserve_count = 0;
+    auto Alloc = [this](int64_t count) {
+        int64_t offset = reserve_count;
+        reserve_count += count; return offset;
+    };
+    h_offsets.assign(num_layers * D, -1);
+    act_offsets.assign(num_layers * D, -1);
+    c_offsets.assign(num_layers * D, -1);
+    hn_offsets.assign(num_layers * D, -1);
+    for (int64_t i = 0; i < num_layers * D; ++i) {
+        //  Unidirectional hidden states live in the layer output
+        if (D > 1) h_offsets[i] = Alloc(TN * H);
+        if (G > 1) act_offsets[i] = Alloc(TN * G * H);
+        if (rnn_mode == "lstm") c_offsets[i] = Alloc(TN * H);
+        if (rnn_mode == "gru") hn_offsets[i] = Alloc(TN * H);
+    }
+    y_offsets.assign(num_layers - 1, -1);
+    x_offsets.assign(num_layers - 1, -1);
+    for (int64_t i = 0; i < num_layers - 1; ++i) {
+        y_offsets[i] = Alloc(TN * D * H);
+        if (use_dropout()) x_offsets[i] = Alloc(TN * D * H);
+    }
+}
+
+template <class Context> template <typename T>
+void RecurrentOp<Context>::RunWithType() {
+    this->ResetDims();
+    if (InputSize() > 2) { TENSOR_FILL(Input(2), hidden_dims); }
+    if (InputSize() > 3) { TENSOR_FILL(Input(3), hidden_dims); }
+    Output(0)->Reshape(output_dims);
+    if (OutputSize() > 1) Output(1)->Reshape(hidden_dims);
+    if (OutputSize() > 2) Output(2)->Reshape(hidden_dims);
+
+    const int64_t L = num_layers, D = num_directions;
+    const int64_t N = batch_size, H = hidden_size;
+    const int64_t TN = seq_length * N, NH = N * H;
+    const int64_t GH = num_gates * H;
+    const bool use_relu = rnn_mode == "rnn_relu";
+
+    auto XsData = [this](int i) {
+        if (i >= InputSize()) return (const T*)NULL;
+        return Input(i).template data<T, Context>();
+    };
+    auto YsData = [this](int i) {
+        if (i >= OutputSize()) return (T*)NULL;
+        if (Output(i)->name() == "NULL") return (T*)NULL;
+        return Output(i)->template mutable_data<T, Context>();
+    };
+
+    // The reserve space is persistent only for training
+    T* Rdata; vector<T*> scratch;
+    if (phase() == "TRAIN") {
+        Rdata = ws()->CreateTensor(mount_name("rnn/reserve"))
+            ->Reshape({ std::max(reserve_count, (int64_t)1) })
+                ->template mutable_data<T, Context>();
+        scratch = ws()->template caches<T, Context>({ TN * GH, N * GH, NH });
+    } else {
+        scratch = ws()->template caches<T, Context>({
+            TN * GH, N * GH, NH, reserve_count });
+        Rdata = scratch[3];
+    }
+    uint8_t* Mdata = nullptr;
+    if (this->use_dropout()) {
+        Mdata = ws()->CreateTensor(mount_name("rnn/mask"))
+            ->Reshape({ (L - 1) * TN * D * H })
+                ->template mutable_data<uint8_t, Context>();
+    }
+
+    auto* Xproj = scratch[0], *Hr = scratch[1], *zeros = scratch[2];
+    math::Set(NH, cast::to<T>(0.f), zeros, ctx());
+    DECLARE_MULTIPLIER(multiplier, TN);
+
+    auto* Wdata = XsData(1);
+    auto* Hx = XsData(2), *Cx = XsData(3);
+    auto* Ydata = YsData(0), *Hy = YsData(1), *Cy = YsData(2);
+    if (Cy && rnn_mode != "lstm")
+        math::Set(L * D * NH, cast::to<T>(0.f), Cy, ctx());
+
+    for (int64_t l = 0; l < L; ++l) {
+        const int64_t in_dim = l == 0 ? input_dim : D * H;
+        const T* Xl = l == 0 ? XsData(0) : Rdata + (
+            Mdata ? x_offsets[l - 1] : y_offsets[l - 1]);
+        T* Yl = l == L - 1 ? Ydata : Rdata + y_offsets[l];
+        for (int64_t d = 0; d < D; ++d) {
+            const int64_t ld = l * D + d;
+            const T* W = Wdata + w_offsets[ld * 2];
+            const T* R = Wdata + w_offsets[ld * 2 + 1];
+            const T* bW = Wdata + b_offsets[ld * 2];
+            const T* bR = Wdata + b_offsets[ld * 2 + 1];
+            T* Hl = D == 1 ? Yl : Rdata + h_offsets[ld];
+            T* Al = num_gates > 1 ? Rdata + act_offsets[ld] : nullptr;
+            T* Cl = rnn_mode == "lstm" ? Rdata + c_offsets[ld] : nullptr;
+            T* HNl = rnn_mode == "gru" ? Rdata + hn_offsets[ld] : nullptr;
+
+            // Project the inputs of all steps at once
+            math::Gemm(
+                CblasNoTrans, CblasTrans,
+                    TN, GH, in_dim,
+                        1.f, Xl, W,
+                            0.f, Xproj, ctx());
+            math::Gemm(
+                CblasNoTrans, CblasNoTrans,
+                    TN, GH, 1,
+                        1.f, multiplier, bW,
+                            1.f, Xproj, ctx());
+
+            const T* hx = Hx ? Hx + ld * NH : zeros;
+            const T* cx = Cx ? Cx + ld * NH : zeros;
+            for (int64_t s = 0; s < seq_length; ++s) {
+                const int64_t t = d == 0 ? s : seq_length - s - 1;
+                const int64_t tp = d == 0 ? t - 1 : t + 1;
+                const T* hp = s == 0 ? hx : Hl + tp * NH;
+                const T* xw = Xproj + t * N * GH;
+                math::Gemm(
+                    CblasNoTrans, CblasTrans,
+                        N, GH, H,
+                            1.f, hp, R,
+                                0.f, Hr, ctx());
+                if (rnn_mode == "lstm") {
+                    const T* cp = s == 0 ? cx : Cl + tp * NH;
+                    kernel::LSTMUnit(N, H, cp, xw, Hr, bR,
+                        Al + t * N * GH, Cl + t * NH, Hl + t * NH, ctx());
+                } else if (rnn_mode == "gru") {
+                    kernel::GRUUnit(N, H, hp, xw, Hr, bR,
+                        Al + t * N * GH, HNl + t * NH, Hl + t * NH, ctx());
+                } else {
+                    kernel::RNNCell(N, H, use_relu,
+                        xw, Hr, bR, Hl + t * NH, ctx());
+                }
+            }
+
+            const int64_t last = d == 0 ? seq_length - 1 : 0;
+            if (Hy) ctx()->template Copy<T, Context, Context>(
+                NH, Hy + ld * NH, Hl + last * NH);
+            if (Cy && Cl) ctx()->template Copy<T, Context, Context>(
+                NH, Cy + ld * NH, Cl + last * NH);
+
+            // Interleave the directions into the layer output
+            if (D > 1) {
+                for (int64_t i = 0; i < TN; ++i)
+                    ctx()->template Copy<T, Context, Context>(
+                        H, Yl + (i * D + d) * H, Hl + i * H);
+            }
+        }
+        if (Mdata && l < L - 1) {
+            kernel::Dropout(TN * D * H, dropout_ratio,
+                1.f / (1.f - dropout_ratio), Yl, (uint32_t*)nullptr,
+                    Mdata + l * TN * D * H, Rdata + x_offsets[l], ctx());
+        }
+    }
+}
+
+template <class Context>
+void RecurrentOp<Context>::RunOnDevice() {
+    if (XIsType(Input(0), float)) RunWithType<float>();
+    else LOG(FATAL) << DTypeHelper(Input(0), { "float32" });
+}
+
+#ifdef WITH_CUDA
+template <> void RecurrentOp<CUDAContext>::RunOnDevice() {
+    LOG(FATAL) << "RNN Operators on CUDA require CuDNN support.";
+}
+#endif
+
 DEPLOY_CPU(Recurrent);
 #ifdef WITH_CUDA
 DEPLOY_CUDA(Recurrent);
 #endif
 OPERATOR_SCHEMA(Recurrent).NumInputs(2, 4).NumOutputs(1, 3);
 
+template <class Context> template <typename T>
+void RecurrentGradientOp<Context>::RunWithType() {
+    this->ResetDims();
+    Output(2)->Reshape(hidden_dims);   // dHx
+    Output(3)->Reshape(hidden_dims);   // dCx
+
+    const int64_t L = num_layers, D = num_directions;
+    const int64_t N = batch_size, H = hidden_size;
+    const int64_t TN = seq_length * N, NH = N * H;
+    const int64_t GH = num_gates * H;
+    const bool use_relu = rnn_mode == "rnn_relu";
+
+    auto XsData = [this](int i) {
+        if (i >= InputSize()) return (const T*)NULL;
+        if (Input(i).name() == "NULL") return (const T*)NULL;
+        return Input(i).template data<T, Context>();
+    };
+    auto YsData = [this](int i) {
+        if (i >= OutputSize()) return (T*)NULL;
+        if (Output(i)->name() == "NULL") return (T*)NULL;
+        return Output(i)->template mutable_data<T, Context>();
+    };
+
+    auto* reserveT = ws()->GetTensor(mount_name("rnn/reserve"));
+    CHECK_GE(reserveT->count(), reserve_count);
+    auto* Rdata = reserveT->template mutable_data<T, Context>();
+    const uint8_t* Mdata = nullptr;
+    if (this->use_dropout()) {
+        Mdata = ws()->GetTensor(mount_name("rnn/mask"))
+            ->template data<uint8_t, Context>();
+    }
+
+    auto scratch = ws()->template caches<T, Context>({
+        TN * GH, rnn_mode == "gru" ? TN * GH : 0,
+        NH, NH, NH, NH, TN * D * H, TN * D * H });
+    auto* dXproj = scratch[0];
+    auto* dHrs = rnn_mode == "gru" ? scratch[1] : dXproj;
+    auto* dh = scratch[2], *dc = scratch[3], *dhx = scratch[4];
+    auto* zeros = scratch[5];
+    math::Set(NH, cast::to<T>(0.f), zeros, ctx());
+    DECLARE_MULTIPLIER(multiplier, TN);
+
+    auto* Wdata = XsData(1);
+    auto* Hx = XsData(2), *Cx = XsData(3);
+    auto* dHy = XsData(6), *dCy = XsData(7);
+    auto* dXdata = YsData(0), *dWdata = YsData(1);
+    auto* dHx = YsData(2), *dCx = YsData(3);
+    if (dWdata) math::Set(Input(1).count(), cast::to<T>(0.f), dWdata, ctx());
+    if (dCx && rnn_mode != "lstm")
+        math::Set(L * D * NH, cast::to<T>(0.f), dCx, ctx());
+
+    const T* dYl = XsData(5);
+    for (int64_t l = L - 1; l >= 0; --l) {
+        const int64_t in_dim = l == 0 ? input_dim : D * H;
+        const T* Xl = l == 0 ? XsData(0) : Rdata + (
+            Mdata ? x_offsets[l - 1] : y_offsets[l - 1]);
+        T* Yl = l == L - 1 ? (T*)XsData(4) : Rdata + y_offsets[l];
+        T* dXl = l == 0 ? dXdata : scratch[6 + (L - 1 - l) % 2];
+        for (int64_t d = 0; d < D; ++d) {
+            const int64_t ld = l * D + d;
+            const T* W = Wdata + w_offsets[ld * 2];
+            const T* R = Wdata + w_offsets[ld * 2 + 1];
+            const T* Hl = D == 1 ? Yl : Rdata + h_offsets[ld];
+            const T* Al = num_gates > 1 ? Rdata + act_offsets[ld] : nullptr;
+            const T* Cl = rnn_mode == "lstm" ? Rdata + c_offsets[ld] : nullptr;
+            const T* HNl = rnn_mode == "gru" ? Rdata + hn_offsets[ld] : nullptr;
+
+            if (dHy) ctx()->template Copy<T, Context, Context>(
+                NH, dh, dHy + ld * NH);
+            else math::Set(NH, cast::to<T>(0.f), dh, ctx());
+            if (dCy && Cl) ctx()->template Copy<T, Context, Context>(
+                NH, dc, dCy + ld * NH);
+            else math::Set(NH, cast::to<T>(0.f), dc, ctx());
+
+            // BPTT in the reversed order of the forward steps
+            for (int64_t s = seq_length - 1; s >= 0; --s) {
+                const int64_t t = d == 0 ? s : seq_length - s - 1;
+                const int64_t tp = d == 0 ? t - 1 : t + 1;
+                T* dx = dXproj + t * N * GH;
+                if (dYl) {
+                    if (D == 1) {
+                        math::Axpy(NH, 1.f, dYl + t * NH, dh, ctx());
+                    } else {
+                        for (int64_t i = 0; i < N; ++i)
+                            math::Axpy(H, 1.f, dYl + ((t * N + i)
+                                * D + d) * H, dh + i * H, ctx());
+                    }
+                }
+                if (rnn_mode == "lstm") {
+                    const T* cp = s > 0 ? Cl + tp * NH :
+                        (Cx ? Cx + ld * NH : zeros);
+                    kernel::LSTMUnitGrad(N, H, cp, Al + t * N * GH,
+                        Cl + t * NH, dc, dh, dc, dx, ctx());
+                    math::Gemm(
+                        CblasNoTrans, CblasNoTrans,
+                            N, H, GH,
+                                1.f, dx, R,
+                                    0.f, dh, ctx());
+                } else if (rnn_mode == "gru") {
+                    const T* hp = s > 0 ? Hl + tp * NH :
+                        (Hx ? Hx + ld * NH : zeros);
+                    kernel::GRUUnitGrad(N, H, hp, Al + t * N * GH,
+                        HNl + t * NH, dh, dhx, dx, dHrs + t * N * GH, ctx());
+                    math::Gemm(
+                        CblasNoTrans, CblasNoTrans,
+                            N, H, GH,
+                                1.f, dHrs + t * N * GH, R,
+                                    0.f, dh, ctx());
+                    math::Add(NH, dh, dhx, dh, ctx());
+                } else {
+                    kernel::RNNCellGrad(N, H, use_relu,
+                        Hl + t * NH, dh, dx, ctx());
+                    math::Gemm(
+                        CblasNoTrans, CblasNoTrans,
+                            N, H, GH,
+                                1.f, dx, R,
+                                    0.f, dh, ctx());
+                }
+            }
+
+            if (dHx) ctx()->template Copy<T, Context, Context>(
+                NH, dHx + ld * NH, dh);
+            if (dCx && Cl) ctx()->template Copy<T, Context, Context>(
+                NH, dCx + ld * NH, dc);
+
+            // Accumulate the weights gradients of all steps at once
+            if (dWdata) {
+                T* dW = dWdata + w_offsets[ld * 2];
+                T* dR = dWdata + w_offsets[ld * 2 + 1];
+                math::Gemm(
+                    CblasTrans, CblasNoTrans,
+                        GH, in_dim, TN,
+                            1.f, dXproj, Xl,
+                                1.f, dW, ctx());
+                math::Gemv(
+                    CblasTrans, TN, GH,
+                        1.f, dXproj, multiplier,
+                            1.f, dWdata + b_offsets[ld * 2], ctx());
+                if (seq_length > 1) {
+                    //  Pair each step with the hidden state it consumed
+                    math::Gemm(
+                        CblasTrans, CblasNoTrans,
+                            GH, H, (seq_length - 1) * N,
+                                1.f, dHrs + (d == 0 ? N * GH : 0),
+                                    Hl + (d == 0 ? 0 : NH),
+                                        1.f, dR, ctx());
+                }
+                if (Hx) {
+                    const int64_t first = d == 0 ? 0 : seq_length - 1;
+                    math::Gemm(
+                        CblasTrans, CblasNoTrans,
+                            GH, H, N,
+                                1.f, dHrs + first * N * GH, Hx + ld * NH,
+                                    1.f, dR, ctx());
+                }
+                math::Gemv(
+                    CblasTrans, TN, GH,
+                        1.f, dHrs, multiplier,
+                            1.f, dWdata + b_offsets[ld * 2 + 1], ctx());
+            }
+
+            if (dXl) {
+                math::Gemm(
+                    CblasNoTrans, CblasNoTrans,
+                        TN, in_dim, GH,
+                            1.f, dXproj, W,
+                                d == 0 ? 0.f : 1.f, dXl, ctx());
+            }
+        }
+        if (l > 0) {
+            if (Mdata) {
+                kernel::ApplyMask(TN * D * H, 1.f / (1.f - dropout_ratio),
+                    dXl, Mdata + (l - 1) * TN * D * H, dXl, ctx());
+            }
+            dYl = dXl;
+        }
+    }
+}
+
+template <class Context>
+void RecurrentGradientOp<Context>::RunOnDevice() {
+    Output(0)->ReshapeLike(Input(0));  // dX
+    Output(1)->ReshapeLike(Input(1));  // dW
+
+    if (XIsType(Input(0), float)) RunWithType<float>();
+    else LOG(FATAL) << DTypeHelper(Input(0), { "float32" });
+}
+
+#ifdef WITH_CUDA
+template <> void RecurrentGradientOp<CUDAContext>::RunOnDevice() {
+    LOG(FATAL) << "RNN Operators on CUDA require CuDNN support.";
+}
+#endif
+
 DEPLOY_CPU(RecurrentGradient);
 #ifdef WITH_CUDA
 DEPLOY_CUDA(RecurrentGradient);
@@ -38,4 +434,4 @@ class GetRecurrentGradient final : public GradientMakerBase {
 
 REGISTER_GRADIENT(Recurrent, GetRecurrentGradient);
 
-}  // namespace dragon
\ No newline at end of file
+}  // namespace dragon
@@ -4,7 +4,50 @@
 
 namespace dragon {
 
-#ifdef WITH_MPI
+template <class Context>
+void CollectiveUpdateOp<Context>::InitSHM() {
+    comm_size = world_size = OperatorBase::Arg<int64_t>("shm_size", 0);
+    comm_rank = world_rank = OperatorBase::Arg<int64_t>("shm_rank", -1);
+    comm_root = OperatorBase::Arg<int64_t>("root", 0);
+    string name = OperatorBase::Arg<string>("shm_name", "");
+    CHECK(!name.empty())
+        << "\nShared memory collective is not initialized.";
+    shm_comm = SharedMemoryComm::Get(name, comm_size, comm_rank);
+}
+
+template <class Context> template <typename T>
+void CollectiveUpdateOp<Context>::SHMAllReduce(Tensor* tensor) {
+    // Reduce on the host, the device memory is synchronized lazily
+    auto* dXdata = tensor->template mutable_data<T, CPUContext>();
+    shm_comm->AllReduce(dXdata, tensor->count(), 1.f / comm_size);
+}
+
+template <class Context> template <typename T>
+void CollectiveUpdateOp<Context>::SHMReduce(Tensor* tensor, int root) {
+    auto* dXdata = tensor->template mutable_data<T, CPUContext>();
+    shm_comm->Reduce(dXdata, tensor->count(), root, 1.f / comm_size);
+}
+
+template <class Context> template <typename T>
+void CollectiveUpdateOp<Context>::SHMBcast(Tensor* tensor, int root) {
+    auto* dXdata = tensor->template mutable_data<T, CPUContext>();
+    shm_comm->Broadcast(dXdata, tensor->nbytes(), root);
+}
+
+#ifndef WITH_MPI
+
+template <class Context>
+void CollectiveUpdateOp<Context>::InitMPI() {
+    LOG(FATAL) << "MPI was not compiled.";
+}
+
+template <class Context>
+void CollectiveUpdateOp<Context>::InitNCCL() {
+    // The unique id of NCCL is broadcast by MPI
+    LOG(FATAL) << "MPI was not compiled.";
+}
+
+#else
 
 template <class Context>
 void CollectiveUpdateOp<Context>::InitMPI() {
@@ -52,7 +95,9 @@ void CollectiveUpdateOp<Context>::MPIAllReduce(
     segment_ends[0] = segment_sizes[0];
     for (int i = 1; i < segment_ends.size(); i++)
         segment_ends[i] = segment_sizes[i] + segment_ends[i - 1];
-    auto* WSdata = ws()->template caches<T, Context>({ segment_sizes[0] })[0];
+    auto* arena = ScratchArena::Get<Context>(ctx()->stream_id());
+    ScratchScope scratch_scope(arena, ctx()->stream_id());
+    auto* WSdata = (T*)arena->Alloc(sizeof(T) * segment_sizes[0]);
     auto* dXdata = tensor->template mutable_data<T, Context>();
     int recv_from = (comm_rank - 1 + comm_size) % comm_size;
     int send_to = (comm_rank + 1) % comm_size;
@@ -94,12 +139,38 @@ void CollectiveUpdateOp<Context>::MPIAllReduce(
     }
 }
 
+template <class Context> template <typename T>
+void CollectiveUpdateOp<Context>::MPIReduce(
+    Tensor*                 tensor,
+    MPI_Datatype            dtype,
+    int                     root) {
+    int64_t count = tensor->count();
+    auto* dXdata = tensor->template mutable_data<T, Context>();
+    if (comm_rank != root) {
+        MPI_Send(dXdata, count, dtype, root, 0, comm);
+        return;
+    }
+    auto* arena = ScratchArena::Get<Context>(ctx()->stream_id());
+    ScratchScope scratch_scope(arena, ctx()->stream_id());
+    auto* WSdata = (T*)arena->Alloc(sizeof(T) * count);
+    for (int i = 0; i < comm_size; i++) {
+        if (i == root) continue;
+        MPI_Recv(WSdata, count, dtype, i, 0, comm, MPI_STATUS_IGNORE);
+        math::Axpy(count, 1.f, WSdata, dXdata, ctx());
+        ctx()->FinishDeviceCompution();
+    }
+    if (comm_size > 1) {
+        math::Scale(count, 1.f / comm_size, dXdata, dXdata, ctx());
+    }
+}
+
 template <class Context> template <typename T>
 void CollectiveUpdateOp<Context>::MPIBcast(
     Tensor*                 tensor,
-    MPI_Datatype            dtype) {
+    MPI_Datatype            dtype,
+    int                     root) {
     auto* dXdata = tensor->template mutable_data<T, Context>();
-    MPI_Bcast(dXdata, tensor->count(), dtype, comm_root, comm);
+    MPI_Bcast(dXdata, tensor->count(), dtype, root, comm);
 }
 
 #ifdef WITH_NCCL
@@ -115,22 +186,82 @@ void CollectiveUpdateOp<Context>::NCCLAllReduce(
         count, dtype, ncclSum, nccl_comm, stream));
 }
 
+template <class Context> template <typename T>
+void CollectiveUpdateOp<Context>::NCCLReduce(
+    Tensor*                 tensor,
+    ncclDataType_t          dtype,
+    cudaStream_t&           stream,
+    int                     root) {
+    int64_t count = tensor->count();
+    auto* dXdata = tensor->template mutable_data<T, Context>();
+    NCCL_CHECK(ncclReduce((const void*)dXdata, (void*)dXdata,
+        count, dtype, ncclSum, root, nccl_comm, stream));
+    if (comm_rank == root) {
+        math::Scale(count, 1.f / comm_size, dXdata, dXdata, ctx());
+    }
+}
+
 template <class Context> template <typename T>
 void CollectiveUpdateOp<Context>::NCCLBcast(
     Tensor*                 tensor,
     ncclDataType_t          dtype,
-    cudaStream_t&           stream) {
+    cudaStream_t&           stream,
+    int                     root) {
     int64_t count = tensor->count();
     auto* dXdata = tensor->template mutable_data<T, Context>();
     NCCL_CHECK(ncclBcast((void*)dXdata,
-        count, dtype, comm_root, nccl_comm, stream));
+        count, dtype, root, nccl_comm, stream));
 }
 
 #endif
 
+#endif  // WITH_MPI
+
 template <class Context>
 void CollectiveUpdateOp<Context>::RunOnDevice() {
-    if (mode == "MPI_ALLREDUCE") {
+    // The sharded modes reduce and broadcast each tensor at its owner
+    if (mode.find("REDUCE_SCATTER") != string::npos ||
+            mode.find("ALLGATHER") != string::npos) {
+        CHECK_EQ(shard_ranks.size(), InputSize())
+            << "\nExcepted " << InputSize() << " shard ranks, "
+            << "got " << shard_ranks.size() << ".";
+    }
+
+    if (mode == "SHM_ALLREDUCE") {
+        for (int i = 0; i < InputSize(); i++) {
+            if (XIsType(Input(i), float))
+                SHMAllReduce<float>(&Input(i));
+            else if (XIsType(Input(i), float16))
+                SHMAllReduce<float16>(&Input(i));
+            else LOG(FATAL) << DTypeHelper(Input(0), { "float32", "float16" });
+        }
+    } else if (mode == "SHM_BCAST") {
+        for (int i = 0; i < InputSize(); i++) {
+            if (XIsType(Input(i), float))
+                SHMBcast<float>(&Input(i), comm_root);
+            else if (XIsType(Input(i), float16))
+                SHMBcast<float16>(&Input(i), comm_root);
+            else LOG(FATAL) << DTypeHelper(Input(0), { "float32", "float16" });
+        }
+    } else if (mode == "SHM_REDUCE_SCATTER") {
+        for (int i = 0; i < InputSize(); i++) {
+            if (XIsType(Input(i), float))
+                SHMReduce<float>(&Input(i), shard_ranks[i]);
+            else if (XIsType(Input(i), float16))
+                SHMReduce<float16>(&Input(i), shard_ranks[i]);
+            else LOG(FATAL) << DTypeHelper(Input(0), { "float32", "float16" });
+        }
+    } else if (mode == "SHM_ALLGATHER") {
+        for (int i = 0; i < InputSize(); i++) {
+            if (XIsType(Input(i), float))
+                SHMBcast<float>(&Input(i), shard_ranks[i]);
+            else if (XIsType(Input(i), float16))
+                SHMBcast<float16>(&Input(i), shard_ranks[i]);
+            else LOG(FATAL) << DTypeHelper(Input(0), { "float32", "float16" });
+        }
+    }
+#ifdef WITH_MPI
+    else if (mode == "MPI_ALLREDUCE") {
         for (int i = 0; i < InputSize(); i++) {
             if (XIsType(Input(i), float))
                 MPIAllReduce<float>(&Input(i), MPI_FLOAT);
@@ -141,13 +272,32 @@ void CollectiveUpdateOp<Context>::RunOnDevice() {
     } else if (mode == "MPI_BCAST") {
         for (int i = 0; i < InputSize(); i++) {
             if (XIsType(Input(i), float))
-                MPIBcast<float>(&Input(i), MPI_FLOAT);
+                MPIBcast<float>(&Input(i), MPI_FLOAT, comm_root);
             else if (XIsType(Input(i), float16))
-                MPIBcast<float16>(&Input(i), MPI_UNSIGNED_SHORT);
+                MPIBcast<float16>(&Input(i), MPI_UNSIGNED_SHORT, comm_root);
+            else LOG(FATAL) << DTypeHelper(Input(0), { "float32", "float16" });
+        }
+    } else if (mode == "MPI_REDUCE_SCATTER") {
+        for (int i = 0; i < InputSize(); i++) {
+            if (XIsType(Input(i), float))
+                MPIReduce<float>(&Input(i), MPI_FLOAT, shard_ranks[i]);
+            else if (XIsType(Input(i), float16))
+                MPIReduce<float16>(&Input(i),
+                    MPI_UNSIGNED_SHORT, shard_ranks[i]);
+            else LOG(FATAL) << DTypeHelper(Input(0), { "float32", "float16" });
+        }
+    } else if (mode == "MPI_ALLGATHER") {
+        for (int i = 0; i < InputSize(); i++) {
+            if (XIsType(Input(i), float))
+                MPIBcast<float>(&Input(i), MPI_FLOAT, shard_ranks[i]);
+            else if (XIsType(Input(i), float16))
+                MPIBcast<float16>(&Input(i),
+                    MPI_UNSIGNED_SHORT, shard_ranks[i]);
             else LOG(FATAL) << DTypeHelper(Input(0), { "float32", "float16" });
         }
     }
-#ifdef WITH_NCCL
+#endif  // WITH_MPI
+#if defined(WITH_MPI) && defined(WITH_NCCL)
     else if (mode == "NCCL_ALLREDUCE") {
         auto stream = ((CUDAContext*)ctx())->cuda_stream();
         for (int i = 0; i < InputSize(); i++) {
@@ -172,9 +322,31 @@ void CollectiveUpdateOp<Context>::RunOnDevice() {
         auto stream = ((CUDAContext*)ctx())->cuda_stream();
         for (int i = 0; i < InputSize(); i++) {
             if (XIsType(Input(i), float))
-                NCCLBcast<float>(&Input(i), ncclFloat, stream);
+                NCCLBcast<float>(&Input(i), ncclFloat, stream, comm_root);
+            else if (XIsType(Input(i), float16))
+                NCCLBcast<float16>(&Input(i), ncclHalf, stream, comm_root);
+            else LOG(FATAL) << DTypeHelper(Input(0), { "float32", "float16" });
+        }
+    } else if (mode == "NCCL_REDUCE_SCATTER") {
+        auto stream = ((CUDAContext*)ctx())->cuda_stream();
+        for (int i = 0; i < InputSize(); i++) {
+            if (XIsType(Input(i), float))
+                NCCLReduce<float>(&Input(i),
+                    ncclFloat, stream, shard_ranks[i]);
+            else if (XIsType(Input(i), float16))
+                NCCLReduce<float16>(&Input(i),
+                    ncclHalf, stream, shard_ranks[i]);
+            else LOG(FATAL) << DTypeHelper(Input(0), { "float32", "float16" });
+        }
+    } else if (mode == "NCCL_ALLGATHER") {
+        auto stream = ((CUDAContext*)ctx())->cuda_stream();
+        for (int i = 0; i < InputSize(); i++) {
+            if (XIsType(Input(i), float))
+                NCCLBcast<float>(&Input(i),
+                    ncclFloat, stream, shard_ranks[i]);
             else if (XIsType(Input(i), float16))
-                NCCLBcast<float16>(&Input(i), ncclHalf, stream);
+                NCCLBcast<float16>(&Input(i),
+                    ncclHalf, stream, shard_ranks[i]);
             else LOG(FATAL) << DTypeHelper(Input(0), { "float32", "float16" });
         }
     }
@@ -188,6 +360,4 @@ DEPLOY_CUDA(CollectiveUpdate);
 #endif
 OPERATOR_SCHEMA(CollectiveUpdate).IgnoreVerify();
 
-#endif  // WITH_MPI
-
 }  // namespace dragon
\ No newline at end of file
@@ -12,9 +12,11 @@ void Conv2dOp<Context>::RunWithType() {
     auto* Xdata = Input(0).template data<T, Context>();
     auto* Wdata = Input(1).template data<T, Context>();
     auto* Ydata = Output(0)->template mutable_data<T, Context>();
+    auto* Pdata = this->template PackWeights<T>(Input(1));
 
     for (int n = 0; n < Input(0).dim(0); n++)
-        Wx(Xdata + n * x_offset, Wdata, Ydata + n * y_offset);
+        Wx(Xdata + n * x_offset, Wdata,
+            Ydata + n * y_offset, false, Pdata);
   
     if (HasBias()) {
         auto* Bdata = Input(2).template data<T, Context>();
@@ -77,12 +77,30 @@ void ConvOpBase<Context>::ComputeOutputShape() {
     }
 }
 
+template <class Context> template <typename T>
+const T* ConvOpBase<Context>::PackWeights(const Tensor& W) {
+    // Only the inference with a packing backend reuses the weights
+    if (phase() != "TEST" || group != 1 ||
+            !math::GemmPackable<T, Context>(ctx())) return nullptr;
+    auto* packed = ws()->CreateTensor(mount_name("conv/packed_weights"));
+    if (data_format == "NCHW") {
+        return W_cache.Get<T>(W, CblasAMatrix, CblasNoTrans,
+            conv_out_channels, conv_out_spatial_dim,
+                kernel_dim, packed, ctx());
+    } else {
+        return W_cache.Get<T>(W, CblasBMatrix, CblasTrans,
+            conv_out_spatial_dim, conv_out_channels,
+                kernel_dim, packed, ctx());
+    }
+}
+
 template <class Context> template <typename T>
 void ConvOpBase<Context>::Wx(
     const T*                x,
     const T*                weights,
     T*                      y,
-    bool                    skip_im2col) {
+    bool                    skip_im2col,
+    const T*                packed_weights) {
     auto* col_buffer = x;
 
     if (!is_1x1) {
@@ -92,23 +110,35 @@ void ConvOpBase<Context>::Wx(
         col_buffer = WSdata;
     }
 
-    for (int g = 0; g < group; g++) {
+    if (packed_weights) {
         if (data_format == "NCHW") {
-            math::Gemm(
-                CblasNoTrans, CblasNoTrans,
-                    conv_out_channels / group,
-                         conv_out_spatial_dim,
-                                   kernel_dim,
-                1.f, weights + weight_offset * g,
-                     col_buffer + col_offset * g,
-                0.f, y + output_offset * g, ctx());
+            math::GemmPacked(
+                CblasAMatrix, CblasNoTrans, CblasNoTrans,
+                    conv_out_channels, conv_out_spatial_dim,
+                        kernel_dim, packed_weights, col_buffer,
+                0.f, y, ctx());
         } else if (data_format == "NHWC") {
-            math::Gemm(
-                CblasNoTrans, CblasTrans,
+            math::GemmPacked(
+                CblasBMatrix, CblasNoTrans, CblasTrans,
                     conv_out_spatial_dim, conv_out_channels,
-                        kernel_dim,
-                1.f, col_buffer, weights, 0.f, y, ctx());
+                        kernel_dim, col_buffer, packed_weights,
+                0.f, y, ctx());
         }
+    } else if (data_format == "NCHW") {
+        math::GemmStridedBatched(
+            CblasNoTrans, CblasNoTrans, group,
+                conv_out_channels / group,
+                     conv_out_spatial_dim,
+                               kernel_dim,
+            1.f, weights, weight_offset,
+                 col_buffer, col_offset,
+            0.f, y, output_offset, ctx());
+    } else if (data_format == "NHWC") {
+        math::Gemm(
+            CblasNoTrans, CblasTrans,
+                conv_out_spatial_dim, conv_out_channels,
+                    kernel_dim,
+            1.f, col_buffer, weights, 0.f, y, ctx());
     }
 }
 
@@ -124,22 +154,20 @@ template <class Context> template <typename T>
 void ConvOpBase<Context>::Dx(const T* dy, const T* weights, T* dx) {
     auto* col_buffer = is_1x1 ? dx :
         ws()->template caches<T, Context>({ col_dim })[0];
-    for (int g = 0; g < group; g++) {
-        if (data_format == "NCHW") {
-            math::Gemm(
-                CblasTrans, CblasNoTrans,
-                    kernel_dim, conv_out_spatial_dim,
-                        conv_out_channels / group,
-                1.f, weights + weight_offset * g,
-                          dy + output_offset * g,
-                0.f, col_buffer + col_offset * g, ctx());
-        } else if (data_format == "NHWC") {
-             math::Gemm(
-                 CblasNoTrans, CblasNoTrans,
-                     conv_out_spatial_dim, kernel_dim,
-                         conv_out_channels,
-                 1.f, dy, weights, 0.f, col_buffer, ctx());
-        }
+    if (data_format == "NCHW") {
+        math::GemmStridedBatched(
+            CblasTrans, CblasNoTrans, group,
+                kernel_dim, conv_out_spatial_dim,
+                    conv_out_channels / group,
+            1.f, weights, weight_offset,
+                      dy, output_offset,
+            0.f, col_buffer, col_offset, ctx());
+    } else if (data_format == "NHWC") {
+        math::Gemm(
+            CblasNoTrans, CblasNoTrans,
+                conv_out_spatial_dim, kernel_dim,
+                    conv_out_channels,
+            1.f, dy, weights, 0.f, col_buffer, ctx());
     }
     if (!is_1x1) Col2Im(col_buffer, dx);
 }
@@ -155,23 +183,21 @@ void ConvOpBase<Context>::Dw(const T* dy, const T* x, T *dw) {
         col_buffer = WSdata;
     }
 
-    for (int g = 0; g < group; g++) {
-        if (data_format == "NCHW") {
-            math::Gemm(
-                CblasNoTrans, CblasTrans,
-                    conv_out_channels / group,
-                                   kernel_dim,
-                         conv_out_spatial_dim,
-                1.f, dy + output_offset * g,
-                    col_buffer + col_offset * g,
-                0.f, dw + weight_offset * g, ctx());
-        } else if (data_format == "NHWC") {
-            math::Gemm(
-                CblasTrans, CblasNoTrans,
-                    conv_out_channels, kernel_dim,
-                        conv_out_spatial_dim,
-                1.f, dy, col_buffer, 0.f, dw, ctx());
-        }
+    if (data_format == "NCHW") {
+        math::GemmStridedBatched(
+            CblasNoTrans, CblasTrans, group,
+                conv_out_channels / group,
+                               kernel_dim,
+                     conv_out_spatial_dim,
+            1.f, dy, output_offset,
+                col_buffer, col_offset,
+            0.f, dw, weight_offset, ctx());
+    } else if (data_format == "NHWC") {
+        math::Gemm(
+            CblasTrans, CblasNoTrans,
+                conv_out_channels, kernel_dim,
+                    conv_out_spatial_dim,
+            1.f, dy, col_buffer, 0.f, dw, ctx());
     }
 }
 
@@ -401,7 +427,8 @@ void ConvOpBase<Context>::GradientReshape() {
 }
 
 template class ConvOpBase<CPUContext>;
-template void ConvOpBase<CPUContext>::Wx(const float*, const float*, float*, bool);
+template void ConvOpBase<CPUContext>::Wx(const float*, const float*, float*, bool, const float*);
+template const float* ConvOpBase<CPUContext>::PackWeights<float>(const Tensor&);
 template void ConvOpBase<CPUContext>::Pb(const float*, float*);
 template void ConvOpBase<CPUContext>::Dx(const float*, const float*, float*);
 template void ConvOpBase<CPUContext>::Dw(const float*, const float*, float*);
@@ -409,7 +436,8 @@ template void ConvOpBase<CPUContext>::Db(const float*, float*);
 
 #ifdef WITH_CUDA
 template class ConvOpBase<CUDAContext>;
-template void ConvOpBase<CUDAContext>::Wx(const float*, const float*, float*, bool);
+template void ConvOpBase<CUDAContext>::Wx(const float*, const float*, float*, bool, const float*);
+template const float* ConvOpBase<CUDAContext>::PackWeights<float>(const Tensor&);
 template void ConvOpBase<CUDAContext>::Pb(const float*, float*);
 template void ConvOpBase<CUDAContext>::Dx(const float*, const float*, float*);
 template void ConvOpBase<CUDAContext>::Dw(const float*, const float*, float*);
@@ -1,5 +1,8 @@
 #ifdef WITH_CUDNN
 
+#include <cmath>
+#include <limits>
+
 #include "core/workspace.h"
 #include "utils/filler.h"
 #include "utils/op_kernel.h"
@@ -10,35 +13,20 @@ namespace dragon {
 template <class Context> template <typename T>
 void CuDNNDepthwiseConv2dOp<Context>::RunWithType() {
     TENSOR_FILL(Input(1), weight_shape);
-    if (HasBias()) {
-        TENSOR_FILL(Input(2), bias_shape);
-        if (data_format == "NCHW") {
-            cudnnSetTensor4dDesc<T>(&bias_desc, data_format,
-                vector<int64_t>({ 1, num_output, 1, 1 }));
-        } else if (data_format == "NHWC") {
-            cudnnSetTensor4dDesc<T>(&bias_desc, data_format,
-                vector<int64_t>({ 1, 1, 1, num_output }));
-        }
-    }
-
-    cudnnSetTensor4dDesc<T>(&output_desc,
-        data_format, Output(0)->dims());
+    if (HasBias()) { TENSOR_FILL(Input(2), bias_shape); }
 
     auto* Xdata = Input(0).template data<T, Context>();
     auto* Wdata = Input(1).template data<T, Context>();
     auto* Ydata = Output(0)->template mutable_data<T, Context>();
+    const T* Bdata = nullptr;
+    if (HasBias()) Bdata = Input(2).template data<T, Context>();
 
+    // Apply the bias and activation in the output loop
     kernel::DepthwiseConv2d(Input(0).dim(0), channels,
         input_shape[0], input_shape[1], output_shape[0], output_shape[1],
-            kernel_shape[0], kernel_shape[1], stride[0], pad_l[0], pad_l[1],
-                data_format, Xdata, Wdata, Ydata, ctx());
-
-    if (HasBias()) {
-        auto* Bdata = Input(2).template data<T, Context>();
-        CUDNN_CHECK(cudnnAddTensor(ctx()->cudnn_handle(),
-            CUDNNType<T>::one, bias_desc, Bdata,
-                CUDNNType<T>::one, output_desc, Ydata));
-    }
+            kernel_shape[0], kernel_shape[1], stride[0], stride[1],
+                pad_l[0], pad_l[1], data_format, activation == "Relu6",
+                    Xdata, Wdata, Bdata, Ydata, ctx());
 }
 
 template <class Context>
@@ -71,6 +59,17 @@ void CuDNNDepthwiseConv2dGradientOp<Context>::RunWithType() {
 
     auto* dYdata = Input(-1).template data<T, Context>();
 
+    if (activation == "Relu6") {
+        // The clamped outputs, i.e. 0 and 6, pass no gradients
+        auto* Ydata = Input(2).template data<T, Context>();
+        auto* dZdata = ws()->template caches<T, Context>(
+            { Input(-1).count() })[0];
+        kernel::ClipGrad(Input(-1).count(),
+            std::numeric_limits<float>::denorm_min(),
+                std::nextafter(6.f, 0.f), Ydata, dYdata, dZdata, ctx());
+        dYdata = dZdata;
+    }
+
     if (HasBias()) {
         T* dBdata = Output(2)->template mutable_data<T, Context>();
         CUDNN_CHECK(cudnnConvolutionBackwardBias(ctx()->cudnn_handle(),
@@ -78,24 +77,26 @@ void CuDNNDepthwiseConv2dGradientOp<Context>::RunWithType() {
                 CUDNNType<T>::zero, bias_desc, dBdata));
     }
 
-    for (int n = 0; n < Input(2).dim(0); n++) {
-        if (Output(1)->name() != "NULL") {
-            auto* Xdata = Input(0).template data<T, Context>();
-            auto* dWdata = Output(1)->template mutable_data<T, Context>();
-            math::Set(Output(1)->count(), cast::to<T>(0.f), dWdata, ctx());
-            kernel::DepthwiseConv2dWGrad(Input(0).dim(0), channels,
-                input_shape[0], input_shape[1], output_shape[0], output_shape[1],
-                    kernel_shape[0], kernel_shape[1], stride[0], pad_l[0], pad_l[1],
-                        data_format, dYdata, Xdata, dWdata, ctx());
-        }
-        if (Output(0)->name() != "NULL") {
-            auto* Wdata = Input(1).template data<T, Context>();
-            auto* dXdata = Output(0)->template mutable_data<T, Context>();
-            kernel::DepthwiseConv2dGrad(Input(0).dim(0), channels,
-                input_shape[0], input_shape[1], output_shape[0], output_shape[1],
-                    kernel_shape[0], kernel_shape[1], stride[0], pad_l[0], pad_l[1],
-                        data_format, dYdata, Wdata, dXdata, ctx());
-        }
+    // The kernels compute the whole batch at once
+    if (Output(1)->name() != "NULL") {
+        auto* Xdata = Input(0).template data<T, Context>();
+        auto* dWdata = Output(1)->template mutable_data<T, Context>();
+        math::Set(Output(1)->count(), cast::to<T>(0.f), dWdata, ctx());
+        kernel::DepthwiseConv2dWGrad(Input(0).dim(0), channels,
+            input_shape[0], input_shape[1], output_shape[0], output_shape[1],
+                kernel_shape[0], kernel_shape[1], stride[0], stride[1],
+                    pad_l[0], pad_l[1], data_format,
+                        dYdata, Xdata, dWdata, ctx());
+    }
+
+    if (Output(0)->name() != "NULL") {
+        auto* Wdata = Input(1).template data<T, Context>();
+        auto* dXdata = Output(0)->template mutable_data<T, Context>();
+        kernel::DepthwiseConv2dGrad(Input(0).dim(0), channels,
+            input_shape[0], input_shape[1], output_shape[0], output_shape[1],
+                kernel_shape[0], kernel_shape[1], stride[0], stride[1],
+                    pad_l[0], pad_l[1], data_format,
+                        dYdata, Wdata, dXdata, ctx());
     }
 }
 
@@ -1,3 +1,6 @@
+#include <cmath>
+#include <limits>
+
 #include "core/workspace.h"
 #include "utils/filler.h"
 #include "utils/op_kernel.h"
@@ -13,16 +16,15 @@ void DepthwiseConv2dOp<Context>::RunWithType() {
     auto* Xdata = Input(0).template data<T, Context>();
     auto* Wdata = Input(1).template data<T, Context>();
     auto* Ydata = Output(0)->template mutable_data<T, Context>();
+    const T* Bdata = nullptr;
+    if (HasBias()) Bdata = Input(2).template data<T, Context>();
 
+    // Apply the bias and activation in the output loop
     kernel::DepthwiseConv2d(Input(0).dim(0), channels,
         input_shape[0], input_shape[1], output_shape[0], output_shape[1],
-            kernel_shape[0], kernel_shape[1], stride[0], pad_l[0], pad_l[1],
-                data_format, Xdata, Wdata, Ydata, ctx());
-
-    if (HasBias()) {
-        auto* Bdata = Input(2).template data<T, Context>();
-        Pb(Bdata, Ydata);
-    }
+            kernel_shape[0], kernel_shape[1], stride[0], stride[1],
+                pad_l[0], pad_l[1], data_format, activation == "Relu6",
+                    Xdata, Wdata, Bdata, Ydata, ctx());
 }
 
 template <class Context>
@@ -47,30 +49,43 @@ template <class Context> template <typename T>
 void DepthwiseConv2dGradientOp<Context>::RunWithType() {
     auto* dYdata = Input(-1).template data<T, Context>();
 
+    if (activation == "Relu6") {
+        // The clamped outputs, i.e. 0 and 6, pass no gradients
+        auto* Ydata = Input(2).template data<T, Context>();
+        auto* dZdata = ws()->template caches<T, Context>(
+            { Input(-1).count() })[0];
+        kernel::ClipGrad(Input(-1).count(),
+            std::numeric_limits<float>::denorm_min(),
+                std::nextafter(6.f, 0.f), Ydata, dYdata, dZdata, ctx());
+        dYdata = dZdata;
+    }
+
     if (HasBias()) {
         T* dBdata = Output(2)->template mutable_data<T, Context>();
-        for (int n = 0; n < Input(2).dim(0); n++)
+        for (int n = 0; n < Input(0).dim(0); n++)
             Db(dYdata + n * y_offset, dBdata);
     }
 
-    for (int n = 0; n < Input(2).dim(0); n++) {
-        if (Output(1)->name() != "NULL") {
-            auto* Xdata = Input(0).template data<T, Context>();
-            auto* dWdata = Output(1)->template mutable_data<T, Context>();
-            math::Set(Output(1)->count(), cast::to<T>(0.f), dWdata, ctx());
-            kernel::DepthwiseConv2dWGrad(Input(0).dim(0), channels,
-                input_shape[0], input_shape[1], output_shape[0], output_shape[1],
-                    kernel_shape[0], kernel_shape[1], stride[0], pad_l[0], pad_l[1],
-                        data_format, dYdata, Xdata, dWdata, ctx());
-        }
-        if (Output(0)->name() != "NULL") {
-            auto* Wdata = Input(1).template data<T, Context>();
-            auto* dXdata = Output(0)->template mutable_data<T, Context>();
-            kernel::DepthwiseConv2dGrad(Input(0).dim(0), channels,
-                input_shape[0], input_shape[1], output_shape[0], output_shape[1],
-                    kernel_shape[0], kernel_shape[1], stride[0], pad_l[0], pad_l[1],
-                        data_format, dYdata, Wdata, dXdata, ctx());
-        }
+    // The kernels compute the whole batch at once
+    if (Output(1)->name() != "NULL") {
+        auto* Xdata = Input(0).template data<T, Context>();
+        auto* dWdata = Output(1)->template mutable_data<T, Context>();
+        math::Set(Output(1)->count(), cast::to<T>(0.f), dWdata, ctx());
+        kernel::DepthwiseConv2dWGrad(Input(0).dim(0), channels,
+            input_shape[0], input_shape[1], output_shape[0], output_shape[1],
+                kernel_shape[0], kernel_shape[1], stride[0], stride[1],
+                    pad_l[0], pad_l[1], data_format,
+                        dYdata, Xdata, dWdata, ctx());
+    }
+
+    if (Output(0)->name() != "NULL") {
+        auto* Wdata = Input(1).template data<T, Context>();
+        auto* dXdata = Output(0)->template mutable_data<T, Context>();
+        kernel::DepthwiseConv2dGrad(Input(0).dim(0), channels,
+            input_shape[0], input_shape[1], output_shape[0], output_shape[1],
+                kernel_shape[0], kernel_shape[1], stride[0], stride[1],
+                    pad_l[0], pad_l[1], data_format,
+                        dYdata, Wdata, dXdata, ctx());
     }
 }
 
@@ -90,15 +105,19 @@ DEPLOY_CUDA(DepthwiseConv2dGradient);
 #endif
 
 OPERATOR_SCHEMA(DepthwiseConv2dGradient)
-    .NumInputs(3).NumOutputs(3);
+    .NumInputs(3, 4).NumOutputs(3);
 
 class GetDepthwiseConv2dGradient
     final : public GradientMakerBase {
  public:
     GRADIENT_MAKER_CTOR(GetDepthwiseConv2dGradient);
     vector<OperatorDef> MakeDefs() override {
-        return SingleDef(def.type() + "Gradient", "",
-            vector<string>({ I(0), I(1), GO(0) }),
+        vector<string> inputs({ I(0), I(1), GO(0) });
+        // The fused activation is backward with the output
+        for (const auto& arg : def.arg())
+            if (arg.name() == "activation" && !arg.s().empty())
+                inputs.insert(inputs.begin() + 2, O(0));
+        return SingleDef(def.type() + "Gradient", "", inputs,
             vector<string>({ GI(0), GI(1), GI(2) }));
     }
 };
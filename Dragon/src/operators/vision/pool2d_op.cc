@@ -64,12 +64,16 @@ namespace dragon {
 
 template <class Context> template <typename T>
 void Pool2dOp<Context>::MAXRunWithType() {
-    mask = ws()->CreateTensor(mount_name(
-        "max_pool/mask"))->ReshapeLike(*Output(0));
-
     auto* Xdata = Input(0).template data<T, Context>();
     auto* Ydata = Output(0)->template mutable_data<T, Context>();
-    auto* Mdata = mask->template mutable_data<int, Context>();
+
+    // The mask is only required by the gradient
+    int* Mdata = nullptr;
+    if (phase() != "TEST") {
+        mask = ws()->CreateTensor(mount_name(
+            "max_pool/mask"))->ReshapeLike(*Output(0));
+        Mdata = mask->template mutable_data<int, Context>();
+    }
 
     kernel::MAXPool2d(n, c, h, w, pool_h, pool_w,
         kernel_shape[0], kernel_shape[1],
@@ -0,0 +1,74 @@
+#include <cstdlib>
+
+#include "utils/cpu_isa.h"
+#include "utils/logging.h"
+
+#ifdef WITH_CPU_ISA_DISPATCH
+#include <cpuid.h>
+#endif
+
+namespace dragon {
+
+#ifdef WITH_CPU_ISA_DISPATCH
+/*! The targets of AVX2 and AVX512 enable the half conversions */
+bool _SupportsF16C() {
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return false;
+    return (ecx & bit_F16C) != 0;
+}
+#endif
+
+CPUISA GetSupportedCPUISA() {
+#ifdef WITH_CPU_ISA_DISPATCH
+    __builtin_cpu_init();
+    const bool f16c = _SupportsF16C();
+    if (f16c && __builtin_cpu_supports("avx512f") &&
+        __builtin_cpu_supports("avx512dq") &&
+        __builtin_cpu_supports("avx512bw") &&
+        __builtin_cpu_supports("avx512vl")) return CPUISA::AVX512;
+    if (f16c && __builtin_cpu_supports("avx2") &&
+        __builtin_cpu_supports("fma")) return CPUISA::AVX2;
+    if (__builtin_cpu_supports("sse4.2") &&
+        __builtin_cpu_supports("popcnt")) return CPUISA::SSE42;
+#endif
+    return CPUISA::DEFAULT;
+}
+
+std::string CPUISAToString(CPUISA isa) {
+    switch (isa) {
+        case CPUISA::AVX512: return "avx512";
+        case CPUISA::AVX2: return "avx2";
+        case CPUISA::SSE42: return "sse4.2";
+        default: return "default";
+    }
+}
+
+CPUISA _SelectCPUISA() {
+    CPUISA supported = GetSupportedCPUISA(), isa = supported;
+    const char* env = getenv("DRAGON_CPU_ISA");
+    if (env != nullptr && std::string(env) != "") {
+        std::string str(env);
+        if (str == "default") isa = CPUISA::DEFAULT;
+        else if (str == "sse4.2") isa = CPUISA::SSE42;
+        else if (str == "avx2") isa = CPUISA::AVX2;
+        else if (str == "avx512") isa = CPUISA::AVX512;
+        else LOG(WARNING) << "Unknown DRAGON_CPU_ISA: " << str
+                          << ", expected default, sse4.2, avx2 or avx512.";
+        if (isa > supported) {
+            LOG(WARNING) << "DRAGON_CPU_ISA requires " << str
+                         << ", while the processor supports "
+                         << CPUISAToString(supported) << ".";
+            isa = supported;
+        }
+    }
+    LOG(DEBUG) << "Dispatch the CPU kernels with ISA: "
+               << CPUISAToString(isa);
+    return isa;
+}
+
+CPUISA GetCPUISA() {
+    static CPUISA isa = _SelectCPUISA();
+    return isa;
+}
+
+}  // namespace dragon
@@ -0,0 +1,142 @@
+#include "utils/dlpack.h"
+
+namespace dragon {
+
+namespace {
+
+/*! The context to keep the exported memory and layout */
+struct DLPackContext {
+    Tensor holder;
+    vector<int64_t> shape, strides;
+    DLManagedTensor managed;
+};
+
+void DeleteDLPackContext(DLManagedTensor* self) {
+    delete static_cast<DLPackContext*>(self->manager_ctx);
+}
+
+}  // namespace
+
+bool TypeMetaToDLPack(const TypeMeta& meta, DLDataType* dtype) {
+    static std::unordered_map<TypeId, DLDataType> m2dl_type_map {
+        { TypeMeta::Id<bool>(), { kDLBool, 8, 1 } },
+        { TypeMeta::Id<int8_t>(), { kDLInt, 8, 1 } },
+        { TypeMeta::Id<uint8_t>(), { kDLUInt, 8, 1 } },
+        { TypeMeta::Id<int>(), { kDLInt, 32, 1 } },
+        { TypeMeta::Id<int64_t>(), { kDLInt, 64, 1 } },
+        { TypeMeta::Id<float16>(), { kDLFloat, 16, 1 } },
+        { TypeMeta::Id<float>(), { kDLFloat, 32, 1 } },
+        { TypeMeta::Id<double>(), { kDLFloat, 64, 1 } },
+    };
+    auto it = m2dl_type_map.find(meta.id());
+    if (it == m2dl_type_map.end()) return false;
+    *dtype = it->second;
+    return true;
+}
+
+const TypeMeta& TypeDLPackToMeta(const DLDataType& dtype) {
+    static std::map<std::pair<int, int>, TypeMeta> dl2m_type_map {
+        { { kDLBool, 8 }, TypeMeta::Make<bool>() },
+        { { kDLInt, 8 }, TypeMeta::Make<int8_t>() },
+        { { kDLUInt, 8 }, TypeMeta::Make<uint8_t>() },
+        { { kDLInt, 32 }, TypeMeta::Make<int>() },
+        { { kDLInt, 64 }, TypeMeta::Make<int64_t>() },
+        { { kDLFloat, 16 }, TypeMeta::Make<float16>() },
+        { { kDLFloat, 32 }, TypeMeta::Make<float>() },
+        { { kDLFloat, 64 }, TypeMeta::Make<double>() },
+    };
+    static TypeMeta unknown_type;
+    if (dtype.lanes != 1) return unknown_type;
+    auto it = dl2m_type_map.find({ dtype.code, dtype.bits });
+    return it != dl2m_type_map.end() ? it->second : unknown_type;
+}
+
+DLManagedTensor* TensorToDLPack(Tensor* tensor) {
+    DLDataType dtype;
+    CHECK(TypeMetaToDLPack(tensor->meta(), &dtype))
+        << "\nTensor(" << tensor->name() << ") with dtype."
+        << TypeMetaToString(tensor->meta())
+        << " is not supported by dlpack.";
+    CHECK_GT(tensor->count(), 0)
+        << "\nTensor(" << tensor->name() << ") is empty.";
+    // Share the memory on the device holding the latest contents,
+    // which also detaches the memory shared by copy-on-write
+    DLDevice device = { kDLCPU, 0 };
+    void* data = nullptr;
+    if (tensor->has_memory() && tensor->memory_state()
+            == MixedMemory::STATE_AT_CUDA) {
+        data = tensor->raw_mutable_data<CUDAContext>();
+        device = { kDLCUDA, tensor->memory()->device_id() };
+    } else {
+        data = tensor->raw_mutable_data<CPUContext>();
+    }
+    CHECK(tensor->is_viewable())
+        << "\nTensor(" << tensor->name() << ") does not own a memory.";
+    auto* ctx = new DLPackContext;
+    ctx->holder.ShareView(*tensor, tensor->offset(),
+        tensor->dims(), tensor->strides());
+    ctx->shape = tensor->dims();
+    ctx->strides = tensor->strides();
+    auto& dl_tensor = ctx->managed.dl_tensor;
+    dl_tensor.data = data;
+    dl_tensor.device = device;
+    dl_tensor.ndim = tensor->ndim();
+    dl_tensor.dtype = dtype;
+    dl_tensor.shape = ctx->shape.data();
+    dl_tensor.strides = ctx->strides.data();
+    dl_tensor.byte_offset = 0;
+    ctx->managed.manager_ctx = ctx;
+    ctx->managed.deleter = &DeleteDLPackContext;
+    return &ctx->managed;
+}
+
+void TensorFromDLPack(DLManagedTensor* managed, Tensor* tensor) {
+    const DLTensor& dl_tensor = managed->dl_tensor;
+    const TypeMeta& meta = TypeDLPackToMeta(dl_tensor.dtype);
+    CHECK(meta.id() != 0)
+        << "\nUnsupported dlpack data type: (code="
+        << (int)dl_tensor.dtype.code << ", bits="
+        << (int)dl_tensor.dtype.bits << ", lanes="
+        << dl_tensor.dtype.lanes << ").";
+    vector<int64_t> dims(dl_tensor.ndim), strides(dl_tensor.ndim);
+    size_t count = 1, span = 1;
+    for (int i = dl_tensor.ndim - 1; i >= 0; i--) {
+        dims[i] = dl_tensor.shape[i];
+        strides[i] = dl_tensor.strides ?
+            dl_tensor.strides[i] : (int64_t)count;
+        CHECK_GE(strides[i], 0)
+            << "\nThe negative strides are not supported.";
+        if (dims[i] > 0) {
+            count *= dims[i];
+            span += (dims[i] - 1) * strides[i];
+        }
+    }
+    if (count == 0) span = 0;
+    const size_t nbytes = span * meta.itemsize();
+    auto* data = (uint8_t*)dl_tensor.data + dl_tensor.byte_offset;
+    MixedMemory* memory = new MixedMemory(meta, nbytes);
+    switch (dl_tensor.device.device_type) {
+        case kDLCPU:
+        case kDLCUDAHost:
+            memory->set_cpu_data(data, nbytes);
+            break;
+        case kDLCUDA:
+            memory->set_cuda_data(data, nbytes,
+                dl_tensor.device.device_id);
+            break;
+        default:
+            LOG(FATAL) << "Unsupported dlpack device type: "
+                       << (int)dl_tensor.device.device_type;
+    }
+    // Release the producer with the memory,
+    // which may outlive the tensor as views
+    memory->set_deleter([managed]()->void {
+        if (managed->deleter) managed->deleter(managed);
+    });
+    Tensor holder;
+    holder.SetMeta(meta);
+    holder.set_memory(memory);
+    tensor->ShareView(holder, 0, dims, strides);
+}
+
+}  // namespace dragon
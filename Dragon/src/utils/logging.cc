@@ -30,6 +30,10 @@ void SetLogDestination(LogSeverity type) {
     g_log_destination = type;
 }
 
+LogSeverity GetLogDestination() {
+    return g_log_destination;
+}
+
 LogSeverity StrToLogSeverity(std::string level) {
     return LOG_LEVELS[level];
 }
@@ -0,0 +1,444 @@
+#include <algorithm>
+
+#include "core/context.h"
+#include "utils/eigen_utils.h"
+#include "utils/omp_alternative.h"
+#include "utils/math_functions.h"
+
+#if defined(WITH_MKL)
+#include <mkl.h>
+#define WITH_CBLAS
+#elif defined(WITH_OPENBLAS)
+#include <cblas.h>
+#define WITH_CBLAS
+#endif
+
+namespace dragon {
+
+namespace math {
+
+/*!
+ * ----------------------------------------------
+ *
+ *
+ *        Linear Algebra Binary Functions
+ *
+ *
+ * ----------------------------------------------
+ */
+
+#ifdef WITH_CBLAS
+
+/*! The CBLAS of OpenBLAS or MKL */
+
+inline ::CBLAS_TRANSPOSE _CblasTrans(const CBLAS_TRANSPOSE trans) {
+    return trans == CblasNoTrans ? ::CblasNoTrans : ::CblasTrans;
+}
+
+#define DEFINE_CBLAS_FUNC(T, prefix) \
+    void _Gemm( \
+        const CBLAS_TRANSPOSE   TransA, \
+        const CBLAS_TRANSPOSE   TransB, \
+        const int               M, \
+        const int               N, \
+        const int               K, \
+        const T                 alpha, \
+        const T*                A, \
+        const T*                B, \
+        const T                 beta, \
+        T*                      C) { \
+        const int lda = (TransA == CblasNoTrans) ? K : M; \
+        const int ldb = (TransB == CblasNoTrans) ? N : K; \
+        cblas_##prefix##gemm(CblasRowMajor, \
+            _CblasTrans(TransA), _CblasTrans(TransB), \
+                M, N, K, alpha, A, lda, B, ldb, beta, C, N); \
+    } \
+    void _Gemv( \
+        const CBLAS_TRANSPOSE   TransA, \
+        const int               M, \
+        const int               N, \
+        const T                 alpha, \
+        const T*                A, \
+        const T*                x, \
+        const T                 beta, \
+        T*                      y) { \
+        cblas_##prefix##gemv(CblasRowMajor, _CblasTrans(TransA), \
+            M, N, alpha, A, N, x, 1, beta, y, 1); \
+    }
+
+DEFINE_CBLAS_FUNC(float, s);
+DEFINE_CBLAS_FUNC(double, d);
+#undef DEFINE_CBLAS_FUNC
+
+#else
+
+/*! The Eigen, by default */
+
+template <typename T>
+void _Gemm(
+    const CBLAS_TRANSPOSE   TransA,
+    const CBLAS_TRANSPOSE   TransB,
+    const int               M,
+    const int               N,
+    const int               K,
+    const T                 alpha,
+    const T*                A,
+    const T*                B,
+    const T                 beta,
+    T*                      C) {
+    auto C_mat = EigenMatrixMap<T>(C, N, M);
+    if (beta == T(0)) C_mat.setZero();
+    else C_mat *= beta;
+    switch (TransA) {
+        case CblasNoTrans: {
+            switch (TransB) {
+                case CblasNoTrans:
+                    C_mat.noalias() += alpha *
+                        (ConstEigenMatrixMap<T>(B, N, K) *
+                            ConstEigenMatrixMap<T>(A, K, M));
+                    return;
+                case CblasTrans:
+                    C_mat.noalias() += alpha *
+                        (ConstEigenMatrixMap<T>(B, K, N).transpose() *
+                            ConstEigenMatrixMap<T>(A, K, M));
+                    return;
+                default:
+                    LOG(FATAL) << "Unexpected CBLAS_TRANSPOSE for TransB";
+            }
+        }
+        case CblasTrans: {
+            switch (TransB) {
+                case CblasNoTrans:
+                    C_mat.noalias() += alpha *
+                        (ConstEigenMatrixMap<T>(B, N, K) *
+                            ConstEigenMatrixMap<T>(A, M, K).transpose());
+                    return;
+                case CblasTrans:
+                    C_mat.noalias() += alpha *
+                        (ConstEigenMatrixMap<T>(B, K, N).transpose() *
+                            ConstEigenMatrixMap<T>(A, M, K).transpose());
+                    return;
+                default:
+                    LOG(FATAL) << "Unexpected CBLAS_TRANSPOSE for TransB";
+            }
+        }
+        default:
+            LOG(FATAL) << "Unexpected CBLAS_TRANSPOSE for TransA";
+    }
+}
+
+template <typename T>
+void _Gemv(
+    const CBLAS_TRANSPOSE   TransA,
+    const int               M,
+    const int               N,
+    const T                 alpha,
+    const T*                A,
+    const T*                x,
+    const T                 beta,
+    T*                      y) {
+    EigenVectorMap<T> y_vec(y, TransA == CblasNoTrans ? M : N);
+    if (beta == T(0)) y_vec.setZero();
+    else y_vec *= beta;
+    switch (TransA) {
+        case CblasNoTrans: {
+            y_vec.noalias() += alpha *
+                (ConstEigenMatrixMap<T>(A, N, M).transpose() *
+                    ConstEigenVectorMap<T>(x, N));
+            return;
+        }
+        case CblasTrans: {
+            y_vec.noalias() += alpha *
+                (ConstEigenMatrixMap<T>(A, N, M) *
+                    ConstEigenVectorMap<T>(x, M));
+            return;
+        }
+        default:
+            LOG(FATAL) << "Gemv float found an unexpected CBLAS_TRANSPOSE input.";
+    }
+}
+
+#endif  // WITH_CBLAS
+
+#define DEFINE_GEMM_FUNC(T) \
+    template <> void Gemm<T, CPUContext>( \
+        const CBLAS_TRANSPOSE   TransA, \
+        const CBLAS_TRANSPOSE   TransB, \
+        const int               M, \
+        const int               N, \
+        const int               K, \
+        const float             alpha, \
+        const T*                A, \
+        const T*                B, \
+        const float             beta, \
+        T*                      C, \
+        CPUContext*             ctx, \
+        TensorProto_DataType    math_type) { \
+        _Gemm(TransA, TransB, M, N, K, \
+            (T)alpha, A, B, (T)beta, C); \
+    }
+
+DEFINE_GEMM_FUNC(float);
+DEFINE_GEMM_FUNC(double);
+#undef DEFINE_GEMM_FUNC
+
+#define DEFINE_GEMV_FUNC(T) \
+    template <> void Gemv<T, CPUContext>( \
+        const CBLAS_TRANSPOSE   TransA, \
+        const int               M, \
+        const int               N, \
+        const float             alpha, \
+        const T*                A, \
+        const T*                x, \
+        const float             beta, \
+        T*                      y, \
+        CPUContext*             ctx, \
+        TensorProto_DataType    math_type) { \
+        _Gemv(TransA, M, N, (T)alpha, A, x, (T)beta, y); \
+    }
+
+DEFINE_GEMV_FUNC(float);
+DEFINE_GEMV_FUNC(double);
+#undef DEFINE_GEMV_FUNC
+
+/*!
+ * ----------------------------------------------
+ *
+ *
+ *              Batched Gemm Functions
+ *
+ *
+ * ----------------------------------------------
+ */
+
+#if defined(WITH_MKL) && INTEL_MKL_VERSION >= 20210000
+
+#define DEFINE_GEMM_STRIDED_BATCHED_FUNC(T, prefix) \
+    template <> void GemmStridedBatched<T, CPUContext>( \
+        const CBLAS_TRANSPOSE   TransA, \
+        const CBLAS_TRANSPOSE   TransB, \
+        const int               batch_size, \
+        const int               M, \
+        const int               N, \
+        const int               K, \
+        const float             alpha, \
+        const T*                A, \
+        const int64_t           A_stride, \
+        const T*                B, \
+        const int64_t           B_stride, \
+        const float             beta, \
+        T*                      C, \
+        const int64_t           C_stride, \
+        CPUContext*             ctx, \
+        TensorProto_DataType    math_type) { \
+        const int lda = (TransA == CblasNoTrans) ? K : M; \
+        const int ldb = (TransB == CblasNoTrans) ? N : K; \
+        cblas_##prefix##gemm_batch_strided(CblasRowMajor, \
+            _CblasTrans(TransA), _CblasTrans(TransB), \
+                M, N, K, (T)alpha, A, lda, A_stride, \
+                    B, ldb, B_stride, (T)beta, C, N, C_stride, \
+                        batch_size); \
+    }
+
+#else
+
+/*!
+ * Eigen runs a Gemm with all threads, which is wasted on
+ * the small matrices, parallelize over the batches instead.
+ * OpenBLAS is not guaranteed to be reentrant in OpenMP.
+ */
+
+inline int _BatchedGemmThreads(
+    const int               batch_size,
+    const int               M,
+    const int               N) {
+#if defined(WITH_OMP) && !defined(WITH_CBLAS)
+    const int64_t count = std::min(
+        (int64_t)batch_size * M * N, (int64_t)INT_MAX);
+    const int threads = GET_OMP_THREADS((int)count);
+    return batch_size >= threads ? threads : 1;
+#else
+    return 1;
+#endif
+}
+
+#define DEFINE_GEMM_STRIDED_BATCHED_FUNC(T, prefix) \
+    template <> void GemmStridedBatched<T, CPUContext>( \
+        const CBLAS_TRANSPOSE   TransA, \
+        const CBLAS_TRANSPOSE   TransB, \
+        const int               batch_size, \
+        const int               M, \
+        const int               N, \
+        const int               K, \
+        const float             alpha, \
+        const T*                A, \
+        const int64_t           A_stride, \
+        const T*                B, \
+        const int64_t           B_stride, \
+        const float             beta, \
+        T*                      C, \
+        const int64_t           C_stride, \
+        CPUContext*             ctx, \
+        TensorProto_DataType    math_type) { \
+        const int threads = _BatchedGemmThreads(batch_size, M, N); \
+        if (threads > 1) { \
+            _Pragma("omp parallel for num_threads(threads)") \
+            for (int i = 0; i < batch_size; ++i) { \
+                _Gemm(TransA, TransB, M, N, K, (T)alpha, \
+                    A + i * A_stride, B + i * B_stride, \
+                        (T)beta, C + i * C_stride); \
+            } \
+        } else { \
+            for (int i = 0; i < batch_size; ++i) { \
+                _Gemm(TransA, TransB, M, N, K, (T)alpha, \
+                    A + i * A_stride, B + i * B_stride, \
+                        (T)beta, C + i * C_stride); \
+            } \
+        } \
+    }
+
+#endif
+
+DEFINE_GEMM_STRIDED_BATCHED_FUNC(float, s);
+DEFINE_GEMM_STRIDED_BATCHED_FUNC(double, d);
+#undef DEFINE_GEMM_STRIDED_BATCHED_FUNC
+
+/*!
+ * ----------------------------------------------
+ *
+ *
+ *              Packed Gemm Functions
+ *
+ *
+ * ----------------------------------------------
+ */
+
+#ifdef WITH_MKL
+
+/*! MKL packs the operand into its internal panels once */
+
+inline ::CBLAS_IDENTIFIER _CblasIdentifier(const CBLAS_IDENTIFIER which) {
+    return which == CblasAMatrix ? ::CblasAMatrix : ::CblasBMatrix;
+}
+
+#define DEFINE_GEMM_PACKED_FUNC(T, prefix) \
+    template <> bool GemmPackable<T, CPUContext>( \
+        CPUContext*             ctx) { \
+        return true; \
+    } \
+    template <> int64_t GemmPackedSize<T, CPUContext>( \
+        const CBLAS_IDENTIFIER  which, \
+        const CBLAS_TRANSPOSE   Trans, \
+        const int               M, \
+        const int               N, \
+        const int               K, \
+        CPUContext*             ctx) { \
+        size_t nbytes = cblas_##prefix##gemm_pack_get_size( \
+            _CblasIdentifier(which), M, N, K); \
+        return (int64_t)((nbytes + sizeof(T) - 1) / sizeof(T)); \
+    } \
+    template <> void GemmPack<T, CPUContext>( \
+        const CBLAS_IDENTIFIER  which, \
+        const CBLAS_TRANSPOSE   Trans, \
+        const int               M, \
+        const int               N, \
+        const int               K, \
+        const T*                X, \
+        T*                      packed_X, \
+        CPUContext*             ctx) { \
+        const int ldx = (which == CblasAMatrix) ? \
+            (Trans == CblasNoTrans ? K : M) : \
+            (Trans == CblasNoTrans ? N : K); \
+        cblas_##prefix##gemm_pack(CblasRowMajor, \
+            _CblasIdentifier(which), _CblasTrans(Trans), \
+                M, N, K, T(1), X, ldx, packed_X); \
+    } \
+    template <> void GemmPacked<T, CPUContext>( \
+        const CBLAS_IDENTIFIER  which, \
+        const CBLAS_TRANSPOSE   TransA, \
+        const CBLAS_TRANSPOSE   TransB, \
+        const int               M, \
+        const int               N, \
+        const int               K, \
+        const T*                A, \
+        const T*                B, \
+        const float             beta, \
+        T*                      C, \
+        CPUContext*             ctx) { \
+        const int lda = (TransA == CblasNoTrans) ? K : M; \
+        const int ldb = (TransB == CblasNoTrans) ? N : K; \
+        const MKL_INT cuTransA = (which == CblasAMatrix) ? \
+            (MKL_INT)CblasPacked : (MKL_INT)_CblasTrans(TransA); \
+        const MKL_INT cuTransB = (which == CblasBMatrix) ? \
+            (MKL_INT)CblasPacked : (MKL_INT)_CblasTrans(TransB); \
+        cblas_##prefix##gemm_compute(CblasRowMajor, \
+            cuTransA, cuTransB, M, N, K, \
+                A, lda, B, ldb, (T)beta, C, N); \
+    }
+
+#else
+
+/*!
+ * Without a packing API, the backend packs the operands inside
+ * each Gemm, so the operand is only stored as the NoTrans copy.
+ */
+
+#define DEFINE_GEMM_PACKED_FUNC(T, prefix) \
+    template <> bool GemmPackable<T, CPUContext>( \
+        CPUContext*             ctx) { \
+        return false; \
+    } \
+    template <> int64_t GemmPackedSize<T, CPUContext>( \
+        const CBLAS_IDENTIFIER  which, \
+        const CBLAS_TRANSPOSE   Trans, \
+        const int               M, \
+        const int               N, \
+        const int               K, \
+        CPUContext*             ctx) { \
+        return (int64_t)(which == CblasAMatrix ? M : N) * K; \
+    } \
+    template <> void GemmPack<T, CPUContext>( \
+        const CBLAS_IDENTIFIER  which, \
+        const CBLAS_TRANSPOSE   Trans, \
+        const int               M, \
+        const int               N, \
+        const int               K, \
+        const T*                X, \
+        T*                      packed_X, \
+        CPUContext*             ctx) { \
+        const int rows = (which == CblasAMatrix) ? M : K; \
+        const int cols = (which == CblasAMatrix) ? K : N; \
+        if (Trans == CblasNoTrans) { \
+            ctx->Copy<T, CPUContext, CPUContext>( \
+                rows * cols, packed_X, X); \
+        } else { \
+            EigenMatrixMap<T>(packed_X, cols, rows) = \
+                ConstEigenMatrixMap<T>(X, rows, cols).transpose(); \
+        } \
+    } \
+    template <> void GemmPacked<T, CPUContext>( \
+        const CBLAS_IDENTIFIER  which, \
+        const CBLAS_TRANSPOSE   TransA, \
+        const CBLAS_TRANSPOSE   TransB, \
+        const int               M, \
+        const int               N, \
+        const int               K, \
+        const T*                A, \
+        const T*                B, \
+        const float             beta, \
+        T*                      C, \
+        CPUContext*             ctx) { \
+        _Gemm(which == CblasAMatrix ? CblasNoTrans : TransA, \
+              which == CblasBMatrix ? CblasNoTrans : TransB, \
+              M, N, K, T(1), A, B, (T)beta, C); \
+    }
+
+#endif  // WITH_MKL
+
+DEFINE_GEMM_PACKED_FUNC(float, s);
+DEFINE_GEMM_PACKED_FUNC(double, d);
+#undef DEFINE_GEMM_PACKED_FUNC
+
+}  // namespace math
+
+}  // namespace dragon
@@ -1,5 +1,8 @@
+#include <cmath>
+
 #include "core/context.h"
 #include "utils/cast.h"
+#include "utils/cpu_isa.h"
 #include "utils/op_kernel.h"
 #include "utils/eigen_utils.h"
 #include "utils/math_functions.h"
@@ -32,20 +35,166 @@ DEFINE_SIMPLE_UNARY_FUNC(Exp, float, exp);
 DEFINE_SIMPLE_UNARY_FUNC(Exp, double, exp);
 DEFINE_SIMPLE_UNARY_FUNC(Log, float, log);
 DEFINE_SIMPLE_UNARY_FUNC(Log, double, log);
-DEFINE_SIMPLE_UNARY_FUNC(Inv, float, inverse);
 DEFINE_SIMPLE_UNARY_FUNC(Inv, double, inverse);
-DEFINE_SIMPLE_UNARY_FUNC(Sqrt, float, sqrt);
 DEFINE_SIMPLE_UNARY_FUNC(Sqrt, double, sqrt);
-DEFINE_SIMPLE_UNARY_FUNC(RSqrt, float, rsqrt);
 DEFINE_SIMPLE_UNARY_FUNC(RSqrt, double, rsqrt);
 DEFINE_SIMPLE_UNARY_FUNC(Square, int8_t, square);
 DEFINE_SIMPLE_UNARY_FUNC(Square, uint8_t, square);
 DEFINE_SIMPLE_UNARY_FUNC(Square, int, square);
 DEFINE_SIMPLE_UNARY_FUNC(Square, int64_t, square);
-DEFINE_SIMPLE_UNARY_FUNC(Square, float, square);
 DEFINE_SIMPLE_UNARY_FUNC(Square, double, square);
 #undef DEFINE_SIMPLE_UNARY_FUNC
 
+/*!
+ * ----------------------------------------------
+ *
+ *
+ *         ISA Dispatched Float Functions
+ *
+ *
+ * ----------------------------------------------
+ */
+
+#define DEFINE_ISA_UNARY_FUNC(name, expr) \
+    CPU_ISA_INLINE void _##name##Elem( \
+        const int               i, \
+        const float*            x, \
+        float*                  y) { \
+        y[i] = expr; \
+    } \
+    DEFINE_CPU_ISA_LOOP(_##name##Elem, \
+        (const float* x, float* y), (x, y)); \
+    template <> void name<float, CPUContext>( \
+        const int               n, \
+        const float*            x, \
+        float*                  y, \
+        CPUContext*             ctx) { \
+        DISPATCH_CPU_ISA(_##name##Elem, n, x, y); \
+    }
+
+DEFINE_ISA_UNARY_FUNC(Inv, 1.f / x[i]);
+DEFINE_ISA_UNARY_FUNC(Sqrt, std::sqrt(x[i]));
+DEFINE_ISA_UNARY_FUNC(RSqrt, 1.f / std::sqrt(x[i]));
+DEFINE_ISA_UNARY_FUNC(Square, x[i] * x[i]);
+#undef DEFINE_ISA_UNARY_FUNC
+
+#define DEFINE_ISA_SCALE_UNARY_FUNC(name, expr) \
+    CPU_ISA_INLINE void _##name##Elem( \
+        const int               i, \
+        const float             alpha, \
+        const float*            x, \
+        float*                  y) { \
+        expr; \
+    } \
+    DEFINE_CPU_ISA_LOOP(_##name##Elem, \
+        (const float alpha, const float* x, float* y), \
+        (alpha, x, y)); \
+    template <> void name<float, CPUContext>( \
+        const int               n, \
+        const float             alpha, \
+        const float*            x, \
+        float*                  y, \
+        CPUContext*             ctx) { \
+        DISPATCH_CPU_ISA(_##name##Elem, n, alpha, x, y); \
+    }
+
+DEFINE_ISA_SCALE_UNARY_FUNC(Scale, y[i] = x[i] * alpha);
+DEFINE_ISA_SCALE_UNARY_FUNC(Axpy, y[i] += x[i] * alpha);
+DEFINE_ISA_SCALE_UNARY_FUNC(InvStd, y[i] = 1.f / std::sqrt(x[i] + alpha));
+#undef DEFINE_ISA_SCALE_UNARY_FUNC
+
+CPU_ISA_INLINE void _AddScalarElem(
+    const int               i,
+    const float             alpha,
+    float*                  y) {
+    y[i] += alpha;
+}
+
+DEFINE_CPU_ISA_LOOP(_AddScalarElem,
+    (const float alpha, float* y), (alpha, y));
+
+template <> void AddScalar<float, CPUContext>(
+    const int               n,
+    const float             alpha,
+    float*                  y,
+    CPUContext*             ctx) {
+    if (alpha == 0.f) return;
+    DISPATCH_CPU_ISA(_AddScalarElem, n, alpha, y);
+}
+
+#define DEFINE_ISA_BINARY_FUNC(name, expr) \
+    CPU_ISA_INLINE void _##name##Elem( \
+        const int               i, \
+        const float*            a, \
+        const float*            b, \
+        float*                  y) { \
+        y[i] = a[i] expr b[i]; \
+    } \
+    DEFINE_CPU_ISA_LOOP(_##name##Elem, \
+        (const float* a, const float* b, float* y), (a, b, y)); \
+    template <> void name<float, CPUContext>( \
+        const int               n, \
+        const float*            a, \
+        const float*            b, \
+        float*                  y, \
+        CPUContext*             ctx) { \
+        DISPATCH_CPU_ISA(_##name##Elem, n, a, b, y); \
+    }
+
+DEFINE_ISA_BINARY_FUNC(Add, +);
+DEFINE_ISA_BINARY_FUNC(Sub, -);
+DEFINE_ISA_BINARY_FUNC(Mul, *);
+DEFINE_ISA_BINARY_FUNC(Div, /);
+#undef DEFINE_ISA_BINARY_FUNC
+
+CPU_ISA_INLINE float _SumElem(const int i, const float* x) { return x[i]; }
+CPU_ISA_INLINE float _ASumElem(const int i, const float* x) { return std::abs(x[i]); }
+
+CPU_ISA_INLINE float _DotElem(
+    const int               i,
+    const float*            a,
+    const float*            b) {
+    return a[i] * b[i];
+}
+
+DEFINE_CPU_ISA_REDUCE(float, _SumElem, (const float* x), (x));
+DEFINE_CPU_ISA_REDUCE(float, _ASumElem, (const float* x), (x));
+DEFINE_CPU_ISA_REDUCE(float, _DotElem,
+    (const float* a, const float* b), (a, b));
+
+template <> void Sum<float, CPUContext>(
+    const int               n,
+    const float             scale,
+    const float*            x,
+    float*                  y,
+    CPUContext*             ctx) {
+    *y = DISPATCH_CPU_ISA(_SumElem, n, x) * scale;
+}
+
+template <> float Sum<float, CPUContext>(
+    const int               n,
+    const float             scale,
+    const float*            x,
+    CPUContext*             ctx) {
+    return DISPATCH_CPU_ISA(_SumElem, n, x) * scale;
+}
+
+template <> float ASum<float, CPUContext>(
+    const int               n,
+    const float*            x,
+    CPUContext*             ctx) {
+    return DISPATCH_CPU_ISA(_ASumElem, n, x);
+}
+
+template <> void Dot<float, CPUContext>(
+    int                     n,
+    const float*            a,
+    const float*            b,
+    float*                  y,
+    CPUContext*             ctx) {
+    *y = DISPATCH_CPU_ISA(_DotElem, n, a, b);
+}
+
 /*!
  * ----------------------------------------------
  *
@@ -144,7 +293,6 @@ DEFINE_SCALE_FUNC(int8_t);
 DEFINE_SCALE_FUNC(uint8_t);
 DEFINE_SCALE_FUNC(int);
 DEFINE_SCALE_FUNC(int64_t);
-DEFINE_SCALE_FUNC(float);
 DEFINE_SCALE_FUNC(double);
 #undef DEFINE_SCALE_FUNC
 
@@ -165,7 +313,6 @@ DEFINE_AXPY_FUNC(int8_t);
 DEFINE_AXPY_FUNC(uint8_t);
 DEFINE_AXPY_FUNC(int);
 DEFINE_AXPY_FUNC(int64_t);
-DEFINE_AXPY_FUNC(float);
 DEFINE_AXPY_FUNC(double);
 #undef DEFINE_AXPY_FUNC
 
@@ -210,7 +357,6 @@ DEFINE_ADD_SCALAR_FUNC(int8_t);
 DEFINE_ADD_SCALAR_FUNC(uint8_t);
 DEFINE_ADD_SCALAR_FUNC(int);
 DEFINE_ADD_SCALAR_FUNC(int64_t);
-DEFINE_ADD_SCALAR_FUNC(float);
 DEFINE_ADD_SCALAR_FUNC(double);
 
 /*!
@@ -236,7 +382,6 @@ DEFINE_ADD_SCALAR_FUNC(double);
             (ConstEigenVectorArrayMap<T>(x, n) + (T)eps).rsqrt(); \
     }
 
-DEFINE_INVSTD_FUNC(float);
 DEFINE_INVSTD_FUNC(double);
 #undef DEFINE_INVSTD_FUNC
 
@@ -265,7 +410,6 @@ DEFINE_SUM_FUNC(int8_t);
 DEFINE_SUM_FUNC(uint8_t);
 DEFINE_SUM_FUNC(int);
 DEFINE_SUM_FUNC(int64_t);
-DEFINE_SUM_FUNC(float);
 DEFINE_SUM_FUNC(double);
 #undef DEFINE_SUM_FUNC
 
@@ -279,7 +423,6 @@ DEFINE_SUM_FUNC(double);
         return ConstEigenVectorArrayMap<T>(x, n).abs().sum(); \
     }
 
-DEFINE_ASUM_FUNC(float);
 DEFINE_ASUM_FUNC(double);
 
 /*!
@@ -309,25 +452,21 @@ DEFINE_SIMPLE_BINARY_FUNC(Add, int8_t, +);
 DEFINE_SIMPLE_BINARY_FUNC(Add, uint8_t, +);
 DEFINE_SIMPLE_BINARY_FUNC(Add, int, +);
 DEFINE_SIMPLE_BINARY_FUNC(Add, int64_t, +);
-DEFINE_SIMPLE_BINARY_FUNC(Add, float, +);
 DEFINE_SIMPLE_BINARY_FUNC(Add, double, +);
 DEFINE_SIMPLE_BINARY_FUNC(Sub, int8_t, -);
 DEFINE_SIMPLE_BINARY_FUNC(Sub, uint8_t, -);
 DEFINE_SIMPLE_BINARY_FUNC(Sub, int, -);
 DEFINE_SIMPLE_BINARY_FUNC(Sub, int64_t, -);
-DEFINE_SIMPLE_BINARY_FUNC(Sub, float, -);
 DEFINE_SIMPLE_BINARY_FUNC(Sub, double, -);
 DEFINE_SIMPLE_BINARY_FUNC(Mul, int8_t, *);
 DEFINE_SIMPLE_BINARY_FUNC(Mul, uint8_t, *);
 DEFINE_SIMPLE_BINARY_FUNC(Mul, int, *);
 DEFINE_SIMPLE_BINARY_FUNC(Mul, int64_t, *);
-DEFINE_SIMPLE_BINARY_FUNC(Mul, float, *);
 DEFINE_SIMPLE_BINARY_FUNC(Mul, double, *);
 DEFINE_SIMPLE_BINARY_FUNC(Div, int8_t, /);
 DEFINE_SIMPLE_BINARY_FUNC(Div, uint8_t, /);
 DEFINE_SIMPLE_BINARY_FUNC(Div, int, /);
 DEFINE_SIMPLE_BINARY_FUNC(Div, int64_t, /);
-DEFINE_SIMPLE_BINARY_FUNC(Div, float, /);
 DEFINE_SIMPLE_BINARY_FUNC(Div, double, / );
 #undef DEFINE_SIMPLE_BINARY_FUNC
 
@@ -342,7 +481,6 @@ DEFINE_SIMPLE_BINARY_FUNC(Div, double, / );
                 ConstEigenVectorMap<T>(b, n)); \
     }
 
-DEFINE_DOT_FUNC(float);
 DEFINE_DOT_FUNC(double);
 #undef DEFINE_DOT_FUNC
 
@@ -500,114 +638,6 @@ DEFINE_BROADCAST_BINARY_FUNC(Div, float, /);
 DEFINE_BROADCAST_BINARY_FUNC(Div, double, /);
 #undef DEFINE_BROADCAST_BINARY_FUNC
 
-/*!
- * ----------------------------------------------
- *
- *
- *        Linear Algebra Binary Functions
- *
- *
- * ----------------------------------------------
- */
-
-#define DEFINE_GEMM_FUNC(T) \
-    template <> void Gemm<T, CPUContext>( \
-        const CBLAS_TRANSPOSE   TransA, \
-        const CBLAS_TRANSPOSE   TransB, \
-        const int               M, \
-        const int               N, \
-        const int               K, \
-        const float             alpha, \
-        const T*                A, \
-        const T*                B, \
-        const float             beta, \
-        T*                      C, \
-        CPUContext*             ctx, \
-        TensorProto_DataType    math_type) { \
-        T _alpha_ = alpha, _beta_ = beta; \
-        auto C_mat = EigenMatrixMap<T>(C, N, M); \
-        if (beta == 0.f) C_mat.setZero(); \
-        else C_mat *= _beta_; \
-        switch (TransA) { \
-            case CblasNoTrans: { \
-                switch (TransB) { \
-                    case CblasNoTrans: \
-                        C_mat.noalias() += _alpha_ * \
-                            (ConstEigenMatrixMap<T>(B, N, K) * \
-                                ConstEigenMatrixMap<T>(A, K, M)); \
-                        return; \
-                    case CblasTrans: \
-                        C_mat.noalias() += _alpha_ * \
-                            (ConstEigenMatrixMap<T>(B, K, N).transpose() * \
-                                ConstEigenMatrixMap<T>(A, K, M)); \
-                        return; \
-                    default: \
-                        LOG(FATAL) << "Unexpected CBLAS_TRANSPOSE for TransB"; \
-                } \
-            } \
-            case CblasTrans: { \
-                switch (TransB) { \
-                    case CblasNoTrans: \
-                        C_mat.noalias() += _alpha_ * \
-                            (ConstEigenMatrixMap<T>(B, N, K) * \
-                                ConstEigenMatrixMap<T>(A, M, K).transpose()); \
-                        return; \
-                    case CblasTrans: \
-                        C_mat.noalias() += _alpha_ * \
-                            (ConstEigenMatrixMap<T>(B, K, N).transpose() * \
-                                ConstEigenMatrixMap<T>(A, M, K).transpose()); \
-                        return; \
-                    default: \
-                        LOG(FATAL) << "Unexpected CBLAS_TRANSPOSE for TransB"; \
-                } \
-            } \
-            default: \
-                LOG(FATAL) << "Unexpected CBLAS_TRANSPOSE for TransA"; \
-        } \
-    }
-
-DEFINE_GEMM_FUNC(float);
-DEFINE_GEMM_FUNC(double);
-#undef DEFINE_GEMM_FUNC
-
-#define DEFINE_GEMV_FUNC(T) \
-    template <> void Gemv<T, CPUContext>( \
-        const CBLAS_TRANSPOSE   TransA, \
-        const int               M, \
-        const int               N, \
-        const float             alpha, \
-        const T*                A, \
-        const T*                x, \
-        const float             beta, \
-        T*                      y, \
-        CPUContext*             ctx, \
-        TensorProto_DataType    math_type) { \
-        T _alpha_ = alpha, _beta_ = beta; \
-        EigenVectorMap<T> y_vec(y, TransA == CblasNoTrans ? M : N); \
-        if (beta == 0.f) y_vec.setZero(); \
-        else y_vec *= _beta_; \
-        switch (TransA) { \
-            case CblasNoTrans: { \
-                y_vec.noalias() += alpha * \
-                    (ConstEigenMatrixMap<T>(A, N, M).transpose() * \
-                        ConstEigenVectorMap<T>(x, N)); \
-                return; \
-            } \
-            case CblasTrans: { \
-                y_vec.noalias() += alpha * \
-                    (ConstEigenMatrixMap<T>(A, N, M) * \
-                        ConstEigenVectorMap<T>(x, M)); \
-                return; \
-            } \
-            default: \
-                LOG(FATAL) << "Gemv float found an unexpected CBLAS_TRANSPOSE input."; \
-        } \
-    }
-
-DEFINE_GEMV_FUNC(float);
-DEFINE_GEMV_FUNC(double);
-#undef DEFINE_GEMV_FUNC
-
 /*!
  * ----------------------------------------------
  *
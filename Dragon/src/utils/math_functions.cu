@@ -921,6 +921,88 @@ template <> void Gemv<double, CUDAContext>(
             &_alpha_, A, N, x, 1, &_beta_, y, 1));
 }
 
+#define DEFINE_GEMM_STRIDED_BATCHED_FUNC(T, cublas_func) \
+    template <> void GemmStridedBatched<T, CUDAContext>( \
+        const CBLAS_TRANSPOSE   TransA, \
+        const CBLAS_TRANSPOSE   TransB, \
+        const int               batch_size, \
+        const int               M, \
+        const int               N, \
+        const int               K, \
+        const float             alpha, \
+        const T*                A, \
+        const int64_t           A_stride, \
+        const T*                B, \
+        const int64_t           B_stride, \
+        const float             beta, \
+        T*                      C, \
+        const int64_t           C_stride, \
+        CUDAContext*            ctx, \
+        TensorProto_DataType    math_type) { \
+        int lda = (TransA == CblasNoTrans) ? K : M; \
+        int ldb = (TransB == CblasNoTrans) ? N : K; \
+        cublasOperation_t cuTransA = (TransA == CblasNoTrans) ? \
+            CUBLAS_OP_N : CUBLAS_OP_T; \
+        cublasOperation_t cuTransB = (TransB == CblasNoTrans) ? \
+            CUBLAS_OP_N : CUBLAS_OP_T; \
+        const T _alpha_ = alpha, _beta_ = beta; \
+        CUBLAS_CHECK(cublas_func(ctx->cublas_handle(), \
+            cuTransB, cuTransA, N, M, K, \
+                &_alpha_, B, ldb, B_stride, A, lda, A_stride, \
+                    &_beta_, C, N, C_stride, batch_size)); \
+    }
+
+DEFINE_GEMM_STRIDED_BATCHED_FUNC(float, cublasSgemmStridedBatched);
+DEFINE_GEMM_STRIDED_BATCHED_FUNC(double, cublasDgemmStridedBatched);
+#undef DEFINE_GEMM_STRIDED_BATCHED_FUNC
+
+/*! cuBLAS has no packing API, the packed operand is a copy */
+
+#define DEFINE_GEMM_PACKED_FUNC(T) \
+    template <> bool GemmPackable<T, CUDAContext>( \
+        CUDAContext*            ctx) { \
+        return false; \
+    } \
+    template <> int64_t GemmPackedSize<T, CUDAContext>( \
+        const CBLAS_IDENTIFIER  which, \
+        const CBLAS_TRANSPOSE   Trans, \
+        const int               M, \
+        const int               N, \
+        const int               K, \
+        CUDAContext*            ctx) { \
+        return (int64_t)(which == CblasAMatrix ? M : N) * K; \
+    } \
+    template <> void GemmPack<T, CUDAContext>( \
+        const CBLAS_IDENTIFIER  which, \
+        const CBLAS_TRANSPOSE   Trans, \
+        const int               M, \
+        const int               N, \
+        const int               K, \
+        const T*                X, \
+        T*                      packed_X, \
+        CUDAContext*            ctx) { \
+        ctx->Copy<T, CUDAContext, CUDAContext>( \
+            (which == CblasAMatrix ? M : N) * K, packed_X, X); \
+    } \
+    template <> void GemmPacked<T, CUDAContext>( \
+        const CBLAS_IDENTIFIER  which, \
+        const CBLAS_TRANSPOSE   TransA, \
+        const CBLAS_TRANSPOSE   TransB, \
+        const int               M, \
+        const int               N, \
+        const int               K, \
+        const T*                A, \
+        const T*                B, \
+        const float             beta, \
+        T*                      C, \
+        CUDAContext*            ctx) { \
+        Gemm(TransA, TransB, M, N, K, 1.f, A, B, beta, C, ctx); \
+    }
+
+DEFINE_GEMM_PACKED_FUNC(float);
+DEFINE_GEMM_PACKED_FUNC(double);
+#undef DEFINE_GEMM_PACKED_FUNC
+
 /*!
  * ----------------------------------------------
  *
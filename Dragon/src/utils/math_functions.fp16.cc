@@ -267,6 +267,69 @@ template <> void Gemv<float16, CPUContext>(
     CPU_FP16_NOT_SUPPORTED;
 }
 
+template <> void GemmStridedBatched<float16, CPUContext>(
+    const CBLAS_TRANSPOSE   TransA,
+    const CBLAS_TRANSPOSE   TransB,
+    const int               batch_size,
+    const int               M,
+    const int               N,
+    const int               K,
+    const float             alpha,
+    const float16*          A,
+    const int64_t           A_stride,
+    const float16*          B,
+    const int64_t           B_stride,
+    const float             beta,
+    float16*                C,
+    const int64_t           C_stride,
+    CPUContext*             ctx,
+    TensorProto_DataType    math_type) {
+    CPU_FP16_NOT_SUPPORTED;
+}
+
+template <> bool GemmPackable<float16, CPUContext>(
+    CPUContext*             ctx) {
+    return false;
+}
+
+template <> int64_t GemmPackedSize<float16, CPUContext>(
+    const CBLAS_IDENTIFIER  which,
+    const CBLAS_TRANSPOSE   Trans,
+    const int               M,
+    const int               N,
+    const int               K,
+    CPUContext*             ctx) {
+    CPU_FP16_NOT_SUPPORTED;
+    return 0;
+}
+
+template <> void GemmPack<float16, CPUContext>(
+    const CBLAS_IDENTIFIER  which,
+    const CBLAS_TRANSPOSE   Trans,
+    const int               M,
+    const int               N,
+    const int               K,
+    const float16*          X,
+    float16*                packed_X,
+    CPUContext*             ctx) {
+    CPU_FP16_NOT_SUPPORTED;
+}
+
+template <> void GemmPacked<float16, CPUContext>(
+    const CBLAS_IDENTIFIER  which,
+    const CBLAS_TRANSPOSE   TransA,
+    const CBLAS_TRANSPOSE   TransB,
+    const int               M,
+    const int               N,
+    const int               K,
+    const float16*          A,
+    const float16*          B,
+    const float             beta,
+    float16*                C,
+    CPUContext*             ctx) {
+    CPU_FP16_NOT_SUPPORTED;
+}
+
 /*!
  * ----------------------------------------------
  *
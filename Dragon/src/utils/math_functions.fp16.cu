@@ -1088,6 +1088,73 @@ template <> void Gemv<float16, CUDAContext>(
     }
 }
 
+template <> void GemmStridedBatched<float16, CUDAContext>(
+    const CBLAS_TRANSPOSE   TransA,
+    const CBLAS_TRANSPOSE   TransB,
+    const int               batch_size,
+    const int               M,
+    const int               N,
+    const int               K,
+    const float             alpha,
+    const float16*          A,
+    const int64_t           A_stride,
+    const float16*          B,
+    const int64_t           B_stride,
+    const float             beta,
+    float16*                C,
+    const int64_t           C_stride,
+    CUDAContext*            ctx,
+    TensorProto_DataType    math_type) {
+    for (int i = 0; i < batch_size; ++i) {
+        Gemm(TransA, TransB, M, N, K,
+            alpha, A + i * A_stride, B + i * B_stride,
+                beta, C + i * C_stride, ctx, math_type);
+    }
+}
+
+template <> bool GemmPackable<float16, CUDAContext>(
+    CUDAContext*            ctx) {
+    return false;
+}
+
+template <> int64_t GemmPackedSize<float16, CUDAContext>(
+    const CBLAS_IDENTIFIER  which,
+    const CBLAS_TRANSPOSE   Trans,
+    const int               M,
+    const int               N,
+    const int               K,
+    CUDAContext*            ctx) {
+    return (int64_t)(which == CblasAMatrix ? M : N) * K;
+}
+
+template <> void GemmPack<float16, CUDAContext>(
+    const CBLAS_IDENTIFIER  which,
+    const CBLAS_TRANSPOSE   Trans,
+    const int               M,
+    const int               N,
+    const int               K,
+    const float16*          X,
+    float16*                packed_X,
+    CUDAContext*            ctx) {
+    ctx->Copy<float16, CUDAContext, CUDAContext>(
+        (which == CblasAMatrix ? M : N) * K, packed_X, X);
+}
+
+template <> void GemmPacked<float16, CUDAContext>(
+    const CBLAS_IDENTIFIER  which,
+    const CBLAS_TRANSPOSE   TransA,
+    const CBLAS_TRANSPOSE   TransB,
+    const int               M,
+    const int               N,
+    const int               K,
+    const float16*          A,
+    const float16*          B,
+    const float             beta,
+    float16*                C,
+    CUDAContext*            ctx) {
+    Gemm(TransA, TransB, M, N, K, 1.f, A, B, beta, C, ctx);
+}
+
 /*!
  * ----------------------------------------------
  *
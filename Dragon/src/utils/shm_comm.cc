@@ -0,0 +1,317 @@
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#if defined(__linux__) || defined(__APPLE__)
+#define WITH_POSIX_SHM
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#include "core/context.h"
+#include "utils/cast.h"
+#include "utils/math_functions.h"
+#include "utils/shm_comm.h"
+
+namespace dragon {
+
+#define SHM_MAGIC 0x44524753
+#define SHM_HEADER_BYTES 4096
+#define SHM_SLOT_BYTES (8 << 20)
+#define SHM_ATTACH_TIMEOUT 120
+
+struct SharedMemoryComm::Header {
+    std::atomic<uint32_t> magic;
+    int32_t size, creator;
+    uint64_t slot_bytes;
+    std::atomic<int32_t> attached, count, generation;
+};
+
+namespace {
+
+/*! Wait until the value is changed, or return spuriously */
+void WaitOnAddress(std::atomic<int32_t>* addr, int32_t value) {
+#ifdef __linux__
+    // Use the shared futex, as the waiters are in different processes
+    syscall(SYS_futex, reinterpret_cast<int32_t*>(addr),
+        FUTEX_WAIT, value, nullptr, nullptr, 0);
+#else
+    std::this_thread::yield();
+#endif
+}
+
+/*! Wake all the waiters of the address */
+void WakeAddress(std::atomic<int32_t>* addr) {
+#ifdef __linux__
+    syscall(SYS_futex, reinterpret_cast<int32_t*>(addr),
+        FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#endif
+}
+
+/*! y += x */
+template <typename T>
+void ReduceSum(int n, const T* x, T* y, CPUContext* ctx) {
+    math::Axpy(n, 1.f, x, y, ctx);
+}
+
+template <> void ReduceSum<float16>(
+    int                         n,
+    const float16*              x,
+    float16*                    y,
+    CPUContext*                 ctx) {
+    for (int i = 0; i < n; ++i) y[i] = cast::to<float16>(
+        cast::to<float>(y[i]) + cast::to<float>(x[i]));
+}
+
+/*! y *= alpha */
+template <typename T>
+void ReduceScale(int n, float alpha, T* y, CPUContext* ctx) {
+    math::Scale(n, alpha, y, y, ctx);
+}
+
+template <> void ReduceScale<float16>(
+    int                         n,
+    float                       alpha,
+    float16*                    y,
+    CPUContext*                 ctx) {
+    for (int i = 0; i < n; ++i) y[i] = cast::to<float16>(
+        cast::to<float>(y[i]) * alpha);
+}
+
+}  // namespace
+
+/*! Constructor of <SharedMemoryComm> */
+
+SharedMemoryComm::SharedMemoryComm(
+    const string&               name,
+    int                         size,
+    int                         rank,
+    size_t                      slot_bytes)
+    : name_("/" + name), size_(size), rank_(rank),
+      slot_bytes_(slot_bytes), header_(nullptr), slots_(nullptr) {
+#ifdef WITH_POSIX_SHM
+    CHECK(!name.empty() && name.find('/') == string::npos)
+        << "\nInvalid name of shared memory: " << name;
+    CHECK(size > 0 && rank >= 0 && rank < size)
+        << "\nInvalid rank " << rank << " of " << size << " ranks.";
+    nbytes_ = SHM_HEADER_BYTES + size * slot_bytes;
+    void* segment = MAP_FAILED;
+    if (rank == 0) {
+        // Remove the segment left by a crashed job
+        shm_unlink(name_.c_str());
+        int fd = shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        CHECK(fd >= 0) << "\nFailed to create shared memory: " << name_;
+        CHECK_EQ(ftruncate(fd, (off_t)nbytes_), 0)
+            << "\nFailed to allocate " << nbytes_ << " bytes for " << name_;
+        segment = mmap(nullptr, nbytes_,
+            PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        CHECK(segment != MAP_FAILED) << "\nFailed to map " << name_;
+        header_ = new (segment) Header();
+        header_->size = size;
+        header_->creator = (int32_t)getpid();
+        header_->slot_bytes = slot_bytes;
+        header_->attached = 1;
+        header_->count = 0;
+        header_->generation = 0;
+        header_->magic.store(SHM_MAGIC, std::memory_order_release);
+    } else {
+        // Wait for the segment of root, skipping the stale ones
+        auto deadline = std::chrono::steady_clock::now() +
+            std::chrono::seconds(SHM_ATTACH_TIMEOUT);
+        while (header_ == nullptr) {
+            CHECK(std::chrono::steady_clock::now() < deadline)
+                << "\nTimeout to attach the shared memory: " << name_;
+            int fd = shm_open(name_.c_str(), O_RDWR, 0600);
+            struct stat st;
+            if (fd >= 0 && fstat(fd, &st) == 0 &&
+                    (size_t)st.st_size >= nbytes_) {
+                segment = mmap(nullptr, nbytes_,
+                    PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            }
+            if (fd >= 0) close(fd);
+            if (segment != MAP_FAILED) {
+                auto* header = static_cast<Header*>(segment);
+                if (header->magic.load(std::memory_order_acquire)
+                        == SHM_MAGIC && kill(header->creator, 0) == 0) {
+                    CHECK(header->size == size &&
+                          header->slot_bytes == slot_bytes)
+                        << "\nThe shared memory " << name_
+                        << " is created for " << header->size << " ranks.";
+                    header_ = header;
+                    header_->attached.fetch_add(1);
+                    break;
+                }
+                munmap(segment, nbytes_);
+                segment = MAP_FAILED;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    slots_ = static_cast<uint8_t*>(segment) + SHM_HEADER_BYTES;
+    Barrier();
+    // Unlink after all the ranks are attached,
+    // the segment is freed as soon as the processes exit
+    if (rank == 0) shm_unlink(name_.c_str());
+#else
+    LOG(FATAL) << "Shared memory collective is not supported "
+               << "on this platform.";
+#endif
+}
+
+/*! Deconstructor of <SharedMemoryComm> */
+
+SharedMemoryComm::~SharedMemoryComm() {
+#ifdef WITH_POSIX_SHM
+    if (header_) munmap(header_, nbytes_);
+#endif
+}
+
+/*! Return the communicator of the job, create if necessary */
+
+SharedMemoryComm* SharedMemoryComm::Get(
+    const string&               name,
+    int                         size,
+    int                         rank) {
+    static std::mutex mutex;
+    static Map<string, unique_ptr<SharedMemoryComm> > comms;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& comm = comms[name];
+    if (!comm) {
+        comm.reset(new SharedMemoryComm(
+            name, size, rank, SHM_SLOT_BYTES));
+    } else {
+        CHECK(comm->size() == size && comm->rank() == rank)
+            << "\nThe shared memory " << name << " is attached as rank "
+            << comm->rank() << " of " << comm->size() << " ranks.";
+    }
+    return comm.get();
+}
+
+/*! Block until all the ranks arrive */
+
+void SharedMemoryComm::Barrier() {
+    const int32_t generation =
+        header_->generation.load(std::memory_order_acquire);
+    if (header_->count.fetch_add(1,
+            std::memory_order_acq_rel) == size_ - 1) {
+        // The last one starts the next generation
+        header_->count.store(0, std::memory_order_relaxed);
+        header_->generation.fetch_add(1, std::memory_order_release);
+        WakeAddress(&header_->generation);
+    } else {
+        for (int spin = 0; header_->generation.load(
+                std::memory_order_acquire) == generation; ++spin) {
+            if (spin < 1024) std::this_thread::yield();
+            else WaitOnAddress(&header_->generation, generation);
+        }
+    }
+}
+
+/*! Sum the data over all the ranks, then scale it */
+
+template <typename T>
+void SharedMemoryComm::AllReduce(T* data, int64_t count, float scale) {
+    ReduceImpl(data, count, -1, scale);
+}
+
+/*! Sum the data over all the ranks into root, then scale it */
+
+template <typename T>
+void SharedMemoryComm::Reduce(T* data, int64_t count, int root, float scale) {
+    CHECK(root >= 0 && root < size_) << "\nInvalid root: " << root;
+    ReduceImpl(data, count, root, scale);
+}
+
+template <typename T>
+void SharedMemoryComm::ReduceImpl(
+    T*                          data,
+    int64_t                     count,
+    int                         root,
+    float                       scale) {
+    CPUContext ctx;
+    const int64_t chunk = slot_bytes_ / sizeof(T);
+    for (int64_t offset = 0; offset < count; offset += chunk) {
+        const int64_t n = std::min(chunk, count - offset);
+        if (size_ > 1) {
+            memcpy(slot(rank_), data + offset, n * sizeof(T));
+            Barrier();
+        }
+        // Reduce-Scatter
+        // Sum the partition of this rank over all the slots
+        const int64_t begin = n * rank_ / size_;
+        const int64_t end = n * (rank_ + 1) / size_;
+        auto* y = size_ > 1 ? (T*)slot(0) + begin : data + offset;
+        for (int i = 1; i < size_; ++i) {
+            ReduceSum((int)(end - begin),
+                (const T*)slot(i) + begin, y, &ctx);
+        }
+        if (scale != 1.f) ReduceScale((int)(end - begin), scale, y, &ctx);
+        // All-Gather, or Gather if root is specified
+        if (size_ > 1) {
+            Barrier();
+            if (root < 0 || root == rank_)
+                memcpy(data + offset, slot(0), n * sizeof(T));
+            Barrier();
+        }
+    }
+}
+
+template void SharedMemoryComm::AllReduce<float16>(float16*, int64_t, float);
+template void SharedMemoryComm::AllReduce<float>(float*, int64_t, float);
+template void SharedMemoryComm::AllReduce<double>(double*, int64_t, float);
+template void SharedMemoryComm::Reduce<float16>(float16*, int64_t, int, float);
+template void SharedMemoryComm::Reduce<float>(float*, int64_t, int, float);
+template void SharedMemoryComm::Reduce<double>(double*, int64_t, int, float);
+
+/*! Copy the bytes of root to all the ranks */
+
+void SharedMemoryComm::Broadcast(void* data, size_t nbytes, int root) {
+    if (size_ == 1) return;
+    auto* bytes = static_cast<uint8_t*>(data);
+    for (size_t offset = 0; offset < nbytes; offset += slot_bytes_) {
+        const size_t n = std::min(slot_bytes_, nbytes - offset);
+        if (rank_ == root) memcpy(slot(root), bytes + offset, n);
+        Barrier();
+        if (rank_ != root) memcpy(bytes + offset, slot(root), n);
+        Barrier();
+    }
+}
+
+/*! Concat the bytes of all the ranks at root */
+
+void SharedMemoryComm::Gather(
+    const void*                 x,
+    size_t                      nbytes,
+    void*                       y,
+    int                         root) {
+    auto* src = static_cast<const uint8_t*>(x);
+    auto* dst = static_cast<uint8_t*>(y);
+    if (size_ == 1) { memcpy(dst, src, nbytes); return; }
+    for (size_t offset = 0; offset < nbytes; offset += slot_bytes_) {
+        const size_t n = std::min(slot_bytes_, nbytes - offset);
+        memcpy(slot(rank_), src + offset, n);
+        Barrier();
+        if (rank_ == root) {
+            for (int i = 0; i < size_; ++i)
+                memcpy(dst + i * nbytes + offset, slot(i), n);
+        }
+        Barrier();
+    }
+}
+
+#undef SHM_MAGIC
+#undef SHM_HEADER_BYTES
+#undef SHM_SLOT_BYTES
+#undef SHM_ATTACH_TIMEOUT
+
+}  // namespace dragon